@@ -70,3 +70,24 @@ ENDIF()
 IF (KOKKOSKERNELS_INST_COMPLEX_FLOAT)
   LIST(APPEND SCALAR_LIST "complex<float>")
 ENDIF()
+
+#Mixed-precision pairs: the first type is the matrix scalar, the second
+#is the vector and accumulation scalar. A pair is instantiated only if
+#both of its scalar types are.
+SET(MIXED_FLOATS
+  FLOAT_DOUBLE
+  COMPLEX_FLOAT_COMPLEX_DOUBLE)
+SET(FLOAT_DOUBLE_CPP_TYPE "float, double")
+SET(COMPLEX_FLOAT_COMPLEX_DOUBLE_CPP_TYPE "Kokkos::complex<float>, Kokkos::complex<double>")
+
+IF (KOKKOSKERNELS_INST_FLOAT AND KOKKOSKERNELS_INST_DOUBLE)
+  SET(KOKKOSKERNELS_INST_FLOAT_DOUBLE ON)
+ELSE()
+  SET(KOKKOSKERNELS_INST_FLOAT_DOUBLE OFF)
+ENDIF()
+
+IF (KOKKOSKERNELS_INST_COMPLEX_FLOAT AND KOKKOSKERNELS_INST_COMPLEX_DOUBLE)
+  SET(KOKKOSKERNELS_INST_COMPLEX_FLOAT_COMPLEX_DOUBLE ON)
+ELSE()
+  SET(KOKKOSKERNELS_INST_COMPLEX_FLOAT_COMPLEX_DOUBLE OFF)
+ENDIF()
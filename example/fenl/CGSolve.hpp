@@ -122,11 +122,12 @@ struct CGSolve< ImportType , SparseMatrixType , VectorType ,
 
       timer.reset();
       /* import p    */  import( pAll );
-      /* Ap = A * p  */  KokkosSparse::spmv( "N", 1.0, A , pAll, 0.0, Ap);
+      /* Ap = A * p, local p'Ap in the same pass */
+      const double pAp_local = KokkosSparse::spmv_dot( "N", 1.0, A , pAll, 0.0, Ap);
       execution_space().fence();
       matvec_time += timer.seconds();
 
-      const double pAp_dot = Kokkos::Example::all_reduce( KokkosBlas::dot( p , Ap ) , import.comm );
+      const double pAp_dot = Kokkos::Example::all_reduce( pAp_local , import.comm );
       const double alpha   = old_rdot / pAp_dot ;
 
       /* x +=  alpha * p ;  */ KokkosBlas::axpby( alpha, p  , 1.0 , x );
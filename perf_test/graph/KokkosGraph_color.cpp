@@ -54,6 +54,7 @@
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "KokkosKernels_TestParameters.hpp"
 #include "KokkosGraph_Distance1Color.hpp"
+#include "KokkosSparse_gauss_seidel.hpp"
 
 
 
@@ -94,8 +95,10 @@ void print_options(std::ostream &os, const char *app_name, unsigned int indent =
        << spaces << "                 COLORING_VBDBIT   - Use the vertex-based deterministic with bit vectors method." << std::endl
        << std::endl
        << spaces << "  Optional Parameters:" << std::endl
+       << spaces << "      --balance           Balance the sizes of the color classes after coloring." << std::endl
        << spaces << "      --chunksize <N>     Set the chunk size." << std::endl
        << spaces << "      --dynamic           Use dynamic scheduling." << std::endl
+       << spaces << "      --gssweeps <N>      Time N symmetric Gauss-Seidel sweeps using the coloring, 0 to skip (Default: 1)." << std::endl
        << spaces << "      --outputfile <FILE> Output the colors of the nodes to the file." << std::endl
        << spaces << "      --repeat <N>        Set number of test repetitions (Default: 1) " << std::endl
        << spaces << "      --teamsize  <N>     Set the team size." << std::endl
@@ -156,6 +159,12 @@ int parse_inputs (KokkosKernels::Experiment::Parameters &params, int argc, char
     else if ( 0 == strcasecmp( argv[i] , "--dynamic" ) ) {
       params.use_dynamic_scheduling = 1;
     }
+    else if ( 0 == strcasecmp( argv[i] , "--balance" ) ) {
+      params.balance_colors = true;
+    }
+    else if ( 0 == strcasecmp( argv[i] , "--gssweeps" ) ) {
+      params.gs_sweeps = atoi(getNextArg(i, argc, argv));
+    }
     else if ( 0 == strcasecmp( argv[i] , "--verbose" ) ) {
       params.verbose = 1;
     }
@@ -231,6 +240,49 @@ namespace KokkosKernels{
 
 namespace Experiment{
 
+//Fills the values of a diagonally dominant matrix with the given graph, for timing Gauss-Seidel.
+template <typename row_map_t, typename entries_t, typename values_t>
+struct FillDiagDominantValues{
+  row_map_t row_map;
+  entries_t entries;
+  values_t values;
+
+  FillDiagDominantValues(row_map_t row_map_, entries_t entries_, values_t values_):
+    row_map(row_map_), entries(entries_), values(values_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename entries_t::non_const_value_type i) const {
+    const auto rowBegin = row_map(i);
+    const auto rowEnd = row_map(i + 1);
+    for (auto j = rowBegin; j < rowEnd; ++j){
+      values(j) = entries(j) == i ? double(rowEnd - rowBegin) : -1.0;
+    }
+  }
+};
+
+//Prints the size statistics of the color classes, which determine how well
+//a multicolor algorithm uses the device in each of its per-color launches.
+template <typename color_view_t>
+void print_color_class_stats(color_view_t colors, size_t num_colors){
+  typename color_view_t::HostMirror h_colors = Kokkos::create_mirror_view(colors);
+  Kokkos::deep_copy(h_colors, colors);
+  std::vector<size_t> class_sizes(num_colors + 1, 0);
+  for (size_t i = 0; i < h_colors.extent(0); ++i){
+    class_sizes[h_colors(i)]++;
+  }
+  double mean = double(h_colors.extent(0)) / num_colors;
+  double variance = 0;
+  size_t min_size = h_colors.extent(0), max_size = 0;
+  for (size_t c = 1; c <= num_colors; ++c){
+    variance += (class_sizes[c] - mean) * (class_sizes[c] - mean);
+    min_size = std::min(min_size, class_sizes[c]);
+    max_size = std::max(max_size, class_sizes[c]);
+  }
+  variance /= num_colors;
+  std::cout << "Color class sizes: min:" << min_size << " max:" << max_size
+            << " mean:" << mean << " variance:" << variance << std::endl;
+}
+
 
 template <typename ExecSpace, typename crsGraph_t, typename crsGraph_t2 , typename crsGraph_t3 , typename TempMemSpace , typename PersistentMemSpace >
 void run_experiment(
@@ -317,6 +369,8 @@ void run_experiment(
 
     }
 
+    kh.get_graph_coloring_handle()->set_balance_colors(params.balance_colors);
+
     graph_color_symbolic(&kh,crsGraph.numRows(), num_cols, crsGraph.row_map, crsGraph.entries);
 
     std::cout << std::endl <<
@@ -324,6 +378,44 @@ void run_experiment(
         "Num colors:" << kh.get_graph_coloring_handle()->get_num_colors() << " "
         "Num Phases:" << kh.get_graph_coloring_handle()->get_num_phases() << std::endl;
     std::cout << "\t"; KokkosKernels::Impl::print_1Dview(kh.get_graph_coloring_handle()->get_vertex_colors());
+    print_color_class_stats(kh.get_graph_coloring_handle()->get_vertex_colors(), kh.get_graph_coloring_handle()->get_num_colors());
+
+    if (params.gs_sweeps > 0){
+      //Multicolor Gauss-Seidel recolors with the same algorithm and balancing option,
+      //then launches one kernel per color in each sweep.
+      typedef KokkosKernels::Experimental::KokkosKernelsHandle
+          <size_type,lno_t, double,
+          ExecSpace, TempMemSpace,PersistentMemSpace > GSKernelHandle;
+      typedef Kokkos::View<double *, Kokkos::Device<ExecSpace, PersistentMemSpace> > scalar_view_t;
+
+      const lno_t num_rows = crsGraph.numRows();
+      scalar_view_t values("values", crsGraph.entries.extent(0));
+      Kokkos::parallel_for("FillDiagDominantValues", Kokkos::RangePolicy<ExecSpace>(0, num_rows),
+          FillDiagDominantValues<decltype(crsGraph.row_map), decltype(crsGraph.entries), scalar_view_t>
+            (crsGraph.row_map, crsGraph.entries, values));
+      scalar_view_t x("x", num_rows);
+      scalar_view_t b("b", num_rows);
+      Kokkos::deep_copy(b, 1.0);
+
+      GSKernelHandle gskh;
+      gskh.create_graph_coloring_handle(kh.get_graph_coloring_handle()->get_coloring_algo_type());
+      gskh.get_graph_coloring_handle()->set_balance_colors(params.balance_colors);
+      gskh.create_gs_handle(KokkosSparse::GS_DEFAULT);
+      KokkosSparse::Experimental::gauss_seidel_symbolic
+        (&gskh, num_rows, num_rows, crsGraph.row_map, crsGraph.entries, true);
+      KokkosSparse::Experimental::gauss_seidel_numeric
+        (&gskh, num_rows, num_rows, crsGraph.row_map, crsGraph.entries, values, true);
+      ExecSpace().fence();
+      Kokkos::Impl::Timer timer;
+      KokkosSparse::Experimental::symmetric_gauss_seidel_apply
+        (&gskh, num_rows, num_rows, crsGraph.row_map, crsGraph.entries, values, x, b, true, true, 1.0, params.gs_sweeps);
+      ExecSpace().fence();
+      double gs_time = timer.seconds();
+      std::cout << "GS Num colors:" << gskh.get_graph_coloring_handle()->get_num_colors()
+                << " GS sweep time:" << gs_time / params.gs_sweeps << std::endl;
+      gskh.destroy_gs_handle();
+      gskh.destroy_graph_coloring_handle();
+    }
 
     if( params.coloring_output_file != NULL ) {
       std::ofstream os(params.coloring_output_file, std::ofstream::out);
@@ -0,0 +1,221 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosKernels_IOUtils.hpp"
+#include "KokkosKernels_SparseUtils.hpp"
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosSparse_spgemm.hpp"
+#include "KokkosSparse_spgemm_masked.hpp"
+#include "KokkosKernels_TestParameters.hpp"
+
+namespace KokkosKernels {
+namespace Experiment {
+
+//Keeps the entries of C that are in the (sorted) mask M, or those that are not in it.
+//The first pass (fill = false) counts the entries of each row, the second one writes them.
+template <typename crsMat_t, typename lno_view_t, typename lno_nnz_view_t, typename scalar_view_t>
+struct MaskFilterFunctor{
+  typedef typename crsMat_t::ordinal_type lno_t;
+  typedef typename crsMat_t::size_type size_type;
+
+  crsMat_t C, M;
+  lno_view_t row_mapF;
+  lno_nnz_view_t entriesF;
+  scalar_view_t valuesF;
+  bool complement, fill;
+
+  MaskFilterFunctor(crsMat_t C_, crsMat_t M_,
+      lno_view_t row_mapF_, lno_nnz_view_t entriesF_, scalar_view_t valuesF_,
+      bool complement_, bool fill_):
+    C(C_), M(M_), row_mapF(row_mapF_), entriesF(entriesF_), valuesF(valuesF_),
+    complement(complement_), fill(fill_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t i) const {
+    size_type count = 0;
+    const size_type m_begin = M.graph.row_map(i), m_end = M.graph.row_map(i + 1);
+    for (size_type p = C.graph.row_map(i); p < C.graph.row_map(i + 1); ++p){
+      const lno_t col = C.graph.entries(p);
+      size_type lo = m_begin, hi = m_end;
+      while (lo < hi){
+        const size_type mid = lo + (hi - lo) / 2;
+        if (M.graph.entries(mid) < col) lo = mid + 1;
+        else hi = mid;
+      }
+      const bool in_mask = lo < m_end && M.graph.entries(lo) == col;
+      if (in_mask != complement){
+        if (fill){
+          entriesF(row_mapF(i) + count) = col;
+          valuesF(row_mapF(i) + count) = C.values(p);
+        }
+        ++count;
+      }
+    }
+    if (!fill) row_mapF(i) = count;
+  }
+};
+
+template <typename crsMat_t>
+void run_experiment(Parameters params, const char *mask_file, bool complement)
+{
+  using namespace KokkosSparse;
+  using namespace KokkosSparse::Experimental;
+
+  using size_type = typename crsMat_t::size_type;
+  using lno_t = typename crsMat_t::ordinal_type;
+  using scalar_t = typename crsMat_t::value_type;
+  using device_t = typename crsMat_t::device_type;
+  using exec_space = typename device_t::execution_space;
+  using mem_space = typename device_t::memory_space;
+
+  using KernelHandle = KokkosKernels::Experimental::KokkosKernelsHandle
+      <size_type, lno_t, scalar_t, exec_space, mem_space, mem_space>;
+
+  typedef typename crsMat_t::values_type::non_const_type scalar_view_t;
+  typedef typename crsMat_t::StaticCrsGraphType::row_map_type::non_const_type lno_view_t;
+  typedef typename crsMat_t::StaticCrsGraphType::entries_type::non_const_type lno_nnz_view_t;
+
+  std::cout << "Loading A from " << params.a_mtx_bin_file << '\n';
+  crsMat_t A = Impl::read_kokkos_crst_matrix<crsMat_t>(params.a_mtx_bin_file);
+  crsMat_t B = A;
+  if (params.b_mtx_bin_file){
+    std::cout << "Loading B from " << params.b_mtx_bin_file << '\n';
+    B = Impl::read_kokkos_crst_matrix<crsMat_t>(params.b_mtx_bin_file);
+  }
+  //the mask defaults to the pattern of A, as in triangle counting.
+  crsMat_t M = A;
+  if (mask_file){
+    std::cout << "Loading M from " << mask_file << '\n';
+    M = Impl::read_kokkos_crst_matrix<crsMat_t>(mask_file);
+  }
+  if (A.numCols() != B.numRows() || M.numRows() != A.numRows() || M.numCols() != B.numCols()){
+    std::cout << "ERROR: A, B and M have incompatible dimensions\n";
+    exit(1);
+  }
+  const lno_t m = A.numRows();
+  const lno_t k = B.numCols();
+  std::cout << "C<" << (complement ? "!" : "") << "M> = A*B: " << m << "x" << k
+            << " nnz(A):" << A.nnz() << " nnz(B):" << B.nnz() << " nnz(M):" << M.nnz() << '\n';
+
+  double masked_symbolic_time = 0, masked_numeric_time = 0;
+  double full_symbolic_time = 0, full_numeric_time = 0, filter_time = 0;
+  size_type masked_nnz = 0, full_nnz = 0, filtered_nnz = 0;
+
+  for (int i = 0; i < params.repeat; ++i){
+    KernelHandle kh;
+    kh.set_verbose(params.verbose);
+    kh.create_spgemm_handle();
+    crsMat_t C;
+
+    Kokkos::Impl::Timer timer1;
+    spgemm_masked_symbolic(kh, A, B, M, complement, C);
+    exec_space().fence();
+    masked_symbolic_time += timer1.seconds();
+
+    Kokkos::Impl::Timer timer2;
+    spgemm_masked_numeric(kh, A, B, M, complement, C);
+    exec_space().fence();
+    masked_numeric_time += timer2.seconds();
+    masked_nnz = C.nnz();
+  }
+
+  //the filter looks up the columns of the mask with a binary search.
+  crsMat_t sortedM("sorted M", M);
+  KokkosKernels::Impl::sort_crs_matrix(sortedM);
+
+  for (int i = 0; i < params.repeat; ++i){
+    KernelHandle kh;
+    kh.set_verbose(params.verbose);
+    kh.create_spgemm_handle();
+    crsMat_t C;
+
+    Kokkos::Impl::Timer timer1;
+    spgemm_symbolic(kh, A, false, B, false, C);
+    exec_space().fence();
+    full_symbolic_time += timer1.seconds();
+
+    Kokkos::Impl::Timer timer2;
+    spgemm_numeric(kh, A, false, B, false, C);
+    exec_space().fence();
+    full_numeric_time += timer2.seconds();
+    full_nnz = C.nnz();
+
+    Kokkos::Impl::Timer timer3;
+    lno_view_t row_mapF("filtered rowmap", m + 1);
+    Kokkos::parallel_for("MaskFilter::Count", Kokkos::RangePolicy<exec_space>(0, m),
+        MaskFilterFunctor<crsMat_t, lno_view_t, lno_nnz_view_t, scalar_view_t>
+          (C, sortedM, row_mapF, lno_nnz_view_t(), scalar_view_t(), complement, false));
+    KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<lno_view_t, exec_space>(m + 1, row_mapF);
+    size_type f_nnz = 0;
+    Kokkos::deep_copy(f_nnz, Kokkos::subview(row_mapF, m));
+    lno_nnz_view_t entriesF(Kokkos::ViewAllocateWithoutInitializing("filtered entries"), f_nnz);
+    scalar_view_t valuesF(Kokkos::ViewAllocateWithoutInitializing("filtered values"), f_nnz);
+    Kokkos::parallel_for("MaskFilter::Fill", Kokkos::RangePolicy<exec_space>(0, m),
+        MaskFilterFunctor<crsMat_t, lno_view_t, lno_nnz_view_t, scalar_view_t>
+          (C, sortedM, row_mapF, entriesF, valuesF, complement, true));
+    exec_space().fence();
+    filter_time += timer3.seconds();
+    filtered_nnz = f_nnz;
+  }
+
+  const double repeat = params.repeat > 0 ? params.repeat : 1;
+  std::cout
+    << "masked   total_time:" << (masked_symbolic_time + masked_numeric_time) / repeat
+    << " symbolic_time:" << masked_symbolic_time / repeat
+    << " numeric_time:" << masked_numeric_time / repeat
+    << " nnz:" << masked_nnz << std::endl;
+  std::cout
+    << "filtered total_time:" << (full_symbolic_time + full_numeric_time + filter_time) / repeat
+    << " symbolic_time:" << full_symbolic_time / repeat
+    << " numeric_time:" << full_numeric_time / repeat
+    << " filter_time:" << filter_time / repeat
+    << " full_nnz:" << full_nnz
+    << " nnz:" << filtered_nnz << std::endl;
+  if (masked_nnz != filtered_nnz){
+    std::cout << "ERROR: the masked product has " << masked_nnz
+              << " entries, but the filtered product has " << filtered_nnz << std::endl;
+  }
+}
+
+}}  // namespace KokkosKernels::Experiment
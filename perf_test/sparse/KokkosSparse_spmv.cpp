@@ -56,6 +56,7 @@
 #include <KokkosSparse_CrsMatrix.hpp>
 #include <KokkosKernels_IOUtils.hpp>
 #include <KokkosSparse_spmv.hpp>
+#include <KokkosKernels_Handle.hpp>
 #include "KokkosKernels_default_types.hpp"
 #include <spmv/Kokkos_SPMV.hpp>
 #include <spmv/Kokkos_SPMV_Inspector.hpp>
@@ -74,16 +75,19 @@
 #include <OpenMPSmartStatic_SPMV.hpp>
 #endif
 
-enum {KOKKOS, MKL, CUSPARSE, KK_KERNELS, KK_KERNELS_INSP, KK_INSP, OMP_STATIC, OMP_DYNAMIC, OMP_INSP};
+enum {KOKKOS, MKL, CUSPARSE, KK_KERNELS, KK_KERNELS_INSP, KK_KERNELS_HANDLE, KK_INSP, OMP_STATIC, OMP_DYNAMIC, OMP_INSP};
 enum {AUTO, DYNAMIC, STATIC};
 
 typedef default_scalar Scalar;
 typedef default_lno_t Ordinal;
 typedef default_size_type Offset;
 typedef default_layout Layout;
+typedef KokkosKernels::Experimental::KokkosKernelsHandle
+  <Offset, Ordinal, Scalar, Kokkos::DefaultExecutionSpace,
+   Kokkos::DefaultExecutionSpace::memory_space, Kokkos::DefaultExecutionSpace::memory_space> handle_type;
 
 template<typename AType, typename XType, typename YType>
-void matvec(AType& A, XType x, YType y, Ordinal rows_per_thread, int team_size, int vector_length, int test, int schedule) {
+void matvec(AType& A, XType x, YType y, Ordinal rows_per_thread, int team_size, int vector_length, int test, int schedule, handle_type* kh) {
 
         switch(test) {
 
@@ -137,6 +141,10 @@ void matvec(AType& A, XType x, YType y, Ordinal rows_per_thread, int team_size,
                 }
                 KokkosSparse::spmv (KokkosSparse::NoTranspose,1.0,A,x,0.0,y);
                 break;
+        case KK_KERNELS_HANDLE:
+                // the analysis of A runs on the first call with kh only
+                KokkosSparse::Experimental::spmv (kh,KokkosSparse::NoTranspose,1.0,A,x,0.0,y);
+                break;
         default:
           fprintf(stderr, "Selected test is not available.\n");
       }
@@ -200,8 +208,13 @@ int test_crs_matrix_singlevec(Ordinal numRows, Ordinal numCols, int test, const
   Kokkos::deep_copy(x1,h_x);
   mv_type y1("Y1",numRows);
 
+  // the handle belongs to this matrix, and is destroyed before Kokkos::finalize
+  handle_type kh;
+  if(test == KK_KERNELS_HANDLE)
+    kh.create_spmv_handle();
+
   //int nnz_per_row = A.nnz()/A.numRows();
-  matvec(A,x1,y1,rows_per_thread,team_size,vector_length,test,schedule);
+  matvec(A,x1,y1,rows_per_thread,team_size,vector_length,test,schedule,&kh);
 
   // Error Check
   Kokkos::deep_copy(h_y,y1);
@@ -226,7 +239,7 @@ int test_crs_matrix_singlevec(Ordinal numRows, Ordinal numCols, int test, const
   double ave_time = 0.0;
   for(int i=0;i<loop;i++) {
     Kokkos::Timer timer;
-    matvec(A,x1,y1,rows_per_thread,team_size,vector_length,test,schedule);
+    matvec(A,x1,y1,rows_per_thread,team_size,vector_length,test,schedule,&kh);
     Kokkos::fence();
     double time = timer.seconds();
     ave_time += time;
@@ -246,6 +259,7 @@ int test_crs_matrix_singlevec(Ordinal numRows, Ordinal numCols, int test, const
           2.0*nnz*loop/ave_time/1e9, 2.0*nnz/max_time/1e9, 2.0*nnz/min_time/1e9,
           ave_time/loop*1000, max_time*1000, min_time*1000,
           num_errors);
+  kh.destroy_spmv_handle();
   return (int)total_error;
 }
 
@@ -259,6 +273,7 @@ void print_help() {
   printf("                    Options:\n");
   printf("                      kk,kk-kernels          (Kokkos/Trilinos)\n");
   printf("                      kk-insp                (Kokkos Structure Inspection)\n");
+  printf("                      kk-kernels-handle      (Kokkos Kernels SpMV handle)\n");
 #ifdef KOKKOS_ENABLE_OPENMP
   printf("                      omp-dynamic,omp-static (Standard OpenMP)\n");
   printf("                      omp-insp               (OpenMP Structure Inspection)\n");
@@ -316,6 +331,8 @@ int main(int argc, char **argv)
       test = KK_KERNELS;
     if((strcmp(argv[i],"kk-kernels-insp")==0))
       test = KK_KERNELS_INSP;
+    if((strcmp(argv[i],"kk-kernels-handle")==0))
+      test = KK_KERNELS_HANDLE;
     if((strcmp(argv[i],"kk-insp")==0))
       test = KK_INSP;
 #ifdef KOKKOS_ENABLE_OPENMP
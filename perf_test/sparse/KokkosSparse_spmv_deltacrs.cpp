@@ -0,0 +1,166 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+#include <Kokkos_Core.hpp>
+#include <KokkosSparse_CrsMatrix.hpp>
+#include <KokkosSparse_DeltaCrsMatrix.hpp>
+#include <KokkosKernels_IOUtils.hpp>
+#include <KokkosSparse_spmv.hpp>
+#include "KokkosKernels_default_types.hpp"
+
+typedef default_scalar Scalar;
+typedef default_lno_t Ordinal;
+typedef default_size_type Offset;
+
+void run_spmv(Ordinal numRows, Ordinal numCols, Ordinal rowVariance, const char* filename,
+              int loop, Ordinal blockRows) {
+  typedef KokkosSparse::CrsMatrix<Scalar, Ordinal, Kokkos::DefaultExecutionSpace, void, Offset> matrix_type;
+  typedef KokkosSparse::Experimental::DeltaCrsMatrix<Scalar, Ordinal, Kokkos::DefaultExecutionSpace, Offset> delta_type;
+  typedef typename Kokkos::View<Scalar*> vector_type;
+
+  srand(17312837);
+  matrix_type A;
+  if(filename)
+    A = KokkosKernels::Impl::read_kokkos_crst_matrix<matrix_type>(filename);
+  else
+  {
+    Offset nnz = 10 * numRows;
+    A = KokkosKernels::Impl::kk_generate_sparse_matrix<matrix_type>(numRows, numCols, nnz, rowVariance, 0.01 * numRows);
+  }
+  numRows = A.numRows();
+  numCols = A.numCols();
+
+  Kokkos::Timer timer;
+  delta_type D = KokkosSparse::Experimental::crs_to_delta_crs<delta_type>(A, blockRows);
+  Kokkos::DefaultExecutionSpace().fence();
+  double convert_time = timer.seconds();
+
+  vector_type x("X", numCols);
+  vector_type y("Y", numRows);
+  Kokkos::deep_copy(x, 1.0);
+
+  // Warm up both kernels once
+  KokkosSparse::spmv("N", 1.0, A, x, 0.0, y);
+  KokkosSparse::Experimental::spmv("N", 1.0, D, x, 0.0, y);
+  Kokkos::DefaultExecutionSpace().fence();
+
+  timer.reset();
+  for(int i = 0; i < loop; i++) {
+    KokkosSparse::spmv("N", 1.0, A, x, 0.0, y);
+    Kokkos::DefaultExecutionSpace().fence();
+  }
+  double crs_time = timer.seconds() / loop;
+
+  timer.reset();
+  for(int i = 0; i < loop; i++) {
+    KokkosSparse::Experimental::spmv("N", 1.0, D, x, 0.0, y);
+    Kokkos::DefaultExecutionSpace().fence();
+  }
+  double delta_time = timer.seconds() / loop;
+
+  // Bytes moved by a perfect-cache spmv: values, column indices, row
+  // offsets, x once, y once.  Only the index part differs.
+  double common_bytes = A.nnz() * sizeof(Scalar) + (numRows + 1) * sizeof(Offset)
+                      + (numRows + numCols) * sizeof(Scalar);
+  double crs_bytes    = common_bytes + A.nnz() * sizeof(Ordinal);
+  double delta_bytes  = common_bytes + D.indexBytes();
+  double nnz = A.nnz();
+
+  std::cout << numRows << " rows, " << numCols << " cols, " << A.nnz() << " nnz\n";
+  std::cout << "DeltaCrs, " << D.blockRows() << " rows per block: "
+            << D.numWideBlocks() << " of " << D.numBlocks() << " blocks escaped"
+            << ", conversion " << convert_time << " s\n";
+  std::cout << "CRS      spmv: " << crs_time << " s, "
+            << crs_bytes / nnz << " bytes/nnz (" << A.nnz() * sizeof(Ordinal) / nnz << " index), "
+            << crs_bytes / crs_time * 1e-9 << " GB/s\n";
+  std::cout << "DeltaCrs spmv: " << delta_time << " s, "
+            << delta_bytes / nnz << " bytes/nnz (" << D.indexBytes() / nnz << " index), "
+            << delta_bytes / delta_time * 1e-9 << " GB/s, speedup " << crs_time / delta_time << "\n";
+}
+
+void print_help() {
+  printf("  -s [nrows]            : matrix dimension (square)\n");
+  printf("  --variance [n]        : row length variance of the generated matrix (default 5).\n");
+  printf("  -f [file],-fb [file]  : Read in Matrix Market (.mtx), or binary (.bin) matrix file.\n");
+  printf("  -l [LOOP]             : How many spmv to run to aggregate average time. \n");
+  printf("  -b [n]                : Rows per block sharing a base column (default 8).\n");
+}
+
+int main(int argc, char **argv)
+{
+ long long int size = 110503; // a prime number
+ Ordinal variance = 5;
+ char* filename = NULL;
+ int loop = 100;
+ Ordinal blockRows = 8;
+
+ if(argc == 1) {
+   print_help();
+   return 0;
+ }
+
+ for(int i=0;i<argc;i++)
+ {
+   if((strcmp(argv[i],"-s")==0)) {size=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"--variance")==0)) {variance=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"-f")==0 || strcmp(argv[i], "-fb") == 0)) {filename = argv[++i]; continue;}
+   if((strcmp(argv[i],"-l")==0)) {loop=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"-b")==0)) {blockRows=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"--help")==0) || (strcmp(argv[i],"-h")==0)) {
+     print_help();
+     return 0;
+   }
+ }
+
+ Kokkos::initialize(argc,argv);
+
+ run_spmv(size, size, variance, filename, loop, blockRows);
+
+ Kokkos::finalize();
+}
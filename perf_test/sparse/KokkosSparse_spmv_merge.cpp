@@ -162,7 +162,7 @@ matrix_type generate_unbalanced_matrix(const typename matrix_type::ordinal_type
 
 void print_help() {
   printf("SPMV merge benchmark code written by Luc Berger-Vergiat.\n");
-  printf("The goal is to test cusSPARSE's merge algorithm on imbalanced matrices.");
+  printf("The goal is to test the merge algorithm (cuSPARSE or native) on imbalanced matrices.\n");
   printf("Options:\n");
   printf("  --compare       : Compare the performance of the merge algo with the default algo.\n");
   printf("  -l [LOOP]       : How many spmv to run to aggregate average time. \n");
@@ -218,7 +218,7 @@ int main(int argc, char** argv) {
   Kokkos::initialize(argc, argv);
 
   {
-    if(std::is_same<Kokkos::Cuda, Kokkos::DefaultExecutionSpace>::value) {
+    {
       // Note that we template the matrix with entries=lno_t and offsets=lno_t to make sure
       // it verifies the cusparse requirements
       using matrix_type = KokkosSparse::CrsMatrix<Scalar, lno_t, Kokkos::DefaultExecutionSpace, void, lno_t>;
@@ -251,7 +251,7 @@ int main(int argc, char** argv) {
 	if(time<min_time) min_time = time;
       }
 
-      std::cout << "cuSPARSE Merge alg    ---  min: " << min_time
+      std::cout << "Merge alg             ---  min: " << min_time
 		<< " max: " << max_time
 		<< " avg: " << avg_time / loop << std::endl;
 
@@ -271,7 +271,7 @@ int main(int argc, char** argv) {
 	  if(time<min_time) min_time = time;
 	}
       
-	std::cout << "cuSPARSE Default alg  ---  min: " << min_time
+	std::cout << "Default alg           ---  min: " << min_time
 		  << " max: " << max_time
 		  << " avg: " << avg_time / loop << std::endl;
 
@@ -293,8 +293,6 @@ int main(int argc, char** argv) {
 		  << " max: " << max_time
 		  << " avg: " << avg_time / loop << std::endl;
       }
-    } else {
-      std::cout << "The default execution space is not Cuda, nothing to do!" << std::endl;
     }
   }
 
@@ -0,0 +1,251 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <Kokkos_Core.hpp>
+#include <KokkosSparse_CrsMatrix.hpp>
+#include <KokkosKernels_IOUtils.hpp>
+#include <KokkosKernels_Handle.hpp>
+#include <KokkosSparse_spmv.hpp>
+#include "KokkosKernels_default_types.hpp"
+
+typedef default_scalar Scalar;
+typedef default_lno_t Ordinal;
+typedef default_size_type Offset;
+
+#ifdef KOKKOS_ENABLE_OPENMP
+
+// Socket of the CPU the calling thread runs on; 0 if unknown.
+int current_socket() {
+#ifdef __linux__
+  const int cpu = sched_getcpu();
+  if(cpu >= 0) {
+    std::ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/physical_package_id");
+    int socket = 0;
+    if(f >> socket) return socket;
+  }
+#endif
+  return 0;
+}
+
+// Time each thread's block of rows separately and report the bandwidth
+// achieved by the threads of each socket: bytes moved by the socket's
+// threads over the time of its slowest thread.
+template<class RowMap, class Entries, class Values, class XVector, class YVector>
+void per_socket_bandwidth(const char* name, const Ordinal* threadRows, const int nparts,
+                          const RowMap& row_map, const Entries& entries, const Values& values,
+                          const XVector& x, const YVector& y, const int loop) {
+  std::vector<double> thread_time(nparts, 0.0);
+  std::vector<double> thread_bytes(nparts, 0.0);
+  std::vector<int> thread_socket(nparts, 0);
+
+  for(int l = 0; l < loop; l++) {
+    #pragma omp parallel
+    {
+      const int nthreads = omp_get_num_threads();
+      for(int part = omp_get_thread_num(); part < nparts; part += nthreads) {
+        Kokkos::Timer timer;
+        for(Ordinal row = threadRows[part]; row < threadRows[part + 1]; ++row) {
+          Scalar sum = 0;
+          for(Offset i = row_map[row]; i < row_map[row + 1]; ++i)
+            sum += values[i] * x[entries[i]];
+          y[row] = sum;
+        }
+        thread_time[part] += timer.seconds();
+        if(l == 0) {
+          const Offset nnz = row_map[threadRows[part + 1]] - row_map[threadRows[part]];
+          const Ordinal rows = threadRows[part + 1] - threadRows[part];
+          thread_bytes[part] = nnz * (sizeof(Scalar) + sizeof(Ordinal) + sizeof(Scalar))
+                             + rows * (sizeof(Offset) + sizeof(Scalar));
+          thread_socket[part] = current_socket();
+        }
+      }
+    }
+  }
+
+  std::map<int, std::pair<double, double> > sockets; // bytes, slowest time
+  for(int t = 0; t < nparts; ++t) {
+    auto& s = sockets[thread_socket[t]];
+    s.first += thread_bytes[t];
+    s.second = std::max(s.second, thread_time[t] / loop);
+  }
+  for(const auto& s : sockets) {
+    std::cout << name << " socket " << s.first << ": "
+              << s.second.first / s.second.second * 1e-9 << " GB/s\n";
+  }
+}
+
+void run_spmv(Ordinal numRows, Ordinal rowVariance, const char* filename, int loop) {
+  typedef KokkosSparse::CrsMatrix<Scalar, Ordinal, Kokkos::OpenMP, void, Offset> matrix_type;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle
+    <Offset, Ordinal, Scalar, Kokkos::OpenMP, Kokkos::HostSpace, Kokkos::HostSpace> handle_type;
+  typedef typename Kokkos::View<Scalar*, Kokkos::OpenMP> vector_type;
+
+  srand(17312837);
+  matrix_type A;
+  if(filename)
+    A = KokkosKernels::Impl::read_kokkos_crst_matrix<matrix_type>(filename);
+  else
+  {
+    Offset nnz = 10 * numRows;
+    A = KokkosKernels::Impl::kk_generate_sparse_matrix<matrix_type>(numRows, numRows, nnz, rowVariance, 0.01 * numRows);
+  }
+  numRows = A.numRows();
+  if(A.numCols() != numRows) {
+    std::cout << "The matrix must be square\n";
+    return;
+  }
+
+  vector_type x("X", numRows);
+  vector_type y("Y", numRows);
+  Kokkos::deep_copy(x, 1.0);
+
+  handle_type kh_plain, kh_numa;
+  kh_plain.create_spmv_handle(KokkosSparse::Experimental::SPMVAlgorithm::SPMV_PARTITIONED);
+  kh_numa.create_spmv_handle(KokkosSparse::Experimental::SPMVAlgorithm::SPMV_PARTITIONED);
+  kh_numa.get_spmv_handle()->set_numa_first_touch(true);
+
+  Kokkos::Timer timer;
+  KokkosSparse::Experimental::spmv_symbolic(&kh_plain, A);
+  KokkosSparse::Experimental::spmv_symbolic(&kh_numa, A);
+  auto numa_x = KokkosSparse::Experimental::spmv_first_touch(&kh_numa, x);
+  auto numa_y = KokkosSparse::Experimental::spmv_first_touch(&kh_numa, y);
+  double setup_time = timer.seconds();
+
+  auto spmv_handle = kh_numa.get_spmv_handle();
+  auto thread_rows = spmv_handle->get_numa_thread_rows();
+  const int nparts = static_cast<int>(thread_rows.extent(0)) - 1;
+
+  KokkosSparse::Experimental::spmv(&kh_plain, "N", 1.0, A, x, 0.0, y);
+  KokkosSparse::Experimental::spmv(&kh_numa, "N", 1.0, A, numa_x, 0.0, numa_y);
+  Kokkos::fence();
+
+  timer.reset();
+  for(int i = 0; i < loop; i++) {
+    KokkosSparse::Experimental::spmv(&kh_plain, "N", 1.0, A, x, 0.0, y);
+    Kokkos::fence();
+  }
+  double plain_time = timer.seconds() / loop;
+
+  timer.reset();
+  for(int i = 0; i < loop; i++) {
+    KokkosSparse::Experimental::spmv(&kh_numa, "N", 1.0, A, numa_x, 0.0, numa_y);
+    Kokkos::fence();
+  }
+  double numa_time = timer.seconds() / loop;
+
+  double bytes = A.nnz() * (sizeof(Scalar) + sizeof(Ordinal)) + (numRows + 1) * sizeof(Offset)
+               + 2 * numRows * sizeof(Scalar);
+
+  std::cout << numRows << " rows, " << A.nnz() << " nnz, " << nparts << " threads"
+            << ", NUMA setup " << setup_time << " s\n";
+  std::cout << "Partitioned spmv: " << plain_time << " s, " << bytes / plain_time * 1e-9 << " GB/s\n";
+  std::cout << "First-touch spmv: " << numa_time << " s, " << bytes / numa_time * 1e-9 << " GB/s\n";
+
+  per_socket_bandwidth("Original arrays ", thread_rows.data(), nparts,
+                       A.graph.row_map.data(), A.graph.entries.data(), A.values.data(),
+                       x.data(), y.data(), loop);
+  per_socket_bandwidth("First-touched   ", thread_rows.data(), nparts,
+                       spmv_handle->get_numa_row_map().data(), spmv_handle->get_numa_entries().data(),
+                       spmv_handle->get_numa_values().data(), numa_x.data(), numa_y.data(), loop);
+}
+
+#endif
+
+void print_help() {
+  printf("  -s [nrows]            : matrix dimension (square)\n");
+  printf("  --variance [n]        : row length variance of the generated matrix (default 5).\n");
+  printf("  -f [file],-fb [file]  : Read in Matrix Market (.mtx), or binary (.bin) matrix file.\n");
+  printf("  -l [LOOP]             : How many spmv to run to aggregate average time. \n");
+  printf("  Bind the threads (e.g. OMP_PROC_BIND=spread OMP_PLACES=cores) for meaningful results.\n");
+}
+
+int main(int argc, char **argv)
+{
+ long long int size = 110503; // a prime number
+ Ordinal variance = 5;
+ char* filename = NULL;
+ int loop = 100;
+
+ if(argc == 1) {
+   print_help();
+   return 0;
+ }
+
+ for(int i=0;i<argc;i++)
+ {
+   if((strcmp(argv[i],"-s")==0)) {size=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"--variance")==0)) {variance=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"-f")==0 || strcmp(argv[i], "-fb") == 0)) {filename = argv[++i]; continue;}
+   if((strcmp(argv[i],"-l")==0)) {loop=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"--help")==0) || (strcmp(argv[i],"-h")==0)) {
+     print_help();
+     return 0;
+   }
+ }
+
+ Kokkos::initialize(argc,argv);
+
+#ifdef KOKKOS_ENABLE_OPENMP
+ run_spmv(size, variance, filename, loop);
+#else
+ (void) size; (void) variance; (void) filename; (void) loop;
+ std::cout << "sparse_spmv_numa requires Kokkos with OpenMP enabled\n";
+#endif
+
+ Kokkos::finalize();
+}
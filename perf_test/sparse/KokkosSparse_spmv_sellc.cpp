@@ -0,0 +1,168 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+#include <Kokkos_Core.hpp>
+#include <KokkosSparse_CrsMatrix.hpp>
+#include <KokkosSparse_SellCMatrix.hpp>
+#include <KokkosKernels_IOUtils.hpp>
+#include <KokkosSparse_spmv.hpp>
+#include "KokkosKernels_default_types.hpp"
+
+typedef default_scalar Scalar;
+typedef default_lno_t Ordinal;
+typedef default_size_type Offset;
+
+void run_spmv(Ordinal numRows, Ordinal numCols, Ordinal rowVariance, const char* filename,
+              int loop, Ordinal chunkSize, Ordinal sortingWindow) {
+  typedef KokkosSparse::CrsMatrix<Scalar, Ordinal, Kokkos::DefaultExecutionSpace, void, Offset> matrix_type;
+  typedef KokkosSparse::Experimental::SellCMatrix<Scalar, Ordinal, Kokkos::DefaultExecutionSpace, Offset> sellc_type;
+  typedef typename Kokkos::View<Scalar*> vector_type;
+
+  srand(17312837);
+  matrix_type A;
+  if(filename)
+    A = KokkosKernels::Impl::read_kokkos_crst_matrix<matrix_type>(filename);
+  else
+  {
+    Offset nnz = 10 * numRows;
+    A = KokkosKernels::Impl::kk_generate_sparse_matrix<matrix_type>(numRows, numCols, nnz, rowVariance, 0.01 * numRows);
+  }
+  numRows = A.numRows();
+  numCols = A.numCols();
+
+  Kokkos::Timer timer;
+  sellc_type S = KokkosSparse::Experimental::crs_to_sellc<sellc_type>(A, chunkSize, sortingWindow);
+  Kokkos::DefaultExecutionSpace().fence();
+  double convert_time = timer.seconds();
+
+  vector_type x("X", numCols);
+  vector_type y("Y", numRows);
+  Kokkos::deep_copy(x, 1.0);
+
+  // Warm up both kernels once
+  KokkosSparse::spmv("N", 1.0, A, x, 0.0, y);
+  KokkosSparse::Experimental::spmv("N", 1.0, S, x, 0.0, y);
+  Kokkos::DefaultExecutionSpace().fence();
+
+  timer.reset();
+  for(int i = 0; i < loop; i++) {
+    KokkosSparse::spmv("N", 1.0, A, x, 0.0, y);
+    Kokkos::DefaultExecutionSpace().fence();
+  }
+  double crs_time = timer.seconds() / loop;
+
+  timer.reset();
+  for(int i = 0; i < loop; i++) {
+    KokkosSparse::Experimental::spmv("N", 1.0, S, x, 0.0, y);
+    Kokkos::DefaultExecutionSpace().fence();
+  }
+  double sellc_time = timer.seconds() / loop;
+
+  // Bytes moved by a perfect-cache spmv: values, column indices, x once, y once
+  double crs_bytes   = A.nnz() * (sizeof(Scalar) + sizeof(Ordinal)) + (numRows + 1) * sizeof(Offset)
+                     + (numRows + numCols) * sizeof(Scalar);
+  double sellc_bytes = S.numStoredEntries() * (sizeof(Scalar) + sizeof(Ordinal))
+                     + (S.numChunks() + 1) * sizeof(Offset) + S.numChunks() * sizeof(Ordinal)
+                     + 2 * numRows * sizeof(Ordinal) + (numRows + numCols) * sizeof(Scalar);
+
+  std::cout << numRows << " rows, " << numCols << " cols, " << A.nnz() << " nnz\n";
+  std::cout << "SELL-" << S.chunkSize() << "-" << S.sortingWindow()
+            << ": padding ratio " << S.paddingRatio()
+            << ", conversion " << convert_time << " s\n";
+  std::cout << "CRS   spmv: " << crs_time << " s, "
+            << 2.0 * A.nnz() / crs_time * 1e-9 << " GFlop/s, "
+            << crs_bytes / crs_time * 1e-9 << " GB/s\n";
+  std::cout << "SellC spmv: " << sellc_time << " s, "
+            << 2.0 * A.nnz() / sellc_time * 1e-9 << " GFlop/s, "
+            << sellc_bytes / sellc_time * 1e-9 << " GB/s\n";
+}
+
+void print_help() {
+  printf("  -s [nrows]            : matrix dimension (square)\n");
+  printf("  --variance [n]        : row length variance of the generated matrix (default 5).\n");
+  printf("  -f [file],-fb [file]  : Read in Matrix Market (.mtx), or binary (.bin) matrix file.\n");
+  printf("  -l [LOOP]             : How many spmv to run to aggregate average time. \n");
+  printf("  -C [n]                : SELL chunk size, a power of two up to 64 (default 8).\n");
+  printf("  --sigma [n]           : SELL sorting window, 1 for no sorting (default 256).\n");
+}
+
+int main(int argc, char **argv)
+{
+ long long int size = 110503; // a prime number
+ Ordinal variance = 5;
+ char* filename = NULL;
+ int loop = 100;
+ Ordinal chunkSize = 8;
+ Ordinal sortingWindow = 256;
+
+ if(argc == 1) {
+   print_help();
+   return 0;
+ }
+
+ for(int i=0;i<argc;i++)
+ {
+   if((strcmp(argv[i],"-s")==0)) {size=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"--variance")==0)) {variance=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"-f")==0 || strcmp(argv[i], "-fb") == 0)) {filename = argv[++i]; continue;}
+   if((strcmp(argv[i],"-l")==0)) {loop=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"-C")==0)) {chunkSize=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"--sigma")==0)) {sortingWindow=atoi(argv[++i]); continue;}
+   if((strcmp(argv[i],"--help")==0) || (strcmp(argv[i],"-h")==0)) {
+     print_help();
+     return 0;
+   }
+ }
+
+ Kokkos::initialize(argc,argv);
+
+ run_spmv(size, size, variance, filename, loop, chunkSize, sortingWindow);
+
+ Kokkos::finalize();
+}
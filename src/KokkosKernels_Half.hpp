@@ -49,6 +49,10 @@
 
 namespace KokkosKernels {
     namespace Experimental {
+        // Storage type for half precision matrix values; falls back to float
+        // when the backend has no native half precision type.
+        using half_t = Kokkos::Experimental::half_t;
+
         ////////////// BEGIN FP16/binary16 limits //////////////
         #define KOKKOSKERNELS_IMPL_FP16_MAX 65504.0F           // Maximum normalized number
         #define KOKKOSKERNELS_IMPL_FP16_MIN 0.000000059604645F // Minimum normalized positive half precision number
@@ -0,0 +1,152 @@
+#ifndef __KOKKOSBATCHED_SPMV_DECL_HPP__
+#define __KOKKOSBATCHED_SPMV_DECL_HPP__
+
+#include "KokkosBatched_Util.hpp"
+#include "KokkosBatched_Vector.hpp"
+
+namespace KokkosBatched {
+
+  ///
+  /// Batched Spmv
+  /// ============
+  ///
+  /// y_l = beta y_l + alpha A_l x_l for l = 0, ..., numMatrices-1
+  ///
+  /// All matrices A_l share one CRS graph (row_ptr, colIndices) and differ
+  /// only in their values. The arguments are
+  ///
+  ///   values     (numMatrices x nnz)      values of A_l in row l
+  ///   row_ptr    (numRows+1)              shared row offsets
+  ///   colIndices (nnz)                    shared column indices
+  ///   X          (numMatrices x numCols)  input vectors
+  ///   Y          (numMatrices x numRows)  output vectors
+  ///
+  /// The value type of values, X and Y may be Vector<SIMD<T>,l>; then each
+  /// entry of the batch dimension packs l matrices and the kernel runs
+  /// interleaved over them.
+  ///
+
+  ///
+  /// Serial Spmv
+  ///
+
+  template<typename ArgTrans>
+  struct SerialSpmv {
+    template<typename ScalarType,
+             typename ValuesViewType,
+             typename RowPtrViewType,
+             typename ColIndViewType,
+             typename xViewType,
+             typename yViewType>
+    KOKKOS_INLINE_FUNCTION
+    static int
+    invoke(const ScalarType alpha,
+           const ValuesViewType &values,
+           const RowPtrViewType &row_ptr,
+           const ColIndViewType &colIndices,
+           const xViewType &x,
+           const ScalarType beta,
+           const yViewType &y) {
+      assert(false && "Error: encounter dummy impl");
+      return 0;
+    }
+  };
+
+  ///
+  /// Team Spmv
+  ///
+
+  template<typename MemberType,
+           typename ArgTrans>
+  struct TeamSpmv {
+    template<typename ScalarType,
+             typename ValuesViewType,
+             typename RowPtrViewType,
+             typename ColIndViewType,
+             typename xViewType,
+             typename yViewType>
+    KOKKOS_INLINE_FUNCTION
+    static int
+    invoke(const MemberType &member,
+           const ScalarType alpha,
+           const ValuesViewType &values,
+           const RowPtrViewType &row_ptr,
+           const ColIndViewType &colIndices,
+           const xViewType &x,
+           const ScalarType beta,
+           const yViewType &y) {
+      assert(false && "Error: encounter dummy impl");
+      return 0;
+    }
+  };
+
+  ///
+  /// TeamVector Spmv
+  ///
+
+  template<typename MemberType,
+           typename ArgTrans>
+  struct TeamVectorSpmv {
+    template<typename ScalarType,
+             typename ValuesViewType,
+             typename RowPtrViewType,
+             typename ColIndViewType,
+             typename xViewType,
+             typename yViewType>
+    KOKKOS_INLINE_FUNCTION
+    static int
+    invoke(const MemberType &member,
+           const ScalarType alpha,
+           const ValuesViewType &values,
+           const RowPtrViewType &row_ptr,
+           const ColIndViewType &colIndices,
+           const xViewType &x,
+           const ScalarType beta,
+           const yViewType &y) {
+      assert(false && "Error: encounter dummy impl");
+      return 0;
+    }
+  };
+
+  ///
+  /// Selective Interface
+  ///
+  template<typename MemberType,
+           typename ArgTrans,
+           typename ArgMode>
+  struct Spmv {
+    template<typename ScalarType,
+             typename ValuesViewType,
+             typename RowPtrViewType,
+             typename ColIndViewType,
+             typename xViewType,
+             typename yViewType>
+    KOKKOS_FORCEINLINE_FUNCTION
+    static int
+    invoke(const MemberType &member,
+           const ScalarType alpha,
+           const ValuesViewType &values,
+           const RowPtrViewType &row_ptr,
+           const ColIndViewType &colIndices,
+           const xViewType &x,
+           const ScalarType beta,
+           const yViewType &y) {
+      int r_val = 0;
+      if (std::is_same<ArgMode,Mode::Serial>::value) {
+        r_val = SerialSpmv<ArgTrans>::invoke(alpha, values, row_ptr, colIndices, x, beta, y);
+      } else if (std::is_same<ArgMode,Mode::Team>::value) {
+        r_val = TeamSpmv<MemberType,ArgTrans>::invoke(member, alpha, values, row_ptr, colIndices, x, beta, y);
+      } else if (std::is_same<ArgMode,Mode::TeamVector>::value) {
+        r_val = TeamVectorSpmv<MemberType,ArgTrans>::invoke(member, alpha, values, row_ptr, colIndices, x, beta, y);
+      }
+      return r_val;
+    }
+  };
+
+}
+
+#include "KokkosBatched_Spmv_Serial_Impl.hpp"
+#include "KokkosBatched_Spmv_Team_Impl.hpp"
+#include "KokkosBatched_Spmv_TeamVector_Impl.hpp"
+
+#endif
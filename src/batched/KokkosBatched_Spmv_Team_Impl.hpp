@@ -0,0 +1,59 @@
+#ifndef __KOKKOSBATCHED_SPMV_TEAM_IMPL_HPP__
+#define __KOKKOSBATCHED_SPMV_TEAM_IMPL_HPP__
+
+#include "KokkosBatched_Util.hpp"
+#include "KokkosBatched_Spmv_Team_Internal.hpp"
+
+namespace KokkosBatched {
+
+  ///
+  /// Team Impl
+  /// =========
+
+  ///
+  /// Implemented:
+  /// NT
+  ///
+  /// Not yet implemented
+  /// T, CT
+
+  ///
+  /// NT
+  ///
+
+  template<typename MemberType>
+  struct TeamSpmv<MemberType,Trans::NoTranspose> {
+
+    template<typename ScalarType,
+             typename ValuesViewType,
+             typename RowPtrViewType,
+             typename ColIndViewType,
+             typename xViewType,
+             typename yViewType>
+    KOKKOS_INLINE_FUNCTION
+    static int
+    invoke(const MemberType &member,
+           const ScalarType alpha,
+           const ValuesViewType &values,
+           const RowPtrViewType &row_ptr,
+           const ColIndViewType &colIndices,
+           const xViewType &x,
+           const ScalarType beta,
+           const yViewType &y) {
+      return TeamSpmvInternal::
+        invoke(member,
+               values.extent(0), y.extent(1),
+               alpha,
+               values.data(), values.stride_0(), values.stride_1(),
+               row_ptr.data(), row_ptr.stride_0(),
+               colIndices.data(), colIndices.stride_0(),
+               x.data(), x.stride_0(), x.stride_1(),
+               beta,
+               y.data(), y.stride_0(), y.stride_1());
+    }
+  };
+
+}
+
+
+#endif
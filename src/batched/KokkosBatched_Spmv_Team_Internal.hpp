@@ -0,0 +1,76 @@
+#ifndef __KOKKOSBATCHED_SPMV_TEAM_INTERNAL_HPP__
+#define __KOKKOSBATCHED_SPMV_TEAM_INTERNAL_HPP__
+
+#include "KokkosBatched_Util.hpp"
+
+namespace KokkosBatched {
+
+  ///
+  /// Team Internal Impl
+  /// ==================
+  struct TeamSpmvInternal {
+    template<typename MemberType,
+             typename ScalarType,
+             typename ValueType,
+             typename OffsetType,
+             typename OrdinalType>
+    KOKKOS_INLINE_FUNCTION
+    static int
+    invoke(const MemberType &member,
+           const int numMatrices, const int numRows,
+           const ScalarType alpha,
+           const ValueType *__restrict__ values, const int valuess0, const int valuess1,
+           const OffsetType *__restrict__ row_ptr, const int row_ptrs0,
+           const OrdinalType *__restrict__ colIndices, const int colIndicess0,
+           const ValueType *__restrict__ X, const int xs0, const int xs1,
+           const ScalarType beta,
+           /**/  ValueType *__restrict__ Y, const int ys0, const int ys1);
+  };
+
+  template<typename MemberType,
+           typename ScalarType,
+           typename ValueType,
+           typename OffsetType,
+           typename OrdinalType>
+  KOKKOS_INLINE_FUNCTION
+  int
+  TeamSpmvInternal::
+  invoke(const MemberType &member,
+         const int numMatrices, const int numRows,
+         const ScalarType alpha,
+         const ValueType *__restrict__ values, const int valuess0, const int valuess1,
+         const OffsetType *__restrict__ row_ptr, const int row_ptrs0,
+         const OrdinalType *__restrict__ colIndices, const int colIndicess0,
+         const ValueType *__restrict__ X, const int xs0, const int xs1,
+         const ScalarType beta,
+         /**/  ValueType *__restrict__ Y, const int ys0, const int ys1) {
+    const ScalarType zero(0);
+
+    // y_l = beta y_l + alpha A_l x_l
+    // threads are spread over (matrix, row) pairs; the matrix index runs
+    // fastest so neighbouring threads share the same row of the graph
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(member,0,numMatrices*numRows),[&](const int &ij) {
+        const int iMatrix = ij%numMatrices;
+        const int iRow    = ij/numMatrices;
+
+        const OffsetType rowBegin = row_ptr[iRow*row_ptrs0];
+        const OffsetType rowEnd   = row_ptr[(iRow+1)*row_ptrs0];
+
+        const ValueType *__restrict__ tvalues = values + iMatrix*valuess0;
+        const ValueType *__restrict__ tX      = X + iMatrix*xs0;
+
+        ValueType sum = 0;
+        for (OffsetType iEntry=rowBegin;iEntry<rowEnd;++iEntry)
+          sum += tvalues[iEntry*valuess1]*tX[colIndices[iEntry*colIndicess0]*xs1];
+
+        ValueType &y = Y[iMatrix*ys0 + iRow*ys1];
+        if (beta == zero) y = alpha*sum;
+        else              y = beta*y + alpha*sum;
+      });
+    return 0;
+  }
+
+}
+
+
+#endif
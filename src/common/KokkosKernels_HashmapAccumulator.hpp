@@ -451,6 +451,26 @@ struct HashmapAccumulator
   }
 
 
+  //does not insert. returns the index of key in keys, or -1 if it is not in the hashmap.
+  //used in the masked spgemm to accumulate only at the keys of the mask.
+  KOKKOS_INLINE_FUNCTION
+  size_type sequential_find_in_hash (key_type key)
+  {
+    size_type hash, i;
+
+    if (key == -1)
+      return -1;
+
+    hash = __compute_hash(key, __hashOpRHS);
+    for (i = hash_begins[hash]; i != -1; i = hash_nexts[i]) {
+      if (keys[i] == key) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+
   //used in the kkmem's numeric phase for second level hashmaps.
   //function to be called from device.
   //Accumulation is Add operation. It is not atomicAdd, as this
@@ -373,6 +373,27 @@ public:
 
 };
 
+//Number of chunks for a pool of type pool_memory_space, given the number of chunks that would give
+//each thread/team its own chunk. pool_memory_space can be any type with execution_space and
+//memory_space typedefs, e.g. the UniformMemoryPool itself or a Kokkos::Device. On GPUs it is limited by half of the free memory,
+//and rounded down to a power of 2. Host memory is assumed to be large enough.
+template <typename pool_memory_space>
+size_t kk_compute_num_pool_chunks(size_t chunk_bytes, size_t ideal_num_chunks){
+  if (!kk_is_gpu_exec_space<typename pool_memory_space::execution_space>())
+    return ideal_num_chunks;
+  size_t free_byte, total_byte;
+  kk_get_free_total_memory<typename pool_memory_space::memory_space>(free_byte, total_byte);
+  size_t num_chunks = ideal_num_chunks;
+  if (ideal_num_chunks * chunk_bytes > free_byte / 2){
+    num_chunks = (free_byte / 2) / chunk_bytes;
+  }
+  size_t po2_num_chunks = 1;
+  while (po2_num_chunks * 2 < num_chunks){
+    po2_num_chunks *= 2;
+  }
+  return po2_num_chunks;
+}
+
 }
 }
 
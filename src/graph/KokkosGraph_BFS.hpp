@@ -0,0 +1,83 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Brian Kelley (bmkelle@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef _KOKKOSGRAPH_BFS_HPP
+#define _KOKKOSGRAPH_BFS_HPP
+
+#include "KokkosGraph_BFS_impl.hpp"
+
+namespace KokkosGraph
+{
+namespace Experimental
+{
+
+//Breadth-first search from source on a CRS graph.
+//On return, levels(v) is the distance from source to v and parents(v) is the vertex
+//v was reached from (parents(source) == source); both are -1 for unreachable vertices.
+//Returns the number of levels, i.e. one more than the eccentricity of source.
+//
+//By default the search switches between top-down and bottom-up steps depending on the
+//size of the frontier (see Impl::DirectionOptimizingBFS); direction forces one of them.
+//The graph should be symmetric for bottom-up steps to be valid.
+//Column indices >= num_verts are ignored.
+
+template <typename device_t, typename rowmap_t, typename colinds_t, typename lno_view_t = typename colinds_t::non_const_type>
+typename colinds_t::non_const_value_type
+graph_bfs(const rowmap_t& rowmap, const colinds_t& colinds, typename colinds_t::non_const_value_type source,
+    lno_view_t& levels, lno_view_t& parents, BFS_Direction direction = BFS_DIRECTION_OPTIMIZING)
+{
+  using lno_t = typename colinds_t::non_const_value_type;
+  lno_t numVerts = rowmap.extent(0) ? rowmap.extent(0) - 1 : 0;
+  if(source < 0 || source >= numVerts)
+    throw std::invalid_argument("graph_bfs: source is not a vertex of the graph");
+  Impl::DirectionOptimizingBFS<device_t, rowmap_t, colinds_t, lno_view_t> bfs(rowmap, colinds, direction);
+  lno_t numLevels = bfs.compute(source);
+  levels = bfs.levels;
+  parents = bfs.parents;
+  return numLevels;
+}
+
+}}  //namespace KokkosGraph::Experimental
+
+#endif
@@ -0,0 +1,77 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef _KOKKOSGRAPH_CONNECTED_COMPONENTS_HPP
+#define _KOKKOSGRAPH_CONNECTED_COMPONENTS_HPP
+
+#include "KokkosGraph_ConnectedComponents_impl.hpp"
+
+namespace KokkosGraph
+{
+namespace Experimental
+{
+
+//Connected components of a symmetric CRS graph (see Impl::AfforestCC).
+//Returns the component of each vertex, in [0, numComponents). Components are numbered
+//in increasing order of their smallest vertex, so the labels do not depend on the
+//execution space or on the number of threads.
+//
+//Column indices >= num_verts are ignored.
+
+template <typename device_t, typename rowmap_t, typename colinds_t, typename labels_t = typename colinds_t::non_const_type>
+labels_t
+graph_connected_components(const rowmap_t& rowmap, const colinds_t& colinds, typename colinds_t::non_const_value_type& numComponents)
+{
+  if(rowmap.extent(0) <= 1)
+  {
+    //there are no vertices to label
+    numComponents = 0;
+    return labels_t();
+  }
+  Impl::AfforestCC<device_t, rowmap_t, colinds_t, labels_t> cc(rowmap, colinds);
+  return cc.compute(numComponents);
+}
+
+}}  //namespace KokkosGraph::Experimental
+
+#endif
@@ -47,6 +47,7 @@
 #include "KokkosGraph_Distance1ColorHandle.hpp"
 #include "KokkosGraph_Distance1Color_impl.hpp"
 #include "KokkosKernels_Utils.hpp"
+#include <algorithm>
 
 namespace KokkosGraph{
 
@@ -118,6 +119,14 @@ void graph_color_symbolic(
   gc->color_graph(colors_out, num_phases);
 
   delete gc;
+
+  if (gch->get_balance_colors()){
+    typedef typename Impl::GraphColorBalance
+        <typename KernelHandle::GraphColoringHandleType, lno_row_view_t_, lno_nnz_view_t_> BalanceGraphColoring;
+    BalanceGraphColoring gb(num_rows, row_map, entries, gch);
+    int num_balance_rounds = 0;
+    gb.balance(colors_out, num_balance_rounds);
+  }
   double coloring_time = timer.seconds();
   gch->add_to_overall_coloring_time(coloring_time);
   gch->set_coloring_time(coloring_time);
@@ -137,6 +146,103 @@ void graph_color(
   graph_color_symbolic(handle, num_rows, num_cols, row_map, entries, is_symmetric);
 }
 
+}  // end namespace Experimental
+
+namespace Impl{
+
+template <class KernelHandle, typename lno_row_view_t_, typename lno_nnz_view_t_, typename vertex_view_t_>
+void graph_recolor(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t num_rows,
+    typename KernelHandle::nnz_lno_t num_cols,
+    lno_row_view_t_ row_map,
+    lno_nnz_view_t_ entries,
+    vertex_view_t_ changed_vertices,
+    typename KernelHandle::nnz_lno_t num_changed_vertices,
+    bool check_all_vertices){
+
+  typedef typename KernelHandle::GraphColoringHandleType gch_t;
+  typedef typename gch_t::color_view_t color_view_type;
+  typedef typename KernelHandle::nnz_lno_t nnz_lno_t;
+
+  gch_t *gch = handle->get_graph_coloring_handle();
+  color_view_type prev_colors = gch->get_vertex_colors();
+
+  //nothing to repair, color from scratch.
+  if (!gch->is_coloring_called() || prev_colors.use_count() == 0 || prev_colors.extent(0) == 0){
+    KokkosGraph::Experimental::graph_color_symbolic(handle, num_rows, num_cols, row_map, entries);
+    return;
+  }
+
+  Kokkos::Impl::Timer timer;
+  gch->set_tictoc(handle->get_verbose());
+
+  //vertices beyond the previous graph are new, and start uncolored.
+  const nnz_lno_t num_old_vertices =
+      std::min<nnz_lno_t>(num_rows, static_cast<nnz_lno_t>(prev_colors.extent(0)));
+  color_view_type colors_out = prev_colors;
+  if (static_cast<nnz_lno_t>(prev_colors.extent(0)) != num_rows){
+    colors_out = color_view_type("Graph Colors", num_rows);
+    Kokkos::deep_copy(
+        Kokkos::subview(colors_out, Kokkos::make_pair(nnz_lno_t(0), num_old_vertices)),
+        Kokkos::subview(prev_colors, Kokkos::make_pair(nnz_lno_t(0), num_old_vertices)));
+  }
+
+  typedef GraphRecolor<gch_t, lno_row_view_t_, lno_nnz_view_t_> RecolorType;
+  RecolorType gr(num_rows, entries.extent(0), row_map, entries, gch);
+  int num_phases = 0;
+  gr.recolor(colors_out, changed_vertices, num_changed_vertices, num_old_vertices, check_all_vertices, num_phases);
+
+  double coloring_time = timer.seconds();
+  gch->add_to_overall_coloring_time(coloring_time);
+  gch->set_coloring_time(coloring_time);
+  gch->set_num_phases(num_phases);
+  gch->set_vertex_colors(colors_out);
+}
+
+}  // end namespace Impl
+
+namespace Experimental{
+
+/** \brief Repairs the coloring held by the handle after the graph changed, instead of recoloring
+ *  it from scratch. Only the changed vertices that conflict with a neighbor, and the new vertices
+ *  (ids beyond the size of the previous coloring), are recolored with the VB or VBBIT algorithm;
+ *  the other vertices keep their colors. The coloring is not balanced again.
+ *  If the handle holds no coloring yet, the graph is colored with graph_color.
+ *  \param row_map, entries: the new graph, which must be symmetric.
+ *  \param changed_vertices: the vertices whose adjacency changed, without duplicates.
+ *    Both endpoints of a new edge may be given, but at least one of them must be.
+ *  \param num_changed_vertices: the number of entries of changed_vertices.
+ */
+template <class KernelHandle,typename lno_row_view_t_, typename lno_nnz_view_t_, typename vertex_view_t_>
+void graph_recolor(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t num_rows,
+    typename KernelHandle::nnz_lno_t num_cols,
+    lno_row_view_t_ row_map,
+    lno_nnz_view_t_ entries,
+    vertex_view_t_ changed_vertices,
+    typename KernelHandle::nnz_lno_t num_changed_vertices)
+{
+  Impl::graph_recolor(handle, num_rows, num_cols, row_map, entries, changed_vertices, num_changed_vertices, false);
+}
+
+/** \brief Repairs the coloring held by the handle after the graph changed, when the changed
+ *  vertices are not known. All vertices are checked for conflicts with their neighbors,
+ *  but only the conflicting and new ones are recolored.
+ */
+template <class KernelHandle,typename lno_row_view_t_, typename lno_nnz_view_t_>
+void graph_recolor(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t num_rows,
+    typename KernelHandle::nnz_lno_t num_cols,
+    lno_row_view_t_ row_map,
+    lno_nnz_view_t_ entries)
+{
+  typename KernelHandle::GraphColoringHandleType::nnz_lno_temp_work_view_t no_changed_vertices;
+  Impl::graph_recolor(handle, num_rows, num_cols, row_map, entries, no_changed_vertices, 0, true);
+}
+
 }  // end namespace Experimental
 }  // end namespace KokkosGraph
 
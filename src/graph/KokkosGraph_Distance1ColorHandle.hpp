@@ -142,6 +142,8 @@ private:
 
   int eb_num_initial_colors; //the number of colors to assign at the beginning of the edge-based algorithm
 
+  bool balance_colors; //after coloring, move vertices from overfull to underfull color classes.
+
   //STATISTICS
   double overall_coloring_time; //the overall time that it took to color the graph. In the case of the iterative calls.
   double overall_coloring_time_phase1;    //
@@ -185,6 +187,7 @@ private:
     vb_chunk_size(8),
     max_number_of_iterations(200),
     eb_num_initial_colors(1),
+    balance_colors(false),
     overall_coloring_time(0),
     overall_coloring_time_phase1(0),
     overall_coloring_time_phase2(0),
@@ -640,6 +643,7 @@ private:
   int get_vb_chunk_size() const{return this->vb_chunk_size;}
   int get_max_number_of_iterations() const{return this->max_number_of_iterations;}
   int get_eb_num_initial_colors() const{return this->eb_num_initial_colors;}
+  bool get_balance_colors() const{return this->balance_colors;}
 
   double get_overall_coloring_time() const { return this->overall_coloring_time;}
   double get_overall_coloring_time_phase1() const { return this->overall_coloring_time_phase1; }
@@ -670,6 +674,13 @@ private:
   void set_vb_chunk_size(const int &chunksize){this->vb_chunk_size = chunksize;}
   void set_max_number_of_iterations(const int &max_phases){this->max_number_of_iterations = max_phases;}
   void set_eb_num_initial_colors(const int &num_initial_colors){this->eb_num_initial_colors = num_initial_colors;}
+
+  /** \brief Requests a balancing pass after the coloring. Vertices are moved from color classes
+   *  larger than ceil(nv / num_colors) to smaller ones while keeping the coloring valid,
+   *  so that multicolor algorithms (e.g. Gauss-Seidel) launch kernels of similar size per color.
+   *  The number of colors does not change. Like the coloring itself, it requires a symmetric graph.
+   */
+  void set_balance_colors(const bool use_balance_colors){this->balance_colors = use_balance_colors;}
   void add_to_overall_coloring_time(const double &coloring_time_){this->overall_coloring_time += coloring_time_;}
   void add_to_overall_coloring_time_phase1(const double &coloring_time_){this->overall_coloring_time_phase1 += coloring_time_;}
   void add_to_overall_coloring_time_phase2(const double &coloring_time_){this->overall_coloring_time_phase2 += coloring_time_;}
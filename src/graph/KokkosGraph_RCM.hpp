@@ -55,6 +55,8 @@ namespace Experimental
 //Compute the reverse Cuthill-McKee ordering of a graph.
 //The graph must be symmetric, but it may have any number of connected components.
 //This function returns a list of vertices in RCM order.
+//The ordering is computed in parallel in device_t's execution space
+//(see Impl::ParallelRCM).
 
 template <typename device_t, typename rowmap_t, typename colinds_t, typename labels_t = typename colinds_t::non_const_type>
 labels_t
@@ -69,7 +71,7 @@ graph_rcm(const rowmap_t& rowmap, const colinds_t& colinds)
       numVerts--;
     return labels_t("RCM Labels", numVerts);
   }
-  Impl::SerialRCM<rowmap_t, colinds_t, labels_t> algo(rowmap, colinds);
+  Impl::ParallelRCM<device_t, rowmap_t, colinds_t, labels_t> algo(rowmap, colinds);
   return algo.rcm();
 }
 
@@ -47,10 +47,22 @@
 
 #include "Kokkos_Core.hpp"
 #include "KokkosKernels_Utils.hpp"
+#include "KokkosKernels_Sorting.hpp"
+#include "Kokkos_Bitset.hpp"
 #include <vector>
 #include <algorithm>
+#include <limits>
 
 namespace KokkosGraph {
+
+//Traversal direction of KokkosGraph::Experimental::graph_bfs
+enum BFS_Direction
+{
+  BFS_DIRECTION_OPTIMIZING,
+  BFS_TOP_DOWN,
+  BFS_BOTTOM_UP
+};
+
 namespace Experimental {
 namespace Impl {
 
@@ -156,5 +168,651 @@ struct SerialRCM
   }
 };
 
+//Number of vertices and sum of degrees of a BFS frontier
+struct BFSFrontierSize
+{
+  int64_t verts;
+  int64_t edges;
+};
+
+//One top-down step of a level-synchronous BFS, shared by graph_bfs and graph_rcm.
+//
+//Expands the frontier queue[begin, end) at depth level: each unvisited neighbor
+//(levels == -1) is claimed with a compare-and-swap on its level and appended to
+//nextQueue at position tail, which may be the end of queue itself. If parents is
+//not empty, each claimed vertex records the frontier vertex that claimed it. If
+//minPosition is not empty, each vertex of the next level records the lowest queue
+//position among its neighbors in the frontier, whoever claimed it.
+template<typename rowmap_t, typename entries_t, typename level_view_t, typename queue_view_t>
+struct BFSTopDownFunctor
+{
+  using size_type = typename rowmap_t::non_const_value_type;
+  using lno_t = typename entries_t::non_const_value_type;
+  using scalar_view_t = Kokkos::View<lno_t, typename queue_view_t::memory_space>;
+  typedef BFSFrontierSize value_type;
+
+  BFSTopDownFunctor(const rowmap_t& rowmap_, const entries_t& entries_, lno_t numVerts_, const level_view_t& levels_, const level_view_t& parents_,
+      const queue_view_t& minPosition_, const queue_view_t& queue_, const queue_view_t& nextQueue_, const scalar_view_t& tail_, lno_t level_)
+    : rowmap(rowmap_), entries(entries_), numVerts(numVerts_), levels(levels_), parents(parents_), minPosition(minPosition_),
+    queue(queue_), nextQueue(nextQueue_), tail(tail_), level(level_)
+  {}
+
+  KOKKOS_INLINE_FUNCTION void operator()(lno_t i, value_type& lsize) const
+  {
+    lno_t v = queue(i);
+    for(size_type j = rowmap(v); j < rowmap(v + 1); j++)
+    {
+      lno_t nei = entries(j);
+      if(nei == v || nei >= numVerts)
+        continue;
+      if(levels(nei) == -1 && Kokkos::atomic_compare_exchange(&levels(nei), (lno_t) -1, (lno_t) (level + 1)) == -1)
+      {
+        if(parents.extent(0))
+          parents(nei) = v;
+        nextQueue(Kokkos::atomic_fetch_add(&tail(), (lno_t) 1)) = nei;
+        lsize.verts++;
+        lsize.edges += rowmap(nei + 1) - rowmap(nei);
+      }
+      if(minPosition.extent(0) && levels(nei) == level + 1)
+        Kokkos::atomic_min(&minPosition(nei), i);
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION void init(value_type& size) const
+  {
+    size.verts = 0;
+    size.edges = 0;
+  }
+
+  KOKKOS_INLINE_FUNCTION void join(volatile value_type& dst, const volatile value_type& src) const
+  {
+    dst.verts += src.verts;
+    dst.edges += src.edges;
+  }
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  level_view_t levels;
+  level_view_t parents;
+  queue_view_t minPosition;
+  queue_view_t queue;
+  queue_view_t nextQueue;
+  scalar_view_t tail;
+  lno_t level;
+};
+
+//Reverse Cuthill-McKee ordering computed in the execution space of device_t.
+//
+//Each connected component is numbered by a level-synchronous BFS, stepped by the
+//BFSTopDownFunctor shared with graph_bfs. The vertices discovered from one level
+//form the next level; each remembers the lowest CM label among its neighbors in
+//the current level (its parent), and the level is
+//sorted by (parent label, degree, vertex ID) before labels are handed out. This
+//is the same order the serial queue-based algorithm produces, since a serial BFS
+//enqueues each vertex from its first-dequeued neighbor and sorts siblings by degree.
+//
+//The BFS root of each component is refined by a George-Liu pseudo-peripheral
+//search: repeatedly BFS from the current root and move to the minimum degree
+//vertex of the last level, as long as that increases the eccentricity.
+//
+//Every component costs a dozen or so kernel launches and host syncs, so isolated
+//vertices (no neighbors besides themselves) are all labeled first in one scan,
+//in order of vertex ID, before the component loop starts.
+template<typename device_t, typename rowmap_t, typename entries_t, typename lno_view_t>
+struct ParallelRCM
+{
+  using exec_space = typename device_t::execution_space;
+  using mem_space = typename device_t::memory_space;
+  using size_type = typename rowmap_t::non_const_value_type;
+  using lno_t = typename entries_t::non_const_value_type;
+  using work_view_t = Kokkos::View<lno_t*, mem_space>;
+  using scalar_view_t = Kokkos::View<lno_t, mem_space>;
+  using range_pol = Kokkos::RangePolicy<exec_space>;
+  //(degree, vertex) packed into one integer, so a plain min reduction picks the
+  //lowest degree vertex with the lowest ID as the tiebreak
+  using key_t = int64_t;
+
+  //Upper bound on the number of BFS sweeps of the pseudo-peripheral search
+  static constexpr int maxPeripheralSweeps = 8;
+
+  ParallelRCM(const rowmap_t& rowmap_, const entries_t& entries_)
+    : rowmap(rowmap_), entries(entries_), numVerts(rowmap_.extent(0) - 1),
+    labels(Kokkos::ViewAllocateWithoutInitializing("RCM Permutation"), numVerts),
+    order(Kokkos::ViewAllocateWithoutInitializing("RCM Order"), numVerts),
+    work(Kokkos::ViewAllocateWithoutInitializing("RCM Work"), numVerts),
+    levels(Kokkos::ViewAllocateWithoutInitializing("RCM Levels"), numVerts),
+    parent(Kokkos::ViewAllocateWithoutInitializing("RCM Parent"), numVerts),
+    tail("RCM Tail")
+  {}
+
+  KOKKOS_INLINE_FUNCTION static lno_t degree(const rowmap_t& rowmap, lno_t v)
+  {
+    return rowmap(v + 1) - rowmap(v);
+  }
+
+  struct InitFunctor
+  {
+    InitFunctor(const lno_view_t& labels_, const work_view_t& levels_, const work_view_t& parent_, lno_t numVerts_)
+      : labels(labels_), levels(levels_), parent(parent_), numVerts(numVerts_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      labels(i) = -1;
+      levels(i) = -1;
+      parent(i) = numVerts;
+    }
+
+    lno_view_t labels;
+    work_view_t levels;
+    work_view_t parent;
+    lno_t numVerts;
+  };
+
+  //Give the isolated vertices the first labels, in order of vertex ID
+  struct IsolatedFunctor
+  {
+    typedef lno_t value_type;
+
+    IsolatedFunctor(const rowmap_t& rowmap_, const entries_t& entries_, lno_t numVerts_, const lno_view_t& labels_, const work_view_t& levels_)
+      : rowmap(rowmap_), entries(entries_), numVerts(numVerts_), labels(labels_), levels(levels_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, lno_t& offset, bool final) const
+    {
+      for(size_type j = rowmap(v); j < rowmap(v + 1); j++)
+      {
+        lno_t nei = entries(j);
+        if(nei != v && nei < numVerts)
+          return;
+      }
+      if(final)
+      {
+        labels(v) = offset;
+        levels(v) = 0;
+      }
+      offset++;
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    lno_t numVerts;
+    lno_view_t labels;
+    work_view_t levels;
+  };
+
+  //Key of the minimum degree vertex among the unlabeled vertices, or among queue[begin, end)
+  struct MinDegreeFunctor
+  {
+    MinDegreeFunctor(const rowmap_t& rowmap_, const work_view_t& queue_, const lno_view_t& labels_, lno_t numVerts_, bool useQueue_)
+      : rowmap(rowmap_), queue(queue_), labels(labels_), numVerts(numVerts_), useQueue(useQueue_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i, key_t& lmin) const
+    {
+      if(!useQueue && labels(i) >= 0)
+        return;
+      lno_t v = useQueue ? queue(i) : i;
+      key_t key = (key_t) degree(rowmap, v) * numVerts + v;
+      if(key < lmin)
+        lmin = key;
+    }
+
+    rowmap_t rowmap;
+    work_view_t queue;
+    lno_view_t labels;
+    lno_t numVerts;
+    bool useQueue;
+  };
+
+  struct FirstUnlabeledFunctor
+  {
+    FirstUnlabeledFunctor(const lno_view_t& labels_) : labels(labels_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i, lno_t& lmin) const
+    {
+      if(labels(i) < 0 && i < lmin)
+        lmin = i;
+    }
+
+    lno_view_t labels;
+  };
+
+  //Put the root of a BFS at queue(base)
+  struct SeedFunctor
+  {
+    SeedFunctor(const work_view_t& queue_, const work_view_t& levels_, const lno_view_t& labels_, const scalar_view_t& tail_, lno_t root_, lno_t base_, bool ordering_)
+      : queue(queue_), levels(levels_), labels(labels_), tail(tail_), root(root_), base(base_), ordering(ordering_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t) const
+    {
+      levels(root) = 0;
+      queue(base) = root;
+      if(ordering)
+        labels(root) = base;
+      tail() = base + 1;
+    }
+
+    work_view_t queue;
+    work_view_t levels;
+    lno_view_t labels;
+    scalar_view_t tail;
+    lno_t root;
+    lno_t base;
+    bool ordering;
+  };
+
+  struct LevelComparator
+  {
+    LevelComparator(const rowmap_t& rowmap_, const work_view_t& parent_)
+      : rowmap(rowmap_), parent(parent_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION bool operator()(const lno_t lhs, const lno_t rhs) const
+    {
+      if(parent(lhs) != parent(rhs))
+        return parent(lhs) < parent(rhs);
+      lno_t lhsDeg = degree(rowmap, lhs);
+      lno_t rhsDeg = degree(rowmap, rhs);
+      if(lhsDeg != rhsDeg)
+        return lhsDeg < rhsDeg;
+      return lhs < rhs;
+    }
+
+    rowmap_t rowmap;
+    work_view_t parent;
+  };
+
+  struct AssignLabelsFunctor
+  {
+    AssignLabelsFunctor(const work_view_t& queue_, const lno_view_t& labels_) : queue(queue_), labels(labels_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      labels(queue(i)) = i;
+    }
+
+    work_view_t queue;
+    lno_view_t labels;
+  };
+
+  struct ResetLevelFunctor
+  {
+    ResetLevelFunctor(const work_view_t& queue_, const work_view_t& levels_) : queue(queue_), levels(levels_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      levels(queue(i)) = -1;
+    }
+
+    work_view_t queue;
+    work_view_t levels;
+  };
+
+  struct ReverseFunctor
+  {
+    ReverseFunctor(const lno_view_t& labels_, lno_t numVerts_) : labels(labels_), numVerts(numVerts_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      labels(i) = numVerts - labels(i) - 1;
+    }
+
+    lno_view_t labels;
+    lno_t numVerts;
+  };
+
+  //Level-synchronous BFS from root, filling queue from position base.
+  //Returns the number of levels; lastLevelBegin and end delimit the last
+  //level and the whole component in the queue.
+  lno_t bfs(const work_view_t& queue, lno_t root, lno_t base, bool ordering, lno_t& lastLevelBegin, lno_t& end)
+  {
+    Kokkos::parallel_for(range_pol(0, 1), SeedFunctor(queue, levels, labels, tail, root, base, ordering));
+    lno_t levelBegin = base;
+    lno_t levelEnd = base + 1;
+    lno_t numLevels = 1;
+    while(true)
+    {
+      //the next level is appended to the queue; in the ordering BFS, queue positions are final CM labels
+      BFSFrontierSize size;
+      Kokkos::parallel_reduce(range_pol(levelBegin, levelEnd),
+          BFSTopDownFunctor<rowmap_t, entries_t, work_view_t, work_view_t>
+            (rowmap, entries, numVerts, levels, work_view_t(), ordering ? parent : work_view_t(), queue, queue, tail, numLevels - 1), size);
+      if(size.verts == 0)
+        break;
+      lno_t nextEnd = levelEnd + size.verts;
+      if(ordering)
+      {
+        auto nextLevel = Kokkos::subview(queue, Kokkos::make_pair(levelEnd, nextEnd));
+        KokkosKernels::Impl::bitonicSort<decltype(nextLevel), exec_space, lno_t, LevelComparator>
+          (nextLevel, LevelComparator(rowmap, parent));
+        Kokkos::parallel_for(range_pol(levelEnd, nextEnd), AssignLabelsFunctor(queue, labels));
+      }
+      levelBegin = levelEnd;
+      levelEnd = nextEnd;
+      numLevels++;
+    }
+    lastLevelBegin = levelBegin;
+    end = levelEnd;
+    return numLevels;
+  }
+
+  lno_t minDegreeVertex(lno_t begin, lno_t end, bool useQueue)
+  {
+    key_t minKey = std::numeric_limits<key_t>::max();
+    Kokkos::parallel_reduce(range_pol(begin, end), MinDegreeFunctor(rowmap, work, labels, numVerts, useQueue), Kokkos::Min<key_t>(minKey));
+    return minKey % numVerts;
+  }
+
+  //George-Liu pseudo-peripheral vertex search within the component of root
+  lno_t findPseudoPeripheral(lno_t root)
+  {
+    lno_t lastLevelBegin, end;
+    lno_t eccentricity = bfs(work, root, 0, false, lastLevelBegin, end);
+    //a single vertex is its own pseudo-peripheral vertex
+    if(end == 1)
+    {
+      Kokkos::parallel_for(range_pol(0, end), ResetLevelFunctor(work, levels));
+      return root;
+    }
+    for(int sweep = 0; sweep < maxPeripheralSweeps; sweep++)
+    {
+      lno_t candidate = minDegreeVertex(lastLevelBegin, end, true);
+      Kokkos::parallel_for(range_pol(0, end), ResetLevelFunctor(work, levels));
+      lno_t candLastLevelBegin, candEnd;
+      lno_t candEccentricity = bfs(work, candidate, 0, false, candLastLevelBegin, candEnd);
+      if(candEccentricity <= eccentricity)
+        break;
+      root = candidate;
+      eccentricity = candEccentricity;
+      lastLevelBegin = candLastLevelBegin;
+    }
+    Kokkos::parallel_for(range_pol(0, end), ResetLevelFunctor(work, levels));
+    return root;
+  }
+
+  //Lowest unlabeled vertex ID >= cursor. Chunks grow geometrically, so
+  //skipping over the labeled vertices costs O(numVerts) in total.
+  lno_t findNextUnlabeled(lno_t& cursor)
+  {
+    lno_t chunk = 1024;
+    while(cursor < numVerts)
+    {
+      lno_t chunkEnd = (numVerts - cursor > chunk) ? cursor + chunk : numVerts;
+      lno_t found = numVerts;
+      Kokkos::parallel_reduce(range_pol(cursor, chunkEnd), FirstUnlabeledFunctor(labels), Kokkos::Min<lno_t>(found));
+      if(found < numVerts)
+      {
+        cursor = found;
+        return found;
+      }
+      cursor = chunkEnd;
+      chunk *= 2;
+    }
+    return -1;
+  }
+
+  lno_view_t rcm()
+  {
+    Kokkos::parallel_for(range_pol(0, numVerts), InitFunctor(labels, levels, parent, numVerts));
+    lno_t numLabeled = 0;
+    Kokkos::parallel_scan(range_pol(0, numVerts), IsolatedFunctor(rowmap, entries, numVerts, labels, levels), numLabeled);
+    lno_t cursor = 0;
+    //first component: start at the lowest degree vertex not yet labeled, like SerialRCM
+    lno_t root = numLabeled < numVerts ? minDegreeVertex(0, numVerts, false) : -1;
+    while(numLabeled < numVerts)
+    {
+      root = findPseudoPeripheral(root);
+      lno_t lastLevelBegin;
+      bfs(order, root, numLabeled, true, lastLevelBegin, numLabeled);
+      if(numLabeled == numVerts)
+        break;
+      //this connected component is done, but others remain unlabeled
+      root = findNextUnlabeled(cursor);
+    }
+    Kokkos::parallel_for(range_pol(0, numVerts), ReverseFunctor(labels, numVerts));
+    return labels;
+  }
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  lno_view_t labels;
+  work_view_t order;
+  work_view_t work;
+  work_view_t levels;
+  work_view_t parent;
+  scalar_view_t tail;
+};
+
+//Direction-optimizing breadth-first search (Beamer, Asanovic and Patterson).
+//
+//Top-down steps expand a queue of frontier vertices, claiming unvisited neighbors
+//with a compare-and-swap on their level. Bottom-up steps let every unvisited vertex
+//look for a parent among its neighbors in a bitmap of the frontier, stopping at the
+//first hit; this is much cheaper once the frontier holds a large share of the edges.
+//In direction-optimizing mode the search goes bottom-up when the frontier's edges
+//exceed 1/alpha of the unexplored edges, and back to top-down when the frontier
+//shrinks below 1/beta of the vertices.
+template<typename device_t, typename rowmap_t, typename entries_t, typename lno_view_t>
+struct DirectionOptimizingBFS
+{
+  using exec_space = typename device_t::execution_space;
+  using mem_space = typename device_t::memory_space;
+  using size_type = typename rowmap_t::non_const_value_type;
+  using lno_t = typename entries_t::non_const_value_type;
+  using bitset_t = Kokkos::Bitset<device_t>;
+  using work_view_t = Kokkos::View<lno_t*, mem_space>;
+  using scalar_view_t = Kokkos::View<lno_t, mem_space>;
+  using range_pol = Kokkos::RangePolicy<exec_space>;
+
+  //Thresholds of the direction switch, from the reference paper
+  static constexpr int alpha = 14;
+  static constexpr int beta = 24;
+
+  DirectionOptimizingBFS(const rowmap_t& rowmap_, const entries_t& entries_, BFS_Direction direction_)
+    : rowmap(rowmap_), entries(entries_), numVerts(rowmap_.extent(0) - 1), direction(direction_),
+    levels(Kokkos::ViewAllocateWithoutInitializing("BFS Levels"), numVerts),
+    parents(Kokkos::ViewAllocateWithoutInitializing("BFS Parents"), numVerts),
+    queue(Kokkos::ViewAllocateWithoutInitializing("BFS Queue"), numVerts),
+    nextQueue(Kokkos::ViewAllocateWithoutInitializing("BFS Next Queue"), numVerts),
+    frontier(numVerts), nextFrontier(numVerts),
+    tail("BFS Tail")
+  {}
+
+  KOKKOS_INLINE_FUNCTION static int64_t degree(const rowmap_t& rowmap, lno_t v)
+  {
+    return rowmap(v + 1) - rowmap(v);
+  }
+
+  struct InitFunctor
+  {
+    InitFunctor(const lno_view_t& levels_, const lno_view_t& parents_, lno_t source_)
+      : levels(levels_), parents(parents_), source(source_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      levels(i) = (i == source) ? 0 : -1;
+      parents(i) = (i == source) ? source : -1;
+    }
+
+    lno_view_t levels;
+    lno_view_t parents;
+    lno_t source;
+  };
+
+  struct BottomUpFunctor
+  {
+    typedef BFSFrontierSize value_type;
+
+    BottomUpFunctor(const rowmap_t& rowmap_, const entries_t& entries_, lno_t numVerts_, const lno_view_t& levels_, const lno_view_t& parents_,
+        const bitset_t& frontier_, const bitset_t& nextFrontier_, lno_t level_)
+      : rowmap(rowmap_), entries(entries_), numVerts(numVerts_), levels(levels_), parents(parents_),
+      frontier(frontier_), nextFrontier(nextFrontier_), level(level_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, value_type& lsize) const
+    {
+      if(levels(v) != -1)
+        return;
+      for(size_type j = rowmap(v); j < rowmap(v + 1); j++)
+      {
+        lno_t nei = entries(j);
+        if(nei < numVerts && frontier.test(nei))
+        {
+          levels(v) = level + 1;
+          parents(v) = nei;
+          nextFrontier.set(v);
+          lsize.verts++;
+          lsize.edges += degree(rowmap, v);
+          break;
+        }
+      }
+    }
+
+    KOKKOS_INLINE_FUNCTION void init(value_type& size) const
+    {
+      size.verts = 0;
+      size.edges = 0;
+    }
+
+    KOKKOS_INLINE_FUNCTION void join(volatile value_type& dst, const volatile value_type& src) const
+    {
+      dst.verts += src.verts;
+      dst.edges += src.edges;
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    lno_t numVerts;
+    lno_view_t levels;
+    lno_view_t parents;
+    bitset_t frontier;
+    bitset_t nextFrontier;
+    lno_t level;
+  };
+
+  //Queue to bitmap, when switching to bottom-up
+  struct QueueToBitsetFunctor
+  {
+    QueueToBitsetFunctor(const work_view_t& queue_, const bitset_t& bits_) : queue(queue_), bits(bits_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      bits.set(queue(i));
+    }
+
+    work_view_t queue;
+    bitset_t bits;
+  };
+
+  //Bitmap to queue, when switching to top-down
+  struct BitsetToQueueFunctor
+  {
+    typedef lno_t value_type;
+
+    BitsetToQueueFunctor(const bitset_t& bits_, const work_view_t& queue_) : bits(bits_), queue(queue_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i, lno_t& offset, bool finalPass) const
+    {
+      if(bits.test(i))
+      {
+        if(finalPass)
+          queue(offset) = i;
+        offset++;
+      }
+    }
+
+    bitset_t bits;
+    work_view_t queue;
+  };
+
+  struct SourceFunctor
+  {
+    SourceFunctor(const work_view_t& queue_, lno_t source_) : queue(queue_), source(source_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t) const
+    {
+      queue(0) = source;
+    }
+
+    work_view_t queue;
+    lno_t source;
+  };
+
+  //Returns the number of levels, i.e. one more than the largest level reached
+  lno_t compute(lno_t source)
+  {
+    Kokkos::parallel_for(range_pol(0, numVerts), InitFunctor(levels, parents, source));
+    Kokkos::parallel_for(range_pol(0, 1), SourceFunctor(queue, source));
+    //The frontier starts as the queue {source}
+    bool bottomUp = false;
+    BFSFrontierSize size;
+    size.verts = 1;
+    auto sourceRow = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), Kokkos::subview(rowmap, Kokkos::make_pair(source, source + 2)));
+    size.edges = sourceRow(1) - sourceRow(0);
+    int64_t unexploredEdges = entries.extent(0) - size.edges;
+    lno_t level = 0;
+    while(size.verts)
+    {
+      //choose the direction of this step
+      bool nextBottomUp = bottomUp;
+      if(direction == BFS_TOP_DOWN)
+        nextBottomUp = false;
+      else if(direction == BFS_BOTTOM_UP)
+        nextBottomUp = true;
+      else if(!bottomUp && size.edges > unexploredEdges / alpha)
+        nextBottomUp = true;
+      else if(bottomUp && size.verts < numVerts / beta)
+        nextBottomUp = false;
+      if(nextBottomUp && !bottomUp)
+      {
+        frontier.reset();
+        Kokkos::parallel_for(range_pol(0, size.verts), QueueToBitsetFunctor(queue, frontier));
+      }
+      else if(!nextBottomUp && bottomUp)
+      {
+        Kokkos::parallel_scan(range_pol(0, numVerts), BitsetToQueueFunctor(frontier, queue));
+      }
+      bottomUp = nextBottomUp;
+      BFSFrontierSize nextSize;
+      if(bottomUp)
+      {
+        nextFrontier.reset();
+        Kokkos::parallel_reduce(range_pol(0, numVerts),
+            BottomUpFunctor(rowmap, entries, numVerts, levels, parents, frontier, nextFrontier, level), nextSize);
+        std::swap(frontier, nextFrontier);
+      }
+      else
+      {
+        Kokkos::deep_copy(tail, (lno_t) 0);
+        Kokkos::parallel_reduce(range_pol(0, size.verts),
+            BFSTopDownFunctor<rowmap_t, entries_t, lno_view_t, work_view_t>
+              (rowmap, entries, numVerts, levels, parents, work_view_t(), queue, nextQueue, tail, level), nextSize);
+        std::swap(queue, nextQueue);
+      }
+      size = nextSize;
+      unexploredEdges -= size.edges;
+      level++;
+    }
+    return level;
+  }
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  BFS_Direction direction;
+  lno_view_t levels;
+  lno_view_t parents;
+  work_view_t queue;
+  work_view_t nextQueue;
+  bitset_t frontier;
+  bitset_t nextFrontier;
+  scalar_view_t tail;
+};
+
 }}} //namespace KokkosGraph::Experimental::Impl
 #endif
@@ -0,0 +1,285 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef _KOKKOSGRAPH_CONNECTED_COMPONENTS_IMPL_HPP
+#define _KOKKOSGRAPH_CONNECTED_COMPONENTS_IMPL_HPP
+
+#include "Kokkos_Core.hpp"
+#include "KokkosKernels_Utils.hpp"
+#include <unordered_map>
+
+namespace KokkosGraph {
+namespace Impl {
+
+//Connected components with the Afforest algorithm (Sutton, Ben-Nun and Barak, IPDPS 2018).
+//Components are built as union-find trees in comp, where roots are only ever hooked onto
+//smaller roots, so the root of each tree is the smallest vertex of its component.
+//First the first neighborRounds neighbors of every vertex are linked, which is enough to
+//connect most of the largest component. That component is then found by sampling, and only
+//the vertices outside of it link their remaining neighbors. Pointer jumping (compress)
+//flattens the trees between the phases.
+//The graph must be symmetric: edges leaving the largest component are only seen from the other side.
+template<typename device_t, typename rowmap_t, typename entries_t, typename lno_view_t>
+struct AfforestCC
+{
+  using exec_space = typename device_t::execution_space;
+  using mem_space = typename device_t::memory_space;
+  using size_type = typename rowmap_t::non_const_value_type;
+  using lno_t = typename entries_t::non_const_value_type;
+  using work_view_t = Kokkos::View<lno_t*, mem_space>;
+  using range_pol = Kokkos::RangePolicy<exec_space>;
+
+  //Number of neighbors of each vertex linked before sampling the largest component
+  static constexpr int neighborRounds = 2;
+  //Number of vertices sampled to find the largest component
+  static constexpr int numSamples = 1024;
+
+  AfforestCC(const rowmap_t& rowmap_, const entries_t& entries_)
+    : rowmap(rowmap_), entries(entries_), numVerts(rowmap_.extent(0) ? rowmap_.extent(0) - 1 : 0),
+    comp(Kokkos::ViewAllocateWithoutInitializing("CC Components"), numVerts)
+  {}
+
+  //Merges the trees of u and v, hooking the larger root onto the smaller one.
+  KOKKOS_INLINE_FUNCTION static void link(const work_view_t& comp, lno_t u, lno_t v)
+  {
+    lno_t p1 = comp(u);
+    lno_t p2 = comp(v);
+    while(p1 != p2)
+    {
+      lno_t high = p1 > p2 ? p1 : p2;
+      lno_t low = p1 > p2 ? p2 : p1;
+      lno_t pHigh = comp(high);
+      //another thread already hooked high onto low
+      if(pHigh == low)
+        break;
+      if(pHigh == high && Kokkos::atomic_compare_exchange(&comp(high), high, low) == high)
+        break;
+      p1 = comp(comp(high));
+      p2 = comp(low);
+    }
+  }
+
+  struct InitFunctor
+  {
+    InitFunctor(const work_view_t& comp_) : comp(comp_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      comp(i) = i;
+    }
+
+    work_view_t comp;
+  };
+
+  //Links every vertex with its neighbor in position round of its row
+  struct LinkNeighborFunctor
+  {
+    LinkNeighborFunctor(const rowmap_t& rowmap_, const entries_t& entries_, lno_t numVerts_, const work_view_t& comp_, int round_)
+      : rowmap(rowmap_), entries(entries_), numVerts(numVerts_), comp(comp_), round(round_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      size_type j = rowmap(i) + round;
+      if(j < rowmap(i + 1))
+      {
+        lno_t nei = entries(j);
+        if(nei < numVerts)
+          link(comp, i, nei);
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    lno_t numVerts;
+    work_view_t comp;
+    int round;
+  };
+
+  //Links the remaining neighbors of the vertices outside of the component skipComp
+  struct LinkRemainingFunctor
+  {
+    LinkRemainingFunctor(const rowmap_t& rowmap_, const entries_t& entries_, lno_t numVerts_, const work_view_t& comp_, lno_t skipComp_)
+      : rowmap(rowmap_), entries(entries_), numVerts(numVerts_), comp(comp_), skipComp(skipComp_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      if(comp(i) == skipComp)
+        return;
+      size_type rowEnd = rowmap(i + 1);
+      for(size_type j = rowmap(i) + neighborRounds; j < rowEnd; j++)
+      {
+        lno_t nei = entries(j);
+        if(nei < numVerts)
+          link(comp, i, nei);
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    lno_t numVerts;
+    work_view_t comp;
+    lno_t skipComp;
+  };
+
+  //Pointer jumping: makes every vertex point directly to its root
+  struct CompressFunctor
+  {
+    CompressFunctor(const work_view_t& comp_) : comp(comp_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      while(comp(i) != comp(comp(i)))
+        comp(i) = comp(comp(i));
+    }
+
+    work_view_t comp;
+  };
+
+  struct SampleFunctor
+  {
+    SampleFunctor(const work_view_t& comp_, const work_view_t& samples_, lno_t numVerts_)
+      : comp(comp_), samples(samples_), numVerts(numVerts_)
+    {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      //fixed pseudo-random vertices, so that results are reproducible
+      uint64_t x = (uint64_t(i) + 1) * 0x9E3779B97F4A7C15ULL;
+      x ^= x >> 32;
+      samples(i) = comp(x % uint64_t(numVerts));
+    }
+
+    work_view_t comp;
+    work_view_t samples;
+    lno_t numVerts;
+  };
+
+  //Numbers the roots in increasing order
+  struct NumberRootsFunctor
+  {
+    NumberRootsFunctor(const work_view_t& comp_, const lno_view_t& labels_) : comp(comp_), labels(labels_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i, lno_t& lnum, bool finalPass) const
+    {
+      if(comp(i) == i)
+      {
+        if(finalPass)
+          labels(i) = lnum;
+        lnum++;
+      }
+    }
+
+    work_view_t comp;
+    lno_view_t labels;
+  };
+
+  //Roots were labeled by NumberRootsFunctor and are left untouched, so this only reads them.
+  struct LabelFunctor
+  {
+    LabelFunctor(const work_view_t& comp_, const lno_view_t& labels_) : comp(comp_), labels(labels_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const
+    {
+      lno_t root = comp(i);
+      if(root != i)
+        labels(i) = labels(root);
+    }
+
+    work_view_t comp;
+    lno_view_t labels;
+  };
+
+  //Finds the most frequent component among a sample of the vertices
+  lno_t sampleLargestComponent()
+  {
+    lno_t sampleSize = numSamples < numVerts ? numSamples : numVerts;
+    work_view_t samples(Kokkos::ViewAllocateWithoutInitializing("CC Samples"), sampleSize);
+    Kokkos::parallel_for(range_pol(0, sampleSize), SampleFunctor(comp, samples, numVerts));
+    auto samplesHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), samples);
+    std::unordered_map<lno_t, lno_t> counts;
+    lno_t largest = samplesHost(0);
+    lno_t largestCount = 0;
+    for(lno_t i = 0; i < sampleSize; i++)
+    {
+      lno_t count = ++counts[samplesHost(i)];
+      if(count > largestCount)
+      {
+        largestCount = count;
+        largest = samplesHost(i);
+      }
+    }
+    return largest;
+  }
+
+  //Returns the component labels in [0, numComponents), ordered by the smallest vertex of each component.
+  lno_view_t compute(lno_t& numComponents)
+  {
+    lno_view_t labels(Kokkos::ViewAllocateWithoutInitializing("CC Labels"), numVerts);
+    numComponents = 0;
+    if(numVerts == 0)
+      return labels;
+    Kokkos::parallel_for(range_pol(0, numVerts), InitFunctor(comp));
+    for(int round = 0; round < neighborRounds; round++)
+    {
+      Kokkos::parallel_for(range_pol(0, numVerts), LinkNeighborFunctor(rowmap, entries, numVerts, comp, round));
+      Kokkos::parallel_for(range_pol(0, numVerts), CompressFunctor(comp));
+    }
+    lno_t largest = sampleLargestComponent();
+    Kokkos::parallel_for(range_pol(0, numVerts), LinkRemainingFunctor(rowmap, entries, numVerts, comp, largest));
+    Kokkos::parallel_for(range_pol(0, numVerts), CompressFunctor(comp));
+    Kokkos::parallel_scan(range_pol(0, numVerts), NumberRootsFunctor(comp, labels), numComponents);
+    Kokkos::parallel_for(range_pol(0, numVerts), LabelFunctor(comp, labels));
+    return labels;
+  }
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  work_view_t comp;
+};
+
+}}  //namespace KokkosGraph::Impl
+
+#endif
@@ -3048,6 +3048,464 @@ public:
   };
 };
 
+/*! \brief Balancing pass applied on an existing distance-1 coloring.
+ *  Multicolor algorithms such as Gauss-Seidel launch one kernel per color, so a coloring with
+ *  a few very large and many small color classes leaves most of those launches underutilized.
+ *  This pass moves vertices out of the classes larger than ceil(nv / num_colors) into the
+ *  smaller ones, keeping the coloring valid and the number of colors unchanged.
+ *  Each round, only the vertices of overfull classes with the highest (randomized) priority among
+ *  their overfull neighbors move, so the moving vertices form an independent set and can each pick
+ *  a color not used by their neighbors without conflicts. Moves into and out of a class are bounded
+ *  by atomic budgets, hence no class becomes overfull because of the pass.
+ *  The graph is assumed to be symmetric.
+ */
+template <typename HandleType, typename lno_row_view_t_, typename lno_nnz_view_t_>
+class GraphColorBalance{
+public:
+
+  typedef typename HandleType::color_view_t color_view_type;
+  typedef typename HandleType::color_t color_t;
+
+  typedef typename HandleType::size_type size_type;
+  typedef typename HandleType::nnz_lno_t nnz_lno_t;
+
+  typedef typename HandleType::HandleExecSpace MyExecSpace;
+  typedef typename HandleType::HandleTempMemorySpace MyTempMemorySpace;
+
+  typedef Kokkos::RangePolicy<MyExecSpace> my_exec_space;
+
+  typedef typename HandleType::nnz_lno_temp_work_view_t nnz_lno_temp_work_view_t;
+
+  typedef typename lno_row_view_t_::const_type const_lno_row_view_t;
+  typedef typename lno_nnz_view_t_::const_type const_lno_nnz_view_t;
+
+  //number of colors checked at once against the neighbor colors.
+  static constexpr int color_window_size = 64;
+
+protected:
+  nnz_lno_t nv; //# vertices
+  const_lno_row_view_t xadj; //rowmap
+  const_lno_nnz_view_t adj; // entries
+  HandleType *cp;
+
+public:
+  /**
+   * \brief GraphColorBalance constructor.
+   * \param nv_: number of vertices in the graph
+   * \param row_map: the xadj array of the graph. Its size is nv_ +1
+   * \param entries: adjacency array of the graph.
+   * \param coloring_handle: GraphColoringHandle object that holds the parameters of the coloring.
+   */
+  GraphColorBalance(
+      nnz_lno_t nv_,
+      const_lno_row_view_t row_map,
+      const_lno_nnz_view_t entries,
+      HandleType *coloring_handle):
+        nv(nv_), xadj(row_map), adj(entries), cp(coloring_handle){}
+
+  /** \brief Balances the color classes of the given coloring in place.
+   *  \param colors: a valid distance-1 coloring with colors in [1, num_colors].
+   *  \param num_rounds: output, the number of rounds performed.
+   *  \return the number of vertices that changed color.
+   */
+  nnz_lno_t balance(color_view_type colors, int &num_rounds){
+    num_rounds = 0;
+    if (nv == 0) return 0;
+
+    color_t num_colors = 0;
+    Kokkos::parallel_reduce("KokkosGraph::BalanceColors::FindMaxColor", my_exec_space(0, nv),
+        functorMaxColor(colors), Kokkos::Max<color_t>(num_colors));
+    if (num_colors <= 1) return 0;
+
+    const nnz_lno_t target = (nv + num_colors - 1) / num_colors;
+
+    nnz_lno_temp_work_view_t class_size("ColorClassSizes", num_colors + 1);
+    nnz_lno_temp_work_view_t surplus("ColorClassSurplus", num_colors + 1);
+    nnz_lno_temp_work_view_t deficit("ColorClassDeficit", num_colors + 1);
+    nnz_lno_temp_work_view_t movers("BalanceMovers", nv);
+
+    const int max_rounds = cp->get_max_number_of_iterations();
+    nnz_lno_t total_moved = 0;
+    for (int round = 0; round < max_rounds; ++round){
+      Kokkos::deep_copy(class_size, 0);
+      Kokkos::parallel_for("KokkosGraph::BalanceColors::CountClassSizes", my_exec_space(0, nv),
+          functorCountClassSizes(colors, class_size));
+      Kokkos::parallel_for("KokkosGraph::BalanceColors::SetBudgets", my_exec_space(1, num_colors + 1),
+          functorSetBudgets(class_size, surplus, deficit, target));
+      Kokkos::parallel_for("KokkosGraph::BalanceColors::SelectMovers", my_exec_space(0, nv),
+          functorSelectMovers(nv, xadj, adj, colors, class_size, movers, target, round));
+
+      nnz_lno_t num_moved = 0;
+      Kokkos::parallel_reduce("KokkosGraph::BalanceColors::MoveVertices", my_exec_space(0, nv),
+          functorMoveVertices(nv, xadj, adj, colors, surplus, deficit, movers, num_colors), num_moved);
+      ++num_rounds;
+      if (cp->get_tictoc()){
+        std::cout << "\tBalance round:" << round << " moved vertices:" << num_moved << std::endl;
+      }
+      total_moved += num_moved;
+      if (num_moved == 0) break;
+    }
+    return total_moved;
+  }
+
+  /** \brief Randomized priority of a vertex for the given round. Ties are broken by vertex id.
+   */
+  KOKKOS_INLINE_FUNCTION
+  static bool has_priority(nnz_lno_t u, nnz_lno_t v, int round){
+    const uint64_t hu = hash_vertex(u, round);
+    const uint64_t hv = hash_vertex(v, round);
+    return hu > hv || (hu == hv && u > v);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  static uint64_t hash_vertex(nnz_lno_t v, int round){
+    uint64_t x = static_cast<uint64_t>(v) * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(round);
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 29;
+    return x;
+  }
+
+  struct functorMaxColor{
+    color_view_type colors;
+
+    functorMaxColor(color_view_type colors_): colors(colors_){}
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const nnz_lno_t i, color_t &lmax) const {
+      if (colors(i) > lmax) lmax = colors(i);
+    }
+  };
+
+  struct functorCountClassSizes{
+    color_view_type colors;
+    nnz_lno_temp_work_view_t class_size;
+
+    functorCountClassSizes(color_view_type colors_, nnz_lno_temp_work_view_t class_size_):
+      colors(colors_), class_size(class_size_){}
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const nnz_lno_t i) const {
+      Kokkos::atomic_increment(&class_size(colors(i)));
+    }
+  };
+
+  /**
+   * Sets how many vertices may leave (surplus) or enter (deficit) each color class in this round.
+   */
+  struct functorSetBudgets{
+    nnz_lno_temp_work_view_t class_size;
+    nnz_lno_temp_work_view_t surplus;
+    nnz_lno_temp_work_view_t deficit;
+    nnz_lno_t target;
+
+    functorSetBudgets(
+        nnz_lno_temp_work_view_t class_size_,
+        nnz_lno_temp_work_view_t surplus_,
+        nnz_lno_temp_work_view_t deficit_,
+        nnz_lno_t target_):
+      class_size(class_size_), surplus(surplus_), deficit(deficit_), target(target_){}
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const color_t c) const {
+      const nnz_lno_t s = class_size(c);
+      surplus(c) = s > target ? s - target : 0;
+      deficit(c) = s < target ? target - s : 0;
+    }
+  };
+
+  /**
+   * Marks the vertices of overfull classes that have the highest priority among their neighbors
+   * in overfull classes. Colors are only read here, so the selection is consistent.
+   */
+  struct functorSelectMovers{
+    nnz_lno_t nv;
+    const_lno_row_view_t xadj;
+    const_lno_nnz_view_t adj;
+    color_view_type colors;
+    nnz_lno_temp_work_view_t class_size;
+    nnz_lno_temp_work_view_t movers;
+    nnz_lno_t target;
+    int round;
+
+    functorSelectMovers(
+        nnz_lno_t nv_,
+        const_lno_row_view_t xadj_,
+        const_lno_nnz_view_t adj_,
+        color_view_type colors_,
+        nnz_lno_temp_work_view_t class_size_,
+        nnz_lno_temp_work_view_t movers_,
+        nnz_lno_t target_,
+        int round_):
+      nv(nv_), xadj(xadj_), adj(adj_), colors(colors_), class_size(class_size_),
+      movers(movers_), target(target_), round(round_){}
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const nnz_lno_t i) const {
+      nnz_lno_t is_mover = 0;
+      if (class_size(colors(i)) > target){
+        is_mover = 1;
+        const size_type nbegin = xadj(i);
+        const size_type nend = xadj(i + 1);
+        for (size_type j = nbegin; j < nend; ++j){
+          const nnz_lno_t n = adj(j);
+          if (n == i || n >= nv) continue;
+          if (class_size(colors(n)) > target && has_priority(n, i, round)){
+            is_mover = 0;
+            break;
+          }
+        }
+      }
+      movers(i) = is_mover;
+    }
+  };
+
+  /**
+   * Moves the selected vertices into the first underfull class that none of their neighbors use.
+   * None of the neighbors of a selected vertex is selected, so neighbor colors do not change here.
+   */
+  struct functorMoveVertices{
+    nnz_lno_t nv;
+    const_lno_row_view_t xadj;
+    const_lno_nnz_view_t adj;
+    color_view_type colors;
+    nnz_lno_temp_work_view_t surplus;
+    nnz_lno_temp_work_view_t deficit;
+    nnz_lno_temp_work_view_t movers;
+    color_t num_colors;
+
+    functorMoveVertices(
+        nnz_lno_t nv_,
+        const_lno_row_view_t xadj_,
+        const_lno_nnz_view_t adj_,
+        color_view_type colors_,
+        nnz_lno_temp_work_view_t surplus_,
+        nnz_lno_temp_work_view_t deficit_,
+        nnz_lno_temp_work_view_t movers_,
+        color_t num_colors_):
+      nv(nv_), xadj(xadj_), adj(adj_), colors(colors_), surplus(surplus_), deficit(deficit_),
+      movers(movers_), num_colors(num_colors_){}
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const nnz_lno_t i, nnz_lno_t &num_moved) const {
+      if (!movers(i)) return;
+      const color_t my_color = colors(i);
+      //reserve a slot to leave the class, it might have been taken by other movers.
+      if (Kokkos::atomic_fetch_add(&surplus(my_color), nnz_lno_t(-1)) <= 0) return;
+
+      const size_type nbegin = xadj(i);
+      const size_type nend = xadj(i + 1);
+      for (color_t base = 1; base <= num_colors; base += color_window_size){
+        //colors in [base, base + color_window_size) used by the neighbors.
+        uint64_t forbidden = 0;
+        for (size_type j = nbegin; j < nend; ++j){
+          const nnz_lno_t n = adj(j);
+          if (n == i || n >= nv) continue;
+          const color_t c = colors(n);
+          if (c >= base && c < base + color_window_size){
+            forbidden |= uint64_t(1) << (c - base);
+          }
+        }
+        for (color_t offset = 0; offset < color_window_size && base + offset <= num_colors; ++offset){
+          const color_t c = base + offset;
+          if ((forbidden & (uint64_t(1) << offset)) || c == my_color || deficit(c) <= 0) continue;
+          if (Kokkos::atomic_fetch_add(&deficit(c), nnz_lno_t(-1)) > 0){
+            colors(i) = c;
+            num_moved++;
+            return;
+          }
+        }
+      }
+      //no underfull class is available for this vertex, give the slot back.
+      Kokkos::atomic_add(&surplus(my_color), nnz_lno_t(1));
+    }
+  };
+};  // class GraphColorBalance
+
+/*! \brief Repairs a distance-1 coloring after the graph changed.
+ *  Only the changed vertices that conflict with a neighbor, and the vertices added to the graph,
+ *  are uncolored. They are then recolored by the speculative vertex based algorithm (VB or VBBIT)
+ *  working on that vertex list only, the colors of all other vertices being fixed.
+ *  Apart from allocations, the work is proportional to the adjacencies of the changed vertices.
+ *  The graph is assumed to be symmetric.
+ */
+template <typename HandleType, typename lno_row_view_t_, typename lno_nnz_view_t_>
+class GraphRecolor{
+public:
+
+  typedef typename HandleType::color_view_t color_view_type;
+  typedef typename HandleType::color_t color_t;
+
+  typedef typename HandleType::size_type size_type;
+  typedef typename HandleType::nnz_lno_t nnz_lno_t;
+
+  typedef typename HandleType::HandleExecSpace MyExecSpace;
+  typedef typename HandleType::HandleTempMemorySpace MyTempMemorySpace;
+
+  typedef Kokkos::RangePolicy<MyExecSpace> my_exec_space;
+
+  typedef typename HandleType::nnz_lno_temp_work_view_t nnz_lno_temp_work_view_t;
+  typedef typename Kokkos::View<nnz_lno_t, MyTempMemorySpace> single_dim_index_view_type;
+
+  typedef typename lno_row_view_t_::const_type const_lno_row_view_t;
+  typedef typename lno_nnz_view_t_::const_type const_lno_nnz_view_t;
+
+protected:
+  nnz_lno_t nv; //# vertices
+  size_type ne; //# edges
+  const_lno_row_view_t xadj; //rowmap
+  const_lno_nnz_view_t adj; // entries
+  HandleType *cp;
+
+public:
+  /**
+   * \brief GraphRecolor constructor.
+   * \param nv_: number of vertices in the new graph
+   * \param ne_: number of edges in the new graph
+   * \param row_map: the xadj array of the new graph. Its size is nv_ +1
+   * \param entries: adjacency array of the new graph. Its size is ne_
+   * \param coloring_handle: GraphColoringHandle object that holds the parameters of the coloring.
+   */
+  GraphRecolor(
+      nnz_lno_t nv_,
+      size_type ne_,
+      const_lno_row_view_t row_map,
+      const_lno_nnz_view_t entries,
+      HandleType *coloring_handle):
+        nv(nv_), ne(ne_), xadj(row_map), adj(entries), cp(coloring_handle){}
+
+  /** \brief Recolors the conflicting changed vertices and the new vertices in place.
+   *  \param colors: the previous coloring, of size nv. The vertices in [num_old_vertices, nv)
+   *    are new and must have color 0.
+   *  \param changed_vertices: the vertices whose adjacency changed, without duplicates.
+   *    Ignored if check_all_vertices is true.
+   *  \param num_changed_vertices: the number of entries of changed_vertices.
+   *  \param num_old_vertices: the number of vertices that have a color from the previous coloring.
+   *  \param check_all_vertices: whether all old vertices are checked for conflicts, when
+   *    the changed vertices are not known.
+   *  \param num_phases: output, the number of phases of the speculative coloring.
+   *  \return the number of recolored vertices.
+   */
+  template <typename vertex_view_t>
+  nnz_lno_t recolor(
+      color_view_type colors,
+      vertex_view_t changed_vertices,
+      nnz_lno_t num_changed_vertices,
+      nnz_lno_t num_old_vertices,
+      bool check_all_vertices,
+      int &num_phases){
+
+    num_phases = 0;
+    const nnz_lno_t num_candidates = check_all_vertices ? num_old_vertices : num_changed_vertices;
+    const nnz_lno_t num_new_vertices = nv - num_old_vertices;
+
+    nnz_lno_temp_work_view_t worklist(
+        Kokkos::ViewAllocateWithoutInitializing("RecolorList"), num_candidates + num_new_vertices);
+    single_dim_index_view_type worklist_length("RecolorListLength");
+
+    Kokkos::parallel_for("KokkosGraph::GraphRecolor::FindConflicts", my_exec_space(0, num_candidates),
+        functorUncolorConflicts<vertex_view_t>(
+          nv, num_old_vertices, xadj, adj, colors, changed_vertices, !check_all_vertices,
+          worklist, worklist_length));
+
+    nnz_lno_t num_conflicts = 0;
+    Kokkos::deep_copy(num_conflicts, worklist_length);
+    Kokkos::parallel_for("KokkosGraph::GraphRecolor::AppendNewVertices", my_exec_space(0, num_new_vertices),
+        functorAppendNewVertices(num_old_vertices, num_conflicts, worklist));
+
+    const nnz_lno_t worklist_size = num_conflicts + num_new_vertices;
+    if (cp->get_tictoc()){
+      std::cout << "\tRecolor conflicting vertices:" << num_conflicts
+                << " new vertices:" << num_new_vertices << std::endl;
+    }
+    if (worklist_size == 0) return 0;
+
+    //The speculative VB kernels only color the vertices of the given list and
+    //treat the colors of the others as fixed. Other algorithms fall back to VBBIT.
+    HandleType repair_handle(*cp);
+    if (repair_handle.get_coloring_algo_type() != COLORING_VB &&
+        repair_handle.get_coloring_algo_type() != COLORING_VBBIT){
+      repair_handle.set_coloring_algo_type(COLORING_VBBIT);
+    }
+    if (repair_handle.get_conflict_list_type() == COLORING_NOCONFLICT){
+      repair_handle.set_conflict_list_type(COLORING_ATOMIC);
+    }
+    //edge filtering would copy the whole adjacency array.
+    repair_handle.set_vb_edge_filtering(false);
+    repair_handle.set_vertex_list(worklist, worklist_size);
+
+    GraphColor_VB<HandleType, lno_row_view_t_, lno_nnz_view_t_> gc(nv, ne, xadj, adj, &repair_handle);
+    gc.color_graph(colors, num_phases);
+    return worklist_size;
+  }
+
+  /**
+   * Uncolors the candidate vertices that have a neighbor with the same color, and adds
+   * them to the worklist. The compare-exchange makes sure that a vertex is added once.
+   */
+  template <typename vertex_view_t>
+  struct functorUncolorConflicts{
+    nnz_lno_t nv;
+    nnz_lno_t num_old_vertices;
+    const_lno_row_view_t xadj;
+    const_lno_nnz_view_t adj;
+    color_view_type colors;
+    vertex_view_t candidates;
+    bool use_candidates;
+    nnz_lno_temp_work_view_t worklist;
+    single_dim_index_view_type worklist_length;
+
+    functorUncolorConflicts(
+        nnz_lno_t nv_,
+        nnz_lno_t num_old_vertices_,
+        const_lno_row_view_t xadj_,
+        const_lno_nnz_view_t adj_,
+        color_view_type colors_,
+        vertex_view_t candidates_,
+        bool use_candidates_,
+        nnz_lno_temp_work_view_t worklist_,
+        single_dim_index_view_type worklist_length_):
+      nv(nv_), num_old_vertices(num_old_vertices_), xadj(xadj_), adj(adj_), colors(colors_),
+      candidates(candidates_), use_candidates(use_candidates_),
+      worklist(worklist_), worklist_length(worklist_length_){}
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const nnz_lno_t ii) const {
+      const nnz_lno_t i = use_candidates ? nnz_lno_t(candidates(ii)) : ii;
+      //new vertices are added separately.
+      if (i < 0 || i >= num_old_vertices) return;
+      const color_t my_color = colors(i);
+      bool conflict = (my_color == 0);
+      const size_type nbegin = xadj(i);
+      const size_type nend = xadj(i + 1);
+      for (size_type j = nbegin; !conflict && j < nend; ++j){
+        const nnz_lno_t n = adj(j);
+        if (n == i || n >= nv) continue;
+        conflict = (colors(n) == my_color);
+      }
+      if (!conflict) return;
+      if (my_color == 0 || Kokkos::atomic_compare_exchange(&colors(i), my_color, color_t(0)) == my_color){
+        const nnz_lno_t k = Kokkos::atomic_fetch_add(&worklist_length(), nnz_lno_t(1));
+        worklist(k) = i;
+      }
+    }
+  };
+
+  struct functorAppendNewVertices{
+    nnz_lno_t num_old_vertices;
+    nnz_lno_t offset;
+    nnz_lno_temp_work_view_t worklist;
+
+    functorAppendNewVertices(nnz_lno_t num_old_vertices_, nnz_lno_t offset_, nnz_lno_temp_work_view_t worklist_):
+      num_old_vertices(num_old_vertices_), offset(offset_), worklist(worklist_){}
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const nnz_lno_t ii) const {
+      worklist(offset + ii) = num_old_vertices + ii;
+    }
+  };
+};  // class GraphRecolor
+
 }
 }
 
@@ -0,0 +1,359 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+/// \file KokkosSparse_DeltaCrsMatrix.hpp
+/// \brief Local sparse matrix interface
+///
+/// This file provides KokkosSparse::Experimental::DeltaCrsMatrix.
+/// This implements a local (no MPI) sparse matrix stored in
+/// compressed row storage with 16-bit, delta-encoded column indices.
+
+#ifndef KOKKOS_SPARSE_DELTACRSMATRIX_HPP_
+#define KOKKOS_SPARSE_DELTACRSMATRIX_HPP_
+
+#include "Kokkos_Core.hpp"
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+
+namespace KokkosSparse {
+
+namespace Experimental {
+
+namespace Impl {
+
+// Per row block: copy the row offsets, compute the base column, and
+// count the entries that go to the 16-bit deltas or, if the block's
+// column span does not fit in 16 bits, to the full-width escape array.
+template<class CrsMatrixType, class DeltaCrsMatrixType>
+struct DeltaCrsCountFunctor {
+  typedef typename DeltaCrsMatrixType::ordinal_type ordinal_type;
+  typedef typename DeltaCrsMatrixType::size_type    size_type;
+
+  CrsMatrixType A;
+  DeltaCrsMatrixType D;
+
+  DeltaCrsCountFunctor (const CrsMatrixType& A_, const DeltaCrsMatrixType& D_) : A (A_), D (D_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type block) const
+  {
+    const ordinal_type first = block * D.blockRows ();
+    const ordinal_type last  = (first + D.blockRows () < D.numRows ()) ? first + D.blockRows () : D.numRows ();
+    for (ordinal_type i = first; i < last; ++i) {
+      D.row_map(i) = A.graph.row_map(i);
+    }
+    if (last == D.numRows ()) {
+      D.row_map(last) = A.graph.row_map(last);
+    }
+
+    const size_type k0 = A.graph.row_map(first);
+    const size_type k1 = A.graph.row_map(last);
+    ordinal_type lo = 0, hi = 0;
+    if (k1 > k0) {
+      lo = hi = A.graph.entries(k0);
+      for (size_type k = k0 + 1; k < k1; ++k) {
+        const ordinal_type c = A.graph.entries(k);
+        if (c < lo) lo = c;
+        if (c > hi) hi = c;
+      }
+    }
+    const bool wide = (static_cast<uint64_t> (hi - lo) > DeltaCrsMatrixType::max_delta);
+    D.block_base(block) = lo;
+    D.delta_ptr(block)  = wide ? size_type (0) : k1 - k0;
+    D.wide_ptr(block)   = wide ? k1 - k0 : size_type (0);
+  }
+};
+
+// Per row block: write the entries as deltas from the block's base
+// column, or as full column indices for wide blocks.
+template<class CrsMatrixType, class DeltaCrsMatrixType>
+struct DeltaCrsFillFunctor {
+  typedef typename DeltaCrsMatrixType::ordinal_type ordinal_type;
+  typedef typename DeltaCrsMatrixType::size_type    size_type;
+  typedef typename DeltaCrsMatrixType::delta_type   delta_type;
+
+  CrsMatrixType A;
+  DeltaCrsMatrixType D;
+
+  DeltaCrsFillFunctor (const CrsMatrixType& A_, const DeltaCrsMatrixType& D_) : A (A_), D (D_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type block) const
+  {
+    const ordinal_type first = block * D.blockRows ();
+    const ordinal_type last  = (first + D.blockRows () < D.numRows ()) ? first + D.blockRows () : D.numRows ();
+    const size_type k0 = A.graph.row_map(first);
+    const size_type k1 = A.graph.row_map(last);
+    if (D.isWideBlock (block)) {
+      const size_type dst = D.wide_ptr(block);
+      for (size_type k = k0; k < k1; ++k) {
+        D.wide_entries(dst + (k - k0)) = A.graph.entries(k);
+      }
+    }
+    else {
+      const size_type dst = D.delta_ptr(block);
+      const ordinal_type base = D.block_base(block);
+      for (size_type k = k0; k < k1; ++k) {
+        D.deltas(dst + (k - k0)) = static_cast<delta_type> (A.graph.entries(k) - base);
+      }
+    }
+  }
+};
+
+// Number of row blocks with a nonzero escape count.
+template<class CountView, class OrdinalType>
+struct DeltaCrsWideBlocksFunctor {
+  CountView wide_count;
+
+  DeltaCrsWideBlocksFunctor (const CountView& wide_count_) : wide_count (wide_count_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OrdinalType b, OrdinalType& n) const
+  {
+    if (wide_count(b) > 0) ++n;
+  }
+};
+
+} // namespace Impl
+
+/// \class DeltaCrsMatrix
+/// \brief Compressed row storage with 16-bit delta-encoded column indices.
+/// \tparam ScalarType The type of entries in the sparse matrix.
+/// \tparam OrdinalType The type of column indices in the sparse matrix.
+/// \tparam Device The Kokkos Device type.
+/// \tparam SizeType The type of row offsets in the sparse matrix.
+///
+/// Rows are grouped in blocks of blockRows() consecutive rows.  Each
+/// block stores a base column (the smallest column index in the
+/// block), and each entry of the block stores its column index as a
+/// 16-bit offset from that base.  Blocks whose columns span more than
+/// 65535 (e.g. rows with a far off-diagonal coupling) take the escape
+/// path and store full-width column indices in wide_entries instead.
+/// For banded or well-ordered matrices almost all blocks are narrow,
+/// which halves (32-bit ordinals) or quarters (64-bit ordinals) the
+/// index traffic of SpMV.
+///
+/// row_map and values are laid out exactly as in the source CrsMatrix;
+/// values is shared with it, so changing the values of the CrsMatrix
+/// updates this matrix as well.  The entries of row i of block b are at
+/// positions row_map(i) - row_map(b*blockRows()) + delta_ptr(b) of
+/// deltas, or + wide_ptr(b) of wide_entries if isWideBlock(b).
+template<class ScalarType,
+         class OrdinalType,
+         class Device,
+         class SizeType = typename Kokkos::ViewTraits<OrdinalType*, Device, void, void>::size_type>
+class DeltaCrsMatrix {
+public:
+  //! Type of the matrix's execution space.
+  typedef typename Device::execution_space execution_space;
+  //! Type of the matrix's memory space.
+  typedef typename Device::memory_space memory_space;
+  //! Canonical device type
+  typedef Kokkos::Device<execution_space, memory_space> device_type;
+
+  //! Type of each value in the matrix.
+  typedef ScalarType value_type;
+  //! Type of each (column) index in the matrix.
+  typedef OrdinalType ordinal_type;
+  //! Type of the row offsets.
+  typedef SizeType size_type;
+  //! Type of the encoded column offsets.
+  typedef uint16_t delta_type;
+  //! Nonconst version of the type of each value in the matrix.
+  typedef typename std::remove_const<ScalarType>::type non_const_value_type;
+  //! Nonconst version of the type of column indices in the matrix.
+  typedef typename std::remove_const<OrdinalType>::type non_const_ordinal_type;
+  //! Nonconst version of the type of row offsets.
+  typedef typename std::remove_const<SizeType>::type non_const_size_type;
+
+  //! Type of the row offsets.
+  typedef Kokkos::View<size_type*, Kokkos::LayoutLeft, device_type> row_map_type;
+  //! Type of the values; the same as CrsMatrix's.
+  typedef Kokkos::View<value_type*, Kokkos::LayoutRight, device_type> values_type;
+  //! Type of the block base columns and full-width column indices.
+  typedef Kokkos::View<ordinal_type*, Kokkos::LayoutRight, device_type> ordinal_view_type;
+  //! Type of the encoded column offsets.
+  typedef Kokkos::View<delta_type*, Kokkos::LayoutRight, device_type> delta_view_type;
+
+  //! Largest column span a narrow block can encode.
+  static constexpr uint64_t max_delta = 65535;
+
+  //! Row offsets into values, length numRows()+1.
+  row_map_type row_map;
+  //! Base column of each row block.
+  ordinal_view_type block_base;
+  //! Offset of each block's entries in deltas, length numBlocks()+1.
+  row_map_type delta_ptr;
+  //! Offset of each block's entries in wide_entries, length numBlocks()+1.
+  row_map_type wide_ptr;
+  //! Column offsets from the block base for narrow blocks.
+  delta_view_type deltas;
+  //! Full column indices for wide blocks.
+  ordinal_view_type wide_entries;
+  //! The values, shared with the source CrsMatrix.
+  values_type values;
+
+  //! Default constructor; constructs an empty sparse matrix.
+  DeltaCrsMatrix () :
+    numRows_ (0), numCols_ (0), nnz_ (0), blockRows_ (1), numWideBlocks_ (0)
+  {}
+
+  /// \brief Construct from a CrsMatrix.
+  ///
+  /// Two parallel passes over the row blocks of A (count, then fill)
+  /// separated by a prefix sum; no data goes through the host except
+  /// the total sizes.
+  ///
+  /// \param label [in] The sparse matrix's label.
+  /// \param A [in] The input matrix.
+  /// \param blockRows [in] Number of consecutive rows sharing a base
+  ///   column.  Larger blocks have less metadata per nonzero, but a
+  ///   wider column span and thus a higher chance of taking the
+  ///   escape path.
+  template<typename SType,
+           typename OType,
+           class DType,
+           class MTType,
+           typename IType>
+  DeltaCrsMatrix (const std::string& label,
+                  const KokkosSparse::CrsMatrix<SType, OType, DType, MTType, IType>& A,
+                  const OrdinalType blockRows = 8) :
+    values (A.values),
+    numRows_ (A.numRows ()), numCols_ (A.numCols ()), nnz_ (A.nnz ()),
+    blockRows_ (blockRows), numWideBlocks_ (0)
+  {
+    if (blockRows_ < 1) {
+      std::ostringstream os;
+      os << "KokkosSparse::Experimental::DeltaCrsMatrix: block size " << blockRows_
+         << " must be positive.";
+      throw std::invalid_argument (os.str ());
+    }
+
+    const ordinal_type nblocks = numBlocks ();
+    row_map    = row_map_type (Kokkos::ViewAllocateWithoutInitializing (label + " row_map"), numRows_ + 1);
+    block_base = ordinal_view_type (Kokkos::ViewAllocateWithoutInitializing (label + " block_base"), nblocks);
+    delta_ptr  = row_map_type (label + " delta_ptr", nblocks + 1);
+    wide_ptr   = row_map_type (label + " wide_ptr", nblocks + 1);
+    if (numRows_ == 0) {
+      Kokkos::deep_copy (row_map, 0);
+      return;
+    }
+
+    typedef KokkosSparse::CrsMatrix<SType, OType, DType, MTType, IType> crs_matrix_type;
+    Kokkos::parallel_for ("KokkosSparse::DeltaCrsMatrix::count",
+                          Kokkos::RangePolicy<execution_space> (0, nblocks),
+                          Impl::DeltaCrsCountFunctor<crs_matrix_type, DeltaCrsMatrix> (A, *this));
+
+    // Blocks are wide iff they have entries in wide_ptr; count them
+    // before the prefix sum turns the counts into offsets.
+    ordinal_type nwide = 0;
+    Kokkos::parallel_reduce ("KokkosSparse::DeltaCrsMatrix::count_wide",
+                             Kokkos::RangePolicy<execution_space> (0, nblocks),
+                             Impl::DeltaCrsWideBlocksFunctor<row_map_type, ordinal_type> (wide_ptr), nwide);
+    numWideBlocks_ = nwide;
+
+    KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<row_map_type, execution_space> (nblocks + 1, delta_ptr);
+    KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<row_map_type, execution_space> (nblocks + 1, wide_ptr);
+
+    size_type ndeltas = 0, nwide_entries = 0;
+    Kokkos::deep_copy (ndeltas, Kokkos::subview (delta_ptr, nblocks));
+    Kokkos::deep_copy (nwide_entries, Kokkos::subview (wide_ptr, nblocks));
+    deltas       = delta_view_type (Kokkos::ViewAllocateWithoutInitializing (label + " deltas"), ndeltas);
+    wide_entries = ordinal_view_type (Kokkos::ViewAllocateWithoutInitializing (label + " wide_entries"), nwide_entries);
+
+    Kokkos::parallel_for ("KokkosSparse::DeltaCrsMatrix::fill",
+                          Kokkos::RangePolicy<execution_space> (0, nblocks),
+                          Impl::DeltaCrsFillFunctor<crs_matrix_type, DeltaCrsMatrix> (A, *this));
+  }
+
+  //! The number of rows in the sparse matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numRows () const { return numRows_; }
+  //! The number of columns in the sparse matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numCols () const { return numCols_; }
+  //! The number of stored entries.
+  KOKKOS_INLINE_FUNCTION size_type nnz () const { return nnz_; }
+  //! The number of rows per block.
+  KOKKOS_INLINE_FUNCTION ordinal_type blockRows () const { return blockRows_; }
+  //! The number of row blocks.
+  KOKKOS_INLINE_FUNCTION ordinal_type numBlocks () const { return (numRows_ + blockRows_ - 1) / blockRows_; }
+  //! Whether block b stores full-width column indices.
+  KOKKOS_INLINE_FUNCTION bool isWideBlock (const ordinal_type b) const { return wide_ptr(b + 1) > wide_ptr(b); }
+  //! The number of blocks that take the escape path.
+  ordinal_type numWideBlocks () const { return numWideBlocks_; }
+
+  /// \brief Bytes of column index data (deltas, escaped indices and
+  ///   per-block metadata), excluding row_map and values.
+  ///
+  /// Compare with nnz()*sizeof(ordinal_type) for a CrsMatrix.
+  size_t indexBytes () const {
+    return deltas.extent (0) * sizeof (delta_type) +
+           wide_entries.extent (0) * sizeof (ordinal_type) +
+           block_base.extent (0) * sizeof (ordinal_type) +
+           (delta_ptr.extent (0) + wide_ptr.extent (0)) * sizeof (size_type);
+  }
+
+private:
+  ordinal_type numRows_;
+  ordinal_type numCols_;
+  size_type nnz_;
+  ordinal_type blockRows_;
+  ordinal_type numWideBlocks_;
+};
+
+/// \brief Convert a CrsMatrix to delta-encoded CRS.
+template<class DeltaCrsMatrixType, class CrsMatrixType>
+DeltaCrsMatrixType crs_to_delta_crs (const CrsMatrixType& A,
+                                     const typename DeltaCrsMatrixType::ordinal_type blockRows = 8)
+{
+  return DeltaCrsMatrixType ("DeltaCrsMatrix", A, blockRows);
+}
+
+} // namespace Experimental
+} // namespace KokkosSparse
+
+#endif // KOKKOS_SPARSE_DELTACRSMATRIX_HPP_
@@ -0,0 +1,375 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+/// \file KokkosSparse_SellCMatrix.hpp
+/// \brief Local sparse matrix interface
+///
+/// This file provides KokkosSparse::Experimental::SellCMatrix.  This
+/// implements a local (no MPI) sparse matrix stored in sliced ELLPACK
+/// ("SELL-C-sigma") format.
+
+#ifndef KOKKOS_SPARSE_SELLCMATRIX_HPP_
+#define KOKKOS_SPARSE_SELLCMATRIX_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "KokkosSparse_CrsMatrix.hpp"
+
+namespace KokkosSparse {
+
+namespace Experimental {
+
+namespace Impl {
+
+// Scatter the entries of a CrsMatrix into the padded, column-major
+// chunks of a SellCMatrix.  One work item per (padded) sorted row.
+template<class CrsMatrixType, class SellCMatrixType>
+struct SellCFillFunctor {
+  typedef typename SellCMatrixType::ordinal_type ordinal_type;
+  typedef typename SellCMatrixType::size_type    size_type;
+  typedef typename SellCMatrixType::value_type   value_type;
+
+  CrsMatrixType A;
+  SellCMatrixType S;
+
+  SellCFillFunctor (const CrsMatrixType& A_, const SellCMatrixType& S_) : A (A_), S (S_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type pos) const
+  {
+    const ordinal_type C     = S.chunkSize ();
+    const ordinal_type chunk = pos / C;
+    const ordinal_type lane  = pos % C;
+    const size_type base     = S.chunk_ptr(chunk);
+    const ordinal_type width = S.chunk_len(chunk);
+
+    ordinal_type row_length = 0;
+    size_type row_start = 0;
+    if (pos < S.numRows ()) {
+      const ordinal_type row = S.row_perm(pos);
+      row_start  = A.graph.row_map(row);
+      row_length = static_cast<ordinal_type> (A.graph.row_map(row + 1) - row_start);
+    }
+
+    // Padding reuses the last column of the row so that x stays in cache.
+    // Kernels skip it by row_len, so pad_col only has to be a valid column.
+    ordinal_type pad_col = 0;
+    for (ordinal_type j = 0; j < width; ++j) {
+      const size_type dst = base + static_cast<size_type> (j) * C + lane;
+      if (j < row_length) {
+        pad_col = A.graph.entries(row_start + j);
+        S.entries(dst) = pad_col;
+        S.values(dst)  = A.values(row_start + j);
+      } else {
+        S.entries(dst) = pad_col;
+        S.values(dst)  = Kokkos::Details::ArithTraits<value_type>::zero ();
+      }
+    }
+  }
+};
+
+} // namespace Impl
+
+/// \class SellCMatrix
+/// \brief Sliced ELLPACK (SELL-C-sigma) implementation of a sparse matrix.
+/// \tparam ScalarType The type of entries in the sparse matrix.
+/// \tparam OrdinalType The type of column indices in the sparse matrix.
+/// \tparam Device The Kokkos Device type.
+/// \tparam SizeType The type of the chunk offsets.
+///
+/// Rows are grouped in chunks of C consecutive (sorted) rows.  Each
+/// chunk is stored as a dense, column-major C x width block, where
+/// width is the length of the longest row in the chunk; shorter rows
+/// are padded with explicit zeros, which SpMV masks out by row_len.
+/// Within windows of sigma rows, rows are sorted by decreasing length
+/// before chunking, which reduces the padding.  The row_perm array maps sorted positions back to the
+/// original row indices and row_len keeps the unpadded row lengths.
+///
+/// Element j of the row in lane r of chunk c is stored at
+/// chunk_ptr(c) + j*C + r, so the C rows of a chunk can be processed
+/// with unit-stride SIMD loads on CPUs and coalesced loads on GPUs.
+template<class ScalarType,
+         class OrdinalType,
+         class Device,
+         class SizeType = typename Kokkos::ViewTraits<OrdinalType*, Device, void, void>::size_type>
+class SellCMatrix {
+public:
+  //! Type of the matrix's execution space.
+  typedef typename Device::execution_space execution_space;
+  //! Type of the matrix's memory space.
+  typedef typename Device::memory_space memory_space;
+  //! Canonical device type
+  typedef Kokkos::Device<execution_space, memory_space> device_type;
+
+  //! Type of each value in the matrix.
+  typedef ScalarType value_type;
+  //! Type of each (column) index in the matrix.
+  typedef OrdinalType ordinal_type;
+  //! Type of the chunk offsets.
+  typedef SizeType size_type;
+  //! Nonconst version of the type of each value in the matrix.
+  typedef typename std::remove_const<ScalarType>::type non_const_value_type;
+  //! Nonconst version of the type of column indices in the matrix.
+  typedef typename std::remove_const<OrdinalType>::type non_const_ordinal_type;
+  //! Nonconst version of the type of chunk offsets.
+  typedef typename std::remove_const<SizeType>::type non_const_size_type;
+
+  //! Type of the padded column indices.
+  typedef Kokkos::View<ordinal_type*, Kokkos::LayoutRight, device_type> index_type;
+  //! Type of the padded values.
+  typedef Kokkos::View<value_type*, Kokkos::LayoutRight, device_type> values_type;
+  //! Type of the chunk offsets.
+  typedef Kokkos::View<size_type*, Kokkos::LayoutRight, device_type> chunk_ptr_type;
+  //! Type of the chunk widths and of the row permutation.
+  typedef Kokkos::View<ordinal_type*, Kokkos::LayoutRight, device_type> ordinal_view_type;
+
+  //! Offset of the first entry of each chunk, length numChunks()+1.
+  chunk_ptr_type chunk_ptr;
+  //! Width (longest row length) of each chunk.
+  ordinal_view_type chunk_len;
+  //! Original row index of each sorted row.
+  ordinal_view_type row_perm;
+  //! Unpadded length of each sorted row.
+  ordinal_view_type row_len;
+  //! Padded column indices.
+  index_type entries;
+  //! Padded values.
+  values_type values;
+
+  //! Default constructor; constructs an empty sparse matrix.
+  SellCMatrix () :
+    numRows_ (0), numCols_ (0), nnz_ (0), C_ (1), sigma_ (1)
+  {}
+
+  /// \brief Construct from a CrsMatrix.
+  ///
+  /// The chunk layout (row permutation, chunk widths and offsets) is
+  /// computed on host from the row map only; the entries and values
+  /// are then scattered into the chunks in parallel on the device.
+  ///
+  /// \param label [in] The sparse matrix's label.
+  /// \param A [in] The input matrix.
+  /// \param chunkSize [in] Chunk height C; a power of two in [1, 64].
+  /// \param sortingWindow [in] Sorting scope sigma.  1 disables
+  ///   sorting; otherwise it is rounded up to a multiple of C.
+  template<typename SType,
+           typename OType,
+           class DType,
+           class MTType,
+           typename IType>
+  SellCMatrix (const std::string& label,
+               const KokkosSparse::CrsMatrix<SType, OType, DType, MTType, IType>& A,
+               const OrdinalType chunkSize,
+               const OrdinalType sortingWindow = 1) :
+    numRows_ (A.numRows ()), numCols_ (A.numCols ()), nnz_ (A.nnz ()),
+    C_ (chunkSize), sigma_ (sortingWindow)
+  {
+    if ((C_ < 1) || (C_ > 64) || ((C_ & (C_ - 1)) != 0)) {
+      std::ostringstream os;
+      os << "KokkosSparse::Experimental::SellCMatrix: chunk size " << C_
+         << " must be a power of two between 1 and 64.";
+      throw std::invalid_argument (os.str ());
+    }
+    if (sigma_ < 1) sigma_ = 1;
+    if (sigma_ > 1) sigma_ = ((sigma_ + C_ - 1) / C_) * C_;
+
+    const ordinal_type nchunks = numChunks ();
+
+    auto h_row_map = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), A.graph.row_map);
+    std::vector<ordinal_type> lengths (numRows_);
+    for (ordinal_type i = 0; i < numRows_; ++i) {
+      lengths[i] = static_cast<ordinal_type> (h_row_map(i + 1) - h_row_map(i));
+    }
+
+    // Sort rows by decreasing length within each sigma window
+    row_perm = ordinal_view_type (label + " row_perm", numRows_);
+    row_len  = ordinal_view_type (label + " row_len", numRows_);
+    auto h_perm    = Kokkos::create_mirror_view (row_perm);
+    auto h_row_len = Kokkos::create_mirror_view (row_len);
+    std::vector<ordinal_type> perm (numRows_);
+    std::iota (perm.begin (), perm.end (), ordinal_type (0));
+    if (sigma_ > 1) {
+      for (ordinal_type w = 0; w < numRows_; w += sigma_) {
+        const ordinal_type wend = std::min (w + sigma_, numRows_);
+        std::stable_sort (perm.begin () + w, perm.begin () + wend,
+                          [&] (const ordinal_type a, const ordinal_type b) {
+                            return lengths[a] > lengths[b];
+                          });
+      }
+    }
+    for (ordinal_type i = 0; i < numRows_; ++i) {
+      h_perm(i) = perm[i];
+      h_row_len(i) = lengths[perm[i]];
+    }
+
+    chunk_ptr = chunk_ptr_type (label + " chunk_ptr", nchunks + 1);
+    chunk_len = ordinal_view_type (label + " chunk_len", nchunks);
+    auto h_chunk_ptr = Kokkos::create_mirror_view (chunk_ptr);
+    auto h_chunk_len = Kokkos::create_mirror_view (chunk_len);
+    h_chunk_ptr(0) = 0;
+    for (ordinal_type c = 0; c < nchunks; ++c) {
+      ordinal_type width = 0;
+      for (ordinal_type r = c * C_; r < std::min ((c + 1) * C_, numRows_); ++r) {
+        width = std::max (width, lengths[perm[r]]);
+      }
+      h_chunk_len(c) = width;
+      h_chunk_ptr(c + 1) = h_chunk_ptr(c) + static_cast<size_type> (width) * C_;
+    }
+    Kokkos::deep_copy (row_perm, h_perm);
+    Kokkos::deep_copy (row_len, h_row_len);
+    Kokkos::deep_copy (chunk_ptr, h_chunk_ptr);
+    Kokkos::deep_copy (chunk_len, h_chunk_len);
+
+    const size_type nstored = h_chunk_ptr(nchunks);
+    entries = index_type (Kokkos::ViewAllocateWithoutInitializing (label + " entries"), nstored);
+    values  = values_type (Kokkos::ViewAllocateWithoutInitializing (label + " values"), nstored);
+
+    typedef KokkosSparse::CrsMatrix<SType, OType, DType, MTType, IType> crs_matrix_type;
+    Kokkos::parallel_for ("KokkosSparse::SellCMatrix::fill",
+                          Kokkos::RangePolicy<execution_space> (0, nchunks * C_),
+                          Impl::SellCFillFunctor<crs_matrix_type, SellCMatrix> (A, *this));
+  }
+
+  //! The number of rows in the sparse matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numRows () const { return numRows_; }
+  //! The number of columns in the sparse matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numCols () const { return numCols_; }
+  //! The number of structural nonzeros, not counting the padding.
+  KOKKOS_INLINE_FUNCTION size_type nnz () const { return nnz_; }
+  //! The number of stored entries, including the padding.
+  KOKKOS_INLINE_FUNCTION size_type numStoredEntries () const { return values.extent (0); }
+  //! The chunk height C.
+  KOKKOS_INLINE_FUNCTION ordinal_type chunkSize () const { return C_; }
+  //! The sorting window sigma.
+  KOKKOS_INLINE_FUNCTION ordinal_type sortingWindow () const { return sigma_; }
+  //! The number of chunks.
+  KOKKOS_INLINE_FUNCTION ordinal_type numChunks () const { return (numRows_ + C_ - 1) / C_; }
+
+  /// \brief Ratio of stored entries to structural nonzeros.
+  ///
+  /// 1 means no padding; use it to pick C and sigma for a matrix.
+  double paddingRatio () const {
+    return (nnz_ == 0) ? 1.0 : static_cast<double> (numStoredEntries ()) / static_cast<double> (nnz_);
+  }
+
+private:
+  ordinal_type numRows_;
+  ordinal_type numCols_;
+  size_type nnz_;
+  ordinal_type C_;
+  ordinal_type sigma_;
+};
+
+/// \brief Convert a CrsMatrix to SELL-C-sigma format.
+template<class SellCMatrixType, class CrsMatrixType>
+SellCMatrixType crs_to_sellc (const CrsMatrixType& A,
+                              const typename SellCMatrixType::ordinal_type chunkSize,
+                              const typename SellCMatrixType::ordinal_type sortingWindow = 1)
+{
+  return SellCMatrixType ("SellCMatrix", A, chunkSize, sortingWindow);
+}
+
+/// \brief Convert a SellCMatrix back to a CrsMatrix, dropping the
+///   padding and undoing the row permutation.
+///
+/// Column indices keep the order they had in the original CrsMatrix.
+template<class CrsMatrixType, class SellCMatrixType>
+CrsMatrixType sellc_to_crs (const SellCMatrixType& S)
+{
+  typedef typename CrsMatrixType::row_map_type::non_const_type row_map_type;
+  typedef typename CrsMatrixType::index_type::non_const_type   entries_type;
+  typedef typename CrsMatrixType::values_type::non_const_type  values_type;
+  typedef typename CrsMatrixType::non_const_size_type          offset_type;
+  typedef typename SellCMatrixType::ordinal_type               ordinal_type;
+  typedef typename SellCMatrixType::size_type                  size_type;
+
+  auto h_chunk_ptr = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), S.chunk_ptr);
+  auto h_perm      = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), S.row_perm);
+  auto h_row_len   = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), S.row_len);
+  auto h_entries   = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), S.entries);
+  auto h_values    = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), S.values);
+
+  const ordinal_type nrows = S.numRows ();
+  const ordinal_type C = S.chunkSize ();
+
+  std::vector<ordinal_type> lengths (nrows, 0);
+  for (ordinal_type pos = 0; pos < nrows; ++pos) {
+    lengths[h_perm(pos)] = h_row_len(pos);
+  }
+
+  row_map_type row_map ("SellC to CRS row map", nrows + 1);
+  auto h_row_map = Kokkos::create_mirror_view (row_map);
+  h_row_map(0) = 0;
+  for (ordinal_type i = 0; i < nrows; ++i) h_row_map(i + 1) = h_row_map(i) + lengths[i];
+  const offset_type nnz = h_row_map(nrows);
+
+  entries_type entries (Kokkos::ViewAllocateWithoutInitializing ("SellC to CRS entries"), nnz);
+  values_type  values  (Kokkos::ViewAllocateWithoutInitializing ("SellC to CRS values"), nnz);
+  auto h_out_entries = Kokkos::create_mirror_view (entries);
+  auto h_out_values  = Kokkos::create_mirror_view (values);
+  for (ordinal_type pos = 0; pos < nrows; ++pos) {
+    const ordinal_type c = pos / C, lane = pos % C;
+    const ordinal_type row = h_perm(pos);
+    for (ordinal_type j = 0; j < lengths[row]; ++j) {
+      const size_type src = h_chunk_ptr(c) + static_cast<size_type> (j) * C + lane;
+      h_out_entries(h_row_map(row) + j) = h_entries(src);
+      h_out_values(h_row_map(row) + j)  = h_values(src);
+    }
+  }
+  Kokkos::deep_copy (row_map, h_row_map);
+  Kokkos::deep_copy (entries, h_out_entries);
+  Kokkos::deep_copy (values, h_out_values);
+
+  return CrsMatrixType ("CrsMatrix", nrows, S.numCols (), nnz, values, row_map, entries);
+}
+
+} // namespace Experimental
+} // namespace KokkosSparse
+
+#endif // KOKKOS_SPARSE_SELLCMATRIX_HPP_
@@ -0,0 +1,288 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+/// \file KokkosSparse_matrix_powers.hpp
+/// \brief Matrix powers kernel for s-step Krylov methods
+///
+/// KokkosSparse::Experimental::matrix_powers computes the Krylov basis
+/// [x, p_1(A) x, ..., p_s(A) x] of a square CrsMatrix A, where
+/// p_k(A) = (A - theta_{k-1} I) ... (A - theta_0 I) (Newton basis; the
+/// monomial basis when no shifts are given).  Chebyshev-like bases are
+/// obtained by passing Leja-ordered Chebyshev nodes as the shifts.
+
+#ifndef KOKKOSSPARSE_MATRIX_POWERS_HPP_
+#define KOKKOSSPARSE_MATRIX_POWERS_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+#include "KokkosSparse_matrix_powers_impl.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace KokkosSparse {
+namespace Experimental {
+
+/// \class MatrixPowersPlan
+/// \brief Row tiling of a CrsMatrix for matrix_powers.
+///
+/// The rows of A are cut into tiles small enough for the tile's rows
+/// of A to stay in cache while all s powers are applied to them.
+/// Computing s levels of a tile needs the previous levels on the rows
+/// the tile depends on (its ghost zone); those are recomputed by the
+/// tile itself, so tiles run independently.  The plan depends only on
+/// the graph of A and on s: build it once and reuse it for every
+/// basis computed with the same matrix.
+template<class AMatrix>
+class MatrixPowersPlan {
+public:
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_size_type    size_type;
+  typedef typename AMatrix::device_type            device_type;
+  typedef typename AMatrix::execution_space        execution_space;
+  typedef Kokkos::View<ordinal_type*, device_type> ordinal_view_t;
+  typedef Kokkos::View<size_type*, device_type>    size_view_t;
+
+  //! Start of each tile's row list in local_rows (numTiles()+1 entries).
+  size_view_t tile_ptr;
+  //! Number of listed rows on which level k is computed, at tile*s + k-1.
+  ordinal_view_t level_count;
+  //! Global row index of each listed row, own rows first.
+  ordinal_view_t local_rows;
+  //! Start of each listed row's entries in local_cols.
+  size_view_t local_col_ptr;
+  //! Position of each entry's column in the tile's row list, or -1.
+  ordinal_view_t local_cols;
+
+  /// \param A [in] Square matrix whose graph is tiled.
+  /// \param s [in] Number of powers, at least 1.
+  /// \param tileRows [in] Rows per tile; <= 0 picks a size targeting
+  ///   about 16k entries (host) or 4k entries (GPU) per tile.
+  MatrixPowersPlan (const AMatrix& A, const int s, ordinal_type tileRows = 0) :
+    s_ (s), nrows_ (A.numRows ()), nnz_ (A.nnz ()), tileRows_ (tileRows), numListed_ (0)
+  {
+    if (s < 1) {
+      throw std::invalid_argument ("MatrixPowersPlan: the number of powers must be at least 1.");
+    }
+    if (A.numRows () != A.numCols ()) {
+      std::ostringstream os;
+      os << "MatrixPowersPlan: A must be square, but is "
+         << A.numRows () << " x " << A.numCols () << ".";
+      throw std::invalid_argument (os.str ());
+    }
+    if (tileRows_ <= 0) {
+      const size_type target_nnz =
+        KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space> () ? 4096 : 16384;
+      const size_type nnz_per_row = nrows_ > 0 ? std::max<size_type> (1, nnz_ / nrows_) : 1;
+      tileRows_ = static_cast<ordinal_type> (std::max<size_type> (1, target_nnz / nnz_per_row));
+    }
+
+    auto row_map = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), A.graph.row_map);
+    auto entries = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), A.graph.entries);
+
+    std::vector<size_type> h_tile_ptr, h_local_col_ptr;
+    std::vector<ordinal_type> h_level_count, h_local_rows, h_local_cols;
+    KokkosSparse::Impl::matrix_powers_build_tiles
+      (row_map, entries, nrows_, s_, tileRows_,
+       h_tile_ptr, h_level_count, h_local_rows, h_local_col_ptr, h_local_cols);
+
+    tile_ptr      = to_device<size_view_t> ("MatrixPowers::tile_ptr", h_tile_ptr);
+    level_count   = to_device<ordinal_view_t> ("MatrixPowers::level_count", h_level_count);
+    local_rows    = to_device<ordinal_view_t> ("MatrixPowers::local_rows", h_local_rows);
+    local_col_ptr = to_device<size_view_t> ("MatrixPowers::local_col_ptr", h_local_col_ptr);
+    local_cols    = to_device<ordinal_view_t> ("MatrixPowers::local_cols", h_local_cols);
+    numListed_    = static_cast<size_type> (h_local_rows.size ());
+  }
+
+  int numPowers () const { return s_; }
+  ordinal_type numRows () const { return nrows_; }
+  size_type nnz () const { return nnz_; }
+  ordinal_type tileRows () const { return tileRows_; }
+  ordinal_type numTiles () const {
+    return static_cast<ordinal_type> (tile_ptr.extent(0) > 0 ? tile_ptr.extent(0) - 1 : 0);
+  }
+  //! Total number of listed rows, own and ghost, over all tiles.
+  size_type numListedRows () const { return numListed_; }
+  //! Listed rows per matrix row; 1 means no redundant work.
+  double redundancy () const {
+    return nrows_ > 0 ? static_cast<double> (numListed_) / nrows_ : 1.0;
+  }
+
+private:
+  template<class ViewType, class T>
+  static ViewType to_device (const std::string& label, const std::vector<T>& v) {
+    ViewType d (Kokkos::ViewAllocateWithoutInitializing (label), v.size ());
+    auto h = Kokkos::create_mirror_view (d);
+    for (size_t i = 0; i < v.size (); ++i)
+      h(i) = v[i];
+    Kokkos::deep_copy (d, h);
+    return d;
+  }
+
+  int s_;
+  ordinal_type nrows_;
+  size_type nnz_;
+  ordinal_type tileRows_;
+  size_type numListed_;
+};
+
+/// \brief Compute the s-step Krylov basis
+///   V(:,0) = x, V(:,k) = (A - shifts(k-1) I) V(:,k-1), k = 1..s.
+///
+/// \param plan [in] Tiling of A, built with the same graph.
+/// \param A [in] The square sparse matrix.
+/// \param x [in] Rank-1 starting vector.
+/// \param V [out] Rank-2 View with at least s+1 columns.
+/// \param shifts [in] Rank-1 View of s shifts, accessible from the
+///   execution space of A; empty for the monomial basis.  See
+///   matrix_powers_chebyshev_shifts for a Chebyshev-like basis.
+template <class AMatrix, class XVector, class VMultiVector, class ShiftView>
+void
+matrix_powers (const MatrixPowersPlan<AMatrix>& plan,
+               const AMatrix& A,
+               const XVector& x,
+               const VMultiVector& V,
+               const ShiftView& shifts)
+{
+  static_assert (static_cast<int> (XVector::rank) == 1,
+    "KokkosSparse::matrix_powers: x must have rank 1.");
+  static_assert (static_cast<int> (VMultiVector::rank) == 2,
+    "KokkosSparse::matrix_powers: V must have rank 2.");
+  static_assert (static_cast<int> (ShiftView::rank) == 1,
+    "KokkosSparse::matrix_powers: shifts must have rank 1.");
+
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename VMultiVector::non_const_value_type value_type;
+  typedef Kokkos::View<value_type*, typename VMultiVector::device_type> work_view_t;
+  typedef KokkosSparse::Impl::MatrixPowers_Functor<AMatrix, XVector, VMultiVector, ShiftView,
+                                                   MatrixPowersPlan<AMatrix>, work_view_t> functor_type;
+
+  const int s = plan.numPowers ();
+  if ((plan.numRows () != A.numRows ()) || (plan.nnz () != A.nnz ()) ||
+      (static_cast<size_t> (x.extent(0)) < static_cast<size_t> (A.numRows ())) ||
+      (static_cast<size_t> (V.extent(0)) < static_cast<size_t> (A.numRows ())) ||
+      (static_cast<int> (V.extent(1)) < s + 1) ||
+      (shifts.extent(0) != 0 && static_cast<int> (shifts.extent(0)) < s)) {
+    std::ostringstream os;
+    os << "KokkosSparse::matrix_powers: Dimensions do not match: "
+       << "plan: " << plan.numRows () << " rows, " << plan.nnz () << " entries, s = " << s
+       << ", A: " << A.numRows () << " x " << A.numCols () << " with " << A.nnz () << " entries"
+       << ", x: " << x.extent(0)
+       << ", V: " << V.extent(0) << " x " << V.extent(1)
+       << ", shifts: " << shifts.extent(0);
+    Kokkos::Impl::throw_runtime_exception (os.str ());
+  }
+  if (A.numRows () == 0) {
+    return;
+  }
+
+  work_view_t work (Kokkos::ViewAllocateWithoutInitializing ("MatrixPowers::work"), 2 * plan.numListedRows ());
+  functor_type func (A, x, V, shifts, plan, work);
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space> ()) {
+    int team_size = -1;
+    int vector_length = -1;
+    KokkosSparse::Impl::spmv_launch_parameters<execution_space>
+      (A.numRows (), A.nnz (), -1, team_size, vector_length);
+    Kokkos::parallel_for ("KokkosSparse::matrix_powers",
+                          Kokkos::TeamPolicy<execution_space> (plan.numTiles (), Kokkos::AUTO, vector_length),
+                          func);
+  }
+  else {
+    Kokkos::parallel_for ("KokkosSparse::matrix_powers",
+                          Kokkos::RangePolicy<execution_space, Kokkos::Schedule<Kokkos::Dynamic> > (0, plan.numTiles ()),
+                          func);
+  }
+}
+
+//! Monomial basis: V(:,k) = A^k x.
+template <class AMatrix, class XVector, class VMultiVector>
+void
+matrix_powers (const MatrixPowersPlan<AMatrix>& plan,
+               const AMatrix& A,
+               const XVector& x,
+               const VMultiVector& V)
+{
+  Kokkos::View<typename VMultiVector::non_const_value_type*, typename VMultiVector::device_type> no_shifts;
+  matrix_powers (plan, A, x, V, no_shifts);
+}
+
+/// \brief Fill shifts with the Leja-ordered Chebyshev nodes of
+///   [lambda_min, lambda_max], for a Chebyshev-like Newton basis.
+///
+/// [lambda_min, lambda_max] should enclose the (real) spectrum of A,
+/// e.g. from a few Lanczos or power iterations.  The number of shifts
+/// is shifts.extent(0), normally the s of the plan.
+template <class ShiftView>
+void
+matrix_powers_chebyshev_shifts (const ShiftView& shifts,
+                                const double lambda_min,
+                                const double lambda_max)
+{
+  static_assert (static_cast<int> (ShiftView::rank) == 1,
+    "KokkosSparse::matrix_powers_chebyshev_shifts: shifts must have rank 1.");
+  typedef typename ShiftView::non_const_value_type value_type;
+
+  if (lambda_max < lambda_min) {
+    std::ostringstream os;
+    os << "KokkosSparse::matrix_powers_chebyshev_shifts: empty interval ["
+       << lambda_min << ", " << lambda_max << "].";
+    throw std::invalid_argument (os.str ());
+  }
+  const int s = static_cast<int> (shifts.extent(0));
+  std::vector<double> nodes;
+  KokkosSparse::Impl::matrix_powers_leja_chebyshev_nodes (lambda_min, lambda_max, s, nodes);
+
+  auto h_shifts = Kokkos::create_mirror_view (shifts);
+  for (int k = 0; k < s; ++k)
+    h_shifts(k) = static_cast<value_type> (nodes[k]);
+  Kokkos::deep_copy (shifts, h_shifts);
+}
+
+} // namespace Experimental
+} // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_MATRIX_POWERS_HPP_
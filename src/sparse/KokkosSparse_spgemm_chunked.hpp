@@ -0,0 +1,208 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef _KOKKOSSPARSE_SPGEMM_CHUNKED_HPP
+#define _KOKKOSSPARSE_SPGEMM_CHUNKED_HPP
+
+#include <stdexcept>
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_spgemm_symbolic.hpp"
+#include "KokkosSparse_spgemm_numeric.hpp"
+#include "KokkosSparse_spgemm_chunked_impl.hpp"
+
+namespace KokkosSparse{
+
+namespace Experimental{
+
+/**
+ * \brief Computes C = A*B in batches of rows, for products whose output does not fit in memory.
+ * The rows of A are split so that an upper bound of the size of each batch of rows of C stays
+ * under handle->get_spgemm_handle()->set_chunk_memory_budget(); each batch then runs the
+ * symbolic and numeric phases of the algorithm of the spgemm handle (KKMEM by default).
+ * After each batch, callback(row_begin, row_end, row_mapC, entriesC, valuesC) is called with
+ * the rows [row_begin, row_end) of C, where row_mapC has row_end - row_begin + 1 entries and
+ * starts at 0. The batch is freed once the callback returns, so it must copy what it keeps.
+ * The spgemm handle must have been created. Returns the number of batches. The symbolic state
+ * left in the handle only describes the last batch, so the handle is marked as not symbolic-called:
+ * spgemm_symbolic must be called again before spgemm_numeric is used on the whole product.
+ * \param m: rows of A and C, n: columns of A and rows of B, k: columns of B and C.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t, typename b_scalar_view_t,
+          typename callback_t>
+size_t spgemm_chunked(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    typename KernelHandle::nnz_lno_t n,
+    typename KernelHandle::nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+    b_row_view_t row_mapB, b_nnz_view_t entriesB, b_scalar_view_t valuesB,
+    callback_t callback){
+
+  typedef Impl::SpgemmChunkTypes<KernelHandle> types;
+  typedef typename types::nnz_lno_t nnz_lno_t;
+
+  if (handle->get_spgemm_handle() == NULL){
+    throw std::runtime_error("KokkosSparse::spgemm_chunked: the spgemm handle has not been created.");
+  }
+
+  std::vector<nnz_lno_t> batches =
+      Impl::spgemm_chunked_row_batches(handle, m, k, row_mapA, entriesA, row_mapB);
+
+  for (size_t b = 0; b + 1 < batches.size(); ++b){
+    const nnz_lno_t row_begin = batches[b], row_end = batches[b + 1];
+    typename types::row_view_t batch_rowmapA, batch_rowmapC;
+    typename types::batch_nnz_view_t batch_entriesA;
+    typename types::batch_scalar_view_t batch_valuesA;
+
+    Impl::spgemm_chunk_symbolic(handle, row_begin, row_end, n, k,
+        row_mapA, entriesA, valuesA, row_mapB, entriesB,
+        batch_rowmapA, batch_entriesA, batch_valuesA, batch_rowmapC);
+
+    const size_t batch_nnz = handle->get_spgemm_handle()->get_c_nnz();
+    typename types::nnz_view_t batch_entriesC(
+        Kokkos::ViewAllocateWithoutInitializing("SpGEMM chunk entries C"), batch_nnz);
+    typename types::scalar_view_t batch_valuesC(
+        Kokkos::ViewAllocateWithoutInitializing("SpGEMM chunk values C"), batch_nnz);
+
+    spgemm_numeric(handle, row_end - row_begin, n, k,
+        batch_rowmapA, batch_entriesA, batch_valuesA, false,
+        row_mapB, entriesB, valuesB, false,
+        batch_rowmapC, batch_entriesC, batch_valuesC);
+
+    callback(row_begin, row_end, batch_rowmapC, batch_entriesC, batch_valuesC);
+  }
+  handle->get_spgemm_handle()->set_call_symbolic(false);
+  return batches.size() - 1;
+}
+
+}  // end namespace Experimental
+
+/**
+ * \brief Computes C = A*B in batches of rows sized to the chunk memory budget of the spgemm handle,
+ * see Experimental::spgemm_chunked. The rows of C are compacted into a single matrix: the pattern
+ * of all batches is computed first to allocate C, and each batch is then recomputed and multiplied
+ * directly into C, so at most C and one batch are allocated at a time.
+ * The spgemm handle must have been created. As in Experimental::spgemm_chunked, the handle is left
+ * marked as not symbolic-called.
+ */
+template <class KernelHandle, class AMatrix, class BMatrix, class CMatrix>
+size_t spgemm_chunked(KernelHandle& kh, const AMatrix& A, const BMatrix& B, CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+  using types        = Impl::SpgemmChunkTypes<KernelHandle>;
+  using nnz_lno_t    = typename types::nnz_lno_t;
+  using size_type    = typename types::size_type;
+  using MyExecSpace  = typename types::MyExecSpace;
+
+  if (kh.get_spgemm_handle() == NULL){
+    throw std::runtime_error("KokkosSparse::spgemm_chunked: the spgemm handle has not been created.");
+  }
+
+  const nnz_lno_t m = A.numRows(), n = A.numCols(), k = B.numCols();
+  std::vector<nnz_lno_t> batches =
+      Impl::spgemm_chunked_row_batches(&kh, m, k, A.graph.row_map, A.graph.entries, B.graph.row_map);
+
+  row_map_type row_mapC("non_const_lnow_row", m + 1);
+  entries_type entriesC;
+  values_type valuesC;
+
+  //pattern of the batches, to place them in C.
+  std::vector<size_type> batch_offsets(1, 0);
+  for (size_t b = 0; b + 1 < batches.size(); ++b){
+    const nnz_lno_t row_begin = batches[b], row_end = batches[b + 1];
+    typename types::row_view_t batch_rowmapA, batch_rowmapC;
+    typename types::batch_nnz_view_t batch_entriesA;
+    typename types::batch_scalar_view_t batch_valuesA;
+
+    Impl::spgemm_chunk_symbolic(&kh, row_begin, row_end, n, k,
+        A.graph.row_map, A.graph.entries, A.values, B.graph.row_map, B.graph.entries,
+        batch_rowmapA, batch_entriesA, batch_valuesA, batch_rowmapC);
+
+    Kokkos::parallel_for("KokkosSparse::spgemm_chunked::PlaceRowmap",
+        Kokkos::RangePolicy<MyExecSpace>(0, row_end - row_begin + 1),
+        Impl::SpgemmShiftRowmapFunctor<typename types::row_view_t, row_map_type>
+          (batch_rowmapC, row_mapC, 0, row_begin, 0, batch_offsets.back()));
+    batch_offsets.push_back(batch_offsets.back() + kh.get_spgemm_handle()->get_c_nnz());
+  }
+
+  const size_t c_nnz_size = batch_offsets.back();
+  if (c_nnz_size) {
+    entriesC = entries_type(Kokkos::ViewAllocateWithoutInitializing("entriesC"),
+                            c_nnz_size);
+    valuesC  = values_type(Kokkos::ViewAllocateWithoutInitializing("valuesC"),
+                          c_nnz_size);
+  }
+
+  //each batch again, multiplied in place.
+  for (size_t b = 0; b + 1 < batches.size(); ++b){
+    const nnz_lno_t row_begin = batches[b], row_end = batches[b + 1];
+    typename types::row_view_t batch_rowmapA, batch_rowmapC;
+    typename types::batch_nnz_view_t batch_entriesA;
+    typename types::batch_scalar_view_t batch_valuesA;
+
+    Impl::spgemm_chunk_symbolic(&kh, row_begin, row_end, n, k,
+        A.graph.row_map, A.graph.entries, A.values, B.graph.row_map, B.graph.entries,
+        batch_rowmapA, batch_entriesA, batch_valuesA, batch_rowmapC);
+
+    const size_type batch_nnz = batch_offsets[b + 1] - batch_offsets[b];
+    typename types::batch_out_nnz_view_t batch_entriesC(entriesC.data() + batch_offsets[b], batch_nnz);
+    typename types::batch_out_scalar_view_t batch_valuesC(valuesC.data() + batch_offsets[b], batch_nnz);
+
+    KokkosSparse::Experimental::spgemm_numeric(&kh, row_end - row_begin, n, k,
+        batch_rowmapA, batch_entriesA, batch_valuesA, false,
+        B.graph.row_map, B.graph.entries, B.values, false,
+        batch_rowmapC, batch_entriesC, batch_valuesC);
+  }
+  kh.get_spgemm_handle()->set_c_nnz(c_nnz_size);
+  kh.get_spgemm_handle()->set_call_symbolic(false);
+
+  C = CMatrix("C=AB", m, k, c_nnz_size, valuesC, row_mapC, entriesC);
+  return batches.size() - 1;
+}
+
+}  // namespace KokkosSparse
+
+#endif
@@ -83,11 +83,56 @@ enum SPGEMMAlgorithm{
 		SPGEMM_KK_MEMORY_SPREADTEAM,
 		SPGEMM_KK_MEMORY_BIGSPREADTEAM,
 		SPGEMM_KK_MEMORY2,
-		SPGEMM_KK_MEMSPEED};
+		SPGEMM_KK_MEMSPEED,
+		SPGEMM_AUTO}; //CHOOSES A KK VARIANT FROM SAMPLED ROWS IN EACH SYMBOLIC PHASE
 
 enum SPGEMMAccumulator{
   SPGEMM_ACC_DEFAULT, SPGEMM_ACC_DENSE, SPGEMM_ACC_SPARSE,
 };
+
+/**
+ * \brief What SPGEMM_AUTO estimated from the sampled rows of A and B, and the algorithm
+ * and accumulator it chose from them.
+ */
+struct SPGEMMAutoSelection{
+  SPGEMMAlgorithm algorithm;
+  SPGEMMAccumulator accumulator;
+  size_t num_sampled_rows;
+  //multiplications per row of A*B.
+  double average_row_flops;
+  //multiplications per entry of A*B, the reduction done by the accumulator.
+  double flops_per_output;
+  //entries of the compressed rows of B over their entries, 1 if compression does not help.
+  double b_compression_ratio;
+  //entries of the largest sampled row of A*B.
+  size_t max_row_nnz;
+  double estimated_c_nnz;
+
+  SPGEMMAutoSelection():
+    algorithm(SPGEMM_KK), accumulator(SPGEMM_ACC_DEFAULT), num_sampled_rows(0),
+    average_row_flops(0), flops_per_output(0), b_compression_ratio(1),
+    max_row_nnz(0), estimated_c_nnz(0){}
+
+  const char *algorithm_name() const {
+    switch (algorithm){
+    case SPGEMM_KK_DENSE: return "SPGEMM_KK_DENSE";
+    case SPGEMM_KK_MEMORY: return "SPGEMM_KK_MEMORY";
+    case SPGEMM_KK_LP: return "SPGEMM_KK_LP";
+    default: return "SPGEMM_KK";
+    }
+  }
+
+  void print(std::ostream &os) const {
+    os << "SPGEMM_AUTO chose " << algorithm_name()
+       << " accumulator:" << (accumulator == SPGEMM_ACC_DENSE ? "dense" : (accumulator == SPGEMM_ACC_SPARSE ? "sparse" : "default"))
+       << " sampled_rows:" << num_sampled_rows
+       << " average_row_flops:" << average_row_flops
+       << " flops_per_output:" << flops_per_output
+       << " b_compression_ratio:" << b_compression_ratio
+       << " max_row_nnz:" << max_row_nnz
+       << " estimated_c_nnz:" << estimated_c_nnz << std::endl;
+  }
+};
 template <class size_type_, class lno_t_, class scalar_t_,
           class ExecutionSpace,
           class TemporaryMemorySpace,
@@ -239,6 +284,23 @@ private:
   int mkl_sort_option;
   bool calculate_read_write_cost;
 
+  size_t c_position_map_budget;
+  bool c_position_map_decided;
+  nnz_lno_persistent_work_view_t c_position_map_entries, numeric_c_entries;
+  row_lno_persistent_work_view_t c_position_map_offsets, c_position_map;
+
+  size_t chunk_memory_budget;
+
+  size_t rap_max_row_flops;
+  row_lno_persistent_work_view_t rap_transpose_rowmap, rap_transpose_permutation;
+  nnz_lno_persistent_work_view_t rap_transpose_entries;
+
+  size_t masked_max_row_size;
+
+  bool auto_algorithm;
+  size_t auto_sample_rows;
+  SPGEMMAutoSelection auto_selection;
+
   public:
 
   std::string coloring_input_file;
@@ -308,6 +370,151 @@ private:
     return this->c_column_indices;
   }
 
+  /**
+   * \brief Enables the reuse of the numeric phase when only the values of A and B change.
+   * The first numeric call after symbolic sorts the rows of C, and records for every
+   * multiplication of A*B the position of its result in C. Later numeric calls with the same
+   * patterns and the same entries view of C then only gather, multiply and accumulate.
+   * The handle keeps a reference to that entries view, so its allocation lives as long as the map.
+   * The map takes one size_type per multiplication (plus one per row of A); it is not built
+   * if this is more than max_bytes. 0 (the default) disables the reuse.
+   */
+  void set_c_position_map_budget(size_t max_bytes){
+    this->c_position_map_budget = max_bytes;
+  }
+  size_t get_c_position_map_budget() const {
+    return this->c_position_map_budget;
+  }
+
+  /**
+   * \brief the entries of C of the running numeric call, set by spgemm_numeric.
+   * Empty if the caller's view cannot be held by the handle; the numeric phase is then not reused.
+   */
+  void set_numeric_c_entries(const nnz_lno_persistent_work_view_t &c_entries){
+    this->numeric_c_entries = c_entries;
+  }
+  nnz_lno_persistent_work_view_t get_numeric_c_entries() const {
+    return this->numeric_c_entries;
+  }
+
+  /**
+   * \brief stores the position map built for the entries of C of the running numeric call.
+   * An empty map records that it did not fit into the budget.
+   */
+  void set_c_position_map(
+      row_lno_persistent_work_view_t c_position_map_offsets_,
+      row_lno_persistent_work_view_t c_position_map_){
+    this->c_position_map_decided = true;
+    this->c_position_map_entries = this->numeric_c_entries;
+    this->c_position_map_offsets = c_position_map_offsets_;
+    this->c_position_map = c_position_map_;
+  }
+  void get_c_position_map(
+      row_lno_persistent_work_view_t &c_position_map_offsets_,
+      row_lno_persistent_work_view_t &c_position_map_){
+    c_position_map_offsets_ = this->c_position_map_offsets;
+    c_position_map_ = this->c_position_map;
+  }
+  //whether the position map was built, or found to be over the budget, since the last symbolic.
+  bool is_c_position_map_decided() const {
+    return this->c_position_map_decided;
+  }
+  //whether a map was built for the view c_entries. The handle holds the view the map was built for,
+  //so no other allocation can take its address meanwhile.
+  bool has_c_position_map(const nnz_lno_persistent_work_view_t &c_entries) const {
+    return this->c_position_map_decided && this->c_position_map_offsets.extent(0) &&
+        c_entries.data() != NULL &&
+        this->c_position_map_entries.data() == c_entries.data() &&
+        this->c_position_map_entries.extent(0) == c_entries.extent(0);
+  }
+  void reset_c_position_map(){
+    this->c_position_map_decided = false;
+    this->c_position_map_entries = nnz_lno_persistent_work_view_t();
+    this->c_position_map_offsets = row_lno_persistent_work_view_t();
+    this->c_position_map = row_lno_persistent_work_view_t();
+  }
+
+  /**
+   * \brief Sets the memory, in bytes, that the output of one batch of rows of spgemm_chunked
+   * may take. The rows of C are computed in batches whose entries and values fit into it.
+   * 0 (the default) computes all rows in a single batch.
+   */
+  void set_chunk_memory_budget(size_t max_bytes){
+    this->chunk_memory_budget = max_bytes;
+  }
+  size_t get_chunk_memory_budget() const {
+    return this->chunk_memory_budget;
+  }
+
+  /**
+   * \brief the largest number of multiplications in a row of the triple product R*A*P,
+   * which bounds the accumulator of its numeric phase.
+   */
+  void set_rap_max_row_flops(size_t max_row_flops){
+    this->rap_max_row_flops = max_row_flops;
+  }
+  size_t get_rap_max_row_flops() const {
+    return this->rap_max_row_flops;
+  }
+
+  /**
+   * \brief stores the pattern of P^T for the triple product P^T*A*P.
+   * The values of P^T are not stored: permutation gives the index in the values of P
+   * of each entry of P^T.
+   */
+  void set_rap_transpose(
+      row_lno_persistent_work_view_t rowmap_,
+      nnz_lno_persistent_work_view_t entries_,
+      row_lno_persistent_work_view_t permutation_){
+    this->rap_transpose_rowmap = rowmap_;
+    this->rap_transpose_entries = entries_;
+    this->rap_transpose_permutation = permutation_;
+  }
+  void get_rap_transpose(
+      row_lno_persistent_work_view_t &rowmap_,
+      nnz_lno_persistent_work_view_t &entries_,
+      row_lno_persistent_work_view_t &permutation_){
+    rowmap_ = this->rap_transpose_rowmap;
+    entries_ = this->rap_transpose_entries;
+    permutation_ = this->rap_transpose_permutation;
+  }
+
+  /**
+   * \brief the largest accumulator needed by a row of the masked product C<M> = A*B:
+   * the row of the mask for a structural mask, and the row of A*B plus the row of the mask
+   * for a complemented mask.
+   */
+  void set_masked_max_row_size(size_t max_row_size){
+    this->masked_max_row_size = max_row_size;
+  }
+  size_t get_masked_max_row_size() const {
+    return this->masked_max_row_size;
+  }
+
+  /**
+   * \brief true if the handle was created with SPGEMM_AUTO. The algorithm is then chosen
+   * again at each symbolic phase, from a sample of the rows of A and B.
+   */
+  bool is_auto_algorithm() const {
+    return this->auto_algorithm;
+  }
+  //the number of rows of A (and of B) that SPGEMM_AUTO samples, 1024 by default.
+  void set_auto_sample_rows(size_t num_rows){
+    this->auto_sample_rows = num_rows;
+  }
+  size_t get_auto_sample_rows() const {
+    return this->auto_sample_rows;
+  }
+  //applies the choice of SPGEMM_AUTO, which is then reported by get_auto_selection().
+  void set_auto_selection(const SPGEMMAutoSelection &selection){
+    this->auto_selection = selection;
+    this->algorithm_type = selection.algorithm;
+    this->accumulator_type = selection.accumulator;
+  }
+  const SPGEMMAutoSelection &get_auto_selection() const {
+    return this->auto_selection;
+  }
+
   void set_color_xadj(
       nnz_lno_t num_colors_,
       nnz_lno_persistent_work_host_view_t color_xadj_,
@@ -465,6 +672,12 @@ private:
     incidence_matrix_entries(),compress_second_matrix(true),
 
     multi_color_scale(1), mkl_sort_option(7), calculate_read_write_cost(false),
+    c_position_map_budget(0), c_position_map_decided(false), c_position_map_entries(), numeric_c_entries(),
+    c_position_map_offsets(), c_position_map(),
+    chunk_memory_budget(0),
+    rap_max_row_flops(0), rap_transpose_rowmap(), rap_transpose_permutation(), rap_transpose_entries(),
+    masked_max_row_size(0),
+    auto_algorithm(gs == SPGEMM_AUTO), auto_sample_rows(1024), auto_selection(),
     coloring_input_file(""),
     coloring_output_file(""), min_hash_size_scale(1), compression_cut_off(0.85), first_level_hash_cut_off(0.50),
     original_max_row_flops(std::numeric_limits<size_t>::max()), original_overall_flops(std::numeric_limits<size_t>::max()),
@@ -590,7 +803,10 @@ private:
 
 
   //setters
-  void set_algorithm_type(const SPGEMMAlgorithm &sgs_algo){this->algorithm_type = sgs_algo;}
+  void set_algorithm_type(const SPGEMMAlgorithm &sgs_algo){
+    this->algorithm_type = sgs_algo;
+    this->auto_algorithm = (sgs_algo == SPGEMM_AUTO);
+  }
   void set_call_symbolic(bool call = true){this->called_symbolic = call;}
   void set_call_numeric(bool call = true){this->called_numeric = call;}
 
@@ -652,6 +868,7 @@ private:
     else if(name=="SPGEMM_KK_DENSE")       return SPGEMM_KK_DENSE;
     else if(name=="SPGEMM_KK_LP")  		   return SPGEMM_KK_LP;
     else if(name=="SPGEMM_KK_MEMSPEED")    return SPGEMM_KK;
+    else if(name=="SPGEMM_AUTO")           return SPGEMM_AUTO;
 
     else if(name=="SPGEMM_DEBUG")          return SPGEMM_SERIAL;
     else if(name=="SPGEMM_SERIAL")         return SPGEMM_SERIAL;
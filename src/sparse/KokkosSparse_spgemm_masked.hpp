@@ -0,0 +1,180 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef _KOKKOSSPARSE_SPGEMM_MASKED_HPP
+#define _KOKKOSSPARSE_SPGEMM_MASKED_HPP
+
+#include <stdexcept>
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_spgemm_masked_impl.hpp"
+
+namespace KokkosSparse{
+
+namespace Experimental{
+
+/**
+ * \brief Symbolic phase of the masked product C<M> = A*B, which computes the entries of A*B only
+ * at the positions of the mask M, or only outside of them if complement_mask is true. The values
+ * of M are not used. With a structural mask, the accumulator of a row is bounded by the row of M,
+ * so this is cheaper than the full product followed by a filter when M is sparser than A*B,
+ * as in triangle counting, common neighbors or k-truss.
+ * The spgemm handle must have been created. Fills row_mapC, and the number of entries of C
+ * is then handle->get_spgemm_handle()->get_c_nnz().
+ * \param m: rows of A, M and C, n: columns of A and rows of B, k: columns of B, M and C.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename b_row_view_t, typename b_nnz_view_t,
+          typename m_row_view_t, typename m_nnz_view_t,
+          typename c_row_view_t>
+void spgemm_masked_symbolic(
+    KernelHandle *handle,
+    typename KernelHandle::const_nnz_lno_t m,
+    typename KernelHandle::const_nnz_lno_t /* n */,
+    typename KernelHandle::const_nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA,
+    b_row_view_t row_mapB, b_nnz_view_t entriesB,
+    m_row_view_t row_mapM, m_nnz_view_t entriesM,
+    bool complement_mask,
+    c_row_view_t row_mapC){
+
+  typename KernelHandle::SPGEMMHandleType *sh = handle->get_spgemm_handle();
+  if (sh == NULL){
+    throw std::runtime_error ("Create the spgemm handle before calling spgemm_masked_symbolic");
+  }
+  if (row_mapM.extent(0) != size_t(m) + 1){
+    throw std::runtime_error ("spgemm_masked_symbolic: the mask must have as many rows as A");
+  }
+  Impl::spgemm_masked_symbolic_impl(
+      handle, m, k,
+      row_mapA, entriesA,
+      row_mapB, entriesB,
+      row_mapM, entriesM,
+      row_mapC, complement_mask);
+  sh->set_call_symbolic();
+}
+
+/**
+ * \brief Numeric phase of C<M> = A*B. The mask and complement_mask must be those given to the
+ * symbolic phase. entriesC and valuesC must have handle->get_spgemm_handle()->get_c_nnz() entries.
+ * The rows of C are not sorted.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t, typename b_scalar_view_t,
+          typename m_row_view_t, typename m_nnz_view_t,
+          typename c_row_view_t, typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_masked_numeric(
+    KernelHandle *handle,
+    typename KernelHandle::const_nnz_lno_t m,
+    typename KernelHandle::const_nnz_lno_t /* n */,
+    typename KernelHandle::const_nnz_lno_t /* k */,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+    b_row_view_t row_mapB, b_nnz_view_t entriesB, b_scalar_view_t valuesB,
+    m_row_view_t row_mapM, m_nnz_view_t entriesM,
+    bool complement_mask,
+    c_row_view_t row_mapC, c_nnz_view_t &entriesC, c_scalar_view_t &valuesC){
+
+  typename KernelHandle::SPGEMMHandleType *sh = handle->get_spgemm_handle();
+  if (sh == NULL || !sh->is_symbolic_called()){
+    throw std::runtime_error ("Call spgemm_masked_symbolic before calling spgemm_masked_numeric");
+  }
+  Impl::spgemm_masked_run(
+      handle, m,
+      row_mapA, entriesA, valuesA,
+      row_mapB, entriesB, valuesB,
+      row_mapM, entriesM,
+      row_mapC, entriesC, valuesC,
+      complement_mask, true);
+  sh->set_call_numeric();
+}
+
+}  // end namespace Experimental
+
+template <class KernelHandle, class AMatrix, class BMatrix, class MMatrix, class CMatrix>
+void spgemm_masked_symbolic(KernelHandle& kh, const AMatrix& A, const BMatrix& B,
+                            const MMatrix& M, bool complement_mask, CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  row_map_type row_mapC(
+      Kokkos::ViewAllocateWithoutInitializing("non_const_lnow_row"),
+      A.numRows() + 1);
+  entries_type entriesC;
+  values_type valuesC;
+
+  KokkosSparse::Experimental::spgemm_masked_symbolic(
+      &kh, A.numRows(), B.numRows(), B.numCols(),
+      A.graph.row_map, A.graph.entries,
+      B.graph.row_map, B.graph.entries,
+      M.graph.row_map, M.graph.entries,
+      complement_mask,
+      row_mapC);
+
+  const size_t c_nnz_size = kh.get_spgemm_handle()->get_c_nnz();
+  if (c_nnz_size) {
+    entriesC = entries_type(Kokkos::ViewAllocateWithoutInitializing("entriesC"),
+                            c_nnz_size);
+    valuesC  = values_type(Kokkos::ViewAllocateWithoutInitializing("valuesC"),
+                          c_nnz_size);
+  }
+
+  C = CMatrix("C<M>=AB", A.numRows(), B.numCols(), c_nnz_size, valuesC, row_mapC, entriesC);
+}
+
+template <class KernelHandle, class AMatrix, class BMatrix, class MMatrix, class CMatrix>
+void spgemm_masked_numeric(KernelHandle& kh, const AMatrix& A, const BMatrix& B,
+                           const MMatrix& M, bool complement_mask, CMatrix& C) {
+  KokkosSparse::Experimental::spgemm_masked_numeric(
+      &kh, A.numRows(), B.numRows(), B.numCols(),
+      A.graph.row_map, A.graph.entries, A.values,
+      B.graph.row_map, B.graph.entries, B.values,
+      M.graph.row_map, M.graph.entries,
+      complement_mask,
+      C.graph.row_map, C.graph.entries, C.values);
+}
+
+}  // namespace KokkosSparse
+
+#endif
@@ -218,6 +218,11 @@ void spgemm_numeric(
   Internal_cscalar_nnz_view_t_ nonconst_c_s ( valuesC.data(), valuesC.extent(0));
 
 
+  //the handle holds on to the entries of C its position map is built for.
+  typedef typename const_handle_type::SPGEMMHandleType::nnz_lno_persistent_work_view_t c_entries_ref_t;
+  tmp_handle.get_spgemm_handle()->set_numeric_c_entries(
+      KokkosSparse::Impl::SpgemmCEntriesRef<c_entries_ref_t, clno_nnz_view_t_>::get(entriesC));
+
   KokkosSparse::Impl::SPGEMM_NUMERIC<
   const_handle_type, //KernelHandle,
   Internal_alno_row_view_t_, Internal_alno_nnz_view_t_, Internal_ascalar_nnz_view_t_,
@@ -239,6 +244,7 @@ void spgemm_numeric(
       nonconst_c_r,
       nonconst_c_l,
       nonconst_c_s);
+  tmp_handle.get_spgemm_handle()->set_numeric_c_entries(c_entries_ref_t());
 }
 
 
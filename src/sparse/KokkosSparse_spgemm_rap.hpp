@@ -0,0 +1,282 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef _KOKKOSSPARSE_SPGEMM_RAP_HPP
+#define _KOKKOSSPARSE_SPGEMM_RAP_HPP
+
+#include <stdexcept>
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_spgemm_rap_impl.hpp"
+
+namespace KokkosSparse{
+
+namespace Experimental{
+
+/**
+ * \brief Symbolic phase of the triple product C = R*A*P, as used for the coarse operators
+ * of multigrid. C is computed row by row with a single accumulator, without forming A*P.
+ * The spgemm handle must have been created. Fills row_mapC, and the number of entries of C
+ * is then handle->get_spgemm_handle()->get_c_nnz(). The numeric phase can be repeated as long
+ * as the patterns of R, A and P do not change.
+ * \param m: rows of R and C, n: rows of A and P, k: columns of P and C.
+ */
+template <typename KernelHandle,
+          typename r_row_view_t, typename r_nnz_view_t,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename p_row_view_t, typename p_nnz_view_t,
+          typename c_row_view_t>
+void spgemm_rap_symbolic(
+    KernelHandle *handle,
+    typename KernelHandle::const_nnz_lno_t m,
+    typename KernelHandle::const_nnz_lno_t /* n */,
+    typename KernelHandle::const_nnz_lno_t k,
+    r_row_view_t row_mapR, r_nnz_view_t entriesR,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA,
+    p_row_view_t row_mapP, p_nnz_view_t entriesP,
+    c_row_view_t row_mapC){
+
+  typename KernelHandle::SPGEMMHandleType *sh = handle->get_spgemm_handle();
+  if (sh == NULL){
+    throw std::runtime_error ("Create the spgemm handle before calling spgemm_rap_symbolic");
+  }
+  Impl::spgemm_rap_symbolic_impl(
+      handle, m, k,
+      row_mapR, entriesR,
+      row_mapA, entriesA,
+      row_mapP, entriesP,
+      row_mapC);
+  sh->set_call_symbolic();
+}
+
+/**
+ * \brief Numeric phase of C = R*A*P. entriesC and valuesC must have
+ * handle->get_spgemm_handle()->get_c_nnz() entries. The rows of C are not sorted.
+ */
+template <typename KernelHandle,
+          typename r_row_view_t, typename r_nnz_view_t, typename r_scalar_view_t,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename p_row_view_t, typename p_nnz_view_t, typename p_scalar_view_t,
+          typename c_row_view_t, typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_rap_numeric(
+    KernelHandle *handle,
+    typename KernelHandle::const_nnz_lno_t m,
+    typename KernelHandle::const_nnz_lno_t /* n */,
+    typename KernelHandle::const_nnz_lno_t k,
+    r_row_view_t row_mapR, r_nnz_view_t entriesR, r_scalar_view_t valuesR,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+    p_row_view_t row_mapP, p_nnz_view_t entriesP, p_scalar_view_t valuesP,
+    c_row_view_t row_mapC, c_nnz_view_t &entriesC, c_scalar_view_t &valuesC){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  spgemmHandleType *sh = handle->get_spgemm_handle();
+  if (sh == NULL || !sh->is_symbolic_called()){
+    throw std::runtime_error ("Call spgemm_rap_symbolic before calling spgemm_rap_numeric");
+  }
+  Impl::spgemm_rap_run(
+      handle, m, k,
+      row_mapR, entriesR, valuesR, typename spgemmHandleType::row_lno_persistent_work_view_t(),
+      row_mapA, entriesA, valuesA,
+      row_mapP, entriesP, valuesP,
+      row_mapC, entriesC, valuesC,
+      true);
+  sh->set_call_numeric();
+}
+
+/**
+ * \brief Symbolic phase of the Galerkin product C = P^T*A*P. P^T is not formed: the handle
+ * keeps its pattern and the position in P of each of its entries, so the numeric phase reads
+ * the current values of P.
+ * \param n: rows of A and P, k: columns of P, and rows and columns of C.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename p_row_view_t, typename p_nnz_view_t,
+          typename c_row_view_t>
+void spgemm_ptap_symbolic(
+    KernelHandle *handle,
+    typename KernelHandle::const_nnz_lno_t n,
+    typename KernelHandle::const_nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA,
+    p_row_view_t row_mapP, p_nnz_view_t entriesP,
+    c_row_view_t row_mapC){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  spgemmHandleType *sh = handle->get_spgemm_handle();
+  if (sh == NULL){
+    throw std::runtime_error ("Create the spgemm handle before calling spgemm_ptap_symbolic");
+  }
+  Impl::spgemm_rap_transpose_pattern(handle, n, k, row_mapP, entriesP);
+
+  typename spgemmHandleType::row_lno_persistent_work_view_t t_rowmap, t_permutation;
+  typename spgemmHandleType::nnz_lno_persistent_work_view_t t_entries;
+  sh->get_rap_transpose(t_rowmap, t_entries, t_permutation);
+
+  Impl::spgemm_rap_symbolic_impl(
+      handle, k, k,
+      t_rowmap, t_entries,
+      row_mapA, entriesA,
+      row_mapP, entriesP,
+      row_mapC);
+  sh->set_call_symbolic();
+}
+
+/**
+ * \brief Numeric phase of C = P^T*A*P. The rows of C are not sorted.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename p_row_view_t, typename p_nnz_view_t, typename p_scalar_view_t,
+          typename c_row_view_t, typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_ptap_numeric(
+    KernelHandle *handle,
+    typename KernelHandle::const_nnz_lno_t /* n */,
+    typename KernelHandle::const_nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+    p_row_view_t row_mapP, p_nnz_view_t entriesP, p_scalar_view_t valuesP,
+    c_row_view_t row_mapC, c_nnz_view_t &entriesC, c_scalar_view_t &valuesC){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  spgemmHandleType *sh = handle->get_spgemm_handle();
+  typename spgemmHandleType::row_lno_persistent_work_view_t t_rowmap, t_permutation;
+  typename spgemmHandleType::nnz_lno_persistent_work_view_t t_entries;
+  if (sh != NULL){
+    sh->get_rap_transpose(t_rowmap, t_entries, t_permutation);
+  }
+  if (sh == NULL || !sh->is_symbolic_called() || t_rowmap.extent(0) == 0){
+    throw std::runtime_error ("Call spgemm_ptap_symbolic before calling spgemm_ptap_numeric");
+  }
+  Impl::spgemm_rap_run(
+      handle, k, k,
+      t_rowmap, t_entries, valuesP, t_permutation,
+      row_mapA, entriesA, valuesA,
+      row_mapP, entriesP, valuesP,
+      row_mapC, entriesC, valuesC,
+      true);
+  sh->set_call_numeric();
+}
+
+}  // end namespace Experimental
+
+template <class KernelHandle, class RMatrix, class AMatrix, class PMatrix, class CMatrix>
+void spgemm_rap_symbolic(KernelHandle& kh, const RMatrix& R, const AMatrix& A,
+                         const PMatrix& P, CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  row_map_type row_mapC(
+      Kokkos::ViewAllocateWithoutInitializing("non_const_lnow_row"),
+      R.numRows() + 1);
+  entries_type entriesC;
+  values_type valuesC;
+
+  KokkosSparse::Experimental::spgemm_rap_symbolic(
+      &kh, R.numRows(), A.numRows(), P.numCols(),
+      R.graph.row_map, R.graph.entries,
+      A.graph.row_map, A.graph.entries,
+      P.graph.row_map, P.graph.entries,
+      row_mapC);
+
+  const size_t c_nnz_size = kh.get_spgemm_handle()->get_c_nnz();
+  if (c_nnz_size) {
+    entriesC = entries_type(Kokkos::ViewAllocateWithoutInitializing("entriesC"),
+                            c_nnz_size);
+    valuesC  = values_type(Kokkos::ViewAllocateWithoutInitializing("valuesC"),
+                          c_nnz_size);
+  }
+
+  C = CMatrix("C=RAP", R.numRows(), P.numCols(), c_nnz_size, valuesC, row_mapC, entriesC);
+}
+
+template <class KernelHandle, class RMatrix, class AMatrix, class PMatrix, class CMatrix>
+void spgemm_rap_numeric(KernelHandle& kh, const RMatrix& R, const AMatrix& A,
+                        const PMatrix& P, CMatrix& C) {
+  KokkosSparse::Experimental::spgemm_rap_numeric(
+      &kh, R.numRows(), A.numRows(), P.numCols(),
+      R.graph.row_map, R.graph.entries, R.values,
+      A.graph.row_map, A.graph.entries, A.values,
+      P.graph.row_map, P.graph.entries, P.values,
+      C.graph.row_map, C.graph.entries, C.values);
+}
+
+template <class KernelHandle, class AMatrix, class PMatrix, class CMatrix>
+void spgemm_ptap_symbolic(KernelHandle& kh, const AMatrix& A, const PMatrix& P, CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  row_map_type row_mapC(
+      Kokkos::ViewAllocateWithoutInitializing("non_const_lnow_row"),
+      P.numCols() + 1);
+  entries_type entriesC;
+  values_type valuesC;
+
+  KokkosSparse::Experimental::spgemm_ptap_symbolic(
+      &kh, P.numRows(), P.numCols(),
+      A.graph.row_map, A.graph.entries,
+      P.graph.row_map, P.graph.entries,
+      row_mapC);
+
+  const size_t c_nnz_size = kh.get_spgemm_handle()->get_c_nnz();
+  if (c_nnz_size) {
+    entriesC = entries_type(Kokkos::ViewAllocateWithoutInitializing("entriesC"),
+                            c_nnz_size);
+    valuesC  = values_type(Kokkos::ViewAllocateWithoutInitializing("valuesC"),
+                          c_nnz_size);
+  }
+
+  C = CMatrix("C=PtAP", P.numCols(), P.numCols(), c_nnz_size, valuesC, row_mapC, entriesC);
+}
+
+template <class KernelHandle, class AMatrix, class PMatrix, class CMatrix>
+void spgemm_ptap_numeric(KernelHandle& kh, const AMatrix& A, const PMatrix& P, CMatrix& C) {
+  KokkosSparse::Experimental::spgemm_ptap_numeric(
+      &kh, P.numRows(), P.numCols(),
+      A.graph.row_map, A.graph.entries, A.values,
+      P.graph.row_map, P.graph.entries, P.values,
+      C.graph.row_map, C.graph.entries, C.values);
+}
+
+}  // namespace KokkosSparse
+
+#endif
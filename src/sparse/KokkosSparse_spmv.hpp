@@ -56,6 +56,17 @@
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "KokkosBlas1_scal.hpp"
 #include "KokkosKernels_Utils.hpp"
+#include "KokkosSparse_SellCMatrix.hpp"
+#include "KokkosSparse_spmv_sellc_impl.hpp"
+#include "KokkosSparse_DeltaCrsMatrix.hpp"
+#include "KokkosSparse_spmv_deltacrs_impl.hpp"
+#include "KokkosSparse_spmv_inspector_impl.hpp"
+#include "KokkosSparse_spmv_blockcrs_impl.hpp"
+#include "KokkosSparse_spmv_dot_impl.hpp"
+#include "KokkosSparse_residual_impl.hpp"
+#include "KokkosSparse_spmv_symmetric_impl.hpp"
+#include "KokkosSparse_spmv_tuning_impl.hpp"
+#include "KokkosBlas1_dot.hpp"
 
 namespace KokkosSparse {
 
@@ -152,8 +163,29 @@ spmv (KokkosKernels::Experimental::Controls controls,
     return;
   }
 
+  // Autotuning: replace the launch parameters by the fastest ones found
+  // for A's row length signature, searching for them on first use.
+  if(controls.isParameter("autotune") && (controls.getParameter("autotune") == "true")) {
+    controls.setParameter("autotune", "false");
+    if((mode[0] == NoTranspose[0]) || (mode[0] == Conjugate[0])) {
+      const std::string signature = Impl::spmv_tuning_signature(controls, mode, A_i);
+      Impl::SpmvTuningEntry tuned;
+      if(!Impl::spmv_tuning_lookup(controls, signature, tuned)) {
+        // Time the candidates on a scratch output so that y is untouched.
+        Kokkos::View<typename YVector::non_const_value_type*, typename YVector::device_type> y_tune("spmv autotune y", y.extent(0));
+        auto run = [&] (const KokkosKernels::Experimental::Controls& trial) {
+          spmv (trial, mode, alpha, A, x, Kokkos::ArithTraits<BetaType>::zero(), y_tune, RANK_ONE());
+        };
+        tuned = Impl::spmv_tuning_search<typename AMatrix_Internal::execution_space>
+          (controls, signature, A_i.numRows(), A_i.nnz(), run);
+      }
+      tuned.apply(controls);
+    }
+  }
+
   //Whether to call KokkosKernel's native implementation, even if a TPL impl is available
-  bool useFallback = controls.isParameter("algorithm") && controls.getParameter("algorithm") == "native";
+  bool useFallback = controls.isParameter("algorithm") &&
+    ((controls.getParameter("algorithm") == "native") || (controls.getParameter("algorithm") == "native-merge"));
 
 #ifdef KOKKOSKERNELS_ENABLE_TPL_CUSPARSE
   //cuSPARSE does not support the conjugate mode (C), and cuSPARSE 9 only supports the normal (N) mode.
@@ -173,6 +205,8 @@ spmv (KokkosKernels::Experimental::Controls controls,
   if(std::is_same<typename AMatrix_Internal::memory_space, Kokkos::HostSpace>::value)
   {
     useFallback = useFallback || (mode[0] == Conjugate[0]);
+    //MKL has no merge-path kernel, use the native one instead
+    useFallback = useFallback || (controls.isParameter("algorithm") && controls.getParameter("algorithm") == "merge");
   }
 #endif
 
@@ -223,7 +257,8 @@ spmv (KokkosKernels::Experimental::Controls controls,
 template<class AlphaType, class AMatrix, class XVector, class BetaType, class YVector ,
          class XLayout = typename XVector::array_layout>
 struct SPMV2D1D {
-  static bool spmv2d1d (const char mode[],
+  static bool spmv2d1d (const KokkosKernels::Experimental::Controls& controls,
+        const char mode[],
         const AlphaType& alpha,
         const AMatrix& A,
         const XVector& x,
@@ -234,7 +269,8 @@ struct SPMV2D1D {
 
 template<class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
 struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutStride>{
-  static bool spmv2d1d (const char mode[],
+  static bool spmv2d1d (const KokkosKernels::Experimental::Controls& controls,
+        const char mode[],
         const AlphaType& alpha,
         const AMatrix& A,
         const XVector& x,
@@ -242,7 +278,7 @@ struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutSt
         const YVector& y)
   {
 #if defined (KOKKOSKERNELS_INST_LAYOUTSTRIDE) || !defined(KOKKOSKERNELS_ETI_ONLY)
-    spmv (mode, alpha, A, x, beta, y);
+    spmv (controls, mode, alpha, A, x, beta, y);
     return true;
 #else
     return false;
@@ -252,7 +288,8 @@ struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutSt
 
 template<class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
 struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutLeft>{
-  static bool spmv2d1d (const char mode[],
+  static bool spmv2d1d (const KokkosKernels::Experimental::Controls& controls,
+        const char mode[],
         const AlphaType& alpha,
         const AMatrix& A,
         const XVector& x,
@@ -260,7 +297,7 @@ struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutLe
         const YVector& y)
   {
 #if defined (KOKKOSKERNELS_INST_LAYOUTLEFT) || !defined(KOKKOSKERNELS_ETI_ONLY)
-    spmv (mode, alpha, A, x, beta, y);
+    spmv (controls, mode, alpha, A, x, beta, y);
     return true;
 #else
     return false;
@@ -271,7 +308,8 @@ struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutLe
 
 template<class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
 struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutRight>{
-  static bool spmv2d1d (const char mode[],
+  static bool spmv2d1d (const KokkosKernels::Experimental::Controls& controls,
+        const char mode[],
         const AlphaType& alpha,
         const AMatrix& A,
         const XVector& x,
@@ -279,7 +317,7 @@ struct SPMV2D1D<AlphaType, AMatrix, XVector, BetaType, YVector, Kokkos::LayoutRi
         const YVector& y)
   {
 #if defined (KOKKOSKERNELS_INST_LAYOUTLEFT) || !defined(KOKKOSKERNELS_ETI_ONLY)
-    spmv (mode, alpha, A, x, beta, y);
+    spmv (controls, mode, alpha, A, x, beta, y);
     return true;
 #else
     return false;
@@ -361,7 +399,7 @@ spmv (KokkosKernels::Experimental::Controls controls,
     using impl_type = SPMV2D1D<AlphaType, AMatrix_Internal,
       XVector_SubInternal, BetaType, YVector_SubInternal,
       typename XVector_SubInternal::array_layout>;
-    if (impl_type::spmv2d1d (mode, alpha, A, x_i, beta, y_i)) {
+    if (impl_type::spmv2d1d (controls, mode, alpha, A, x_i, beta, y_i)) {
       return;
     }
   }
@@ -393,7 +431,7 @@ spmv (KokkosKernels::Experimental::Controls controls,
                          typename YVector_Internal::value_type**,
                          typename YVector_Internal::array_layout,
                          typename YVector_Internal::device_type,
-                         typename YVector_Internal::memory_traits>::spmv_mv (mode, alpha, A_i, x_i, beta, y_i);
+                         typename YVector_Internal::memory_traits>::spmv_mv (controls, mode, alpha, A_i, x_i, beta, y_i);
   }
 }
 
@@ -405,7 +443,22 @@ spmv (KokkosKernels::Experimental::Controls controls,
 /// by \c mode.  If beta == 0, ignore and overwrite the initial
 /// entries of y; if alpha == 0, ignore the entries of A and x.
 ///
-/// \param controls [in] kokkos-kernels control structure
+/// \param controls [in] kokkos-kernels control structure.  Setting
+///   "algorithm" to "merge" selects a merge-path (nnz + rows evenly
+///   split across threads) kernel, which is robust to matrices with a
+///   few very long rows; "native-merge" forces the native merge-path
+///   kernel even when a TPL is enabled.  Setting "autotune" to "true"
+///   makes single vector "N" and "C" products use the schedule, team
+///   size, vector length and rows per thread that ran fastest for
+///   matrices with the same row length signature.  The first call for a
+///   new signature times the candidates (on a scratch output) and
+///   appends the winner to the tuning database, given by "autotune
+///   file", the KOKKOSKERNELS_SPMV_TUNING_FILE environment variable or
+///   kokkoskernels_spmv_tuning.txt; "autotune repeats" sets the number
+///   of timed runs per candidate.  The signature is recomputed on every
+///   call (one pass over the row map) unless "autotune key" names the
+///   matrix; it is then remembered for that key, which must change when
+///   the structure of the matrix does.
 /// \param mode [in] "N" for no transpose, "T" for transpose, or "C"
 ///   for conjugate transpose.
 /// \param alpha [in] Scalar multiplier for the matrix A.
@@ -445,6 +498,360 @@ void spmv(const char mode[],
 
 }
 
+
+/// \brief Which inner product KokkosSparse::spmv_dot reduces.
+///
+/// XY: <x,y>, taken over the first y.extent(0) entries of x (e.g. p'Ap in CG).
+/// YY: <y,y> (e.g. the squared norm of a residual).
+enum class SPMVDotType { XY, YY };
+
+namespace Impl {
+template <class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+typename YVector::non_const_value_type
+spmv_dot_single (const KokkosKernels::Experimental::Controls& controls,
+                 const char mode[],
+                 const AlphaType& alpha,
+                 const AMatrix& A,
+                 const XVector& x,
+                 const BetaType& beta,
+                 const YVector& y,
+                 const SPMVDotType dotType)
+{
+  typedef typename YVector::non_const_value_type y_value_type;
+
+  if (dotType == SPMVDotType::XY &&
+      static_cast<size_t> (x.extent(0)) < static_cast<size_t> (y.extent(0))) {
+    std::ostringstream os;
+    os << "KokkosSparse::spmv_dot: <x,y> needs x to be at least as long as y"
+       << ", x: " << x.extent(0) << ", y: " << y.extent(0);
+    Kokkos::Impl::throw_runtime_exception (os.str ());
+  }
+
+  // Transposed products scatter into y, so y is only final once the
+  // whole kernel has run; compute the product and reduce separately.
+  if ((mode[0] != NoTranspose[0]) && (mode[0] != Conjugate[0])) {
+    KokkosSparse::spmv (controls, mode, alpha, A, x, beta, y);
+    if (dotType == SPMVDotType::YY)
+      return KokkosBlas::dot (y, y);
+    auto x_head = Kokkos::subview (x, Kokkos::make_pair (size_t (0), static_cast<size_t> (y.extent(0))));
+    return KokkosBlas::dot (x_head, y);
+  }
+
+  if ((static_cast<size_t> (A.numCols ()) > static_cast<size_t> (x.extent(0))) ||
+      (static_cast<size_t> (A.numRows ()) > static_cast<size_t> (y.extent(0)))) {
+    std::ostringstream os;
+    os << "KokkosSparse::spmv_dot: Dimensions do not match: "
+       << ", A: " << A.numRows () << " x " << A.numCols()
+       << ", x: " << x.extent(0)
+       << ", y: " << y.extent(0);
+    Kokkos::Impl::throw_runtime_exception (os.str ());
+  }
+
+  const bool conjugate = (mode[0] == Conjugate[0]);
+  const y_value_type a = alpha;
+  const y_value_type b = beta;
+  if (dotType == SPMVDotType::XY)
+    return Impl::spmv_dot<AMatrix, XVector, YVector, true> (controls, conjugate, a, A, x, b, y);
+  return Impl::spmv_dot<AMatrix, XVector, YVector, false> (controls, conjugate, a, A, x, b, y);
+}
+// y := beta*y + alpha*op(A)*x for op = transpose ("T") or conjugate
+// transpose ("H"), running the non-transpose kernel on the cached A^T.
+template<class SPMVHandleType, class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+void spmv_explicit_transpose (SPMVHandleType* handle,
+                              const char mode[],
+                              const AlphaType& alpha,
+                              const AMatrix& A,
+                              const XVector& x,
+                              const BetaType& beta,
+                              const YVector& y)
+{
+  typedef KokkosSparse::CrsMatrix<typename SPMVHandleType::nnz_scalar_t,
+                                  typename SPMVHandleType::nnz_lno_t,
+                                  typename AMatrix::device_type,
+                                  void,
+                                  typename SPMVHandleType::size_type> transpose_type;
+
+  transpose_type AT ("SpMV transpose", A.numCols (), A.numRows (), A.nnz (),
+                     handle->get_transpose_values (),
+                     handle->get_transpose_row_map (),
+                     handle->get_transpose_entries ());
+  const char* transposed_mode = (mode[0] == ConjugateTranspose[0]) ? Conjugate : NoTranspose;
+  KokkosSparse::spmv (transposed_mode, alpha, AT, x, beta, y);
+}
+
+} // namespace Impl
+
+/// \brief Fused sparse matrix-vector multiply and inner product.
+///
+/// Compute y = beta*y + alpha*Op(A)*x and return <x,y> or <y,y>
+/// (see SPMVDotType).  For "N" and "C" the inner product is
+/// accumulated inside the SpMV kernel, saving the extra pass over y
+/// a separate KokkosBlas::dot would need.  "T" and "H" fall back to
+/// spmv followed by dot.
+///
+/// \param controls [in] kokkos-kernels control structure; the team
+///   size, vector length and rows per thread parameters of spmv apply.
+/// \param mode [in] "N", "C", "T" or "H", as for spmv.
+/// \param alpha [in] Scalar multiplier for the matrix A.
+/// \param A [in] The sparse matrix; KokkosSparse::CrsMatrix instance.
+/// \param x [in] Rank-1 input vector.
+/// \param beta [in] Scalar multiplier for y.
+/// \param y [in/out] Rank-1 output vector.
+/// \param dotType [in] Which inner product to return.
+template <class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+typename std::enable_if<static_cast<int> (YVector::rank) == 1,
+                        typename YVector::non_const_value_type>::type
+spmv_dot (KokkosKernels::Experimental::Controls controls,
+          const char mode[],
+          const AlphaType& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y,
+          const SPMVDotType dotType = SPMVDotType::XY)
+{
+  static_assert (static_cast<int> (XVector::rank) == 1,
+    "KokkosSparse::spmv_dot: x and y must both have rank 1.");
+  static_assert (std::is_same<typename YVector::value_type,
+                   typename YVector::non_const_value_type>::value,
+    "KokkosSparse::spmv_dot: Output Vector must be non-const.");
+  return Impl::spmv_dot_single (controls, mode, alpha, A, x, beta, y, dotType);
+}
+
+/// \brief Fused multivector spmv and column-wise inner products.
+///
+/// Compute Y = beta*Y + alpha*Op(A)*X, and R(j) = <X(:,j),Y(:,j)> or
+/// <Y(:,j),Y(:,j)> for each column j.  Each column runs the fused
+/// rank-1 kernel.
+template <class RV, class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+typename std::enable_if<static_cast<int> (YVector::rank) == 2>::type
+spmv_dot (KokkosKernels::Experimental::Controls controls,
+          const RV& R,
+          const char mode[],
+          const AlphaType& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y,
+          const SPMVDotType dotType = SPMVDotType::XY)
+{
+  static_assert (Kokkos::Impl::is_view<RV>::value && static_cast<int> (RV::rank) == 1,
+    "KokkosSparse::spmv_dot: R must be a rank-1 Kokkos::View.");
+  static_assert (static_cast<int> (XVector::rank) == 2,
+    "KokkosSparse::spmv_dot: x and y must both have rank 2.");
+  if ((x.extent(1) != y.extent(1)) || (R.extent(0) != y.extent(1))) {
+    std::ostringstream os;
+    os << "KokkosSparse::spmv_dot: Number of columns do not match: "
+       << "R: " << R.extent(0)
+       << ", x: " << x.extent(1)
+       << ", y: " << y.extent(1);
+    Kokkos::Impl::throw_runtime_exception (os.str ());
+  }
+
+  auto R_h = Kokkos::create_mirror_view (R);
+  for (size_t j = 0; j < y.extent(1); ++j) {
+    auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
+    auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
+    R_h(j) = Impl::spmv_dot_single (controls, mode, alpha, A, x_j, beta, y_j, dotType);
+  }
+  Kokkos::deep_copy (R, R_h);
+}
+
+template <class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+typename std::enable_if<static_cast<int> (YVector::rank) == 1,
+                        typename YVector::non_const_value_type>::type
+spmv_dot (const char mode[],
+          const AlphaType& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y,
+          const SPMVDotType dotType = SPMVDotType::XY)
+{
+  KokkosKernels::Experimental::Controls controls;
+  return spmv_dot (controls, mode, alpha, A, x, beta, y, dotType);
+}
+
+template <class RV, class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+typename std::enable_if<static_cast<int> (YVector::rank) == 2>::type
+spmv_dot (const RV& R,
+          const char mode[],
+          const AlphaType& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y,
+          const SPMVDotType dotType = SPMVDotType::XY)
+{
+  KokkosKernels::Experimental::Controls controls;
+  spmv_dot (controls, R, mode, alpha, A, x, beta, y, dotType);
+}
+
+namespace Impl {
+template <class AMatrix, class XVector, class BVector, class RVector>
+void residual_check_dimensions (const AMatrix& A,
+                                const XVector& x,
+                                const BVector& b,
+                                const RVector& r)
+{
+  static_assert (static_cast<int> (XVector::rank) == static_cast<int> (RVector::rank) &&
+                 static_cast<int> (BVector::rank) == static_cast<int> (RVector::rank),
+    "KokkosSparse::residual: x, b and r must have the same rank.");
+  static_assert (std::is_same<typename RVector::value_type,
+                   typename RVector::non_const_value_type>::value,
+    "KokkosSparse::residual: Output Vector must be non-const.");
+
+  if ((x.extent(1) != r.extent(1)) || (b.extent(1) != r.extent(1)) ||
+      (b.extent(0) != r.extent(0)) ||
+      (static_cast<size_t> (A.numCols ()) > static_cast<size_t> (x.extent(0))) ||
+      (static_cast<size_t> (A.numRows ()) != static_cast<size_t> (r.extent(0)))) {
+    std::ostringstream os;
+    os << "KokkosSparse::residual: Dimensions do not match: "
+       << ", A: " << A.numRows () << " x " << A.numCols()
+       << ", x: " << x.extent(0) << " x " << x.extent(1)
+       << ", b: " << b.extent(0) << " x " << b.extent(1)
+       << ", r: " << r.extent(0) << " x " << r.extent(1)
+       ;
+    Kokkos::Impl::throw_runtime_exception (os.str ());
+  }
+}
+} // namespace Impl
+
+template <class AMatrix, class XVector, class BVector, class RVector>
+void
+residual_rank (const KokkosKernels::Experimental::Controls& controls,
+               const AMatrix& A,
+               const XVector& x,
+               const BVector& b,
+               const RVector& r,
+               const RANK_ONE)
+{
+  Impl::residual (controls, A, x, b, r, false);
+}
+
+template <class AMatrix, class XVector, class BVector, class RVector>
+void
+residual_rank (const KokkosKernels::Experimental::Controls& controls,
+               const AMatrix& A,
+               const XVector& x,
+               const BVector& b,
+               const RVector& r,
+               const RANK_TWO)
+{
+  Impl::residual_mv (controls, A, x, b, r, nullptr);
+}
+
+/// \brief Fused residual r = b - A*x.
+///
+/// Computes the residual in a single pass over A, x and b, instead of
+/// copying b into r and calling spmv with alpha = -1 and beta = 1.
+/// r may be the same View as b; it must not alias x.
+///
+/// \param controls [in] kokkos-kernels control structure; the team
+///   size, vector length and rows per thread parameters of spmv apply.
+/// \param A [in] The sparse matrix; KokkosSparse::CrsMatrix instance.
+/// \param x [in] Input (multi)vector, rank 1 or 2.
+/// \param b [in] Right-hand side, same rank as x, A.numRows() rows.
+/// \param r [out] Residual, same shape as b.
+template <class AMatrix, class XVector, class BVector, class RVector>
+void
+residual (KokkosKernels::Experimental::Controls controls,
+          const AMatrix& A,
+          const XVector& x,
+          const BVector& b,
+          const RVector& r)
+{
+  Impl::residual_check_dimensions (A, x, b, r);
+  residual_rank (controls, A, x, b, r,
+                 typename std::conditional<static_cast<int> (RVector::rank) == 2, RANK_TWO, RANK_ONE>::type ());
+}
+
+template <class AMatrix, class XVector, class BVector, class RVector>
+void
+residual (const AMatrix& A,
+          const XVector& x,
+          const BVector& b,
+          const RVector& r)
+{
+  KokkosKernels::Experimental::Controls controls;
+  residual (controls, A, x, b, r);
+}
+
+/// \brief Fused residual r = b - A*x, returning ||r||_2.
+///
+/// The squared norm is accumulated inside the residual kernel, so this
+/// replaces a copy, an spmv and a KokkosBlas::nrm2 by a single pass.
+/// Arguments are as for residual, with rank-1 x, b and r.
+template <class AMatrix, class XVector, class BVector, class RVector>
+typename std::enable_if<static_cast<int> (RVector::rank) == 1,
+                        typename Kokkos::Details::ArithTraits<typename RVector::non_const_value_type>::mag_type>::type
+residual_norm (KokkosKernels::Experimental::Controls controls,
+               const AMatrix& A,
+               const XVector& x,
+               const BVector& b,
+               const RVector& r)
+{
+  Impl::residual_check_dimensions (A, x, b, r);
+  return Impl::residual (controls, A, x, b, r, true);
+}
+
+/// \brief Fused multivector residual R = B - A*X, with the 2-norm of
+///   every column of R written to nrms.
+///
+/// \param nrms [out] Rank-1 View of the magnitude type of R, with
+///   R.extent(1) entries.
+template <class NV, class AMatrix, class XVector, class BVector, class RVector>
+typename std::enable_if<static_cast<int> (RVector::rank) == 2>::type
+residual_norm (KokkosKernels::Experimental::Controls controls,
+               const NV& nrms,
+               const AMatrix& A,
+               const XVector& x,
+               const BVector& b,
+               const RVector& r)
+{
+  static_assert (Kokkos::Impl::is_view<NV>::value && static_cast<int> (NV::rank) == 1,
+    "KokkosSparse::residual_norm: nrms must be a rank-1 Kokkos::View.");
+  Impl::residual_check_dimensions (A, x, b, r);
+  if (nrms.extent(0) != r.extent(1)) {
+    std::ostringstream os;
+    os << "KokkosSparse::residual_norm: Number of columns do not match: "
+       << "nrms: " << nrms.extent(0)
+       << ", r: " << r.extent(1);
+    Kokkos::Impl::throw_runtime_exception (os.str ());
+  }
+
+  typedef typename Kokkos::Details::ArithTraits<typename RVector::non_const_value_type>::mag_type mag_type;
+  Kokkos::View<mag_type*, Kokkos::HostSpace> nrms_h ("residual norms", r.extent(1));
+  Impl::residual_mv (controls, A, x, b, r, nrms_h.data ());
+  auto nrms_mirror = Kokkos::create_mirror_view (nrms);
+  for (size_t k = 0; k < r.extent(1); ++k) nrms_mirror(k) = nrms_h(k);
+  Kokkos::deep_copy (nrms, nrms_mirror);
+}
+
+template <class AMatrix, class XVector, class BVector, class RVector>
+typename std::enable_if<static_cast<int> (RVector::rank) == 1,
+                        typename Kokkos::Details::ArithTraits<typename RVector::non_const_value_type>::mag_type>::type
+residual_norm (const AMatrix& A,
+               const XVector& x,
+               const BVector& b,
+               const RVector& r)
+{
+  KokkosKernels::Experimental::Controls controls;
+  return residual_norm (controls, A, x, b, r);
+}
+
+template <class NV, class AMatrix, class XVector, class BVector, class RVector>
+typename std::enable_if<static_cast<int> (RVector::rank) == 2>::type
+residual_norm (const NV& nrms,
+               const AMatrix& A,
+               const XVector& x,
+               const BVector& b,
+               const RVector& r)
+{
+  KokkosKernels::Experimental::Controls controls;
+  residual_norm (controls, nrms, A, x, b, r);
+}
+
   namespace Experimental {
 
     template <class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
@@ -711,19 +1118,20 @@ void spmv(const char mode[],
         XVector_Internal x_i = x;
         YVector_Internal y_i = y;
 
-        return Impl::SPMV_MV<typename AMatrix_Internal::value_type,
-                             typename AMatrix_Internal::ordinal_type,
-                             typename AMatrix_Internal::device_type,
-                             typename AMatrix_Internal::memory_traits,
-                             typename AMatrix_Internal::size_type,
-                             typename XVector_Internal::value_type**,
-                             typename XVector_Internal::array_layout,
-                             typename XVector_Internal::device_type,
-                             typename XVector_Internal::memory_traits,
-                             typename YVector_Internal::value_type**,
-                             typename YVector_Internal::array_layout,
-                             typename YVector_Internal::device_type,
-                             typename YVector_Internal::memory_traits>::spmv_mv (mode, alpha, A_i, x_i, beta, y_i);
+        return Impl::SPMV_MV_STRUCT<typename AMatrix_Internal::value_type,
+                                    typename AMatrix_Internal::ordinal_type,
+                                    typename AMatrix_Internal::device_type,
+                                    typename AMatrix_Internal::memory_traits,
+                                    typename AMatrix_Internal::size_type,
+                                    typename XVector_Internal::value_type**,
+                                    typename XVector_Internal::array_layout,
+                                    typename XVector_Internal::device_type,
+                                    typename XVector_Internal::memory_traits,
+                                    typename YVector_Internal::value_type**,
+                                    typename YVector_Internal::array_layout,
+                                    typename YVector_Internal::device_type,
+                                    typename YVector_Internal::memory_traits>::spmv_mv_struct (mode, stencil_type, structure,
+                                                                                               alpha, A_i, x_i, beta, y_i);
       }
     }
 
@@ -741,7 +1149,9 @@ void spmv(const char mode[],
     /// \param alpha [in] Scalar multiplier for the matrix A.
     /// \param A [in] The sparse matrix; KokkosSparse::CrsMatrix instance.
     /// \param x [in] Either a single vector (rank-1 Kokkos::View) or
-    ///   multivector (rank-2 Kokkos::View).
+    ///   multivector (rank-2 Kokkos::View).  Multivectors may be
+    ///   LayoutLeft or LayoutRight; for "N" and "C" their columns are
+    ///   processed in register blocks on the stencil kernels.
     /// \param beta [in] Scalar multiplier for the (multi)vector y.
     /// \param y [in/out] Either a single vector (rank-1 Kokkos::View) or
     ///   multivector (rank-2 Kokkos::View).  It must have the same number
@@ -760,6 +1170,564 @@ void spmv(const char mode[],
       spmv_struct (mode, stencil_type, structure, alpha, A, x, beta, y, RANK_SPECIALISE ());
     }
 
+    /// \brief Kokkos sparse matrix-vector multiply on a SellCMatrix.
+    ///   Computes y := alpha*A*x + beta*y.
+    ///
+    /// Only the non transposed product is supported.  On CPUs each
+    /// thread processes whole chunks with a SIMD loop over the C rows
+    /// of the chunk; on GPUs each thread processes one row.  x and y
+    /// may be rank-1 or rank-2 Views; rank-2 Views are processed one
+    /// column at a time.
+    ///
+    /// \param controls [in] Controls; reserved, currently unused.
+    /// \param mode [in] Must be "N".
+    /// \param alpha [in] Scalar multiplier for the matrix A.
+    /// \param A [in] The sparse matrix; SellCMatrix instance.
+    /// \param x [in] Input (multi)vector.
+    /// \param beta [in] Scalar multiplier for the (multi)vector y.
+    /// \param y [in/out] Output (multi)vector.
+    template <class AlphaType, class ScalarType, class OrdinalType, class Device, class SizeType,
+              class XVector, class BetaType, class YVector>
+    void
+    spmv (KokkosKernels::Experimental::Controls /* controls */,
+          const char mode[],
+          const AlphaType& alpha,
+          const SellCMatrix<ScalarType, OrdinalType, Device, SizeType>& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y)
+    {
+      static_assert (Kokkos::Impl::is_view<XVector>::value,
+                     "KokkosSparse::spmv: XVector must be a Kokkos::View.");
+      static_assert (Kokkos::Impl::is_view<YVector>::value,
+                     "KokkosSparse::spmv: YVector must be a Kokkos::View.");
+      static_assert ((int) XVector::rank == (int) YVector::rank,
+                     "KokkosSparse::spmv: Vector ranks do not match.");
+      static_assert (std::is_same<typename YVector::value_type,
+                                  typename YVector::non_const_value_type>::value,
+                     "KokkosSparse::spmv: Output Vector must be non-const.");
+
+      if (mode[0] != NoTranspose[0]) {
+        Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv: SellCMatrix only supports mode \"N\"");
+      }
+      if ((x.extent(0) != static_cast<size_t> (A.numCols ())) ||
+          (y.extent(0) != static_cast<size_t> (A.numRows ())) ||
+          (x.extent(1) != y.extent(1))) {
+        std::ostringstream os;
+        os << "KokkosSparse::spmv (SellCMatrix): Dimensions do not match: "
+           << "A: " << A.numRows () << " x " << A.numCols ()
+           << ", x: " << x.extent(0) << " x " << x.extent(1)
+           << ", y: " << y.extent(0) << " x " << y.extent(1);
+        Kokkos::Impl::throw_runtime_exception (os.str ());
+      }
+
+      typedef SellCMatrix<ScalarType, OrdinalType, Device, SizeType> AMatrix;
+      typedef typename YVector::non_const_value_type y_value_type;
+      const y_value_type a = static_cast<y_value_type> (alpha);
+      const y_value_type b = static_cast<y_value_type> (beta);
+
+      KokkosSparse::Impl::spmv_sellc_mv<AMatrix> (a, A, x, b, y,
+                                                  std::integral_constant<int, static_cast<int> (XVector::rank)> ());
+    }
+
+    template <class AlphaType, class ScalarType, class OrdinalType, class Device, class SizeType,
+              class XVector, class BetaType, class YVector>
+    void
+    spmv (const char mode[],
+          const AlphaType& alpha,
+          const SellCMatrix<ScalarType, OrdinalType, Device, SizeType>& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y)
+    {
+      KokkosKernels::Experimental::Controls controls;
+      spmv (controls, mode, alpha, A, x, beta, y);
+    }
+
+    /// \brief Kokkos sparse matrix-vector multiply on a DeltaCrsMatrix.
+    ///   Computes y := alpha*op(A)*x + beta*y.
+    ///
+    /// Column indices are decoded from the 16-bit deltas on the fly;
+    /// otherwise the kernel is the same as the CrsMatrix one.  x and y
+    /// may be rank-1 or rank-2 Views; rank-2 Views are processed one
+    /// column at a time.
+    ///
+    /// \param controls [in] kokkos-kernels control structure; the team
+    ///   size, vector length and rows per thread parameters of spmv apply.
+    /// \param mode [in] "N" for no transpose or "C" for conjugate.
+    /// \param alpha [in] Scalar multiplier for the matrix A.
+    /// \param A [in] The sparse matrix; DeltaCrsMatrix instance.
+    /// \param x [in] Input (multi)vector.
+    /// \param beta [in] Scalar multiplier for the (multi)vector y.
+    /// \param y [in/out] Output (multi)vector.
+    template <class AlphaType, class ScalarType, class OrdinalType, class Device, class SizeType,
+              class XVector, class BetaType, class YVector>
+    void
+    spmv (KokkosKernels::Experimental::Controls controls,
+          const char mode[],
+          const AlphaType& alpha,
+          const DeltaCrsMatrix<ScalarType, OrdinalType, Device, SizeType>& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y)
+    {
+      static_assert (Kokkos::Impl::is_view<XVector>::value,
+                     "KokkosSparse::spmv: XVector must be a Kokkos::View.");
+      static_assert (Kokkos::Impl::is_view<YVector>::value,
+                     "KokkosSparse::spmv: YVector must be a Kokkos::View.");
+      static_assert ((int) XVector::rank == (int) YVector::rank,
+                     "KokkosSparse::spmv: Vector ranks do not match.");
+      static_assert (std::is_same<typename YVector::value_type,
+                                  typename YVector::non_const_value_type>::value,
+                     "KokkosSparse::spmv: Output Vector must be non-const.");
+
+      if ((mode[0] != NoTranspose[0]) && (mode[0] != Conjugate[0])) {
+        Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv: DeltaCrsMatrix only supports modes \"N\" and \"C\"");
+      }
+      if ((x.extent(0) != static_cast<size_t> (A.numCols ())) ||
+          (y.extent(0) != static_cast<size_t> (A.numRows ())) ||
+          (x.extent(1) != y.extent(1))) {
+        std::ostringstream os;
+        os << "KokkosSparse::spmv (DeltaCrsMatrix): Dimensions do not match: "
+           << "A: " << A.numRows () << " x " << A.numCols ()
+           << ", x: " << x.extent(0) << " x " << x.extent(1)
+           << ", y: " << y.extent(0) << " x " << y.extent(1);
+        Kokkos::Impl::throw_runtime_exception (os.str ());
+      }
+
+      typedef DeltaCrsMatrix<ScalarType, OrdinalType, Device, SizeType> AMatrix;
+      typedef typename YVector::non_const_value_type y_value_type;
+      const y_value_type a = static_cast<y_value_type> (alpha);
+      const y_value_type b = static_cast<y_value_type> (beta);
+
+      KokkosSparse::Impl::spmv_deltacrs_mv<AMatrix> (controls, mode[0] == Conjugate[0], a, A, x, b, y,
+                                                     std::integral_constant<int, static_cast<int> (XVector::rank)> ());
+    }
+
+    template <class AlphaType, class ScalarType, class OrdinalType, class Device, class SizeType,
+              class XVector, class BetaType, class YVector>
+    void
+    spmv (const char mode[],
+          const AlphaType& alpha,
+          const DeltaCrsMatrix<ScalarType, OrdinalType, Device, SizeType>& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y)
+    {
+      KokkosKernels::Experimental::Controls controls;
+      spmv (controls, mode, alpha, A, x, beta, y);
+    }
+
+    /// \brief Kokkos sparse matrix-vector multiply on a BlockCrsMatrix.
+    ///   Computes y := alpha*op(A)*x + beta*y.
+    ///
+    /// The kernels read one column index per block rather than one per
+    /// scalar entry.  Block sizes 1 to 8 use kernels specialized on the
+    /// block size; other block sizes use a runtime-sized kernel.  x and
+    /// y may be rank-1 or rank-2 Views; their lengths are in scalar
+    /// rows, i.e. blockDim times the number of block rows or columns.
+    ///
+    /// \param controls [in] Controls; reserved, currently unused.
+    /// \param mode [in] "N" for no transpose, "T" for transpose, "C"
+    ///   for conjugate, or "H" for conjugate transpose.
+    /// \param alpha [in] Scalar multiplier for the matrix A.
+    /// \param A [in] The sparse matrix; BlockCrsMatrix instance.
+    /// \param x [in] Input (multi)vector.
+    /// \param beta [in] Scalar multiplier for the (multi)vector y.
+    /// \param y [in/out] Output (multi)vector.
+    template <class AlphaType, class ScalarType, class OrdinalType, class Device, class MemoryTraits, class SizeType,
+              class XVector, class BetaType, class YVector>
+    void
+    spmv (KokkosKernels::Experimental::Controls /* controls */,
+          const char mode[],
+          const AlphaType& alpha,
+          const BlockCrsMatrix<ScalarType, OrdinalType, Device, MemoryTraits, SizeType>& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y)
+    {
+      static_assert (Kokkos::Impl::is_view<XVector>::value,
+                     "KokkosSparse::spmv: XVector must be a Kokkos::View.");
+      static_assert (Kokkos::Impl::is_view<YVector>::value,
+                     "KokkosSparse::spmv: YVector must be a Kokkos::View.");
+      static_assert ((int) XVector::rank == (int) YVector::rank,
+                     "KokkosSparse::spmv: Vector ranks do not match.");
+      static_assert (std::is_same<typename YVector::value_type,
+                                  typename YVector::non_const_value_type>::value,
+                     "KokkosSparse::spmv: Output Vector must be non-const.");
+
+      const bool transposed = (mode[0] == Transpose[0]) || (mode[0] == ConjugateTranspose[0]);
+      if (!transposed && (mode[0] != NoTranspose[0]) && (mode[0] != Conjugate[0])) {
+        std::ostringstream os;
+        os << "KokkosSparse::spmv (BlockCrsMatrix): Invalid mode \"" << mode << "\".";
+        Kokkos::Impl::throw_runtime_exception (os.str ());
+      }
+
+      const size_t numPointRows = static_cast<size_t> (A.numRows ()) * A.blockDim ();
+      const size_t numPointCols = static_cast<size_t> (A.numCols ()) * A.blockDim ();
+      if ((x.extent(0) != (transposed ? numPointRows : numPointCols)) ||
+          (y.extent(0) != (transposed ? numPointCols : numPointRows)) ||
+          (x.extent(1) != y.extent(1))) {
+        std::ostringstream os;
+        os << "KokkosSparse::spmv (BlockCrsMatrix): Dimensions do not match: "
+           << "mode " << mode
+           << ", A: " << numPointRows << " x " << numPointCols
+           << ", x: " << x.extent(0) << " x " << x.extent(1)
+           << ", y: " << y.extent(0) << " x " << y.extent(1);
+        Kokkos::Impl::throw_runtime_exception (os.str ());
+      }
+
+      typedef BlockCrsMatrix<ScalarType, OrdinalType, Device, MemoryTraits, SizeType> AMatrix;
+      typedef typename YVector::non_const_value_type y_value_type;
+      KokkosSparse::Impl::spmv_blockcrs_mv<AMatrix> (mode, static_cast<y_value_type> (alpha), A, x,
+                                                     static_cast<y_value_type> (beta), y,
+                                                     std::integral_constant<int, static_cast<int> (XVector::rank)> ());
+    }
+
+    template <class AlphaType, class ScalarType, class OrdinalType, class Device, class MemoryTraits, class SizeType,
+              class XVector, class BetaType, class YVector>
+    void
+    spmv (const char mode[],
+          const AlphaType& alpha,
+          const BlockCrsMatrix<ScalarType, OrdinalType, Device, MemoryTraits, SizeType>& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y)
+    {
+      KokkosKernels::Experimental::Controls controls;
+      spmv (controls, mode, alpha, A, x, beta, y);
+    }
+
+    /// \brief SpMV with a symmetric or Hermitian matrix of which only
+    ///   one triangle is stored.
+    ///
+    /// Compute y = beta*y + alpha*S*x, where S(i,j) = A(i,j) and
+    /// S(j,i) = A(i,j) (conj(A(i,j)) if \c hermitian) for every stored
+    /// off-diagonal entry of A; stored diagonal entries count once.  A
+    /// holds either the lower or the upper triangle, with or without
+    /// the diagonal (e.g. from KokkosKernels::Impl::kk_get_lower_crs_matrix,
+    /// which drops it), so the matrix streamed from memory is about
+    /// half the size of the full one.  A must not hold both (i,j) and
+    /// (j,i), or that pair is counted twice.
+    ///
+    /// On host execution spaces the rows are split into one nnz-balanced
+    /// block per thread; each block accumulates the mirrored updates
+    /// that fall outside of it in a private buffer, and the buffers are
+    /// summed in a second pass, so no atomics are needed.  GPU execution
+    /// spaces (or "algorithm" set to "atomic" in \c controls) use
+    /// atomic updates instead.
+    ///
+    /// \param controls [in] kokkos-kernels control structure; the team
+    ///   size, vector length and rows per thread parameters of spmv
+    ///   apply to the atomic kernel.
+    /// \param hermitian [in] If true, mirror entries as conj(A(i,j)).
+    /// \param alpha [in] Scalar multiplier for the matrix.
+    /// \param A [in] One triangle of the square matrix; KokkosSparse::CrsMatrix.
+    /// \param x [in] Either a single vector or a multivector.
+    /// \param beta [in] Scalar multiplier for y.
+    /// \param y [in/out] Either a single vector or a multivector.
+    template <class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+    void
+    spmv_symmetric (KokkosKernels::Experimental::Controls controls,
+                    const bool hermitian,
+                    const AlphaType& alpha,
+                    const AMatrix& A,
+                    const XVector& x,
+                    const BetaType& beta,
+                    const YVector& y)
+    {
+      static_assert (static_cast<int> (XVector::rank) == static_cast<int> (YVector::rank),
+                     "KokkosSparse::spmv_symmetric: Vector ranks do not match.");
+      static_assert (std::is_same<typename YVector::value_type,
+                                  typename YVector::non_const_value_type>::value,
+                     "KokkosSparse::spmv_symmetric: Output Vector must be non-const.");
+
+      if ((A.numRows () != A.numCols ()) ||
+          (x.extent(0) != static_cast<size_t> (A.numCols ())) ||
+          (y.extent(0) != static_cast<size_t> (A.numRows ())) ||
+          (x.extent(1) != y.extent(1))) {
+        std::ostringstream os;
+        os << "KokkosSparse::spmv_symmetric: Dimensions do not match: "
+           << "A: " << A.numRows () << " x " << A.numCols ()
+           << ", x: " << x.extent(0) << " x " << x.extent(1)
+           << ", y: " << y.extent(0) << " x " << y.extent(1);
+        Kokkos::Impl::throw_runtime_exception (os.str ());
+      }
+
+      typedef typename YVector::non_const_value_type y_value_type;
+      const y_value_type a = alpha;
+      const y_value_type b = beta;
+      KokkosSparse::Impl::spmv_symmetric_mv (controls, hermitian, a, A, x, b, y,
+                                             std::integral_constant<int, static_cast<int> (XVector::rank)> ());
+    }
+
+    template <class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+    void
+    spmv_symmetric (const bool hermitian,
+                    const AlphaType& alpha,
+                    const AMatrix& A,
+                    const XVector& x,
+                    const BetaType& beta,
+                    const YVector& y)
+    {
+      KokkosKernels::Experimental::Controls controls;
+      spmv_symmetric (controls, hermitian, alpha, A, x, beta, y);
+    }
+
+    /// \brief spmv_symmetric reusing the row blocks of the host kernel.
+    ///
+    /// The handle-less spmv_symmetric splits the rows into blocks, and
+    /// works out which blocks' partial results each row must add, on
+    /// every call.  This overload keeps that partition in the SpMV
+    /// handle of \c handle and builds it only on the first call, or
+    /// after spmv_symbolic (which must be called again when the graph
+    /// of A changes).  GPU execution spaces use the atomic kernel,
+    /// which needs no partition.
+    ///
+    /// \param handle [in/out] KokkosKernelsHandle on which
+    ///   create_spmv_handle() has been called.
+    template <class KernelHandle, class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+    void
+    spmv_symmetric (KernelHandle* handle,
+                    const bool hermitian,
+                    const AlphaType& alpha,
+                    const AMatrix& A,
+                    const XVector& x,
+                    const BetaType& beta,
+                    const YVector& y)
+    {
+      static_assert (static_cast<int> (XVector::rank) == static_cast<int> (YVector::rank),
+                     "KokkosSparse::spmv_symmetric: Vector ranks do not match.");
+      static_assert (std::is_same<typename YVector::value_type,
+                                  typename YVector::non_const_value_type>::value,
+                     "KokkosSparse::spmv_symmetric: Output Vector must be non-const.");
+
+      auto spmv_handle = handle->get_spmv_handle ();
+      if (spmv_handle == nullptr) {
+        Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv_symmetric: call create_spmv_handle() first");
+      }
+      if ((A.numRows () != A.numCols ()) ||
+          (x.extent(0) != static_cast<size_t> (A.numCols ())) ||
+          (y.extent(0) != static_cast<size_t> (A.numRows ())) ||
+          (x.extent(1) != y.extent(1))) {
+        std::ostringstream os;
+        os << "KokkosSparse::spmv_symmetric: Dimensions do not match: "
+           << "A: " << A.numRows () << " x " << A.numCols ()
+           << ", x: " << x.extent(0) << " x " << x.extent(1)
+           << ", y: " << y.extent(0) << " x " << y.extent(1);
+        Kokkos::Impl::throw_runtime_exception (os.str ());
+      }
+      if (!spmv_handle->is_symbolic_valid (A.numRows (), A.numCols (), A.nnz (), A.graph.row_map, A.graph.entries)) {
+        KokkosSparse::Impl::spmv_symbolic_impl (spmv_handle, A);
+      }
+
+      typedef typename YVector::non_const_value_type y_value_type;
+      const y_value_type a = alpha;
+      const y_value_type b = beta;
+      KokkosSparse::Impl::spmv_symmetric_mv (spmv_handle, hermitian, a, A, x, b, y,
+                                             std::integral_constant<int, static_cast<int> (XVector::rank)> ());
+    }
+
+    /// \brief Inspector for the handle-based SpMV.
+    ///
+    /// Analyzes the row lengths of A, then stores an nnz-balanced row
+    /// partition, the kernel variant and its launch parameters in the
+    /// SpMV handle of \c handle.  Call once per matrix structure;
+    /// spmv(handle, ...) calls this itself if it has not been done yet,
+    /// if the matrix dimensions or number of entries changed, or if A's
+    /// row map or entries are other views than the analyzed ones.  It
+    /// must be called again after the pattern of A is changed in place.
+    ///
+    /// \param handle [in/out] KokkosKernelsHandle on which
+    ///   create_spmv_handle() has been called.
+    /// \param A [in] The sparse matrix; KokkosSparse::CrsMatrix instance.
+    template <class KernelHandle, class AMatrix>
+    void
+    spmv_symbolic (KernelHandle* handle, const AMatrix& A)
+    {
+      auto spmv_handle = handle->get_spmv_handle ();
+      if (spmv_handle == nullptr) {
+        Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv_symbolic: call create_spmv_handle() first");
+      }
+      KokkosSparse::Impl::spmv_symbolic_impl (spmv_handle, A);
+    }
+
+    /// \brief Refresh the values cached by spmv_symbolic after the
+    ///   values of A changed but its graph did not.
+    ///
+    /// Only needed with explicit transposes (set_explicit_transpose(true))
+    /// or NUMA first touch (set_numa_first_touch(true)) enabled on the
+    /// SpMV handle: the cached A^T is updated with a gather from A's
+    /// values, without rebuilding its graph, and the first-touched copy
+    /// of A gets the new values written by the same threads as before.
+    /// If no valid analysis exists yet, this runs spmv_symbolic.
+    ///
+    /// \param handle [in/out] KokkosKernelsHandle on which
+    ///   create_spmv_handle() has been called.
+    /// \param A [in] The sparse matrix with the same graph as analyzed.
+    template <class KernelHandle, class AMatrix>
+    void
+    spmv_numeric (KernelHandle* handle, const AMatrix& A)
+    {
+      auto spmv_handle = handle->get_spmv_handle ();
+      if (spmv_handle == nullptr) {
+        Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv_numeric: call create_spmv_handle() first");
+      }
+      if (!spmv_handle->is_symbolic_valid (A.numRows (), A.numCols (), A.nnz (), A.graph.row_map, A.graph.entries)) {
+        KokkosSparse::Impl::spmv_symbolic_impl (spmv_handle, A);
+      }
+      else {
+        if (spmv_handle->use_explicit_transpose ())
+          KokkosSparse::Impl::spmv_transpose_numeric_impl (spmv_handle, A);
+        if (spmv_handle->is_numa_complete ())
+          KokkosSparse::Impl::spmv_numa_numeric_impl (spmv_handle, A);
+      }
+    }
+
+    /// \brief Copy a vector so that its pages are placed on the NUMA
+    ///   nodes of the OpenMP threads that use them in spmv(handle, ...).
+    ///
+    /// Requires set_numa_first_touch(true) on the SpMV handle and a
+    /// completed spmv_symbolic; each thread then writes the chunk of
+    /// the copy that matches its block of rows.  Pass the returned
+    /// vector as y (and, for square matrices, as x) instead of the
+    /// original.  Otherwise, or on other execution spaces, this is a
+    /// plain copy.
+    ///
+    /// \param handle [in] KokkosKernelsHandle on which
+    ///   create_spmv_handle() and spmv_symbolic have been called.
+    /// \param v [in] Rank-1 vector to copy.
+    template <class KernelHandle, class VectorType>
+    Kokkos::View<typename VectorType::non_const_value_type*, Kokkos::LayoutLeft, typename VectorType::device_type>
+    spmv_first_touch (KernelHandle* handle, const VectorType& v)
+    {
+      static_assert (static_cast<int> (VectorType::rank) == 1,
+                     "KokkosSparse::spmv_first_touch: v must be a rank-1 View.");
+      auto spmv_handle = handle->get_spmv_handle ();
+      if (spmv_handle == nullptr) {
+        Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv_first_touch: call create_spmv_handle() first");
+      }
+      return KokkosSparse::Impl::spmv_numa_first_touch_vector (spmv_handle, v);
+    }
+
+    /// \brief Executor for the handle-based SpMV; computes
+    ///   y := alpha*op(A)*x + beta*y, reusing the analysis stored in
+    ///   the handle's SpMV handle.
+    ///
+    /// Modes "N" and "C" with rank-1 x and y use the cached partition,
+    /// or, on OpenMP with NUMA first touch enabled on the SpMV handle,
+    /// the first-touched copy of A with one block of rows per thread;
+    /// the caller must then call spmv_numeric after changing the values
+    /// of A.  Modes "T" and "H" run the non-transpose kernel on the cached A^T
+    /// if the SpMV handle has explicit transposes enabled; the caller
+    /// must call spmv_numeric after changing the values of A.  Other
+    /// cases are forwarded to the handle-less KokkosSparse::spmv.
+    ///
+    /// \param handle [in/out] KokkosKernelsHandle on which
+    ///   create_spmv_handle() has been called.
+    /// \param mode [in] "N", "C", "T" or "H".
+    /// \param alpha [in] Scalar multiplier for the matrix A.
+    /// \param A [in] The sparse matrix; KokkosSparse::CrsMatrix instance.
+    /// \param x [in] Input (multi)vector.
+    /// \param beta [in] Scalar multiplier for the (multi)vector y.
+    /// \param y [in/out] Output (multi)vector.
+    template <class KernelHandle, class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+    void
+    spmv (KernelHandle* handle,
+          const char mode[],
+          const AlphaType& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y,
+          const RANK_ONE)
+    {
+      using KokkosSparse::Experimental::SPMVAlgorithm;
+
+      auto spmv_handle = handle->get_spmv_handle ();
+      if (spmv_handle == nullptr) {
+        Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv: call create_spmv_handle() first");
+      }
+
+      if ((mode[0] != NoTranspose[0]) && (mode[0] != Conjugate[0])) {
+        if (spmv_handle->use_explicit_transpose ()) {
+          if (!spmv_handle->is_symbolic_valid (A.numRows (), A.numCols (), A.nnz (), A.graph.row_map, A.graph.entries)) {
+            KokkosSparse::Impl::spmv_symbolic_impl (spmv_handle, A);
+          }
+          KokkosSparse::Impl::spmv_explicit_transpose (spmv_handle, mode, alpha, A, x, beta, y);
+          return;
+        }
+        KokkosSparse::spmv (mode, alpha, A, x, beta, y);
+        return;
+      }
+      if ((x.extent(0) != static_cast<size_t> (A.numCols ())) ||
+          (y.extent(0) != static_cast<size_t> (A.numRows ()))) {
+        std::ostringstream os;
+        os << "KokkosSparse::spmv (handle): Dimensions do not match: "
+           << "A: " << A.numRows () << " x " << A.numCols ()
+           << ", x: " << x.extent(0) << ", y: " << y.extent(0);
+        Kokkos::Impl::throw_runtime_exception (os.str ());
+      }
+
+      if (!spmv_handle->is_symbolic_valid (A.numRows (), A.numCols (), A.nnz (), A.graph.row_map, A.graph.entries)) {
+        KokkosSparse::Impl::spmv_symbolic_impl (spmv_handle, A);
+      }
+
+      if (spmv_handle->get_selected_algorithm () == SPMVAlgorithm::SPMV_MERGE_PATH &&
+          !spmv_handle->is_numa_complete ()) {
+        KokkosKernels::Experimental::Controls controls;
+        controls.setParameter ("algorithm", "native-merge");
+        KokkosSparse::spmv (controls, mode, alpha, A, x, beta, y);
+        return;
+      }
+
+      typedef typename YVector::non_const_value_type y_value_type;
+      KokkosSparse::Impl::spmv_partitioned (spmv_handle, mode[0] == Conjugate[0],
+                                            static_cast<y_value_type> (alpha), A, x,
+                                            static_cast<y_value_type> (beta), y);
+    }
+
+    template <class KernelHandle, class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+    void
+    spmv (KernelHandle* handle,
+          const char mode[],
+          const AlphaType& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y,
+          const RANK_TWO)
+    {
+      auto spmv_handle = handle->get_spmv_handle ();
+      if ((spmv_handle != nullptr) && spmv_handle->use_explicit_transpose () &&
+          (mode[0] != NoTranspose[0]) && (mode[0] != Conjugate[0])) {
+        if (!spmv_handle->is_symbolic_valid (A.numRows (), A.numCols (), A.nnz (), A.graph.row_map, A.graph.entries)) {
+          KokkosSparse::Impl::spmv_symbolic_impl (spmv_handle, A);
+        }
+        KokkosSparse::Impl::spmv_explicit_transpose (spmv_handle, mode, alpha, A, x, beta, y);
+        return;
+      }
+      KokkosSparse::spmv (mode, alpha, A, x, beta, y);
+    }
+
+    template <class KernelHandle, class AlphaType, class AMatrix, class XVector, class BetaType, class YVector>
+    void
+    spmv (KernelHandle* handle,
+          const char mode[],
+          const AlphaType& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          const BetaType& beta,
+          const YVector& y)
+    {
+      static_assert ((int) XVector::rank == (int) YVector::rank,
+                     "KokkosSparse::spmv: Vector ranks do not match.");
+      using RANK_SPECIALISE =
+        typename std::conditional<static_cast<int> (XVector::rank) == 2,
+                                  RANK_TWO, RANK_ONE>::type;
+      spmv (handle, mode, alpha, A, x, beta, y, RANK_SPECIALISE ());
+    }
+
   } // namespace Experimental
 } // namespace KokkosSparse
 
@@ -0,0 +1,375 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_MemoryTraits.hpp>
+#include <Kokkos_Core.hpp>
+#include <iostream>
+#include <string>
+
+#ifndef _SPMVHANDLE_HPP
+#define _SPMVHANDLE_HPP
+
+namespace KokkosSparse {
+namespace Experimental {
+
+/// Kernel variants the SpMV inspector can pick from.
+///   SPMV_PARTITIONED: rows are split into contiguous blocks holding
+///     about the same number of nonzeros; one team per block.
+///   SPMV_MERGE_PATH: merge-path kernel, which also splits long rows.
+///     Picked when a single row holds more nonzeros than a block.
+enum class SPMVAlgorithm { SPMV_DEFAULT, SPMV_PARTITIONED, SPMV_MERGE_PATH };
+
+/// \brief Handle for the inspector-executor SpMV.
+///
+/// spmv_symbolic analyzes the row length distribution of a matrix once
+/// and stores an nnz-balanced row partition along with the selected
+/// kernel variant and launch parameters.  Subsequent spmv calls with
+/// the same handle reuse them instead of recomputing the launch
+/// parameters on every call.  The handle remembers the dimensions and
+/// the number of entries of the analyzed matrix, and holds its row map
+/// and entries, and reruns the analysis if any of them change.  A
+/// matrix whose row map or entries are unmanaged, or in another memory
+/// space than the handle, cannot be held and is analyzed on every call.
+/// A pattern changed in place, in the same row map and entries views,
+/// is not detected: call spmv_symbolic again after such a change.
+///
+/// With set_explicit_transpose(true), the analysis also stores A^T
+/// explicitly, so that the "T" and "H" modes run the non-transpose
+/// kernel on A^T instead of scattering into y with atomics.  Along
+/// with A^T the handle keeps, for each entry of A^T, the index of the
+/// matching entry of A, so that spmv_numeric can refresh the values of
+/// A^T with a gather when only the values of A changed.
+///
+/// With set_numa_first_touch(true) and the OpenMP execution space, the
+/// analysis also splits the rows into one nnz-balanced block per
+/// OpenMP thread and keeps a copy of A in which each thread has
+/// first-touched the rows, entries and values of its own block.  With
+/// bound threads (OMP_PROC_BIND=spread or close) these pages end up on
+/// the thread's own NUMA node, and the "N" and "C" modes then run on
+/// the copy with the same thread-to-rows assignment on every call.
+/// spmv_first_touch re-homes x and y the same way.
+///
+/// spmv_symmetric(handle, ...) keeps the row blocks of its host kernel
+/// in the handle, so that the partition is built once per analysis
+/// instead of on every call.
+template <class size_type_, class lno_t_, class scalar_t_,
+          class ExecutionSpace,
+          class TemporaryMemorySpace,
+          class PersistentMemorySpace>
+class SPMVHandle {
+public:
+
+  typedef ExecutionSpace HandleExecSpace;
+  typedef TemporaryMemorySpace HandleTempMemorySpace;
+  typedef PersistentMemorySpace HandlePersistentMemorySpace;
+
+  typedef ExecutionSpace execution_space;
+  typedef HandlePersistentMemorySpace memory_space;
+
+  typedef typename std::remove_const<size_type_>::type  size_type;
+  typedef const size_type const_size_type;
+
+  typedef typename std::remove_const<lno_t_>::type  nnz_lno_t;
+  typedef const nnz_lno_t const_nnz_lno_t;
+
+  typedef typename std::remove_const<scalar_t_>::type  nnz_scalar_t;
+  typedef const nnz_scalar_t const_nnz_scalar_t;
+
+  typedef typename Kokkos::View<nnz_lno_t *, HandlePersistentMemorySpace> nnz_lno_view_t;
+  typedef typename Kokkos::View<size_type *, HandlePersistentMemorySpace> size_type_view_t;
+  typedef typename Kokkos::View<nnz_scalar_t *, HandlePersistentMemorySpace> scalar_view_t;
+  typedef typename Kokkos::View<const size_type *, HandlePersistentMemorySpace> const_size_type_view_t;
+  typedef typename Kokkos::View<const nnz_lno_t *, HandlePersistentMemorySpace> const_nnz_lno_view_t;
+
+private:
+
+  nnz_lno_view_t row_partition; //first row of each partition, num_partitions+1 entries
+
+  nnz_lno_t nrows;
+  nnz_lno_t ncols;
+  size_type nnz;
+  const_size_type_view_t graph_row_map; //graph of the analyzed matrix, empty if it could not be held
+  const_nnz_lno_view_t graph_entries;
+  nnz_lno_t max_row_length;
+  nnz_lno_t num_partitions;
+
+  bool symbolic_complete;
+
+  SPMVAlgorithm algm;
+  SPMVAlgorithm selected_algm;
+
+  int team_size;
+  int vector_size;
+
+  bool explicit_transpose;
+  bool transpose_complete;
+  size_type_view_t transpose_row_map;
+  nnz_lno_view_t transpose_entries;
+  scalar_view_t transpose_values;
+  size_type_view_t transpose_perm; //entry of A matching each entry of A^T
+
+  bool numa_first_touch;
+  bool numa_complete;
+  nnz_lno_view_t numa_thread_rows; //first row of each thread's block, num_threads+1 entries
+  size_type_view_t numa_row_map;
+  nnz_lno_view_t numa_entries;
+  scalar_view_t numa_values;
+
+  bool symmetric_complete;
+  nnz_lno_view_t symmetric_block_start; //first row of each block, num_blocks+1 entries
+  nnz_lno_view_t symmetric_range_lo;    //first row of y each block may update
+  size_type_view_t symmetric_buf_ptr;   //start of each block's private buffer
+  nnz_lno_view_t symmetric_seg_start;   //row segments of the reduce, num_segs+1 entries
+  size_type_view_t symmetric_seg_ptr;
+  nnz_lno_view_t symmetric_seg_blocks;  //blocks other than the owner covering each segment
+  size_type symmetric_buf_size;
+
+public:
+
+  SPMVHandle ( SPMVAlgorithm choice = SPMVAlgorithm::SPMV_DEFAULT ) :
+    row_partition(),
+    nrows(0),
+    ncols(0),
+    nnz(0),
+    graph_row_map(),
+    graph_entries(),
+    max_row_length(0),
+    num_partitions(0),
+    symbolic_complete(false),
+    algm(choice),
+    selected_algm(choice),
+    team_size(-1),
+    vector_size(-1),
+    explicit_transpose(false),
+    transpose_complete(false),
+    transpose_row_map(),
+    transpose_entries(),
+    transpose_values(),
+    transpose_perm(),
+    numa_first_touch(false),
+    numa_complete(false),
+    numa_thread_rows(),
+    numa_row_map(),
+    numa_entries(),
+    numa_values(),
+    symmetric_complete(false),
+    symmetric_block_start(),
+    symmetric_range_lo(),
+    symmetric_buf_ptr(),
+    symmetric_seg_start(),
+    symmetric_seg_ptr(),
+    symmetric_seg_blocks(),
+    symmetric_buf_size(0)
+  {}
+
+  virtual ~SPMVHandle() {};
+
+  void set_algorithm(SPMVAlgorithm choice) { algm = choice; reset_symbolic_complete(); }
+  SPMVAlgorithm get_algorithm() const { return algm; }
+
+  // The variant chosen by spmv_symbolic; equals get_algorithm() unless that is SPMV_DEFAULT.
+  void set_selected_algorithm(SPMVAlgorithm choice) { selected_algm = choice; }
+  SPMVAlgorithm get_selected_algorithm() const { return selected_algm; }
+
+  nnz_lno_view_t get_row_partition() const { return row_partition; }
+  void set_row_partition(const nnz_lno_view_t& row_partition_) {
+    this->row_partition = row_partition_;
+    this->num_partitions = row_partition_.extent(0) > 0 ? row_partition_.extent(0) - 1 : 0;
+  }
+  nnz_lno_t get_num_partitions() const { return num_partitions; }
+
+  nnz_lno_t get_nrows() const { return nrows; }
+  nnz_lno_t get_ncols() const { return ncols; }
+  size_type get_nnz() const { return nnz; }
+  void set_matrix_size(const nnz_lno_t nrows_, const nnz_lno_t ncols_, const size_type nnz_) {
+    this->nrows = nrows_;
+    this->ncols = ncols_;
+    this->nnz   = nnz_;
+  }
+
+  // The row map and entries of the analyzed matrix, or empty views.
+  void set_matrix_graph(const const_size_type_view_t& row_map_, const const_nnz_lno_view_t& entries_) {
+    this->graph_row_map = row_map_;
+    this->graph_entries = entries_;
+  }
+  const_size_type_view_t get_matrix_graph_row_map() const { return graph_row_map; }
+  const_nnz_lno_view_t get_matrix_graph_entries() const { return graph_entries; }
+
+  nnz_lno_t get_max_row_length() const { return max_row_length; }
+  void set_max_row_length(const nnz_lno_t max_row_length_) { this->max_row_length = max_row_length_; }
+
+  // True if the cached analysis was done for a matrix of this shape,
+  // with the row map and entries held by the handle.
+  template <class RowMapType, class EntriesType>
+  bool is_symbolic_valid(const nnz_lno_t nrows_, const nnz_lno_t ncols_, const size_type nnz_,
+                         const RowMapType& row_map_, const EntriesType& entries_) const {
+    return symbolic_complete && (nrows == nrows_) && (ncols == ncols_) && (nnz == nnz_) &&
+           (static_cast<const void*>(graph_row_map.data()) == static_cast<const void*>(row_map_.data())) &&
+           (graph_row_map.extent(0) == row_map_.extent(0)) &&
+           (static_cast<const void*>(graph_entries.data()) == static_cast<const void*>(entries_.data())) &&
+           (graph_entries.extent(0) == entries_.extent(0));
+  }
+
+  bool is_symbolic_complete() const { return symbolic_complete; }
+  void set_symbolic_complete() { this->symbolic_complete = true; }
+  void reset_symbolic_complete() { this->symbolic_complete = false; }
+
+  void set_team_size(const int ts) {this->team_size = ts;}
+  int get_team_size() const {return this->team_size;}
+
+  void set_vector_size(const int vs) {this->vector_size = vs;}
+  int get_vector_size() const {return this->vector_size;}
+
+  // Build and use A^T for the "T" and "H" modes.
+  void set_explicit_transpose(const bool use) {
+    this->explicit_transpose = use;
+    if (use && !transpose_complete) reset_symbolic_complete();
+  }
+  bool use_explicit_transpose() const { return explicit_transpose; }
+
+  bool is_transpose_complete() const { return transpose_complete; }
+  void set_transpose(const size_type_view_t& row_map_, const nnz_lno_view_t& entries_,
+                     const scalar_view_t& values_, const size_type_view_t& perm_) {
+    this->transpose_row_map  = row_map_;
+    this->transpose_entries  = entries_;
+    this->transpose_values   = values_;
+    this->transpose_perm     = perm_;
+    this->transpose_complete = true;
+  }
+  void reset_transpose() {
+    this->transpose_row_map  = size_type_view_t();
+    this->transpose_entries  = nnz_lno_view_t();
+    this->transpose_values   = scalar_view_t();
+    this->transpose_perm     = size_type_view_t();
+    this->transpose_complete = false;
+  }
+  size_type_view_t get_transpose_row_map() const { return transpose_row_map; }
+  nnz_lno_view_t get_transpose_entries() const { return transpose_entries; }
+  scalar_view_t get_transpose_values() const { return transpose_values; }
+  size_type_view_t get_transpose_perm() const { return transpose_perm; }
+
+  // Keep a first-touched copy of A for the OpenMP execution space.
+  void set_numa_first_touch(const bool use) {
+    this->numa_first_touch = use;
+    if (use && !numa_complete) reset_symbolic_complete();
+  }
+  bool use_numa_first_touch() const { return numa_first_touch; }
+
+  bool is_numa_complete() const { return numa_complete; }
+  void set_numa_matrix(const nnz_lno_view_t& thread_rows_, const size_type_view_t& row_map_,
+                       const nnz_lno_view_t& entries_, const scalar_view_t& values_) {
+    this->numa_thread_rows = thread_rows_;
+    this->numa_row_map     = row_map_;
+    this->numa_entries     = entries_;
+    this->numa_values      = values_;
+    this->numa_complete    = true;
+  }
+  void reset_numa_matrix() {
+    this->numa_thread_rows = nnz_lno_view_t();
+    this->numa_row_map     = size_type_view_t();
+    this->numa_entries     = nnz_lno_view_t();
+    this->numa_values      = scalar_view_t();
+    this->numa_complete    = false;
+  }
+  nnz_lno_view_t get_numa_thread_rows() const { return numa_thread_rows; }
+  size_type_view_t get_numa_row_map() const { return numa_row_map; }
+  nnz_lno_view_t get_numa_entries() const { return numa_entries; }
+  scalar_view_t get_numa_values() const { return numa_values; }
+
+  // Row blocks of the host kernel of spmv_symmetric.
+  bool is_symmetric_partition_complete() const { return symmetric_complete; }
+  void set_symmetric_partition(const nnz_lno_view_t& block_start_, const nnz_lno_view_t& range_lo_,
+                               const size_type_view_t& buf_ptr_, const nnz_lno_view_t& seg_start_,
+                               const size_type_view_t& seg_ptr_, const nnz_lno_view_t& seg_blocks_,
+                               const size_type buf_size_) {
+    this->symmetric_block_start = block_start_;
+    this->symmetric_range_lo    = range_lo_;
+    this->symmetric_buf_ptr     = buf_ptr_;
+    this->symmetric_seg_start   = seg_start_;
+    this->symmetric_seg_ptr     = seg_ptr_;
+    this->symmetric_seg_blocks  = seg_blocks_;
+    this->symmetric_buf_size    = buf_size_;
+    this->symmetric_complete    = true;
+  }
+  void reset_symmetric_partition() {
+    this->symmetric_block_start = nnz_lno_view_t();
+    this->symmetric_range_lo    = nnz_lno_view_t();
+    this->symmetric_buf_ptr     = size_type_view_t();
+    this->symmetric_seg_start   = nnz_lno_view_t();
+    this->symmetric_seg_ptr     = size_type_view_t();
+    this->symmetric_seg_blocks  = nnz_lno_view_t();
+    this->symmetric_buf_size    = 0;
+    this->symmetric_complete    = false;
+  }
+  nnz_lno_view_t get_symmetric_block_start() const { return symmetric_block_start; }
+  nnz_lno_view_t get_symmetric_range_lo() const { return symmetric_range_lo; }
+  size_type_view_t get_symmetric_buf_ptr() const { return symmetric_buf_ptr; }
+  nnz_lno_view_t get_symmetric_seg_start() const { return symmetric_seg_start; }
+  size_type_view_t get_symmetric_seg_ptr() const { return symmetric_seg_ptr; }
+  nnz_lno_view_t get_symmetric_seg_blocks() const { return symmetric_seg_blocks; }
+  size_type get_symmetric_buf_size() const { return symmetric_buf_size; }
+
+  void print_algorithm() {
+    if ( selected_algm == SPMVAlgorithm::SPMV_DEFAULT )
+      std::cout << "SPMV_DEFAULT" << std::endl;
+    if ( selected_algm == SPMVAlgorithm::SPMV_PARTITIONED )
+      std::cout << "SPMV_PARTITIONED" << std::endl;
+    if ( selected_algm == SPMVAlgorithm::SPMV_MERGE_PATH )
+      std::cout << "SPMV_MERGE_PATH" << std::endl;
+  }
+
+  inline SPMVAlgorithm StringToSPMVAlgorithm(std::string & name) {
+    if(name=="SPMV_DEFAULT")          return SPMVAlgorithm::SPMV_DEFAULT;
+    else if(name=="SPMV_PARTITIONED") return SPMVAlgorithm::SPMV_PARTITIONED;
+    else if(name=="SPMV_MERGE_PATH")  return SPMVAlgorithm::SPMV_MERGE_PATH;
+    else
+      throw std::runtime_error("Invalid SPMVAlgorithm name");
+  }
+
+};
+
+} // namespace Experimental
+} // namespace KokkosSparse
+
+#endif
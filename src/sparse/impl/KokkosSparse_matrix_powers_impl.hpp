@@ -0,0 +1,321 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_MATRIX_POWERS_HPP_
+#define KOKKOSSPARSE_IMPL_MATRIX_POWERS_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include <cmath>
+#include <vector>
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief Build the tiles of the matrix powers kernel on the host.
+///
+/// Rows are cut into contiguous tiles of tile_rows rows.  For a tile,
+/// level s is computed on the tile's own rows, and level k < s on the
+/// rows level k+1 reads from (the ghost zone).  The rows of a tile
+/// are listed so that the rows of level k are always the first
+/// level_count(k) entries: own rows first, then the ghost rows added
+/// for level s-1, then those added for level s-2, and so on.
+/// local_cols gives, for every entry of a listed row, the position of
+/// its column in the tile's list, or -1 if the column is not listed
+/// (only possible for the rows of level 1, which read x directly).
+template<class RowMapHost, class EntriesHost,
+         class ordinal_type, class size_type>
+void matrix_powers_build_tiles (const RowMapHost& row_map,
+                                const EntriesHost& entries,
+                                const ordinal_type nrows,
+                                const int s,
+                                const ordinal_type tile_rows,
+                                std::vector<size_type>& tile_ptr,
+                                std::vector<ordinal_type>& level_count,
+                                std::vector<ordinal_type>& local_rows,
+                                std::vector<size_type>& local_col_ptr,
+                                std::vector<ordinal_type>& local_cols)
+{
+  const ordinal_type num_tiles = (nrows + tile_rows - 1) / tile_rows;
+
+  tile_ptr.assign (1, 0);
+  level_count.assign (static_cast<size_t> (num_tiles) * s, 0);
+  local_rows.clear ();
+  local_col_ptr.assign (1, 0);
+  local_cols.clear ();
+
+  // stamp(r) == tile marks row r as listed in the current tile, and
+  // position(r) is then its index in the tile's list
+  std::vector<ordinal_type> stamp (nrows, -1);
+  std::vector<ordinal_type> position (nrows, 0);
+
+  for (ordinal_type tile = 0; tile < num_tiles; ++tile) {
+    const ordinal_type row_begin = tile * tile_rows;
+    const ordinal_type row_end   = std::min (nrows, row_begin + tile_rows);
+    const size_t list_begin      = local_rows.size ();
+
+    for (ordinal_type row = row_begin; row < row_end; ++row) {
+      stamp[row]    = tile;
+      position[row] = static_cast<ordinal_type> (local_rows.size () - list_begin);
+      local_rows.push_back (row);
+    }
+    level_count[static_cast<size_t> (tile) * s + (s - 1)] = row_end - row_begin;
+
+    // Each level only needs to expand the rows added for the level above it
+    size_t frontier_begin = list_begin;
+    for (int level = s - 1; level >= 1; --level) {
+      const size_t frontier_end = local_rows.size ();
+      for (size_t i = frontier_begin; i < frontier_end; ++i) {
+        const ordinal_type row = local_rows[i];
+        for (size_type j = row_map(row); j < row_map(row + 1); ++j) {
+          const ordinal_type col = entries(j);
+          if (stamp[col] != tile) {
+            stamp[col]    = tile;
+            position[col] = static_cast<ordinal_type> (local_rows.size () - list_begin);
+            local_rows.push_back (col);
+          }
+        }
+      }
+      frontier_begin = frontier_end;
+      level_count[static_cast<size_t> (tile) * s + (level - 1)] =
+        static_cast<ordinal_type> (local_rows.size () - list_begin);
+    }
+
+    for (size_t i = list_begin; i < local_rows.size (); ++i) {
+      const ordinal_type row = local_rows[i];
+      for (size_type j = row_map(row); j < row_map(row + 1); ++j) {
+        const ordinal_type col = entries(j);
+        local_cols.push_back (stamp[col] == tile ? position[col] : ordinal_type (-1));
+      }
+      local_col_ptr.push_back (static_cast<size_type> (local_cols.size ()));
+    }
+    tile_ptr.push_back (static_cast<size_type> (local_rows.size ()));
+  }
+}
+
+/// \brief The s Chebyshev nodes of [lambda_min, lambda_max] in Leja order.
+///
+/// The first node is the one of largest magnitude; each next node
+/// maximizes the product of its distances to the nodes already taken
+/// (summed as logarithms, so the product does not overflow).  Applying
+/// the shifts in this order keeps the intermediate basis vectors of a
+/// Newton basis well scaled.
+inline void matrix_powers_leja_chebyshev_nodes (const double lambda_min,
+                                                const double lambda_max,
+                                                const int s,
+                                                std::vector<double>& nodes)
+{
+  const double pi = 3.14159265358979323846;
+  const double center = 0.5 * (lambda_max + lambda_min);
+  const double radius = 0.5 * (lambda_max - lambda_min);
+  std::vector<double> cheb (s);
+  for (int j = 0; j < s; ++j)
+    cheb[j] = center + radius * std::cos ((2 * j + 1) * pi / (2 * s));
+
+  std::vector<bool> taken (s, false);
+  nodes.clear ();
+  for (int k = 0; k < s; ++k) {
+    int best = -1;
+    double best_score = 0;
+    for (int j = 0; j < s; ++j) {
+      if (taken[j]) continue;
+      double score = 0;
+      if (k == 0) {
+        score = std::abs (cheb[j]);
+      }
+      else {
+        for (int i = 0; i < k; ++i)
+          score += std::log (std::abs (cheb[j] - nodes[i]) + 1e-300);
+      }
+      if (best < 0 || score > best_score) {
+        best = j;
+        best_score = score;
+      }
+    }
+    taken[best] = true;
+    nodes.push_back (cheb[best]);
+  }
+}
+
+/// \brief Compute V(:,k) = (A - shift(k-1) I) V(:,k-1) for k = 1..s,
+///   with V(:,0) = x, one tile at a time.
+///
+/// A tile computes all s levels back to back, so the rows of A it
+/// touches are read from memory once and reused from cache for the
+/// remaining levels.  Ghost rows are recomputed redundantly by every
+/// tile that needs them and only kept in the tile's slice of the
+/// work array (two buffers, alternating between levels); V only
+/// receives the tile's own rows.
+template<class AMatrix, class XVector, class VMultiVector, class ShiftView,
+         class PlanType, class WorkView>
+struct MatrixPowers_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_size_type        size_type;
+  typedef typename VMultiVector::non_const_value_type  value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<value_type>     ATV;
+
+  AMatrix m_A;
+  XVector m_x;
+  VMultiVector m_V;
+  ShiftView m_shifts;
+  typename PlanType::size_view_t tile_ptr;
+  typename PlanType::ordinal_view_t level_count;
+  typename PlanType::ordinal_view_t local_rows;
+  typename PlanType::size_view_t local_col_ptr;
+  typename PlanType::ordinal_view_t local_cols;
+  WorkView m_work;
+  const int s;
+
+  MatrixPowers_Functor (const AMatrix& A_, const XVector& x_, const VMultiVector& V_,
+                        const ShiftView& shifts_, const PlanType& plan, const WorkView& work_) :
+    m_A (A_), m_x (x_), m_V (V_), m_shifts (shifts_),
+    tile_ptr (plan.tile_ptr), level_count (plan.level_count),
+    local_rows (plan.local_rows), local_col_ptr (plan.local_col_ptr),
+    local_cols (plan.local_cols), m_work (work_), s (plan.numPowers ())
+  {}
+
+  KOKKOS_INLINE_FUNCTION
+  value_type shift (const int level) const
+  {
+    return m_shifts.extent(0) > 0 ? static_cast<value_type> (m_shifts(level - 1)) : ATV::zero ();
+  }
+
+  // Level k of local row i; prev is the tile's level k-1 buffer (unused for k == 1).
+  KOKKOS_INLINE_FUNCTION
+  value_type row_level (const ordinal_type i, const int level,
+                        const size_type base, const value_type* prev) const
+  {
+    const ordinal_type row = local_rows(base + i);
+    const size_type row_begin = m_A.graph.row_map(row);
+    const size_type row_end   = m_A.graph.row_map(row + 1);
+    const size_type lc_begin  = local_col_ptr(base + i);
+
+    value_type sum = ATV::zero ();
+    if (level == 1) {
+      for (size_type j = row_begin; j < row_end; ++j)
+        sum += static_cast<value_type> (m_A.values(j)) * m_x(m_A.graph.entries(j));
+      return sum - shift (level) * m_x(row);
+    }
+    for (size_type j = row_begin; j < row_end; ++j)
+      sum += static_cast<value_type> (m_A.values(j)) * prev[local_cols(lc_begin + (j - row_begin))];
+    return sum - shift (level) * prev[i];
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type tile) const
+  {
+    const size_type base    = tile_ptr(tile);
+    const size_type listed  = tile_ptr(tile + 1) - base;
+    const ordinal_type own  = level_count(tile * s + (s - 1));
+    value_type* buffers[2]  = {m_work.data () + 2 * base, m_work.data () + 2 * base + listed};
+
+    for (ordinal_type i = 0; i < own; ++i) {
+      const ordinal_type row = local_rows(base + i);
+      m_V(row, 0) = m_x(row);
+    }
+    for (int level = 1; level <= s; ++level) {
+      const value_type* prev = buffers[(level + 1) % 2];
+      value_type* cur        = buffers[level % 2];
+      const ordinal_type count = level_count(tile * s + (level - 1));
+      for (ordinal_type i = 0; i < count; ++i) {
+        cur[i] = row_level (i, level, base, prev);
+        if (i < own)
+          m_V(local_rows(base + i), level) = cur[i];
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev) const
+  {
+    const ordinal_type tile = static_cast<ordinal_type> (dev.league_rank ());
+    const size_type base    = tile_ptr(tile);
+    const size_type listed  = tile_ptr(tile + 1) - base;
+    const ordinal_type own  = level_count(tile * s + (s - 1));
+    value_type* buffers[2]  = {m_work.data () + 2 * base, m_work.data () + 2 * base + listed};
+
+    Kokkos::parallel_for (Kokkos::TeamThreadRange (dev, own), [&] (const ordinal_type i) {
+      const ordinal_type row = local_rows(base + i);
+      Kokkos::single (Kokkos::PerThread (dev), [&] () {
+        m_V(row, 0) = m_x(row);
+      });
+    });
+    for (int level = 1; level <= s; ++level) {
+      const value_type* prev = buffers[(level + 1) % 2];
+      value_type* cur        = buffers[level % 2];
+      const ordinal_type count = level_count(tile * s + (level - 1));
+      Kokkos::parallel_for (Kokkos::TeamThreadRange (dev, count), [&] (const ordinal_type i) {
+        const ordinal_type row = local_rows(base + i);
+        const size_type row_begin = m_A.graph.row_map(row);
+        const ordinal_type length = static_cast<ordinal_type> (m_A.graph.row_map(row + 1) - row_begin);
+        const size_type lc_begin  = local_col_ptr(base + i);
+
+        value_type sum = ATV::zero ();
+        Kokkos::parallel_reduce (Kokkos::ThreadVectorRange (dev, length), [&] (const ordinal_type j, value_type& lsum) {
+          const value_type v = (level == 1) ?
+            m_x(m_A.graph.entries(row_begin + j)) :
+            prev[local_cols(lc_begin + j)];
+          lsum += static_cast<value_type> (m_A.values(row_begin + j)) * v;
+        }, sum);
+
+        Kokkos::single (Kokkos::PerThread (dev), [&] () {
+          const value_type diag = (level == 1) ? static_cast<value_type> (m_x(row)) : prev[i];
+          cur[i] = sum - shift (level) * diag;
+          if (i < own)
+            m_V(row, level) = cur[i];
+        });
+      });
+      dev.team_barrier ();
+    }
+  }
+};
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_MATRIX_POWERS_HPP_
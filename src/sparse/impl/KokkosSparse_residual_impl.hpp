@@ -0,0 +1,477 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_RESIDUAL_HPP_
+#define KOKKOSSPARSE_IMPL_RESIDUAL_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief r := b - A*x, optionally reducing <r,r> over the written
+///   entries of r.
+///
+/// Each row reads b(iRow) before writing r(iRow), so r may alias b.
+/// The squared norm is accumulated from registers right after r(iRow)
+/// is computed, so the caller does not need a second pass over r.
+template<class AMatrix,
+         class XVector,
+         class BVector,
+         class RVector>
+struct Residual_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename RVector::non_const_value_type       r_value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<r_value_type>   ATR;
+  typedef typename ATR::mag_type                       mag_type;
+  typedef mag_type                                     value_type;
+
+  AMatrix m_A;
+  XVector m_x;
+  BVector m_b;
+  RVector m_r;
+
+  const ordinal_type rows_per_team;
+
+  Residual_Functor (const AMatrix m_A_,
+                    const XVector m_x_,
+                    const BVector m_b_,
+                    const RVector m_r_,
+                    const int rows_per_team_) :
+    m_A (m_A_), m_x (m_x_), m_b (m_b_), m_r (m_r_),
+    rows_per_team (rows_per_team_)
+  {
+    static_assert (static_cast<int> (XVector::rank) == 1,
+                   "XVector must be a rank 1 View.");
+    static_assert (static_cast<int> (BVector::rank) == 1,
+                   "BVector must be a rank 1 View.");
+    static_assert (static_cast<int> (RVector::rank) == 1,
+                   "RVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  r_value_type row_sum (const ordinal_type iRow) const
+  {
+    const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+    const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+    r_value_type sum = ATR::zero ();
+
+    for (ordinal_type iEntry = 0; iEntry < row_length; iEntry++) {
+      sum += static_cast<r_value_type> (row.value(iEntry)) * m_x(row.colidx(iEntry));
+    }
+    return sum;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  r_value_type team_row_sum (const team_member& dev, const ordinal_type iRow) const
+  {
+    const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+    const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+    r_value_type sum = ATR::zero ();
+
+    Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(dev,row_length), [&] (const ordinal_type& iEntry, r_value_type& lsum) {
+      lsum += static_cast<r_value_type> (row.value(iEntry)) * m_x(row.colidx(iEntry));
+    },sum);
+    return sum;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  r_value_type update_r (const ordinal_type iRow, const r_value_type sum) const
+  {
+    const r_value_type r_new = static_cast<r_value_type> (m_b(iRow)) - sum;
+    m_r(iRow) = r_new;
+    return r_new;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  static mag_type norm_term (const r_value_type r_new)
+  {
+    const mag_type r_abs = ATR::abs (r_new);
+    return r_abs * r_abs;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type iRow) const
+  {
+    update_r (iRow, row_sum (iRow));
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type iRow, mag_type& nrm) const
+  {
+    nrm += norm_term (update_r (iRow, row_sum (iRow)));
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev) const
+  {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(dev,0,rows_per_team), [&] (const ordinal_type& loop) {
+      const ordinal_type iRow = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+      if (iRow >= m_A.numRows ()) {
+        return;
+      }
+      const r_value_type sum = team_row_sum (dev, iRow);
+      Kokkos::single(Kokkos::PerThread(dev), [&] () {
+        update_r (iRow, sum);
+      });
+    });
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev, mag_type& nrm) const
+  {
+    mag_type team_nrm = Kokkos::Details::ArithTraits<mag_type>::zero ();
+
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(dev,0,rows_per_team), [&] (const ordinal_type& loop, mag_type& tnrm) {
+      const ordinal_type iRow = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+      if (iRow >= m_A.numRows ()) {
+        return;
+      }
+      const r_value_type sum = team_row_sum (dev, iRow);
+
+      // One lane writes r; the new value is broadcast to all lanes so
+      // that every lane contributes the same term to the team sum.
+      r_value_type r_new;
+      Kokkos::single(Kokkos::PerThread(dev), [&] (r_value_type& r_row) {
+        r_row = update_r (iRow, sum);
+      }, r_new);
+
+      tnrm += norm_term (r_new);
+    }, team_nrm);
+
+    Kokkos::single(Kokkos::PerTeam(dev), [&] () {
+      nrm += team_nrm;
+    });
+  }
+};
+
+/// \brief Multivector version of Residual_Functor: R := B - A*X,
+///   optionally reducing <R(:,j),R(:,j)> for every column j into an
+///   array with one entry per column.
+///
+/// Columns are handled one after the other inside a row (or a block
+/// of rows for teams), so the row of A stays in cache across columns.
+template<class AMatrix,
+         class XVector,
+         class BVector,
+         class RVector>
+struct Residual_MV_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename RVector::non_const_value_type       r_value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<r_value_type>   ATR;
+  typedef typename ATR::mag_type                       mag_type;
+  typedef mag_type                                     value_type[];
+
+  const int value_count;
+  AMatrix m_A;
+  XVector m_x;
+  BVector m_b;
+  RVector m_r;
+
+  const ordinal_type rows_per_team;
+
+  Residual_MV_Functor (const AMatrix m_A_,
+                       const XVector m_x_,
+                       const BVector m_b_,
+                       const RVector m_r_,
+                       const int rows_per_team_) :
+    value_count (static_cast<int> (m_r_.extent(1))),
+    m_A (m_A_), m_x (m_x_), m_b (m_b_), m_r (m_r_),
+    rows_per_team (rows_per_team_)
+  {
+    static_assert (static_cast<int> (XVector::rank) == 2,
+                   "XVector must be a rank 2 View.");
+    static_assert (static_cast<int> (BVector::rank) == 2,
+                   "BVector must be a rank 2 View.");
+    static_assert (static_cast<int> (RVector::rank) == 2,
+                   "RVector must be a rank 2 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  r_value_type row_sum (const ordinal_type iRow, const int k) const
+  {
+    const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+    const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+    r_value_type sum = ATR::zero ();
+
+    for (ordinal_type iEntry = 0; iEntry < row_length; iEntry++) {
+      sum += static_cast<r_value_type> (row.value(iEntry)) * m_x(row.colidx(iEntry),k);
+    }
+    return sum;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  r_value_type team_row_sum (const team_member& dev, const ordinal_type iRow, const int k) const
+  {
+    const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+    const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+    r_value_type sum = ATR::zero ();
+
+    Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(dev,row_length), [&] (const ordinal_type& iEntry, r_value_type& lsum) {
+      lsum += static_cast<r_value_type> (row.value(iEntry)) * m_x(row.colidx(iEntry),k);
+    },sum);
+    return sum;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  r_value_type update_r (const ordinal_type iRow, const int k, const r_value_type sum) const
+  {
+    const r_value_type r_new = static_cast<r_value_type> (m_b(iRow,k)) - sum;
+    m_r(iRow,k) = r_new;
+    return r_new;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  static mag_type norm_term (const r_value_type r_new)
+  {
+    const mag_type r_abs = ATR::abs (r_new);
+    return r_abs * r_abs;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type iRow) const
+  {
+    for (int k = 0; k < value_count; ++k) {
+      update_r (iRow, k, row_sum (iRow, k));
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type iRow, value_type nrms) const
+  {
+    for (int k = 0; k < value_count; ++k) {
+      nrms[k] += norm_term (update_r (iRow, k, row_sum (iRow, k)));
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev) const
+  {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(dev,0,rows_per_team), [&] (const ordinal_type& loop) {
+      const ordinal_type iRow = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+      if (iRow >= m_A.numRows ()) {
+        return;
+      }
+      for (int k = 0; k < value_count; ++k) {
+        const r_value_type sum = team_row_sum (dev, iRow, k);
+        Kokkos::single(Kokkos::PerThread(dev), [&] () {
+          update_r (iRow, k, sum);
+        });
+      }
+    });
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev, value_type nrms) const
+  {
+    for (int k = 0; k < value_count; ++k) {
+      mag_type team_nrm = Kokkos::Details::ArithTraits<mag_type>::zero ();
+
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(dev,0,rows_per_team), [&] (const ordinal_type& loop, mag_type& tnrm) {
+        const ordinal_type iRow = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+        if (iRow >= m_A.numRows ()) {
+          return;
+        }
+        const r_value_type sum = team_row_sum (dev, iRow, k);
+
+        r_value_type r_new;
+        Kokkos::single(Kokkos::PerThread(dev), [&] (r_value_type& r_row) {
+          r_row = update_r (iRow, k, sum);
+        }, r_new);
+
+        tnrm += norm_term (r_new);
+      }, team_nrm);
+
+      Kokkos::single(Kokkos::PerTeam(dev), [&] () {
+        nrms[k] += team_nrm;
+      });
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  init (value_type nrms) const
+  {
+    for (int k = 0; k < value_count; ++k) { nrms[k] = Kokkos::Details::ArithTraits<mag_type>::zero (); }
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  join (volatile value_type update, const volatile value_type source) const
+  {
+    for (int k = 0; k < value_count; ++k) { update[k] += source[k]; }
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  join (value_type update, const value_type source) const
+  {
+    for (int k = 0; k < value_count; ++k) { update[k] += source[k]; }
+  }
+};
+
+// Run functor over the rows of A: a range policy on host, and a team
+// policy sized like the native spmv kernel on GPUs.  With nrms set the
+// functor's reduction is written there, otherwise it runs as a for.
+template<class execution_space, class AMatrix, class Functor, class NormsType>
+void residual_launch (const KokkosKernels::Experimental::Controls& controls,
+                      const AMatrix& A,
+                      const char label[],
+                      Functor func,
+                      NormsType* nrms)
+{
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+    int team_size = -1;
+    int vector_length = -1;
+    int64_t rows_per_thread = -1;
+    if(controls.isParameter("team size"))       {team_size       = std::stoi(controls.getParameter("team size"));}
+    if(controls.isParameter("vector length"))   {vector_length   = std::stoi(controls.getParameter("vector length"));}
+    if(controls.isParameter("rows per thread")) {rows_per_thread = std::stoll(controls.getParameter("rows per thread"));}
+
+    int64_t rows_per_team = spmv_launch_parameters<execution_space>(A.numRows(),A.nnz(),rows_per_thread,team_size,vector_length);
+    int64_t worksets = (A.numRows()+rows_per_team-1)/rows_per_team;
+
+    Functor team_func (func.m_A,func.m_x,func.m_b,func.m_r,rows_per_team);
+    Kokkos::TeamPolicy<execution_space> policy(1,1);
+    if(team_size<0)
+      policy = Kokkos::TeamPolicy<execution_space>(worksets,Kokkos::AUTO,vector_length);
+    else
+      policy = Kokkos::TeamPolicy<execution_space>(worksets,team_size,vector_length);
+    if (nrms == nullptr)
+      Kokkos::parallel_for(label,policy,team_func);
+    else
+      Kokkos::parallel_reduce(label,policy,team_func,*nrms);
+  }
+  else {
+    Kokkos::RangePolicy<execution_space> policy(0, A.numRows());
+    if (nrms == nullptr)
+      Kokkos::parallel_for(label,policy,func);
+    else
+      Kokkos::parallel_reduce(label,policy,func,*nrms);
+  }
+}
+
+/// \brief r := b - A*x for rank-1 x, b and r; returns ||r||_2 if
+///   computeNorm is set, and zero otherwise.
+template<class AMatrix,
+         class XVector,
+         class BVector,
+         class RVector>
+typename Kokkos::Details::ArithTraits<typename RVector::non_const_value_type>::mag_type
+residual (const KokkosKernels::Experimental::Controls& controls,
+          const AMatrix& A,
+          const XVector& x,
+          const BVector& b,
+          const RVector& r,
+          const bool computeNorm)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef Residual_Functor<AMatrix,XVector,BVector,RVector> functor_type;
+  typedef typename functor_type::mag_type mag_type;
+  typedef Kokkos::Details::ArithTraits<mag_type> KAM;
+
+  mag_type nrm = KAM::zero ();
+  if (A.numRows () <= 0) {
+    return nrm;
+  }
+
+  functor_type func (A,x,b,r,1);
+  residual_launch<execution_space> (controls, A, "KokkosSparse::residual", func,
+                                    computeNorm ? &nrm : static_cast<mag_type*> (nullptr));
+  return KAM::sqrt (nrm);
+}
+
+/// \brief R := B - A*X for rank-2 X, B and R.  If nrms is not null it
+///   must point to R.extent(1) host values, which receive the 2-norms
+///   of the columns of R.
+template<class AMatrix,
+         class XVector,
+         class BVector,
+         class RVector>
+void
+residual_mv (const KokkosKernels::Experimental::Controls& controls,
+             const AMatrix& A,
+             const XVector& x,
+             const BVector& b,
+             const RVector& r,
+             typename Kokkos::Details::ArithTraits<typename RVector::non_const_value_type>::mag_type* nrms)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef Residual_MV_Functor<AMatrix,XVector,BVector,RVector> functor_type;
+  typedef typename functor_type::mag_type mag_type;
+  typedef Kokkos::Details::ArithTraits<mag_type> KAM;
+  typedef Kokkos::View<mag_type*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged> > host_norms_type;
+
+  const size_t numVecs = r.extent(1);
+  if (nrms != nullptr) {
+    for (size_t k = 0; k < numVecs; ++k) nrms[k] = KAM::zero ();
+  }
+  if (A.numRows () <= 0 || numVecs == 0) {
+    return;
+  }
+
+  functor_type func (A,x,b,r,1);
+  if (nrms == nullptr) {
+    residual_launch<execution_space> (controls, A, "KokkosSparse::residual_mv", func,
+                                      static_cast<host_norms_type*> (nullptr));
+  }
+  else {
+    host_norms_type nrms_view (nrms, numVecs);
+    residual_launch<execution_space> (controls, A, "KokkosSparse::residual_mv", func, &nrms_view);
+    for (size_t k = 0; k < numVecs; ++k) nrms[k] = KAM::sqrt (nrms[k]);
+  }
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_RESIDUAL_HPP_
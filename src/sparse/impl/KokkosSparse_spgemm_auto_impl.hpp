@@ -0,0 +1,323 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef KOKKOSSPARSE_SPGEMM_AUTO_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_AUTO_IMPL_HPP_
+
+#include <iostream>
+#include <Kokkos_Core.hpp>
+#include "KokkosKernels_Utils.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_HashmapAccumulator.hpp"
+#include "KokkosKernels_Uniform_Initialized_MemoryPool.hpp"
+#include "KokkosSparse_spgemm_handle.hpp"
+
+namespace KokkosSparse{
+
+namespace Impl{
+
+//SPGEMM_AUTO: a sample of evenly spaced rows of A is multiplied with a hashmap to measure its
+//multiplications and its entries in A*B, and a sample of rows of B is compressed the way KKMEM
+//compresses B (a set bit per column, sizeof(nnz_lno_t) * 8 columns per set) to measure the
+//compression ratio. The KK algorithm and the accumulator are then chosen from these estimates.
+
+//largest hashmap needed by a sample: the row of A*B, bounded by the columns of B, or the row of B.
+template <typename a_row_view_t, typename a_nnz_view_t, typename b_row_view_t>
+struct SpgemmAutoSampleSizeFunctor{
+  typedef typename a_nnz_view_t::non_const_value_type nnz_lno_t;
+  typedef typename a_row_view_t::non_const_value_type a_size_type;
+
+  a_row_view_t row_mapA;
+  a_nnz_view_t entriesA;
+  b_row_view_t row_mapB;
+  size_t num_rows_a, num_rows_b, num_cols, num_samples;
+
+  SpgemmAutoSampleSizeFunctor(a_row_view_t row_mapA_, a_nnz_view_t entriesA_, b_row_view_t row_mapB_,
+      size_t num_rows_a_, size_t num_rows_b_, size_t num_cols_, size_t num_samples_):
+    row_mapA(row_mapA_), entriesA(entriesA_), row_mapB(row_mapB_),
+    num_rows_a(num_rows_a_), num_rows_b(num_rows_b_), num_cols(num_cols_), num_samples(num_samples_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t s, size_t &max_size) const {
+    const size_t i = s * num_rows_a / num_samples;
+    size_t row_flops = 0;
+    for (a_size_type a = row_mapA(i); a < row_mapA(i + 1); ++a){
+      const nnz_lno_t rowB = entriesA(a);
+      row_flops += row_mapB(rowB + 1) - row_mapB(rowB);
+    }
+    row_flops = KOKKOSKERNELS_MACRO_MIN(row_flops, num_cols);
+    if (row_flops > max_size) max_size = row_flops;
+    if (num_rows_b){
+      const size_t j = s * num_rows_b / num_samples;
+      const size_t b_size = row_mapB(j + 1) - row_mapB(j);
+      if (b_size > max_size) max_size = b_size;
+    }
+  }
+};
+
+//measures the sample s: the multiplications and entries of a row of A*B, and the entries of a row of B
+//before and after compression.
+template <typename a_row_view_t, typename a_nnz_view_t,
+          typename b_row_view_t, typename b_nnz_view_t,
+          typename sample_view_t, typename pool_memory_space>
+struct SpgemmAutoSampleFunctor{
+  typedef typename a_nnz_view_t::non_const_value_type nnz_lno_t;
+  typedef typename a_row_view_t::non_const_value_type a_size_type;
+  typedef typename b_row_view_t::non_const_value_type b_size_type;
+
+  a_row_view_t row_mapA;
+  a_nnz_view_t entriesA;
+  b_row_view_t row_mapB;
+  b_nnz_view_t entriesB;
+  sample_view_t row_flops, row_nnz, b_row_nnz, b_row_compressed_nnz;
+  size_t num_rows_a, num_rows_b, num_samples;
+
+  pool_memory_space memory_space;
+  const nnz_lno_t max_row_size;
+  const nnz_lno_t pow2_hash_size;
+  const KokkosKernels::Impl::ExecSpaceType my_exec_space;
+
+  SpgemmAutoSampleFunctor(
+      a_row_view_t row_mapA_, a_nnz_view_t entriesA_,
+      b_row_view_t row_mapB_, b_nnz_view_t entriesB_,
+      sample_view_t row_flops_, sample_view_t row_nnz_,
+      sample_view_t b_row_nnz_, sample_view_t b_row_compressed_nnz_,
+      size_t num_rows_a_, size_t num_rows_b_, size_t num_samples_,
+      pool_memory_space memory_space_,
+      nnz_lno_t max_row_size_, nnz_lno_t pow2_hash_size_,
+      KokkosKernels::Impl::ExecSpaceType my_exec_space_):
+    row_mapA(row_mapA_), entriesA(entriesA_), row_mapB(row_mapB_), entriesB(entriesB_),
+    row_flops(row_flops_), row_nnz(row_nnz_), b_row_nnz(b_row_nnz_), b_row_compressed_nnz(b_row_compressed_nnz_),
+    num_rows_a(num_rows_a_), num_rows_b(num_rows_b_), num_samples(num_samples_),
+    memory_space(memory_space_),
+    max_row_size(max_row_size_), pow2_hash_size(pow2_hash_size_),
+    my_exec_space(my_exec_space_){}
+
+  KOKKOS_INLINE_FUNCTION
+  size_t get_thread_id(const size_t row_index) const{
+    switch (my_exec_space){
+    default:
+      return row_index;
+#if defined( KOKKOS_ENABLE_SERIAL )
+    case KokkosKernels::Impl::Exec_SERIAL:
+      return 0;
+#endif
+#if defined( KOKKOS_ENABLE_OPENMP )
+    case KokkosKernels::Impl::Exec_OMP:
+      return Kokkos::OpenMP::impl_hardware_thread_id();
+#endif
+#if defined( KOKKOS_ENABLE_THREADS )
+    case KokkosKernels::Impl::Exec_PTHREADS:
+      return Kokkos::Threads::impl_hardware_thread_id();
+#endif
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t s) const {
+    volatile nnz_lno_t *tmp = NULL;
+    const size_t tid = get_thread_id(s);
+    while (tmp == NULL){
+      tmp = (volatile nnz_lno_t *) (memory_space.allocate_chunk(tid));
+    }
+    nnz_lno_t *chunk = (nnz_lno_t *) tmp;
+
+    //chunk: hash begins, used hashes, hash nexts and keys.
+    nnz_lno_t *used_hashes = chunk + pow2_hash_size;
+    KokkosKernels::Experimental::HashmapAccumulator<nnz_lno_t, nnz_lno_t, nnz_lno_t, KokkosKernels::Experimental::HashOpType::bitwiseAnd>
+      hm(max_row_size, pow2_hash_size - 1, chunk, chunk + 2 * pow2_hash_size, chunk + 2 * pow2_hash_size + max_row_size, NULL);
+
+    nnz_lno_t used_size = 0;
+    nnz_lno_t used_hash_count = 0;
+    const size_t i = s * num_rows_a / num_samples;
+    size_t flops = 0;
+    for (a_size_type a = row_mapA(i); a < row_mapA(i + 1); ++a){
+      const nnz_lno_t rowB = entriesA(a);
+      flops += row_mapB(rowB + 1) - row_mapB(rowB);
+      for (b_size_type b = row_mapB(rowB); b < row_mapB(rowB + 1); ++b){
+        hm.sequential_insert_into_hash_TrackHashes(entriesB(b), &used_size, &used_hash_count, used_hashes);
+      }
+    }
+    row_flops(s) = flops;
+    row_nnz(s) = used_size;
+    for (nnz_lno_t h = 0; h < used_hash_count; ++h){
+      hm.hash_begins[used_hashes[h]] = -1;
+    }
+
+    b_row_nnz(s) = 0;
+    b_row_compressed_nnz(s) = 0;
+    if (num_rows_b){
+      const nnz_lno_t set_bits = sizeof(nnz_lno_t) * 8;
+      const size_t j = s * num_rows_b / num_samples;
+      used_size = 0;
+      used_hash_count = 0;
+      for (b_size_type b = row_mapB(j); b < row_mapB(j + 1); ++b){
+        hm.sequential_insert_into_hash_TrackHashes(entriesB(b) / set_bits, &used_size, &used_hash_count, used_hashes);
+      }
+      b_row_nnz(s) = row_mapB(j + 1) - row_mapB(j);
+      b_row_compressed_nnz(s) = used_size;
+      for (nnz_lno_t h = 0; h < used_hash_count; ++h){
+        hm.hash_begins[used_hashes[h]] = -1;
+      }
+    }
+    memory_space.release_chunk(chunk);
+  }
+};
+
+/**
+ * \brief Chooses the algorithm and the accumulator of SPGEMM_AUTO for C = A*B, where A has m rows
+ * and B has k columns, and applies them to the spgemm handle:
+ *  - a dense accumulator (SPGEMM_KK_DENSE) on CPUs, if B has fewer than MaxColDenseAcc columns and a
+ *    hashmap sized for the largest sampled row of C takes at least half of a dense row of k entries,
+ *    as SPGEMM_KK decides from the multiplications of the rows;
+ *  - on GPUs, SPGEMM_KK_MEMORY (a thread per row) for short rows of C, with fewer than 32 entries or
+ *    256 multiplications on average, and otherwise SPGEMM_KK, which picks its team variant;
+ *  - SPGEMM_KK_MEMORY (hashmap accumulator) otherwise.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename b_row_view_t, typename b_nnz_view_t>
+void spgemm_auto_select_algorithm(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    typename KernelHandle::nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA,
+    b_row_view_t row_mapB, b_nnz_view_t entriesB){
+
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename KernelHandle::HandleTempMemorySpace MyTempMemorySpace;
+  typedef typename KernelHandle::nnz_lno_t nnz_lno_t;
+  typedef KokkosKernels::Impl::UniformMemoryPool<MyTempMemorySpace, nnz_lno_t> pool_memory_space;
+  typedef Kokkos::View<size_t *, Kokkos::Device<MyExecSpace, MyTempMemorySpace> > sample_view_t;
+
+  typename KernelHandle::SPGEMMHandleType *sh = handle->get_spgemm_handle();
+  const bool is_gpu = KokkosKernels::Impl::kk_is_gpu_exec_space<MyExecSpace>();
+
+  SPGEMMAutoSelection selection;
+  const size_t num_rows_b = row_mapB.extent(0) ? row_mapB.extent(0) - 1 : 0;
+  const size_t num_samples = KOKKOSKERNELS_MACRO_MIN(size_t(m), KOKKOSKERNELS_MACRO_MAX(size_t(1), sh->get_auto_sample_rows()));
+  selection.num_sampled_rows = num_samples;
+
+  if (num_samples){
+    size_t max_sample_size = 0;
+    Kokkos::parallel_reduce("KokkosSparse::spgemm_auto::SampleSize", Kokkos::RangePolicy<MyExecSpace>(0, num_samples),
+        SpgemmAutoSampleSizeFunctor<a_row_view_t, a_nnz_view_t, b_row_view_t>
+          (row_mapA, entriesA, row_mapB, m, num_rows_b, k, num_samples),
+        Kokkos::Max<size_t>(max_sample_size));
+
+    const nnz_lno_t max_row_size = KOKKOSKERNELS_MACRO_MAX(nnz_lno_t(1), nnz_lno_t(max_sample_size));
+    nnz_lno_t pow2_hash_size = 2;
+    while (pow2_hash_size < max_row_size){
+      pow2_hash_size *= 2;
+    }
+    const size_t chunk_size = 2 * pow2_hash_size + 2 * size_t(max_row_size);
+    KokkosKernels::Impl::PoolType my_pool_type = KokkosKernels::Impl::OneThread2OneChunk;
+    size_t num_chunks = MyExecSpace::concurrency();
+    if (is_gpu){
+      my_pool_type = KokkosKernels::Impl::ManyThread2OneChunk;
+      num_chunks = KokkosKernels::Impl::kk_compute_num_pool_chunks<pool_memory_space>(chunk_size * sizeof(nnz_lno_t), num_chunks);
+    }
+    pool_memory_space m_space(num_chunks, chunk_size, -1, my_pool_type);
+
+    sample_view_t row_flops(Kokkos::ViewAllocateWithoutInitializing("sampled row flops"), num_samples);
+    sample_view_t row_nnz(Kokkos::ViewAllocateWithoutInitializing("sampled row nnz"), num_samples);
+    sample_view_t b_row_nnz(Kokkos::ViewAllocateWithoutInitializing("sampled B row nnz"), num_samples);
+    sample_view_t b_row_compressed_nnz(Kokkos::ViewAllocateWithoutInitializing("sampled B row compressed nnz"), num_samples);
+    Kokkos::parallel_for("KokkosSparse::spgemm_auto::Sample",
+        Kokkos::RangePolicy<MyExecSpace, Kokkos::Schedule<Kokkos::Dynamic> >(0, num_samples),
+        SpgemmAutoSampleFunctor<a_row_view_t, a_nnz_view_t, b_row_view_t, b_nnz_view_t, sample_view_t, pool_memory_space>
+          (row_mapA, entriesA, row_mapB, entriesB,
+           row_flops, row_nnz, b_row_nnz, b_row_compressed_nnz,
+           m, num_rows_b, num_samples,
+           m_space, max_row_size, pow2_hash_size, KokkosKernels::Impl::kk_get_exec_space_type<MyExecSpace>()));
+
+    auto h_row_flops = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), row_flops);
+    auto h_row_nnz = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), row_nnz);
+    auto h_b_row_nnz = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), b_row_nnz);
+    auto h_b_row_compressed_nnz = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), b_row_compressed_nnz);
+
+    double sum_flops = 0, sum_nnz = 0, sum_b_nnz = 0, sum_b_compressed_nnz = 0;
+    for (size_t s = 0; s < num_samples; ++s){
+      sum_flops += h_row_flops(s);
+      sum_nnz += h_row_nnz(s);
+      sum_b_nnz += h_b_row_nnz(s);
+      sum_b_compressed_nnz += h_b_row_compressed_nnz(s);
+      if (h_row_nnz(s) > selection.max_row_nnz) selection.max_row_nnz = h_row_nnz(s);
+    }
+    selection.average_row_flops = sum_flops / num_samples;
+    selection.flops_per_output = sum_nnz > 0 ? sum_flops / sum_nnz : 0;
+    selection.b_compression_ratio = sum_b_nnz > 0 ? sum_b_compressed_nnz / sum_b_nnz : 1;
+    selection.estimated_c_nnz = sum_nnz * m / num_samples;
+  }
+
+  //the hashmap of KKMEM for the largest row, against a dense accumulator of k columns.
+  size_t pow2_row_size = 1;
+  while (pow2_row_size < selection.max_row_nnz){
+    pow2_row_size *= 2;
+  }
+  const size_t sparse_acc_size = 2 * pow2_row_size + 2 * selection.max_row_nnz;
+  const size_t dense_acc_size = size_t(k) + selection.max_row_nnz;
+  const double average_row_nnz = selection.num_sampled_rows ? selection.estimated_c_nnz / m : 0;
+
+  if (!is_gpu && size_t(k) < size_t(sh->MaxColDenseAcc) && sparse_acc_size >= dense_acc_size * 0.5){
+    selection.algorithm = SPGEMM_KK_DENSE;
+    selection.accumulator = SPGEMM_ACC_DENSE;
+  }
+  else if (is_gpu && average_row_nnz >= 32 && selection.average_row_flops >= 256){
+    selection.algorithm = SPGEMM_KK;
+    selection.accumulator = SPGEMM_ACC_SPARSE;
+  }
+  else {
+    selection.algorithm = SPGEMM_KK_MEMORY;
+    selection.accumulator = SPGEMM_ACC_SPARSE;
+  }
+  sh->set_auto_selection(selection);
+
+  if (handle->get_verbose()){
+    selection.print(std::cout);
+  }
+}
+
+}
+}
+#endif
@@ -0,0 +1,228 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef KOKKOSSPARSE_SPGEMM_CHUNKED_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_CHUNKED_IMPL_HPP_
+
+#include <algorithm>
+#include <vector>
+#include <Kokkos_Core.hpp>
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosSparse_spgemm_symbolic.hpp"
+
+namespace KokkosSparse{
+
+namespace Impl{
+
+//Chunked SpGEMM: the rows of A (and so of C) are split into batches, and each batch is multiplied
+//with the existing symbolic and numeric phases, so only the output of one batch is allocated at a time.
+
+//view types of the batches of A and C.
+template <typename KernelHandle>
+struct SpgemmChunkTypes{
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef Kokkos::Device<MyExecSpace, typename KernelHandle::HandleTempMemorySpace> UniformDevice_t;
+  typedef typename KernelHandle::size_type size_type;
+  typedef typename KernelHandle::nnz_lno_t nnz_lno_t;
+  typedef typename KernelHandle::nnz_scalar_t scalar_t;
+
+  typedef Kokkos::View<size_type *, Kokkos::LayoutLeft, UniformDevice_t> row_view_t;
+  typedef Kokkos::View<const nnz_lno_t *, Kokkos::LayoutLeft, UniformDevice_t,
+                       Kokkos::MemoryTraits<Kokkos::Unmanaged> > batch_nnz_view_t;
+  typedef Kokkos::View<const scalar_t *, Kokkos::LayoutLeft, UniformDevice_t,
+                       Kokkos::MemoryTraits<Kokkos::Unmanaged> > batch_scalar_view_t;
+  typedef Kokkos::View<nnz_lno_t *, Kokkos::LayoutLeft, UniformDevice_t> nnz_view_t;
+  typedef Kokkos::View<scalar_t *, Kokkos::LayoutLeft, UniformDevice_t> scalar_view_t;
+  //a batch of the entries and values of an already allocated C.
+  typedef Kokkos::View<nnz_lno_t *, Kokkos::LayoutLeft, UniformDevice_t,
+                       Kokkos::MemoryTraits<Kokkos::Unmanaged> > batch_out_nnz_view_t;
+  typedef Kokkos::View<scalar_t *, Kokkos::LayoutLeft, UniformDevice_t,
+                       Kokkos::MemoryTraits<Kokkos::Unmanaged> > batch_out_scalar_view_t;
+};
+
+//upper bound of the bytes of each row of C: the number of multiplications, but at most
+//the number of columns of B, entries and values.
+template <typename a_row_view_t, typename a_nnz_view_t, typename b_row_view_t, typename bytes_view_t>
+struct SpgemmRowBytesFunctor{
+  typedef typename a_nnz_view_t::non_const_value_type nnz_lno_t;
+  typedef typename a_row_view_t::non_const_value_type size_type;
+
+  a_row_view_t row_mapA;
+  a_nnz_view_t entriesA;
+  b_row_view_t row_mapB;
+  bytes_view_t row_bytes;
+  size_t num_cols;
+  size_t entry_bytes;
+  size_t row_overhead;
+
+  SpgemmRowBytesFunctor(a_row_view_t row_mapA_, a_nnz_view_t entriesA_, b_row_view_t row_mapB_,
+      bytes_view_t row_bytes_, size_t num_cols_, size_t entry_bytes_, size_t row_overhead_):
+    row_mapA(row_mapA_), entriesA(entriesA_), row_mapB(row_mapB_), row_bytes(row_bytes_),
+    num_cols(num_cols_), entry_bytes(entry_bytes_), row_overhead(row_overhead_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const nnz_lno_t i) const {
+    size_t row_flops = 0;
+    for (size_type pa = row_mapA(i); pa < row_mapA(i + 1); ++pa){
+      const nnz_lno_t j = entriesA(pa);
+      row_flops += row_mapB(j + 1) - row_mapB(j);
+    }
+    row_bytes(i) = KOKKOSKERNELS_MACRO_MIN(row_flops, num_cols) * entry_bytes + row_overhead;
+  }
+};
+
+//out_rowmap(out_begin + i) = in_rowmap(in_begin + i) - in_rowmap(in_begin) + out_base,
+//used both to extract the rowmap of a batch and to place it in the rowmap of C.
+template <typename in_row_view_t, typename out_row_view_t>
+struct SpgemmShiftRowmapFunctor{
+  typedef typename out_row_view_t::non_const_value_type size_type;
+
+  in_row_view_t in_rowmap;
+  out_row_view_t out_rowmap;
+  size_t in_begin, out_begin;
+  size_type in_base, out_base;
+
+  SpgemmShiftRowmapFunctor(in_row_view_t in_rowmap_, out_row_view_t out_rowmap_,
+      size_t in_begin_, size_t out_begin_, size_type in_base_, size_type out_base_):
+    in_rowmap(in_rowmap_), out_rowmap(out_rowmap_), in_begin(in_begin_), out_begin(out_begin_),
+    in_base(in_base_), out_base(out_base_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i) const {
+    out_rowmap(out_begin + i) = (in_rowmap(in_begin + i) - in_base) + out_base;
+  }
+};
+
+/**
+ * \brief Splits the m rows of A into batches whose rows of C = A*B are bounded to take at most
+ * the chunk memory budget of the spgemm handle. A row that does not fit alone is a batch by itself.
+ * Returns the first row of each batch, followed by m.
+ */
+template <typename KernelHandle, typename a_row_view_t, typename a_nnz_view_t, typename b_row_view_t>
+std::vector<typename KernelHandle::nnz_lno_t> spgemm_chunked_row_batches(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    typename KernelHandle::nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, b_row_view_t row_mapB){
+
+  typedef SpgemmChunkTypes<KernelHandle> types;
+  typedef typename types::MyExecSpace MyExecSpace;
+  typedef typename types::nnz_lno_t nnz_lno_t;
+  typedef Kokkos::View<size_t *, typename types::UniformDevice_t> bytes_view_t;
+
+  std::vector<nnz_lno_t> batches(1, 0);
+  const size_t budget = handle->get_spgemm_handle()->get_chunk_memory_budget();
+  if (m == 0) return batches;
+  if (budget == 0){
+    batches.push_back(m);
+    return batches;
+  }
+
+  bytes_view_t row_bytes("SpGEMM chunked row bytes", m + 1);
+  Kokkos::parallel_for("KokkosSparse::spgemm_chunked::RowBytes", Kokkos::RangePolicy<MyExecSpace>(0, m),
+      SpgemmRowBytesFunctor<a_row_view_t, a_nnz_view_t, b_row_view_t, bytes_view_t>
+        (row_mapA, entriesA, row_mapB, row_bytes, k,
+         sizeof(typename types::nnz_lno_t) + sizeof(typename types::scalar_t), sizeof(typename types::size_type)));
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<bytes_view_t, MyExecSpace>(m + 1, row_bytes);
+  auto h_row_bytes = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), row_bytes);
+
+  const size_t *prefix = h_row_bytes.data();
+  nnz_lno_t row_begin = 0;
+  while (row_begin < m){
+    //first row whose end is over the budget.
+    const size_t *over = std::upper_bound(prefix + row_begin + 1, prefix + m + 1, prefix[row_begin] + budget);
+    nnz_lno_t row_end = nnz_lno_t(over - prefix) - 1;
+    if (row_end <= row_begin) row_end = row_begin + 1;
+    batches.push_back(row_end);
+    row_begin = row_end;
+  }
+  return batches;
+}
+
+/**
+ * \brief Runs the symbolic phase for the rows [row_begin, row_end) of A, and returns the views of
+ * the batch of A, and the rowmap of the batch of C.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t>
+void spgemm_chunk_symbolic(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t row_begin,
+    typename KernelHandle::nnz_lno_t row_end,
+    typename KernelHandle::nnz_lno_t n,
+    typename KernelHandle::nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+    b_row_view_t row_mapB, b_nnz_view_t entriesB,
+    typename SpgemmChunkTypes<KernelHandle>::row_view_t &batch_rowmapA,
+    typename SpgemmChunkTypes<KernelHandle>::batch_nnz_view_t &batch_entriesA,
+    typename SpgemmChunkTypes<KernelHandle>::batch_scalar_view_t &batch_valuesA,
+    typename SpgemmChunkTypes<KernelHandle>::row_view_t &batch_rowmapC){
+
+  typedef SpgemmChunkTypes<KernelHandle> types;
+  typedef typename types::MyExecSpace MyExecSpace;
+  typedef typename types::size_type size_type;
+  typedef typename types::row_view_t row_view_t;
+
+  const typename KernelHandle::nnz_lno_t num_rows = row_end - row_begin;
+  size_type a_begin = 0, a_end = 0;
+  Kokkos::deep_copy(a_begin, Kokkos::subview(row_mapA, row_begin));
+  Kokkos::deep_copy(a_end, Kokkos::subview(row_mapA, row_end));
+
+  batch_rowmapA = row_view_t(Kokkos::ViewAllocateWithoutInitializing("SpGEMM chunk rowmap A"), num_rows + 1);
+  Kokkos::parallel_for("KokkosSparse::spgemm_chunked::ShiftRowmap", Kokkos::RangePolicy<MyExecSpace>(0, num_rows + 1),
+      SpgemmShiftRowmapFunctor<a_row_view_t, row_view_t>(row_mapA, batch_rowmapA, row_begin, 0, a_begin, 0));
+  batch_entriesA = typename types::batch_nnz_view_t(entriesA.data() + a_begin, a_end - a_begin);
+  batch_valuesA = typename types::batch_scalar_view_t(valuesA.data() + a_begin, a_end - a_begin);
+
+  batch_rowmapC = row_view_t(Kokkos::ViewAllocateWithoutInitializing("SpGEMM chunk rowmap C"), num_rows + 1);
+  KokkosSparse::Experimental::spgemm_symbolic(
+      handle, num_rows, n, k,
+      batch_rowmapA, batch_entriesA, false,
+      row_mapB, entriesB, false,
+      batch_rowmapC);
+}
+
+}
+}
+#endif
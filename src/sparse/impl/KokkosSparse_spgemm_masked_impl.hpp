@@ -0,0 +1,396 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef KOKKOSSPARSE_SPGEMM_MASKED_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_MASKED_IMPL_HPP_
+
+#include <Kokkos_Core.hpp>
+#include "KokkosKernels_Utils.hpp"
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_HashmapAccumulator.hpp"
+#include "KokkosKernels_Uniform_Initialized_MemoryPool.hpp"
+
+namespace KokkosSparse{
+
+namespace Impl{
+
+//Masked product C<M> = A*B: only the entries of A*B at the positions of the mask M (structural mask),
+//or only those that are not in M (complemented mask), are computed.
+//Row i of the mask is inserted first in a hashmap, so its columns take the first indices.
+//With a structural mask, the products are only accumulated at the columns that are found in the
+//hashmap, so its size is bounded by the row of the mask instead of the row of A*B. With a
+//complemented mask, the products are inserted after the mask, and the entries past the mask are kept.
+
+//finds the largest accumulator of a row of C<M> = A*B.
+template <typename a_row_view_t, typename a_nnz_view_t,
+          typename b_row_view_t, typename m_row_view_t>
+struct MaskedRowSizeFunctor{
+  typedef typename a_nnz_view_t::non_const_value_type nnz_lno_t;
+  typedef typename a_row_view_t::non_const_value_type a_size_type;
+
+  a_row_view_t row_mapA;
+  a_nnz_view_t entriesA;
+  b_row_view_t row_mapB;
+  m_row_view_t row_mapM;
+  size_t num_cols;
+  bool complement;
+
+  MaskedRowSizeFunctor(
+      a_row_view_t row_mapA_, a_nnz_view_t entriesA_,
+      b_row_view_t row_mapB_, m_row_view_t row_mapM_,
+      size_t num_cols_, bool complement_):
+    row_mapA(row_mapA_), entriesA(entriesA_),
+    row_mapB(row_mapB_), row_mapM(row_mapM_),
+    num_cols(num_cols_), complement(complement_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const nnz_lno_t i, size_t &max_size) const {
+    size_t row_size = row_mapM(i + 1) - row_mapM(i);
+    if (complement){
+      size_t row_flops = 0;
+      for (a_size_type a = row_mapA(i); a < row_mapA(i + 1); ++a){
+        const nnz_lno_t rowB = entriesA(a);
+        row_flops += row_mapB(rowB + 1) - row_mapB(rowB);
+      }
+      row_size += KOKKOSKERNELS_MACRO_MIN(row_flops, num_cols);
+    }
+    if (row_size > max_size) max_size = row_size;
+  }
+};
+
+//Computes the rows of C<M> = A*B with a hashmap per row, taken from a memory pool.
+//The symbolic phase (is_numeric = false) writes the number of entries of row i into row_mapC(i),
+//the numeric phase writes the entries and values of the rows.
+template <typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t, typename b_scalar_view_t,
+          typename m_row_view_t, typename m_nnz_view_t,
+          typename c_row_view_t, typename c_nnz_view_t, typename c_scalar_view_t,
+          typename pool_memory_space>
+struct MaskedFunctor{
+  typedef typename a_nnz_view_t::non_const_value_type nnz_lno_t;
+  typedef typename a_row_view_t::non_const_value_type a_size_type;
+  typedef typename b_row_view_t::non_const_value_type b_size_type;
+  typedef typename m_row_view_t::non_const_value_type m_size_type;
+  typedef typename c_row_view_t::non_const_value_type c_size_type;
+  typedef typename c_scalar_view_t::non_const_value_type scalar_t;
+
+  a_row_view_t row_mapA;
+  a_nnz_view_t entriesA;
+  a_scalar_view_t valuesA;
+  b_row_view_t row_mapB;
+  b_nnz_view_t entriesB;
+  b_scalar_view_t valuesB;
+  m_row_view_t row_mapM;
+  m_nnz_view_t entriesM;
+  c_row_view_t row_mapC;
+  c_nnz_view_t entriesC;
+  c_scalar_view_t valuesC;
+
+  const bool is_numeric;
+  const bool complement;
+  pool_memory_space memory_space;
+  const nnz_lno_t max_row_size;
+  const nnz_lno_t pow2_hash_size;
+  const KokkosKernels::Impl::ExecSpaceType my_exec_space;
+
+  MaskedFunctor(
+      a_row_view_t row_mapA_, a_nnz_view_t entriesA_, a_scalar_view_t valuesA_,
+      b_row_view_t row_mapB_, b_nnz_view_t entriesB_, b_scalar_view_t valuesB_,
+      m_row_view_t row_mapM_, m_nnz_view_t entriesM_,
+      c_row_view_t row_mapC_, c_nnz_view_t entriesC_, c_scalar_view_t valuesC_,
+      bool is_numeric_, bool complement_,
+      pool_memory_space memory_space_,
+      nnz_lno_t max_row_size_, nnz_lno_t pow2_hash_size_,
+      KokkosKernels::Impl::ExecSpaceType my_exec_space_):
+    row_mapA(row_mapA_), entriesA(entriesA_), valuesA(valuesA_),
+    row_mapB(row_mapB_), entriesB(entriesB_), valuesB(valuesB_),
+    row_mapM(row_mapM_), entriesM(entriesM_),
+    row_mapC(row_mapC_), entriesC(entriesC_), valuesC(valuesC_),
+    is_numeric(is_numeric_), complement(complement_),
+    memory_space(memory_space_),
+    max_row_size(max_row_size_), pow2_hash_size(pow2_hash_size_),
+    my_exec_space(my_exec_space_){}
+
+  KOKKOS_INLINE_FUNCTION
+  size_t get_thread_id(const size_t row_index) const{
+    switch (my_exec_space){
+    default:
+      return row_index;
+#if defined( KOKKOS_ENABLE_SERIAL )
+    case KokkosKernels::Impl::Exec_SERIAL:
+      return 0;
+#endif
+#if defined( KOKKOS_ENABLE_OPENMP )
+    case KokkosKernels::Impl::Exec_OMP:
+      return Kokkos::OpenMP::impl_hardware_thread_id();
+#endif
+#if defined( KOKKOS_ENABLE_THREADS )
+    case KokkosKernels::Impl::Exec_PTHREADS:
+      return Kokkos::Threads::impl_hardware_thread_id();
+#endif
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const nnz_lno_t i) const {
+    //an empty structural mask gives an empty row.
+    if (!complement && row_mapM(i) == row_mapM(i + 1)){
+      if (!is_numeric) row_mapC(i) = 0;
+      return;
+    }
+
+    volatile nnz_lno_t *tmp = NULL;
+    const size_t tid = get_thread_id(i);
+    while (tmp == NULL){
+      tmp = (volatile nnz_lno_t *) (memory_space.allocate_chunk(tid));
+    }
+    nnz_lno_t *chunk = (nnz_lno_t *) tmp;
+
+    //chunk: hash begins, used hashes, hash nexts, keys, hits, and in the numeric phase the values.
+    nnz_lno_t *used_hashes = chunk + pow2_hash_size;
+    nnz_lno_t *keys = chunk + 2 * pow2_hash_size + max_row_size;
+    nnz_lno_t *hits = keys + max_row_size;
+    scalar_t *vals = NULL;
+    if (is_numeric){
+      vals = KokkosKernels::Impl::alignPtr<nnz_lno_t *, scalar_t>(hits + max_row_size);
+    }
+    KokkosKernels::Experimental::HashmapAccumulator<nnz_lno_t, nnz_lno_t, scalar_t, KokkosKernels::Experimental::HashOpType::bitwiseAnd>
+      hm(max_row_size, pow2_hash_size - 1, chunk, chunk + 2 * pow2_hash_size, keys, vals);
+
+    nnz_lno_t used_size = 0;
+    nnz_lno_t used_hash_count = 0;
+    for (m_size_type p = row_mapM(i); p < row_mapM(i + 1); ++p){
+      hm.sequential_insert_into_hash_TrackHashes(entriesM(p), &used_size, &used_hash_count, used_hashes);
+    }
+    const nnz_lno_t mask_size = used_size;
+    for (nnz_lno_t h = 0; h < mask_size; ++h){
+      hits[h] = 0;
+      if (is_numeric) vals[h] = scalar_t();
+    }
+
+    nnz_lno_t row_size = 0;
+    if (!complement){
+      for (a_size_type a = row_mapA(i); a < row_mapA(i + 1); ++a){
+        const nnz_lno_t rowB = entriesA(a);
+        scalar_t valA = scalar_t();
+        if (is_numeric) valA = valuesA(a);
+        for (b_size_type b = row_mapB(rowB); b < row_mapB(rowB + 1); ++b){
+          const nnz_lno_t h = hm.sequential_find_in_hash(entriesB(b));
+          if (h != -1){
+            hits[h] = 1;
+            if (is_numeric) vals[h] += valA * valuesB(b);
+          }
+        }
+      }
+      if (is_numeric){
+        c_size_type c = row_mapC(i);
+        for (nnz_lno_t h = 0; h < mask_size; ++h){
+          if (hits[h]){
+            entriesC(c) = keys[h];
+            valuesC(c) = vals[h];
+            ++c;
+          }
+        }
+      }
+      else {
+        for (nnz_lno_t h = 0; h < mask_size; ++h){
+          row_size += hits[h];
+        }
+      }
+    }
+    else {
+      for (a_size_type a = row_mapA(i); a < row_mapA(i + 1); ++a){
+        const nnz_lno_t rowB = entriesA(a);
+        if (is_numeric){
+          const scalar_t valA = valuesA(a);
+          for (b_size_type b = row_mapB(rowB); b < row_mapB(rowB + 1); ++b){
+            //the accumulator fits the row, insertion cannot fail.
+            hm.sequential_insert_into_hash_mergeAdd_TrackHashes(
+                entriesB(b), valA * valuesB(b), &used_size, &used_hash_count, used_hashes);
+          }
+        }
+        else {
+          for (b_size_type b = row_mapB(rowB); b < row_mapB(rowB + 1); ++b){
+            hm.sequential_insert_into_hash_TrackHashes(
+                entriesB(b), &used_size, &used_hash_count, used_hashes);
+          }
+        }
+      }
+      //the entries past the mask are not in it.
+      if (is_numeric){
+        const c_size_type c_row_begin = row_mapC(i);
+        for (nnz_lno_t h = mask_size; h < used_size; ++h){
+          entriesC(c_row_begin + h - mask_size) = keys[h];
+          valuesC(c_row_begin + h - mask_size) = vals[h];
+        }
+      }
+      row_size = used_size - mask_size;
+    }
+
+    for (nnz_lno_t h = 0; h < used_hash_count; ++h){
+      hm.hash_begins[used_hashes[h]] = -1;
+    }
+    if (!is_numeric){
+      row_mapC(i) = row_size;
+    }
+    memory_space.release_chunk(chunk);
+  }
+};
+
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t, typename b_scalar_view_t,
+          typename m_row_view_t, typename m_nnz_view_t,
+          typename c_row_view_t, typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_masked_run(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+    b_row_view_t row_mapB, b_nnz_view_t entriesB, b_scalar_view_t valuesB,
+    m_row_view_t row_mapM, m_nnz_view_t entriesM,
+    c_row_view_t row_mapC, c_nnz_view_t entriesC, c_scalar_view_t valuesC,
+    bool complement, bool is_numeric){
+
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename KernelHandle::HandleTempMemorySpace MyTempMemorySpace;
+  typedef typename KernelHandle::nnz_lno_t nnz_lno_t;
+  typedef typename c_scalar_view_t::non_const_value_type scalar_t;
+  typedef KokkosKernels::Impl::UniformMemoryPool<MyTempMemorySpace, nnz_lno_t> pool_memory_space;
+  typedef Kokkos::RangePolicy<MyExecSpace, Kokkos::Schedule<Kokkos::Dynamic> > dynamic_range_policy_t;
+
+  if (m == 0) return;
+
+  const size_t max_accumulator_size = handle->get_spgemm_handle()->get_masked_max_row_size();
+  const nnz_lno_t max_row_size = KOKKOSKERNELS_MACRO_MAX(nnz_lno_t(1), nnz_lno_t(max_accumulator_size));
+  nnz_lno_t pow2_hash_size = 2;
+  while (pow2_hash_size < max_row_size){
+    pow2_hash_size *= 2;
+  }
+  size_t chunk_size = 2 * pow2_hash_size + 3 * size_t(max_row_size);
+  if (is_numeric){
+    constexpr size_t scalarAlignPad = (alignof(scalar_t) > alignof(nnz_lno_t)) ? (alignof(scalar_t) - alignof(nnz_lno_t)) : 0;
+    chunk_size += (scalarAlignPad + max_row_size * sizeof(scalar_t) + sizeof(nnz_lno_t) - 1) / sizeof(nnz_lno_t);
+  }
+
+  const KokkosKernels::Impl::ExecSpaceType my_exec_space = KokkosKernels::Impl::kk_get_exec_space_type<MyExecSpace>();
+  KokkosKernels::Impl::PoolType my_pool_type = KokkosKernels::Impl::OneThread2OneChunk;
+  size_t num_chunks = MyExecSpace::concurrency();
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<MyExecSpace>()){
+    my_pool_type = KokkosKernels::Impl::ManyThread2OneChunk;
+    num_chunks = KokkosKernels::Impl::kk_compute_num_pool_chunks<pool_memory_space>(chunk_size * sizeof(nnz_lno_t), num_chunks);
+  }
+  pool_memory_space m_space(num_chunks, chunk_size, -1, my_pool_type);
+
+  if (handle->get_verbose()){
+    std::cout << "\tMasked " << (complement ? "complement " : "") << (is_numeric ? "numeric" : "symbolic")
+              << " max_row_size:" << max_row_size << " hash_size:" << pow2_hash_size
+              << " num_chunks:" << num_chunks << " chunk_size:" << chunk_size << std::endl;
+  }
+
+  MaskedFunctor<a_row_view_t, a_nnz_view_t, a_scalar_view_t,
+                b_row_view_t, b_nnz_view_t, b_scalar_view_t,
+                m_row_view_t, m_nnz_view_t,
+                c_row_view_t, c_nnz_view_t, c_scalar_view_t,
+                pool_memory_space>
+    masked(row_mapA, entriesA, valuesA,
+           row_mapB, entriesB, valuesB,
+           row_mapM, entriesM,
+           row_mapC, entriesC, valuesC,
+           is_numeric, complement, m_space, max_row_size, pow2_hash_size, my_exec_space);
+  Kokkos::parallel_for(is_numeric ? "KokkosSparse::spgemm_masked::Numeric" : "KokkosSparse::spgemm_masked::Symbolic",
+      dynamic_range_policy_t(0, m), masked);
+  MyExecSpace().fence();
+}
+
+/**
+ * \brief Symbolic phase of C<M> = A*B. Fills row_mapC and sets the number of entries of C
+ * in the spgemm handle. A, M and C have m rows, and B and C have k columns.
+ */
+template <typename KernelHandle,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename b_row_view_t, typename b_nnz_view_t,
+          typename m_row_view_t, typename m_nnz_view_t,
+          typename c_row_view_t>
+void spgemm_masked_symbolic_impl(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    typename KernelHandle::nnz_lno_t k,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA,
+    b_row_view_t row_mapB, b_nnz_view_t entriesB,
+    m_row_view_t row_mapM, m_nnz_view_t entriesM,
+    c_row_view_t row_mapC,
+    bool complement){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename KernelHandle::size_type size_type;
+
+  spgemmHandleType *sh = handle->get_spgemm_handle();
+
+  size_t max_row_size = 0;
+  Kokkos::parallel_reduce("KokkosSparse::spgemm_masked::RowSize", Kokkos::RangePolicy<MyExecSpace>(0, m),
+      MaskedRowSizeFunctor<a_row_view_t, a_nnz_view_t, b_row_view_t, m_row_view_t>
+        (row_mapA, entriesA, row_mapB, row_mapM, k, complement),
+      Kokkos::Max<size_t>(max_row_size));
+  sh->set_masked_max_row_size(max_row_size);
+
+  //symbolic phase does not read the values or write the entries.
+  spgemm_masked_run(
+      handle, m,
+      row_mapA, entriesA, typename KernelHandle::in_scalar_nnz_view_t(),
+      row_mapB, entriesB, typename KernelHandle::in_scalar_nnz_view_t(),
+      row_mapM, entriesM,
+      row_mapC, typename KernelHandle::nnz_lno_temp_work_view_t(), typename KernelHandle::scalar_temp_work_view_t(),
+      complement, false);
+
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<c_row_view_t, MyExecSpace>(m + 1, row_mapC);
+  auto c_nnz_view = Kokkos::subview(row_mapC, m);
+  typename c_row_view_t::non_const_value_type c_nnz = 0;
+  Kokkos::deep_copy(c_nnz, c_nnz_view);
+  sh->set_c_nnz(size_type(c_nnz));
+}
+
+}
+}
+#endif
@@ -0,0 +1,343 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef KOKKOSSPARSE_SPGEMM_NUMERIC_REUSE_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_NUMERIC_REUSE_IMPL_HPP_
+
+#include <Kokkos_Core.hpp>
+#include "KokkosKernels_SparseUtils.hpp"
+
+namespace KokkosSparse{
+
+namespace Impl{
+
+//Numeric reuse of C = A*B when only the values of A and B change.
+//The multiplications of row i of A*B are visited in a fixed order: for each entry a_ij of the row of A,
+//all entries b_jk of row j of B. position_map records, in this order, the index in C of the result of each
+//multiplication, and position_map_offsets(i) is the first multiplication of row i.
+//With the map, the numeric phase is a gather-multiply-accumulate without any hashing.
+
+//the caller's entries of C as the view type kept by the spgemm handle, so that the handle can hold the
+//allocation its map belongs to. Empty if the caller's view cannot be held: another memory space,
+//a strided layout, or an unmanaged view.
+template <typename handle_view_t, typename c_lno_view_t,
+          bool holdable =
+              std::is_same<typename handle_view_t::memory_space, typename c_lno_view_t::memory_space>::value &&
+              (std::is_same<typename c_lno_view_t::array_layout, Kokkos::LayoutLeft>::value ||
+               std::is_same<typename c_lno_view_t::array_layout, Kokkos::LayoutRight>::value) &&
+              !c_lno_view_t::memory_traits::is_unmanaged>
+struct SpgemmCEntriesRef{
+  static handle_view_t get(const c_lno_view_t &entriesC){
+    return handle_view_t(entriesC);
+  }
+};
+
+template <typename handle_view_t, typename c_lno_view_t>
+struct SpgemmCEntriesRef<handle_view_t, c_lno_view_t, false>{
+  static handle_view_t get(const c_lno_view_t &){
+    return handle_view_t();
+  }
+};
+
+//counts the multiplications of each row, scanned into the offsets of the map.
+template <typename a_size_view_t, typename a_lno_view_t, typename b_size_view_t, typename offset_view_t>
+struct SpgemmRowFlopsFunctor{
+  typedef typename offset_view_t::non_const_value_type size_type;
+  typedef typename a_lno_view_t::non_const_value_type nnz_lno_t;
+
+  a_size_view_t row_mapA;
+  a_lno_view_t entriesA;
+  b_size_view_t row_mapB;
+  offset_view_t offsets;
+
+  SpgemmRowFlopsFunctor(a_size_view_t row_mapA_, a_lno_view_t entriesA_, b_size_view_t row_mapB_, offset_view_t offsets_):
+    row_mapA(row_mapA_), entriesA(entriesA_), row_mapB(row_mapB_), offsets(offsets_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const nnz_lno_t i, size_type &update, const bool final) const {
+    size_type row_flops = 0;
+    for (size_type pa = row_mapA(i); pa < row_mapA(i + 1); ++pa){
+      const nnz_lno_t j = entriesA(pa);
+      row_flops += row_mapB(j + 1) - row_mapB(j);
+    }
+    update += row_flops;
+    if (final){
+      offsets(i + 1) = update;
+    }
+  }
+};
+
+//finds the position in C of every multiplication. Rows of C must be sorted.
+template <typename team_member_t,
+          typename a_size_view_t, typename a_lno_view_t,
+          typename b_size_view_t, typename b_lno_view_t,
+          typename c_size_view_t, typename c_lno_view_t,
+          typename map_view_t>
+struct SpgemmPositionMapFunctor{
+  typedef typename map_view_t::non_const_value_type size_type;
+  typedef typename a_lno_view_t::non_const_value_type nnz_lno_t;
+
+  nnz_lno_t num_rows;
+  a_size_view_t row_mapA;
+  a_lno_view_t entriesA;
+  b_size_view_t row_mapB;
+  b_lno_view_t entriesB;
+  c_size_view_t row_mapC;
+  c_lno_view_t entriesC;
+  map_view_t offsets;
+  map_view_t position_map;
+  nnz_lno_t team_row_chunk_size;
+
+  SpgemmPositionMapFunctor(
+      nnz_lno_t num_rows_,
+      a_size_view_t row_mapA_, a_lno_view_t entriesA_,
+      b_size_view_t row_mapB_, b_lno_view_t entriesB_,
+      c_size_view_t row_mapC_, c_lno_view_t entriesC_,
+      map_view_t offsets_, map_view_t position_map_,
+      nnz_lno_t team_row_chunk_size_):
+    num_rows(num_rows_),
+    row_mapA(row_mapA_), entriesA(entriesA_),
+    row_mapB(row_mapB_), entriesB(entriesB_),
+    row_mapC(row_mapC_), entriesC(entriesC_),
+    offsets(offsets_), position_map(position_map_),
+    team_row_chunk_size(team_row_chunk_size_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const team_member_t &teamMember) const {
+    const nnz_lno_t team_row_begin = teamMember.league_rank() * team_row_chunk_size;
+    const nnz_lno_t team_row_end = KOKKOSKERNELS_MACRO_MIN(team_row_begin + team_row_chunk_size, num_rows);
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(teamMember, team_row_begin, team_row_end), [&] (const nnz_lno_t i){
+      const size_type c_begin = row_mapC(i);
+      const nnz_lno_t c_len = row_mapC(i + 1) - c_begin;
+      size_type pos = offsets(i);
+      for (size_type pa = row_mapA(i); pa < row_mapA(i + 1); ++pa){
+        const nnz_lno_t j = entriesA(pa);
+        const size_type b_begin = row_mapB(j);
+        const nnz_lno_t b_len = row_mapB(j + 1) - b_begin;
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(teamMember, b_len), [&] (const nnz_lno_t t){
+          const nnz_lno_t col = entriesB(b_begin + t);
+          //lower bound of col in the sorted row of C.
+          nnz_lno_t lo = 0, hi = c_len;
+          while (lo < hi){
+            const nnz_lno_t mid = (lo + hi) / 2;
+            if (entriesC(c_begin + mid) < col) lo = mid + 1;
+            else hi = mid;
+          }
+          position_map(pos + t) = c_begin + lo;
+        });
+        pos += b_len;
+      }
+    });
+  }
+};
+
+//accumulates the multiplications into the recorded positions of C. valuesC must be zero.
+template <typename team_member_t,
+          typename a_size_view_t, typename a_lno_view_t, typename a_scalar_view_t,
+          typename b_size_view_t, typename b_scalar_view_t,
+          typename c_scalar_view_t,
+          typename map_view_t>
+struct SpgemmReuseNumericFunctor{
+  typedef typename map_view_t::non_const_value_type size_type;
+  typedef typename a_lno_view_t::non_const_value_type nnz_lno_t;
+  typedef typename a_scalar_view_t::non_const_value_type scalar_t;
+
+  nnz_lno_t num_rows;
+  a_size_view_t row_mapA;
+  a_lno_view_t entriesA;
+  a_scalar_view_t valuesA;
+  b_size_view_t row_mapB;
+  b_scalar_view_t valuesB;
+  c_scalar_view_t valuesC;
+  map_view_t offsets;
+  map_view_t position_map;
+  nnz_lno_t team_row_chunk_size;
+  //vector lanes working on the same row of A*B can hit the same entry of C.
+  bool use_atomics;
+
+  SpgemmReuseNumericFunctor(
+      nnz_lno_t num_rows_,
+      a_size_view_t row_mapA_, a_lno_view_t entriesA_, a_scalar_view_t valuesA_,
+      b_size_view_t row_mapB_, b_scalar_view_t valuesB_,
+      c_scalar_view_t valuesC_,
+      map_view_t offsets_, map_view_t position_map_,
+      nnz_lno_t team_row_chunk_size_, bool use_atomics_):
+    num_rows(num_rows_),
+    row_mapA(row_mapA_), entriesA(entriesA_), valuesA(valuesA_),
+    row_mapB(row_mapB_), valuesB(valuesB_),
+    valuesC(valuesC_),
+    offsets(offsets_), position_map(position_map_),
+    team_row_chunk_size(team_row_chunk_size_), use_atomics(use_atomics_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const team_member_t &teamMember) const {
+    const nnz_lno_t team_row_begin = teamMember.league_rank() * team_row_chunk_size;
+    const nnz_lno_t team_row_end = KOKKOSKERNELS_MACRO_MIN(team_row_begin + team_row_chunk_size, num_rows);
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(teamMember, team_row_begin, team_row_end), [&] (const nnz_lno_t i){
+      size_type pos = offsets(i);
+      for (size_type pa = row_mapA(i); pa < row_mapA(i + 1); ++pa){
+        const nnz_lno_t j = entriesA(pa);
+        const scalar_t a_val = valuesA(pa);
+        const size_type b_begin = row_mapB(j);
+        const nnz_lno_t b_len = row_mapB(j + 1) - b_begin;
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(teamMember, b_len), [&] (const nnz_lno_t t){
+          const scalar_t val = a_val * valuesB(b_begin + t);
+          if (use_atomics)
+            Kokkos::atomic_add(&valuesC(position_map(pos + t)), val);
+          else
+            valuesC(position_map(pos + t)) += val;
+        });
+        pos += b_len;
+      }
+    });
+  }
+};
+
+/**
+ * \brief Builds the position map of C = A*B after a numeric phase, if it fits into the budget
+ * of the spgemm handle, and stores it in the handle. Sorts the rows of C.
+ */
+template <typename KernelHandle,
+          typename a_size_view_t, typename a_lno_view_t,
+          typename b_size_view_t, typename b_lno_view_t,
+          typename c_size_view_t, typename c_lno_view_t, typename c_scalar_view_t>
+void spgemm_build_c_position_map(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    a_size_view_t row_mapA, a_lno_view_t entriesA,
+    b_size_view_t row_mapB, b_lno_view_t entriesB,
+    c_size_view_t row_mapC, c_lno_view_t entriesC, c_scalar_view_t valuesC){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename KernelHandle::nnz_lno_t nnz_lno_t;
+  typedef typename spgemmHandleType::size_type size_type;
+  typedef typename spgemmHandleType::row_lno_persistent_work_view_t map_view_t;
+  typedef Kokkos::TeamPolicy<MyExecSpace> team_policy_t;
+  typedef typename team_policy_t::member_type team_member_t;
+
+  spgemmHandleType *sh = handle->get_spgemm_handle();
+
+  map_view_t offsets("SpGEMM C position map offsets", m + 1);
+  size_type overall_flops = 0;
+  Kokkos::parallel_scan("KokkosSparse::spgemm_numeric::RowFlops", Kokkos::RangePolicy<MyExecSpace>(0, m),
+      SpgemmRowFlopsFunctor<a_size_view_t, a_lno_view_t, b_size_view_t, map_view_t>(row_mapA, entriesA, row_mapB, offsets),
+      overall_flops);
+
+  const size_t map_bytes = (size_t(overall_flops) + m + 1) * sizeof(size_type);
+  if (map_bytes > sh->get_c_position_map_budget()){
+    if (handle->get_verbose()){
+      std::cout << "\tSpGEMM C position map needs " << map_bytes << " bytes, over the budget of "
+                << sh->get_c_position_map_budget() << ". Numeric is not reused." << std::endl;
+    }
+    sh->set_c_position_map(map_view_t(), map_view_t());
+    return;
+  }
+
+  //the map is searched by column, and the order of C stays fixed from now on.
+  KokkosKernels::Impl::sort_crs_matrix<MyExecSpace, c_size_view_t, c_lno_view_t, c_scalar_view_t>(row_mapC, entriesC, valuesC);
+
+  map_view_t position_map(Kokkos::ViewAllocateWithoutInitializing("SpGEMM C position map"), overall_flops);
+
+  const size_t brows = row_mapB.extent(0) ? row_mapB.extent(0) - 1 : 0;
+  const int suggested_vector_size = handle->get_suggested_vector_size(brows, entriesB.extent(0));
+  const int suggested_team_size = handle->get_suggested_team_size(suggested_vector_size);
+  const nnz_lno_t team_row_chunk_size = handle->get_team_work_size(suggested_team_size, MyExecSpace::concurrency(), m);
+
+  Kokkos::parallel_for("KokkosSparse::spgemm_numeric::PositionMap",
+      team_policy_t(m / team_row_chunk_size + 1, suggested_team_size, suggested_vector_size),
+      SpgemmPositionMapFunctor<team_member_t, a_size_view_t, a_lno_view_t, b_size_view_t, b_lno_view_t,
+                               c_size_view_t, c_lno_view_t, map_view_t>
+        (m, row_mapA, entriesA, row_mapB, entriesB, row_mapC, entriesC, offsets, position_map, team_row_chunk_size));
+  MyExecSpace().fence();
+
+  sh->set_c_position_map(offsets, position_map);
+}
+
+/**
+ * \brief Numeric phase of C = A*B using the position map stored in the spgemm handle.
+ * Only the values of C are written.
+ */
+template <typename KernelHandle,
+          typename a_size_view_t, typename a_lno_view_t, typename a_scalar_view_t,
+          typename b_size_view_t, typename b_lno_view_t, typename b_scalar_view_t,
+          typename c_scalar_view_t>
+void spgemm_reuse_numeric(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    a_size_view_t row_mapA, a_lno_view_t entriesA, a_scalar_view_t valuesA,
+    b_size_view_t row_mapB, b_lno_view_t entriesB, b_scalar_view_t valuesB,
+    c_scalar_view_t valuesC){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename KernelHandle::nnz_lno_t nnz_lno_t;
+  typedef typename spgemmHandleType::row_lno_persistent_work_view_t map_view_t;
+  typedef Kokkos::TeamPolicy<MyExecSpace> team_policy_t;
+  typedef typename team_policy_t::member_type team_member_t;
+
+  spgemmHandleType *sh = handle->get_spgemm_handle();
+  map_view_t offsets, position_map;
+  sh->get_c_position_map(offsets, position_map);
+
+  Kokkos::deep_copy(valuesC, typename c_scalar_view_t::non_const_value_type());
+
+  const size_t brows = row_mapB.extent(0) ? row_mapB.extent(0) - 1 : 0;
+  const int suggested_vector_size = handle->get_suggested_vector_size(brows, entriesB.extent(0));
+  const int suggested_team_size = handle->get_suggested_team_size(suggested_vector_size);
+  const nnz_lno_t team_row_chunk_size = handle->get_team_work_size(suggested_team_size, MyExecSpace::concurrency(), m);
+
+  Kokkos::parallel_for("KokkosSparse::spgemm_numeric::ReuseNumeric",
+      team_policy_t(m / team_row_chunk_size + 1, suggested_team_size, suggested_vector_size),
+      SpgemmReuseNumericFunctor<team_member_t, a_size_view_t, a_lno_view_t, a_scalar_view_t,
+                                b_size_view_t, b_scalar_view_t, c_scalar_view_t, map_view_t>
+        (m, row_mapA, entriesA, valuesA, row_mapB, valuesB, valuesC, offsets, position_map,
+         team_row_chunk_size, suggested_vector_size > 1));
+  MyExecSpace().fence();
+}
+
+}
+}
+#endif
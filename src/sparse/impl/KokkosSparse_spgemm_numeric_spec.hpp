@@ -59,6 +59,7 @@
 #include "KokkosSparse_spgemm_mkl_impl.hpp"
 #include "KokkosSparse_spgemm_mkl2phase_impl.hpp"
 #include "KokkosSparse_spgemm_viennaCL_impl.hpp"
+#include "KokkosSparse_spgemm_numeric_reuse_impl.hpp"
 #endif
 
 namespace KokkosSparse {
@@ -257,6 +258,18 @@ struct SPGEMM_NUMERIC<KernelHandle,
       */
     }
 
+    //only the values changed since the positions in C were recorded.
+    //the entries of C must be the ones spgemm_numeric handed to the spgemm handle.
+    const bool use_c_position_map = sh->get_c_position_map_budget() > 0 && !transposeA && !transposeB &&
+        sh->get_numeric_c_entries().data() != NULL && sh->get_numeric_c_entries().data() == entriesC.data();
+    if (use_c_position_map && sh->has_c_position_map(sh->get_numeric_c_entries())){
+      spgemm_reuse_numeric(
+          handle, m,
+          row_mapA, entriesA, valuesA,
+          row_mapB, entriesB, valuesB,
+          valuesC);
+      return;
+    }
 
     switch (sh->get_algorithm_type()){
     case SPGEMM_CUSPARSE:
@@ -343,6 +356,14 @@ struct SPGEMM_NUMERIC<KernelHandle,
           );
       break;
     }
+
+    if (use_c_position_map && !sh->is_c_position_map_decided()){
+      spgemm_build_c_position_map(
+          handle, m,
+          row_mapA, entriesA,
+          row_mapB, entriesB,
+          row_mapC, entriesC, valuesC);
+    }
 }
 };
 
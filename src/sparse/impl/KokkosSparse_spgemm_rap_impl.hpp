@@ -0,0 +1,381 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef KOKKOSSPARSE_SPGEMM_RAP_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_RAP_IMPL_HPP_
+
+#include <Kokkos_Core.hpp>
+#include "KokkosKernels_Utils.hpp"
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosKernels_SparseUtils.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_HashmapAccumulator.hpp"
+#include "KokkosKernels_Uniform_Initialized_MemoryPool.hpp"
+
+namespace KokkosSparse{
+
+namespace Impl{
+
+//Fused triple product C = R*A*P, as used to form the coarse operators of multigrid.
+//Row i of C is accumulated directly from the rows of A and P:
+//  C(i,:) = sum_{q in R(i,:)} r_iq * sum_{j in A(q,:)} a_qj * P(j,:)
+//into a single hashmap, so the intermediate product A*P is never formed.
+//When R = P^T, the rows of R are given by the pattern of P^T, and its values are read from P
+//through a permutation, so P^T is not formed either.
+
+//finds the largest number of multiplications in a row of R*A*P.
+template <typename r_row_view_t, typename r_nnz_view_t,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename p_row_view_t>
+struct RapRowFlopsFunctor{
+  typedef typename r_nnz_view_t::non_const_value_type nnz_lno_t;
+  typedef typename r_row_view_t::non_const_value_type r_size_type;
+  typedef typename a_row_view_t::non_const_value_type a_size_type;
+
+  r_row_view_t row_mapR;
+  r_nnz_view_t entriesR;
+  a_row_view_t row_mapA;
+  a_nnz_view_t entriesA;
+  p_row_view_t row_mapP;
+
+  RapRowFlopsFunctor(
+      r_row_view_t row_mapR_, r_nnz_view_t entriesR_,
+      a_row_view_t row_mapA_, a_nnz_view_t entriesA_,
+      p_row_view_t row_mapP_):
+    row_mapR(row_mapR_), entriesR(entriesR_),
+    row_mapA(row_mapA_), entriesA(entriesA_),
+    row_mapP(row_mapP_){}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const nnz_lno_t i, size_t &max_flops) const {
+    size_t row_flops = 0;
+    for (r_size_type q = row_mapR(i); q < row_mapR(i + 1); ++q){
+      const nnz_lno_t rowA = entriesR(q);
+      for (a_size_type a = row_mapA(rowA); a < row_mapA(rowA + 1); ++a){
+        const nnz_lno_t rowP = entriesA(a);
+        row_flops += row_mapP(rowP + 1) - row_mapP(rowP);
+      }
+    }
+    if (row_flops > max_flops) max_flops = row_flops;
+  }
+};
+
+//Accumulates the rows of C = R*A*P with a hashmap per row, taken from a memory pool.
+//The symbolic phase (is_numeric = false) writes the number of entries of row i into row_mapC(i),
+//the numeric phase writes the entries and values of the rows.
+template <typename r_row_view_t, typename r_nnz_view_t, typename r_scalar_view_t, typename r_perm_view_t,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename p_row_view_t, typename p_nnz_view_t, typename p_scalar_view_t,
+          typename c_row_view_t, typename c_nnz_view_t, typename c_scalar_view_t,
+          typename pool_memory_space>
+struct RapFunctor{
+  typedef typename r_nnz_view_t::non_const_value_type nnz_lno_t;
+  typedef typename r_row_view_t::non_const_value_type r_size_type;
+  typedef typename a_row_view_t::non_const_value_type a_size_type;
+  typedef typename p_row_view_t::non_const_value_type p_size_type;
+  typedef typename c_scalar_view_t::non_const_value_type scalar_t;
+
+  r_row_view_t row_mapR;
+  r_nnz_view_t entriesR;
+  r_scalar_view_t valuesR;
+  //if not empty, the value of R at q is valuesR(permutationR(q)).
+  r_perm_view_t permutationR;
+  a_row_view_t row_mapA;
+  a_nnz_view_t entriesA;
+  a_scalar_view_t valuesA;
+  p_row_view_t row_mapP;
+  p_nnz_view_t entriesP;
+  p_scalar_view_t valuesP;
+  c_row_view_t row_mapC;
+  c_nnz_view_t entriesC;
+  c_scalar_view_t valuesC;
+
+  const bool is_numeric;
+  const bool use_permutation;
+  pool_memory_space memory_space;
+  const nnz_lno_t max_row_size;
+  const nnz_lno_t pow2_hash_size;
+  const KokkosKernels::Impl::ExecSpaceType my_exec_space;
+
+  RapFunctor(
+      r_row_view_t row_mapR_, r_nnz_view_t entriesR_, r_scalar_view_t valuesR_, r_perm_view_t permutationR_,
+      a_row_view_t row_mapA_, a_nnz_view_t entriesA_, a_scalar_view_t valuesA_,
+      p_row_view_t row_mapP_, p_nnz_view_t entriesP_, p_scalar_view_t valuesP_,
+      c_row_view_t row_mapC_, c_nnz_view_t entriesC_, c_scalar_view_t valuesC_,
+      bool is_numeric_,
+      pool_memory_space memory_space_,
+      nnz_lno_t max_row_size_, nnz_lno_t pow2_hash_size_,
+      KokkosKernels::Impl::ExecSpaceType my_exec_space_):
+    row_mapR(row_mapR_), entriesR(entriesR_), valuesR(valuesR_), permutationR(permutationR_),
+    row_mapA(row_mapA_), entriesA(entriesA_), valuesA(valuesA_),
+    row_mapP(row_mapP_), entriesP(entriesP_), valuesP(valuesP_),
+    row_mapC(row_mapC_), entriesC(entriesC_), valuesC(valuesC_),
+    is_numeric(is_numeric_), use_permutation(permutationR_.extent(0) > 0),
+    memory_space(memory_space_),
+    max_row_size(max_row_size_), pow2_hash_size(pow2_hash_size_),
+    my_exec_space(my_exec_space_){}
+
+  KOKKOS_INLINE_FUNCTION
+  size_t get_thread_id(const size_t row_index) const{
+    switch (my_exec_space){
+    default:
+      return row_index;
+#if defined( KOKKOS_ENABLE_SERIAL )
+    case KokkosKernels::Impl::Exec_SERIAL:
+      return 0;
+#endif
+#if defined( KOKKOS_ENABLE_OPENMP )
+    case KokkosKernels::Impl::Exec_OMP:
+      return Kokkos::OpenMP::impl_hardware_thread_id();
+#endif
+#if defined( KOKKOS_ENABLE_THREADS )
+    case KokkosKernels::Impl::Exec_PTHREADS:
+      return Kokkos::Threads::impl_hardware_thread_id();
+#endif
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const nnz_lno_t i) const {
+    volatile nnz_lno_t *tmp = NULL;
+    const size_t tid = get_thread_id(i);
+    while (tmp == NULL){
+      tmp = (volatile nnz_lno_t *) (memory_space.allocate_chunk(tid));
+    }
+    nnz_lno_t *chunk = (nnz_lno_t *) tmp;
+
+    //chunk: hash begins, used hashes, hash nexts, and in the symbolic phase the keys.
+    KokkosKernels::Experimental::HashmapAccumulator<nnz_lno_t, nnz_lno_t, scalar_t, KokkosKernels::Experimental::HashOpType::bitwiseAnd>
+      hm(max_row_size, pow2_hash_size - 1, chunk, chunk + 2 * pow2_hash_size, NULL, NULL);
+    nnz_lno_t *used_hashes = chunk + pow2_hash_size;
+    if (is_numeric){
+      const size_t c_row_begin = row_mapC(i);
+      hm.keys = entriesC.data() + c_row_begin;
+      hm.values = valuesC.data() + c_row_begin;
+    }
+    else {
+      hm.keys = chunk + 2 * pow2_hash_size + max_row_size;
+    }
+
+    nnz_lno_t used_size = 0;
+    nnz_lno_t used_hash_count = 0;
+    for (r_size_type q = row_mapR(i); q < row_mapR(i + 1); ++q){
+      const nnz_lno_t rowA = entriesR(q);
+      scalar_t valR = scalar_t();
+      if (is_numeric)
+        valR = use_permutation ? valuesR(permutationR(q)) : valuesR(q);
+      for (a_size_type a = row_mapA(rowA); a < row_mapA(rowA + 1); ++a){
+        const nnz_lno_t rowP = entriesA(a);
+        if (is_numeric){
+          const scalar_t valRA = valR * valuesA(a);
+          for (p_size_type p = row_mapP(rowP); p < row_mapP(rowP + 1); ++p){
+            //the accumulator fits the row, insertion cannot fail.
+            hm.sequential_insert_into_hash_mergeAdd_TrackHashes(
+                entriesP(p), valRA * valuesP(p), &used_size, &used_hash_count, used_hashes);
+          }
+        }
+        else {
+          for (p_size_type p = row_mapP(rowP); p < row_mapP(rowP + 1); ++p){
+            hm.sequential_insert_into_hash_TrackHashes(
+                entriesP(p), &used_size, &used_hash_count, used_hashes);
+          }
+        }
+      }
+    }
+    for (nnz_lno_t h = 0; h < used_hash_count; ++h){
+      hm.hash_begins[used_hashes[h]] = -1;
+    }
+    if (!is_numeric){
+      row_mapC(i) = used_size;
+    }
+    memory_space.release_chunk(chunk);
+  }
+};
+
+template <typename KernelHandle,
+          typename r_row_view_t, typename r_nnz_view_t, typename r_scalar_view_t, typename r_perm_view_t,
+          typename a_row_view_t, typename a_nnz_view_t, typename a_scalar_view_t,
+          typename p_row_view_t, typename p_nnz_view_t, typename p_scalar_view_t,
+          typename c_row_view_t, typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_rap_run(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    typename KernelHandle::nnz_lno_t k,
+    r_row_view_t row_mapR, r_nnz_view_t entriesR, r_scalar_view_t valuesR, r_perm_view_t permutationR,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+    p_row_view_t row_mapP, p_nnz_view_t entriesP, p_scalar_view_t valuesP,
+    c_row_view_t row_mapC, c_nnz_view_t entriesC, c_scalar_view_t valuesC,
+    bool is_numeric){
+
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename KernelHandle::HandleTempMemorySpace MyTempMemorySpace;
+  typedef typename KernelHandle::nnz_lno_t nnz_lno_t;
+  typedef KokkosKernels::Impl::UniformMemoryPool<MyTempMemorySpace, nnz_lno_t> pool_memory_space;
+  typedef Kokkos::RangePolicy<MyExecSpace, Kokkos::Schedule<Kokkos::Dynamic> > dynamic_range_policy_t;
+
+  if (m == 0) return;
+
+  //the distinct columns of a row are bounded by its multiplications and by the columns of P.
+  const size_t max_row_flops = handle->get_spgemm_handle()->get_rap_max_row_flops();
+  const nnz_lno_t max_row_size = KOKKOSKERNELS_MACRO_MAX(nnz_lno_t(1), nnz_lno_t(KOKKOSKERNELS_MACRO_MIN(max_row_flops, size_t(k))));
+  nnz_lno_t pow2_hash_size = 2;
+  while (pow2_hash_size < max_row_size){
+    pow2_hash_size *= 2;
+  }
+  const size_t chunk_size = 2 * pow2_hash_size + (is_numeric ? 1 : 2) * size_t(max_row_size);
+
+  const KokkosKernels::Impl::ExecSpaceType my_exec_space = KokkosKernels::Impl::kk_get_exec_space_type<MyExecSpace>();
+  KokkosKernels::Impl::PoolType my_pool_type = KokkosKernels::Impl::OneThread2OneChunk;
+  size_t num_chunks = MyExecSpace::concurrency();
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<MyExecSpace>()){
+    my_pool_type = KokkosKernels::Impl::ManyThread2OneChunk;
+    num_chunks = KokkosKernels::Impl::kk_compute_num_pool_chunks<pool_memory_space>(chunk_size * sizeof(nnz_lno_t), num_chunks);
+  }
+  pool_memory_space m_space(num_chunks, chunk_size, -1, my_pool_type);
+
+  if (handle->get_verbose()){
+    std::cout << "\tRAP " << (is_numeric ? "numeric" : "symbolic")
+              << " max_row_flops:" << max_row_flops << " hash_size:" << pow2_hash_size
+              << " num_chunks:" << num_chunks << " chunk_size:" << chunk_size << std::endl;
+  }
+
+  RapFunctor<r_row_view_t, r_nnz_view_t, r_scalar_view_t, r_perm_view_t,
+             a_row_view_t, a_nnz_view_t, a_scalar_view_t,
+             p_row_view_t, p_nnz_view_t, p_scalar_view_t,
+             c_row_view_t, c_nnz_view_t, c_scalar_view_t,
+             pool_memory_space>
+    rap(row_mapR, entriesR, valuesR, permutationR,
+        row_mapA, entriesA, valuesA,
+        row_mapP, entriesP, valuesP,
+        row_mapC, entriesC, valuesC,
+        is_numeric, m_space, max_row_size, pow2_hash_size, my_exec_space);
+  Kokkos::parallel_for(is_numeric ? "KokkosSparse::spgemm_rap::Numeric" : "KokkosSparse::spgemm_rap::Symbolic",
+      dynamic_range_policy_t(0, m), rap);
+  MyExecSpace().fence();
+}
+
+/**
+ * \brief Symbolic phase of C = R*A*P. Fills row_mapC and sets the number of entries of C
+ * in the spgemm handle. R has m rows, and P has k columns.
+ */
+template <typename KernelHandle,
+          typename r_row_view_t, typename r_nnz_view_t,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename p_row_view_t, typename p_nnz_view_t,
+          typename c_row_view_t>
+void spgemm_rap_symbolic_impl(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t m,
+    typename KernelHandle::nnz_lno_t k,
+    r_row_view_t row_mapR, r_nnz_view_t entriesR,
+    a_row_view_t row_mapA, a_nnz_view_t entriesA,
+    p_row_view_t row_mapP, p_nnz_view_t entriesP,
+    c_row_view_t row_mapC){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename KernelHandle::size_type size_type;
+  typedef typename spgemmHandleType::row_lno_persistent_work_view_t perm_view_t;
+
+  spgemmHandleType *sh = handle->get_spgemm_handle();
+
+  size_t max_row_flops = 0;
+  Kokkos::parallel_reduce("KokkosSparse::spgemm_rap::RowFlops", Kokkos::RangePolicy<MyExecSpace>(0, m),
+      RapRowFlopsFunctor<r_row_view_t, r_nnz_view_t, a_row_view_t, a_nnz_view_t, p_row_view_t>
+        (row_mapR, entriesR, row_mapA, entriesA, row_mapP),
+      Kokkos::Max<size_t>(max_row_flops));
+  sh->set_rap_max_row_flops(max_row_flops);
+
+  //symbolic phase does not read the values or write the entries.
+  spgemm_rap_run(
+      handle, m, k,
+      row_mapR, entriesR, typename KernelHandle::in_scalar_nnz_view_t(), perm_view_t(),
+      row_mapA, entriesA, typename KernelHandle::in_scalar_nnz_view_t(),
+      row_mapP, entriesP, typename KernelHandle::in_scalar_nnz_view_t(),
+      row_mapC, typename KernelHandle::nnz_lno_temp_work_view_t(), typename KernelHandle::scalar_temp_work_view_t(),
+      false);
+
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<c_row_view_t, MyExecSpace>(m + 1, row_mapC);
+  auto c_nnz_view = Kokkos::subview(row_mapC, m);
+  typename c_row_view_t::non_const_value_type c_nnz = 0;
+  Kokkos::deep_copy(c_nnz, c_nnz_view);
+  sh->set_c_nnz(size_type(c_nnz));
+}
+
+/**
+ * \brief Stores the pattern of P^T, and the position in P of each of its entries,
+ * in the spgemm handle for the triple product P^T*A*P. P has n rows and k columns.
+ */
+template <typename KernelHandle, typename p_row_view_t, typename p_nnz_view_t>
+void spgemm_rap_transpose_pattern(
+    KernelHandle *handle,
+    typename KernelHandle::nnz_lno_t n,
+    typename KernelHandle::nnz_lno_t k,
+    p_row_view_t row_mapP, p_nnz_view_t entriesP){
+
+  typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
+  typedef typename KernelHandle::HandleExecSpace MyExecSpace;
+  typedef typename spgemmHandleType::size_type size_type;
+  typedef typename spgemmHandleType::row_lno_persistent_work_view_t row_view_t;
+  typedef typename spgemmHandleType::nnz_lno_persistent_work_view_t nnz_view_t;
+
+  const size_type nnzP = entriesP.extent(0);
+  //the positions of the entries of P, transposed as if they were the values.
+  row_view_t positions(Kokkos::ViewAllocateWithoutInitializing("P positions"), nnzP);
+  KokkosKernels::Impl::linear_init<row_view_t, MyExecSpace>(nnzP, positions);
+
+  row_view_t t_rowmap("P^T rowmap", k + 1);
+  nnz_view_t t_entries(Kokkos::ViewAllocateWithoutInitializing("P^T entries"), nnzP);
+  row_view_t t_permutation(Kokkos::ViewAllocateWithoutInitializing("P^T permutation"), nnzP);
+  KokkosKernels::Impl::transpose_matrix<
+    p_row_view_t, p_nnz_view_t, row_view_t,
+    row_view_t, nnz_view_t, row_view_t,
+    row_view_t, MyExecSpace>
+      (n, k, row_mapP, entriesP, positions, t_rowmap, t_entries, t_permutation);
+
+  handle->get_spgemm_handle()->set_rap_transpose(t_rowmap, t_entries, t_permutation);
+}
+
+}
+}
+#endif
@@ -58,6 +58,7 @@
 #include "KokkosSparse_spgemm_mkl_impl.hpp"
 #include "KokkosSparse_spgemm_mkl2phase_impl.hpp"
 #include "KokkosSparse_spgemm_viennaCL_impl.hpp"
+#include "KokkosSparse_spgemm_auto_impl.hpp"
 #endif
 
 namespace KokkosSparse {
@@ -175,6 +176,11 @@ struct SPGEMM_SYMBOLIC < KernelHandle,
 
     typedef typename KernelHandle::SPGEMMHandleType spgemmHandleType;
     spgemmHandleType *sh = handle->get_spgemm_handle();
+    //a new pattern invalidates the positions recorded by the numeric phase.
+    sh->reset_c_position_map();
+    if (sh->is_auto_algorithm()){
+      spgemm_auto_select_algorithm(handle, m, k, row_mapA, entriesA, row_mapB, entriesB);
+    }
     switch (sh->get_algorithm_type()){
 
     case SPGEMM_CUSPARSE:
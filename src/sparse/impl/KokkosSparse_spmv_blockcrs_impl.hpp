@@ -0,0 +1,335 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_BLOCKCRS_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_BLOCKCRS_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosBlas1_scal.hpp"
+#include "KokkosSparse_BlockCrsMatrix.hpp"
+#include <type_traits>
+
+namespace KokkosSparse {
+namespace Impl {
+
+struct BlockCrsTransposeTag {};
+
+/// \brief y := beta*y + alpha*op(A)*x for a BlockCrsMatrix A.
+///
+/// BS is the block size when it is known at compile time, or 0 for
+/// the runtime fallback.  Within a block-row the values form a dense
+/// blockDim x (numBlocks*blockDim) row-major array, so block K of
+/// local row i starts at i*numBlocks*blockDim + K*blockDim.
+///
+/// The no-transpose kernel reads each block column index once and
+/// applies the whole block to the corresponding slice of x.  The
+/// transpose kernel scatters into y with atomics; y must already
+/// have been scaled by beta.
+template<class AMatrix, class XVector, class YVector, int BS, bool conjugate>
+struct BlockCrs_SPMV_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_size_type        size_type;
+  typedef typename AMatrix::non_const_value_type       value_type;
+  typedef typename YVector::non_const_value_type       y_value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<value_type>     ATV;
+  typedef Kokkos::Details::ArithTraits<y_value_type>   ATY;
+
+  const y_value_type alpha;
+  AMatrix  m_A;
+  XVector  m_x;
+  const y_value_type beta;
+  YVector  m_y;
+  const ordinal_type rows_per_team;
+
+  BlockCrs_SPMV_Functor (const y_value_type alpha_,
+                         const AMatrix m_A_,
+                         const XVector m_x_,
+                         const y_value_type beta_,
+                         const YVector m_y_,
+                         const ordinal_type rows_per_team_ = 1) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_), beta (beta_), m_y (m_y_),
+    rows_per_team (rows_per_team_)
+  {
+    static_assert (static_cast<int> (XVector::rank) == 1,
+                   "XVector must be a rank 1 View.");
+    static_assert (static_cast<int> (YVector::rank) == 1,
+                   "YVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  value_type coeff (const value_type& v) const
+  {
+    return conjugate ? ATV::conj (v) : v;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void store (const ordinal_type row, const y_value_type& sum) const
+  {
+    if (beta == ATY::zero ()) {
+      m_y(row) = alpha * sum;
+    } else {
+      m_y(row) = beta * m_y(row) + alpha * sum;
+    }
+  }
+
+  // Host: one block-row per work item
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type blockRow) const
+  {
+    const ordinal_type bs = (BS > 0) ? BS : m_A.blockDim ();
+    const size_type start = m_A.graph.row_map(blockRow);
+    const ordinal_type len = static_cast<ordinal_type> (m_A.graph.row_map(blockRow + 1) - start);
+    const value_type* vals = m_A.values.data () + start * bs * bs;
+    const ordinal_type stride = len * bs;
+
+    if (BS > 0) {
+      y_value_type sum[BS > 0 ? BS : 1];
+      for (int i = 0; i < BS; ++i) sum[i] = ATY::zero ();
+      for (ordinal_type K = 0; K < len; ++K) {
+        const ordinal_type col = m_A.graph.entries(start + K) * BS;
+        const value_type* blk = vals + K * BS;
+#ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
+#pragma unroll
+#endif
+        for (int i = 0; i < BS; ++i) {
+#ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
+#pragma unroll
+#endif
+          for (int j = 0; j < BS; ++j) {
+            sum[i] += coeff (blk[i * stride + j]) * m_x(col + j);
+          }
+        }
+      }
+      for (int i = 0; i < BS; ++i) {
+        store (blockRow * BS + i, sum[i]);
+      }
+    }
+    else {
+      for (ordinal_type i = 0; i < bs; ++i) {
+        const value_type* row = vals + i * stride;
+        y_value_type sum = ATY::zero ();
+        for (ordinal_type K = 0; K < len; ++K) {
+          const ordinal_type col = m_A.graph.entries(start + K) * bs;
+          for (ordinal_type j = 0; j < bs; ++j) {
+            sum += coeff (row[K * bs + j]) * m_x(col + j);
+          }
+        }
+        store (blockRow * bs + i, sum);
+      }
+    }
+  }
+
+  // GPU: a team handles rows_per_team block-rows, one thread per
+  // block-row and one vector lane per row of the block.
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev) const
+  {
+    const ordinal_type first = static_cast<ordinal_type> (dev.league_rank ()) * rows_per_team;
+    ordinal_type last = first + rows_per_team;
+    if (last > m_A.numRows ()) last = m_A.numRows ();
+
+    Kokkos::parallel_for (Kokkos::TeamThreadRange (dev, first, last), [&] (const ordinal_type& blockRow) {
+      const ordinal_type bs = (BS > 0) ? BS : m_A.blockDim ();
+      const size_type start = m_A.graph.row_map(blockRow);
+      const ordinal_type len = static_cast<ordinal_type> (m_A.graph.row_map(blockRow + 1) - start);
+      const value_type* vals = m_A.values.data () + start * bs * bs;
+
+      Kokkos::parallel_for (Kokkos::ThreadVectorRange (dev, bs), [&] (const ordinal_type& i) {
+        const value_type* row = vals + i * len * bs;
+        y_value_type sum = ATY::zero ();
+        for (ordinal_type K = 0; K < len; ++K) {
+          const ordinal_type col = m_A.graph.entries(start + K) * bs;
+          for (ordinal_type j = 0; j < bs; ++j) {
+            sum += coeff (row[K * bs + j]) * m_x(col + j);
+          }
+        }
+        store (blockRow * bs + i, sum);
+      });
+    });
+  }
+
+  // Transpose: scatter block-row contributions into y
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const BlockCrsTransposeTag&, const ordinal_type blockRow) const
+  {
+    const ordinal_type bs = (BS > 0) ? BS : m_A.blockDim ();
+    const size_type start = m_A.graph.row_map(blockRow);
+    const ordinal_type len = static_cast<ordinal_type> (m_A.graph.row_map(blockRow + 1) - start);
+    const value_type* vals = m_A.values.data () + start * bs * bs;
+    const ordinal_type stride = len * bs;
+
+    for (ordinal_type K = 0; K < len; ++K) {
+      const ordinal_type col = m_A.graph.entries(start + K) * bs;
+      const value_type* blk = vals + K * bs;
+      for (ordinal_type j = 0; j < bs; ++j) {
+        y_value_type sum = ATY::zero ();
+        for (ordinal_type i = 0; i < bs; ++i) {
+          sum += coeff (blk[i * stride + j]) * m_x(blockRow * bs + i);
+        }
+        Kokkos::atomic_add (&m_y(col + j), static_cast<y_value_type> (alpha * sum));
+      }
+    }
+  }
+};
+
+template<class AMatrix, class XVector, class YVector, int BS, bool conjugate>
+void spmv_blockcrs_launch (const char mode[],
+                           const typename YVector::non_const_value_type& alpha,
+                           const AMatrix& A,
+                           const XVector& x,
+                           const typename YVector::non_const_value_type& beta,
+                           const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef BlockCrs_SPMV_Functor<AMatrix, XVector, YVector, BS, conjugate> functor_type;
+
+  if ((mode[0] == 'T') || (mode[0] == 'H')) {
+    KokkosBlas::scal (y, beta, y);
+    functor_type func (alpha, A, x, beta, y);
+    Kokkos::parallel_for ("KokkosSparse::spmv<BlockCrs,Transpose>",
+                          Kokkos::RangePolicy<execution_space, BlockCrsTransposeTag> (0, A.numRows ()), func);
+    return;
+  }
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space> ()) {
+    // Match the vector length to the block size and fill the rest of a
+    // 256-thread team with block-rows.
+    int vector_length = 1;
+    while (vector_length < A.blockDim () && vector_length < 32) vector_length *= 2;
+    const int team_size = 256 / vector_length;
+    const ordinal_type rows_per_team = team_size;
+    const ordinal_type num_teams = (A.numRows () + rows_per_team - 1) / rows_per_team;
+    functor_type func (alpha, A, x, beta, y, rows_per_team);
+    Kokkos::parallel_for ("KokkosSparse::spmv<BlockCrs,NoTranspose>",
+                          Kokkos::TeamPolicy<execution_space> (num_teams, team_size, vector_length), func);
+  }
+  else {
+    functor_type func (alpha, A, x, beta, y);
+    Kokkos::parallel_for ("KokkosSparse::spmv<BlockCrs,NoTranspose>",
+                          Kokkos::RangePolicy<execution_space> (0, A.numRows ()), func);
+  }
+}
+
+template<int BS, class AMatrix, class XVector, class YVector>
+void spmv_blockcrs_bs (const char mode[],
+                       const typename YVector::non_const_value_type& alpha,
+                       const AMatrix& A,
+                       const XVector& x,
+                       const typename YVector::non_const_value_type& beta,
+                       const YVector& y)
+{
+  if ((mode[0] == 'C') || (mode[0] == 'H'))
+    spmv_blockcrs_launch<AMatrix, XVector, YVector, BS, true> (mode, alpha, A, x, beta, y);
+  else
+    spmv_blockcrs_launch<AMatrix, XVector, YVector, BS, false> (mode, alpha, A, x, beta, y);
+}
+
+/// \brief Rank-1 SpMV for a BlockCrsMatrix.  Block sizes 1 to 8 use
+///   kernels specialized on the block size; larger blocks use the
+///   runtime-sized kernel.
+template<class AMatrix, class XVector, class YVector>
+void spmv_blockcrs (const char mode[],
+                    const typename YVector::non_const_value_type& alpha,
+                    const AMatrix& A,
+                    const XVector& x,
+                    const typename YVector::non_const_value_type& beta,
+                    const YVector& y)
+{
+  if (A.numRows () <= 0) {
+    if ((mode[0] == 'T') || (mode[0] == 'H')) KokkosBlas::scal (y, beta, y);
+    return;
+  }
+
+  switch (A.blockDim ()) {
+  case 1: spmv_blockcrs_bs<1> (mode, alpha, A, x, beta, y); break;
+  case 2: spmv_blockcrs_bs<2> (mode, alpha, A, x, beta, y); break;
+  case 3: spmv_blockcrs_bs<3> (mode, alpha, A, x, beta, y); break;
+  case 4: spmv_blockcrs_bs<4> (mode, alpha, A, x, beta, y); break;
+  case 5: spmv_blockcrs_bs<5> (mode, alpha, A, x, beta, y); break;
+  case 6: spmv_blockcrs_bs<6> (mode, alpha, A, x, beta, y); break;
+  case 7: spmv_blockcrs_bs<7> (mode, alpha, A, x, beta, y); break;
+  case 8: spmv_blockcrs_bs<8> (mode, alpha, A, x, beta, y); break;
+  default: spmv_blockcrs_bs<0> (mode, alpha, A, x, beta, y); break;
+  }
+}
+
+template<class AMatrix, class XVector, class YVector>
+void spmv_blockcrs_mv (const char mode[],
+                       const typename YVector::non_const_value_type& alpha,
+                       const AMatrix& A,
+                       const XVector& x,
+                       const typename YVector::non_const_value_type& beta,
+                       const YVector& y,
+                       std::integral_constant<int, 1>)
+{
+  spmv_blockcrs (mode, alpha, A, x, beta, y);
+}
+
+/// \brief Rank-2 SpMV for a BlockCrsMatrix, one column at a time.
+template<class AMatrix, class XVector, class YVector>
+void spmv_blockcrs_mv (const char mode[],
+                       const typename YVector::non_const_value_type& alpha,
+                       const AMatrix& A,
+                       const XVector& x,
+                       const typename YVector::non_const_value_type& beta,
+                       const YVector& y,
+                       std::integral_constant<int, 2>)
+{
+  for (size_t j = 0; j < x.extent(1); ++j) {
+    auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
+    auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
+    spmv_blockcrs (mode, alpha, A, x_j, beta, y_j);
+  }
+}
+
+} // namespace Impl
+} // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_BLOCKCRS_HPP_
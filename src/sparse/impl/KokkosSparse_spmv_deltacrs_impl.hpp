@@ -0,0 +1,265 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_DELTACRS_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_DELTACRS_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosSparse_DeltaCrsMatrix.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+#include <type_traits>
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief y := beta*y + alpha*op(A)*x for a DeltaCrsMatrix A, with
+///   op(A) = A or conj(A).
+///
+/// Column indices are decoded on the fly as base + delta; the test
+/// for the escape path is made once per row, not per entry.
+template<class AMatrix, class XVector, class YVector, int dobeta, bool conjugate>
+struct SPMV_DeltaCrs_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_size_type        size_type;
+  typedef typename AMatrix::non_const_value_type       A_value_type;
+  typedef typename YVector::non_const_value_type       y_value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<A_value_type>   ATV;
+  typedef Kokkos::Details::ArithTraits<y_value_type>   ATY;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+  const ordinal_type rows_per_team;
+
+  SPMV_DeltaCrs_Functor (const y_value_type alpha_,
+                         const AMatrix& m_A_,
+                         const XVector& m_x_,
+                         const y_value_type beta_,
+                         const YVector& m_y_,
+                         const ordinal_type rows_per_team_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_), beta (beta_), m_y (m_y_),
+    rows_per_team (rows_per_team_)
+  {}
+
+  KOKKOS_INLINE_FUNCTION
+  A_value_type value (const size_type k) const
+  {
+    return conjugate ? ATV::conj (m_A.values(k)) : m_A.values(k);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void update_y (const ordinal_type iRow, const y_value_type sum) const
+  {
+    if (dobeta == 0)
+      m_y(iRow) = alpha * sum;
+    else
+      m_y(iRow) = beta * m_y(iRow) + alpha * sum;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type iRow) const
+  {
+    const ordinal_type block = iRow / m_A.blockRows ();
+    const size_type k0 = m_A.row_map(iRow);
+    const size_type k1 = m_A.row_map(iRow + 1);
+    const size_type shift = k0 - m_A.row_map(block * m_A.blockRows ());
+    y_value_type sum = ATY::zero ();
+
+    if (m_A.isWideBlock (block)) {
+      const size_type off = m_A.wide_ptr(block) + shift;
+      for (size_type k = k0; k < k1; ++k) {
+        sum += static_cast<y_value_type> (value (k)) * m_x(m_A.wide_entries(off + (k - k0)));
+      }
+    }
+    else {
+      const ordinal_type base = m_A.block_base(block);
+      const size_type off = m_A.delta_ptr(block) + shift;
+      for (size_type k = k0; k < k1; ++k) {
+        sum += static_cast<y_value_type> (value (k)) *
+               m_x(base + static_cast<ordinal_type> (m_A.deltas(off + (k - k0))));
+      }
+    }
+    update_y (iRow, sum);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev) const
+  {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(dev,0,rows_per_team), [&] (const ordinal_type& loop) {
+      const ordinal_type iRow = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+      if (iRow >= m_A.numRows ()) {
+        return;
+      }
+      const ordinal_type block = iRow / m_A.blockRows ();
+      const size_type k0 = m_A.row_map(iRow);
+      const ordinal_type row_length = static_cast<ordinal_type> (m_A.row_map(iRow + 1) - k0);
+      const size_type shift = k0 - m_A.row_map(block * m_A.blockRows ());
+      const bool wide = m_A.isWideBlock (block);
+      const ordinal_type base = m_A.block_base(block);
+      const size_type off = (wide ? m_A.wide_ptr(block) : m_A.delta_ptr(block)) + shift;
+      y_value_type sum = ATY::zero ();
+
+      Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(dev,row_length), [&] (const ordinal_type& iEntry, y_value_type& lsum) {
+        const ordinal_type col = wide ? m_A.wide_entries(off + iEntry) :
+                                        base + static_cast<ordinal_type> (m_A.deltas(off + iEntry));
+        lsum += static_cast<y_value_type> (value (k0 + iEntry)) * m_x(col);
+      },sum);
+
+      Kokkos::single(Kokkos::PerThread(dev), [&] () {
+        update_y (iRow, sum);
+      });
+    });
+  }
+};
+
+template<class AMatrix, class XVector, class YVector, int dobeta, bool conjugate>
+void spmv_deltacrs_launch (const KokkosKernels::Experimental::Controls& controls,
+                           const typename YVector::non_const_value_type& alpha,
+                           const AMatrix& A,
+                           const XVector& x,
+                           const typename YVector::non_const_value_type& beta,
+                           const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef SPMV_DeltaCrs_Functor<AMatrix, XVector, YVector, dobeta, conjugate> functor_type;
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+    int team_size = -1;
+    int vector_length = -1;
+    int64_t rows_per_thread = -1;
+    if(controls.isParameter("team size"))       {team_size       = std::stoi(controls.getParameter("team size"));}
+    if(controls.isParameter("vector length"))   {vector_length   = std::stoi(controls.getParameter("vector length"));}
+    if(controls.isParameter("rows per thread")) {rows_per_thread = std::stoll(controls.getParameter("rows per thread"));}
+
+    int64_t rows_per_team = spmv_launch_parameters<execution_space>(A.numRows(),A.nnz(),rows_per_thread,team_size,vector_length);
+    int64_t worksets = (A.numRows()+rows_per_team-1)/rows_per_team;
+
+    functor_type func (alpha,A,x,beta,y,rows_per_team);
+    Kokkos::TeamPolicy<execution_space> policy(1,1);
+    if(team_size<0)
+      policy = Kokkos::TeamPolicy<execution_space>(worksets,Kokkos::AUTO,vector_length);
+    else
+      policy = Kokkos::TeamPolicy<execution_space>(worksets,team_size,vector_length);
+    Kokkos::parallel_for("KokkosSparse::spmv<DeltaCrs>",policy,func);
+  }
+  else {
+    functor_type func (alpha,A,x,beta,y,1);
+    Kokkos::parallel_for("KokkosSparse::spmv<DeltaCrs>",
+                         Kokkos::RangePolicy<execution_space>(0, A.numRows()),func);
+  }
+}
+
+/// \brief Rank-1 SpMV, mode "N" or "C", for a DeltaCrsMatrix.
+template<class AMatrix, class XVector, class YVector>
+void spmv_deltacrs (const KokkosKernels::Experimental::Controls& controls,
+                    const bool conjugate,
+                    const typename YVector::non_const_value_type& alpha,
+                    const AMatrix& A,
+                    const XVector& x,
+                    const typename YVector::non_const_value_type& beta,
+                    const YVector& y)
+{
+  typedef Kokkos::Details::ArithTraits<typename YVector::non_const_value_type> KAT;
+
+  if (A.numRows () <= 0) {
+    return;
+  }
+
+  if (beta == KAT::zero ()) {
+    if (conjugate)
+      spmv_deltacrs_launch<AMatrix, XVector, YVector, 0, true> (controls, alpha, A, x, beta, y);
+    else
+      spmv_deltacrs_launch<AMatrix, XVector, YVector, 0, false> (controls, alpha, A, x, beta, y);
+  }
+  else {
+    if (conjugate)
+      spmv_deltacrs_launch<AMatrix, XVector, YVector, 2, true> (controls, alpha, A, x, beta, y);
+    else
+      spmv_deltacrs_launch<AMatrix, XVector, YVector, 2, false> (controls, alpha, A, x, beta, y);
+  }
+}
+
+template<class AMatrix, class XVector, class YVector>
+void spmv_deltacrs_mv (const KokkosKernels::Experimental::Controls& controls,
+                       const bool conjugate,
+                       const typename YVector::non_const_value_type& alpha,
+                       const AMatrix& A,
+                       const XVector& x,
+                       const typename YVector::non_const_value_type& beta,
+                       const YVector& y,
+                       std::integral_constant<int, 1>)
+{
+  spmv_deltacrs (controls, conjugate, alpha, A, x, beta, y);
+}
+
+/// \brief Rank-2 SpMV for a DeltaCrsMatrix, one column at a time.
+template<class AMatrix, class XVector, class YVector>
+void spmv_deltacrs_mv (const KokkosKernels::Experimental::Controls& controls,
+                       const bool conjugate,
+                       const typename YVector::non_const_value_type& alpha,
+                       const AMatrix& A,
+                       const XVector& x,
+                       const typename YVector::non_const_value_type& beta,
+                       const YVector& y,
+                       std::integral_constant<int, 2>)
+{
+  for (size_t j = 0; j < x.extent(1); ++j) {
+    auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
+    auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
+    spmv_deltacrs (controls, conjugate, alpha, A, x_j, beta, y_j);
+  }
+}
+
+} // namespace Impl
+} // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_DELTACRS_HPP_
@@ -0,0 +1,254 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_DOT_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_DOT_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief y := beta*y + alpha*A*x, and reduce either <x,y> or <y,y>
+///   over the freshly written entries of y.
+///
+/// The reduction reads y(iRow) from registers right after it is
+/// computed, so the caller does not need a second pass over y.
+/// <x,y> is taken over the first numRows() entries of x, which is
+/// what a Krylov solver wants when x holds owned entries followed by
+/// ghosts.
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate,
+         bool dotWithX>
+struct SPMV_Dot_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_value_type       A_value_type;
+  typedef typename YVector::non_const_value_type       y_value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<A_value_type>   ATV;
+  typedef Kokkos::Details::ArithTraits<y_value_type>   ATY;
+  typedef y_value_type                                 value_type;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+
+  const ordinal_type rows_per_team;
+
+  SPMV_Dot_Functor (const y_value_type alpha_,
+                    const AMatrix m_A_,
+                    const XVector m_x_,
+                    const y_value_type beta_,
+                    const YVector m_y_,
+                    const int rows_per_team_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_),
+    beta (beta_), m_y (m_y_),
+    rows_per_team (rows_per_team_)
+  {
+    static_assert (static_cast<int> (XVector::rank) == 1,
+                   "XVector must be a rank 1 View.");
+    static_assert (static_cast<int> (YVector::rank) == 1,
+                   "YVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  y_value_type update_y (const ordinal_type iRow, const y_value_type sum) const
+  {
+    const y_value_type y_new = (dobeta == 0) ? alpha * sum : beta * m_y(iRow) + alpha * sum;
+    m_y(iRow) = y_new;
+    return y_new;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  y_value_type dot_term (const ordinal_type iRow, const y_value_type y_new) const
+  {
+    return dotWithX ? ATY::conj (static_cast<y_value_type> (m_x(iRow))) * y_new :
+                      ATY::conj (y_new) * y_new;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type iRow, y_value_type& dot) const
+  {
+    const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+    const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+    y_value_type sum = ATY::zero ();
+
+    for (ordinal_type iEntry = 0; iEntry < row_length; iEntry++) {
+      const A_value_type val = conjugate ?
+        ATV::conj (row.value(iEntry)) :
+        row.value(iEntry);
+      sum += static_cast<y_value_type> (val) * m_x(row.colidx(iEntry));
+    }
+
+    dot += dot_term (iRow, update_y (iRow, sum));
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev, y_value_type& dot) const
+  {
+    y_value_type team_dot = ATY::zero ();
+
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(dev,0,rows_per_team), [&] (const ordinal_type& loop, y_value_type& tdot) {
+      const ordinal_type iRow = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+      if (iRow >= m_A.numRows ()) {
+        return;
+      }
+      const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+      const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+      y_value_type sum = ATY::zero ();
+
+      Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(dev,row_length), [&] (const ordinal_type& iEntry, y_value_type& lsum) {
+        const A_value_type val = conjugate ?
+          ATV::conj (row.value(iEntry)) :
+          row.value(iEntry);
+        lsum += static_cast<y_value_type> (val) * m_x(row.colidx(iEntry));
+      },sum);
+
+      // One lane writes y; the new value is broadcast to all lanes so
+      // that every lane contributes the same term to the team sum.
+      y_value_type y_new;
+      Kokkos::single(Kokkos::PerThread(dev), [&] (y_value_type& y_row) {
+        y_row = update_y (iRow, sum);
+      }, y_new);
+
+      tdot += dot_term (iRow, y_new);
+    }, team_dot);
+
+    Kokkos::single(Kokkos::PerTeam(dev), [&] () {
+      dot += team_dot;
+    });
+  }
+};
+
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate,
+         bool dotWithX>
+typename YVector::non_const_value_type
+spmv_dot_no_transpose (const KokkosKernels::Experimental::Controls& controls,
+                       typename YVector::const_value_type& alpha,
+                       const AMatrix& A,
+                       const XVector& x,
+                       typename YVector::const_value_type& beta,
+                       const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef SPMV_Dot_Functor<AMatrix,XVector,YVector,dobeta,conjugate,dotWithX> functor_type;
+
+  y_value_type dot = Kokkos::Details::ArithTraits<y_value_type>::zero ();
+  if (A.numRows () <= 0) {
+    return dot;
+  }
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+    int team_size = -1;
+    int vector_length = -1;
+    int64_t rows_per_thread = -1;
+    if(controls.isParameter("team size"))       {team_size       = std::stoi(controls.getParameter("team size"));}
+    if(controls.isParameter("vector length"))   {vector_length   = std::stoi(controls.getParameter("vector length"));}
+    if(controls.isParameter("rows per thread")) {rows_per_thread = std::stoll(controls.getParameter("rows per thread"));}
+
+    int64_t rows_per_team = spmv_launch_parameters<execution_space>(A.numRows(),A.nnz(),rows_per_thread,team_size,vector_length);
+    int64_t worksets = (A.numRows()+rows_per_team-1)/rows_per_team;
+
+    functor_type func (alpha,A,x,beta,y,rows_per_team);
+    Kokkos::TeamPolicy<execution_space> policy(1,1);
+    if(team_size<0)
+      policy = Kokkos::TeamPolicy<execution_space>(worksets,Kokkos::AUTO,vector_length);
+    else
+      policy = Kokkos::TeamPolicy<execution_space>(worksets,team_size,vector_length);
+    Kokkos::parallel_reduce("KokkosSparse::spmv_dot<NoTranspose>",policy,func,dot);
+  }
+  else {
+    functor_type func (alpha,A,x,beta,y,1);
+    Kokkos::parallel_reduce("KokkosSparse::spmv_dot<NoTranspose>",
+                            Kokkos::RangePolicy<execution_space>(0, A.numRows()),func,dot);
+  }
+  return dot;
+}
+
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         bool dotWithX>
+typename YVector::non_const_value_type
+spmv_dot (const KokkosKernels::Experimental::Controls& controls,
+          const bool conjugate,
+          typename YVector::const_value_type& alpha,
+          const AMatrix& A,
+          const XVector& x,
+          typename YVector::const_value_type& beta,
+          const YVector& y)
+{
+  typedef Kokkos::Details::ArithTraits<typename YVector::non_const_value_type> KAT;
+
+  if (beta == KAT::zero ()) {
+    return conjugate ?
+      spmv_dot_no_transpose<AMatrix,XVector,YVector,0,true,dotWithX> (controls,alpha,A,x,beta,y) :
+      spmv_dot_no_transpose<AMatrix,XVector,YVector,0,false,dotWithX> (controls,alpha,A,x,beta,y);
+  }
+  return conjugate ?
+    spmv_dot_no_transpose<AMatrix,XVector,YVector,2,true,dotWithX> (controls,alpha,A,x,beta,y) :
+    spmv_dot_no_transpose<AMatrix,XVector,YVector,2,false,dotWithX> (controls,alpha,A,x,beta,y);
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_DOT_HPP_
@@ -51,6 +51,7 @@
 #include "KokkosKernels_ExecSpaceUtils.hpp"
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "KokkosSparse_spmv_impl_omp.hpp"
+#include "KokkosSparse_spmv_impl_merge.hpp"
 
 namespace KokkosSparse {
 namespace Impl {
@@ -116,7 +117,7 @@ struct SPMV_Transpose_Functor {
         ATV::conj (row.value(iEntry)) :
         row.value(iEntry);
       const ordinal_type ind = row.colidx(iEntry);
-      Kokkos::atomic_add (&m_y(ind), static_cast<y_value_type> (alpha * val * m_x(iRow)));
+      Kokkos::atomic_add (&m_y(ind), static_cast<y_value_type> (alpha * static_cast<y_value_type> (val) * m_x(iRow)));
     }
   }
 
@@ -143,7 +144,7 @@ struct SPMV_Transpose_Functor {
           ATV::conj (row.value(iEntry)) :
           row.value(iEntry);
         const ordinal_type ind = row.colidx(iEntry);
-        Kokkos::atomic_add (&m_y(ind), static_cast<y_value_type> (alpha * val * m_x(iRow)));
+        Kokkos::atomic_add (&m_y(ind), static_cast<y_value_type> (alpha * static_cast<y_value_type> (val) * m_x(iRow)));
       });
     });
   }
@@ -161,19 +162,20 @@ struct SPMV_Functor {
   typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
   typedef typename team_policy::member_type            team_member;
   typedef Kokkos::Details::ArithTraits<value_type>     ATV;
+  typedef typename YVector::non_const_value_type       coefficient_type;
 
-  const value_type alpha;
+  const coefficient_type alpha;
   AMatrix  m_A;
   XVector m_x;
-  const value_type beta;
+  const coefficient_type beta;
   YVector m_y;
 
   const ordinal_type rows_per_team;
 
-  SPMV_Functor (const value_type alpha_,
+  SPMV_Functor (const coefficient_type alpha_,
                 const AMatrix m_A_,
                 const XVector m_x_,
-                const value_type beta_,
+                const coefficient_type beta_,
                 const YVector m_y_,
                 const int rows_per_team_) :
      alpha (alpha_), m_A (m_A_), m_x (m_x_),
@@ -202,7 +204,7 @@ struct SPMV_Functor {
       const value_type val = conjugate ?
               ATV::conj (row.value(iEntry)) :
               row.value(iEntry);
-      sum += val * m_x(row.colidx(iEntry));
+      sum += static_cast<y_value_type> (val) * m_x(row.colidx(iEntry));
     }
 
     sum *= alpha;
@@ -233,7 +235,7 @@ struct SPMV_Functor {
         const value_type val = conjugate ?
                 ATV::conj (row.value(iEntry)) :
                 row.value(iEntry);
-        lsum += val * m_x(row.colidx(iEntry));
+        lsum += static_cast<y_value_type> (val) * m_x(row.colidx(iEntry));
       },sum);
 
       Kokkos::single(Kokkos::PerThread(dev), [&] () {
@@ -324,10 +326,18 @@ spmv_beta_no_transpose (const KokkosKernels::Experimental::Controls& controls,
   if (A.numRows () <= static_cast<ordinal_type> (0)) {
     return;
   }
+
+  // Load-balanced merge-path algorithm, requested through the controls
+  if (spmv_use_merge_path(controls)) {
+    spmv_merge_no_transpose<AMatrix,XVector,YVector,dobeta,conjugate>
+      (controls,alpha,A,x,beta,y);
+    return;
+  }
 #if defined(KOKKOS_ENABLE_SERIAL) 
   if(std::is_same<execution_space,Kokkos::Serial>::value) {
     /// serial impl                                                                                         
     typedef typename AMatrix::non_const_value_type value_type;
+    typedef typename YVector::non_const_value_type y_value_type;
     typedef typename AMatrix::non_const_size_type size_type;
 
     const size_type *__restrict__ row_map_ptr = A.graph.row_map.data();
@@ -361,10 +371,10 @@ spmv_beta_no_transpose (const KokkosKernels::Experimental::Controls& controls,
 	  const int jdist = (jend-jbeg)/4;
 	  typename YVector::non_const_value_type tmp1(0), tmp2(0), tmp3(0), tmp4(0);
 	  for (int jj=0;jj<jdist;++jj) {
-	    const value_type value1 = values_ptr[j];
-	    const value_type value2 = values_ptr[j+1];
-	    const value_type value3 = values_ptr[j+2];
-	    const value_type value4 = values_ptr[j+3];
+	    const y_value_type value1 = static_cast<y_value_type> (values_ptr[j]);
+	    const y_value_type value2 = static_cast<y_value_type> (values_ptr[j+1]);
+	    const y_value_type value3 = static_cast<y_value_type> (values_ptr[j+2]);
+	    const y_value_type value4 = static_cast<y_value_type> (values_ptr[j+3]);
 	    const int col_idx1 = col_idx_ptr[j];
 	    const int col_idx2 = col_idx_ptr[j+1];
 	    const int col_idx3 = col_idx_ptr[j+2];
@@ -380,7 +390,7 @@ spmv_beta_no_transpose (const KokkosKernels::Experimental::Controls& controls,
 	    j += 4;
 	  }
 	  for (;j<jend;++j) {
-	    const value_type value = values_ptr[j];
+	    const y_value_type value = static_cast<y_value_type> (values_ptr[j]);
 	    const int col_idx = col_idx_ptr[j];
 	    tmp1 += value*x_ptr[col_idx];
 	  }
@@ -512,6 +522,7 @@ spmv_beta_transpose (typename YVector::const_value_type& alpha,
       /// serial impl                                                                                         
       typedef typename AMatrix::non_const_value_type value_type;
       typedef Kokkos::Details::ArithTraits<value_type> ATV;
+      typedef typename YVector::non_const_value_type y_value_type;
       const size_type *__restrict__ row_map_ptr = A.graph.row_map.data();
       const ordinal_type *__restrict__ col_idx_ptr = A.graph.entries.data();
       const value_type *__restrict__ values_ptr = A.values.data();
@@ -532,10 +543,10 @@ spmv_beta_transpose (typename YVector::const_value_type& alpha,
           const typename XVector::const_value_type x_val = alpha*x_ptr[i];
           int j = jbeg;
           for (int jj=0;jj<jdist;++jj) {
-            const value_type value1 = conjugate ? ATV::conj(values_ptr[j]) : values_ptr[j];
-            const value_type value2 = conjugate ? ATV::conj(values_ptr[j+1]) : values_ptr[j+1];
-            const value_type value3 = conjugate ? ATV::conj(values_ptr[j+2]) : values_ptr[j+2];
-            const value_type value4 = conjugate ? ATV::conj(values_ptr[j+3]) : values_ptr[j+3];
+            const y_value_type value1 = static_cast<y_value_type> (conjugate ? ATV::conj(values_ptr[j]) : values_ptr[j]);
+            const y_value_type value2 = static_cast<y_value_type> (conjugate ? ATV::conj(values_ptr[j+1]) : values_ptr[j+1]);
+            const y_value_type value3 = static_cast<y_value_type> (conjugate ? ATV::conj(values_ptr[j+2]) : values_ptr[j+2]);
+            const y_value_type value4 = static_cast<y_value_type> (conjugate ? ATV::conj(values_ptr[j+3]) : values_ptr[j+3]);
             const int col_idx1 = col_idx_ptr[j];
             const int col_idx2 = col_idx_ptr[j+1];
             const int col_idx3 = col_idx_ptr[j+2];
@@ -547,7 +558,7 @@ spmv_beta_transpose (typename YVector::const_value_type& alpha,
             j += 4;
           }
           for (;j<jend;++j) {
-            const value_type value = conjugate ? ATV::conj(values_ptr[j]) : values_ptr[j];
+            const y_value_type value = static_cast<y_value_type> (conjugate ? ATV::conj(values_ptr[j]) : values_ptr[j]);
             const int col_idx = col_idx_ptr[j];
             y_ptr[col_idx] += value*x_val;
           }
@@ -692,7 +703,7 @@ struct SPMV_MV_Transpose_Functor {
         #endif
         for (ordinal_type k = 0; k < n; ++k) {
           Kokkos::atomic_add (&m_y(ind,k),
-                              static_cast<y_value_type> (alpha * val * m_x(iRow, k)));
+                              static_cast<y_value_type> (alpha * static_cast<y_value_type> (val) * m_x(iRow, k)));
         }
       } else {
         #ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
@@ -700,7 +711,7 @@ struct SPMV_MV_Transpose_Functor {
         #endif
         for (ordinal_type k = 0; k < n; ++k) {
           Kokkos::atomic_add (&m_y(ind,k),
-                              static_cast<y_value_type> (val * m_x(iRow, k)));
+                              static_cast<y_value_type> (static_cast<y_value_type> (val) * m_x(iRow, k)));
         }
       }
     }
@@ -737,7 +748,7 @@ struct SPMV_MV_Transpose_Functor {
           #endif
           for (ordinal_type k = 0; k < n; ++k) {
             Kokkos::atomic_add (&m_y(ind,k),
-                                static_cast<y_value_type> (alpha * val * m_x(iRow, k)));
+                                static_cast<y_value_type> (alpha * static_cast<y_value_type> (val) * m_x(iRow, k)));
           }
         } else {
           #ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
@@ -745,7 +756,7 @@ struct SPMV_MV_Transpose_Functor {
           #endif
           for (ordinal_type k = 0; k < n; ++k) {
             Kokkos::atomic_add (&m_y(ind,k),
-                                static_cast<y_value_type> (val * m_x(iRow, k)));
+                                static_cast<y_value_type> (static_cast<y_value_type> (val) * m_x(iRow, k)));
           }
         }
       });
@@ -824,7 +835,7 @@ struct SPMV_MV_LayoutLeft_Functor {
 #pragma unroll
 #endif
       for (int k = 0; k < UNROLL; ++k) {
-        sum[k] += val * m_x(ind, kk + k);
+        sum[k] += static_cast<y_value_type> (val) * m_x(ind, kk + k);
       }
     });
 
@@ -918,11 +929,11 @@ struct SPMV_MV_LayoutLeft_Functor {
 #endif
       for (int k = 0; k < UNROLL; ++k) {
         if(doalpha == 1)
-          sum[k] += val * m_x(ind, kk + k);
+          sum[k] += static_cast<y_value_type> (val) * m_x(ind, kk + k);
         else if(doalpha == -1)
-          sum[k] -= val * m_x(ind, kk + k);
+          sum[k] -= static_cast<y_value_type> (val) * m_x(ind, kk + k);
         else
-          sum[k] += alpha * val * m_x(ind, kk + k);
+          sum[k] += alpha * static_cast<y_value_type> (val) * m_x(ind, kk + k);
       }
     }
 
@@ -958,7 +969,7 @@ struct SPMV_MV_LayoutLeft_Functor {
       const A_value_type val = conjugate ?
           Kokkos::Details::ArithTraits<A_value_type>::conj (row.value(iEntry)) :
           row.value(iEntry);
-      lsum += val * m_x(row.colidx(iEntry),0);
+      lsum += static_cast<y_value_type> (val) * m_x(row.colidx(iEntry),0);
     }, sum);
     Kokkos::single(Kokkos::PerThread(dev),
     [&]()
@@ -997,7 +1008,7 @@ struct SPMV_MV_LayoutLeft_Functor {
       const A_value_type val = conjugate ?
           Kokkos::Details::ArithTraits<A_value_type>::conj (row.value(iEntry)) :
           row.value(iEntry);
-      sum += val * m_x(row.colidx(iEntry),0);
+      sum += static_cast<y_value_type> (val) * m_x(row.colidx(iEntry),0);
     }
     if (doalpha == -1) {
       sum = -sum;
@@ -1238,7 +1249,8 @@ template<class AMatrix,
          int dobeta,
          bool conjugate>
 static void
-spmv_alpha_beta_mv_no_transpose (const typename YVector::non_const_value_type& alpha,
+spmv_alpha_beta_mv_no_transpose (const KokkosKernels::Experimental::Controls& controls,
+                                 const typename YVector::non_const_value_type& alpha,
                                  const AMatrix& A,
                                  const XVector& x,
                                  const typename YVector::non_const_value_type& beta,
@@ -1256,6 +1268,10 @@ spmv_alpha_beta_mv_no_transpose (const typename YVector::non_const_value_type& a
     }
     return;
   }
+  else if (spmv_use_merge_path(controls)) {
+    spmv_merge_mv_no_transpose<AMatrix, XVector, YVector, dobeta, conjugate> (controls, alpha, A, x, beta, y);
+    return;
+  }
   else {
 
     // Assuming that no row contains duplicate entries, NNZPerRow
@@ -1409,7 +1425,8 @@ template<class AMatrix,
          int doalpha,
          int dobeta>
 static void
-spmv_alpha_beta_mv (const char mode[],
+spmv_alpha_beta_mv (const KokkosKernels::Experimental::Controls& controls,
+                    const char mode[],
                     const typename YVector::non_const_value_type& alpha,
                     const AMatrix& A,
                     const XVector& x,
@@ -1417,10 +1434,10 @@ spmv_alpha_beta_mv (const char mode[],
                     const YVector& y)
 {
   if (mode[0] == NoTranspose[0]) {
-    spmv_alpha_beta_mv_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, false> (alpha, A, x, beta, y);
+    spmv_alpha_beta_mv_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, false> (controls, alpha, A, x, beta, y);
   }
   else if (mode[0] == Conjugate[0]) {
-    spmv_alpha_beta_mv_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, true> (alpha, A, x, beta, y);
+    spmv_alpha_beta_mv_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, true> (controls, alpha, A, x, beta, y);
   }
   else if (mode[0] == Transpose[0]) {
     spmv_alpha_beta_mv_transpose<AMatrix, XVector, YVector, doalpha, dobeta, false> (alpha, A, x, beta, y);
@@ -1438,7 +1455,8 @@ template<class AMatrix,
          class YVector,
          int doalpha>
 void
-spmv_alpha_mv (const char mode[],
+spmv_alpha_mv (const KokkosKernels::Experimental::Controls& controls,
+               const char mode[],
                const typename YVector::non_const_value_type& alpha,
                const AMatrix& A,
                const XVector& x,
@@ -1449,16 +1467,16 @@ spmv_alpha_mv (const char mode[],
   typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
 
   if (beta == KAT::zero ()) {
-    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, 0> (mode, alpha, A, x, beta, y);
+    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, 0> (controls, mode, alpha, A, x, beta, y);
   }
   else if (beta == KAT::one ()) {
-    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, 1> (mode, alpha, A, x, beta, y);
+    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, 1> (controls, mode, alpha, A, x, beta, y);
   }
   else if (beta == -KAT::one ()) {
-    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, -1> (mode, alpha, A, x, beta, y);
+    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, -1> (controls, mode, alpha, A, x, beta, y);
   }
   else {
-    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, 2> (mode, alpha, A, x, beta, y);
+    spmv_alpha_beta_mv<AMatrix, XVector, YVector, doalpha, 2> (controls, mode, alpha, A, x, beta, y);
   }
 }
 
@@ -0,0 +1,398 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_MERGE_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_MERGE_HPP_
+
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief Merge-path search over the rows and nonzeros of a CrsMatrix.
+///
+/// The merge path is the merge of the row end offsets (row_map(1:n))
+/// with the natural numbers 0..nnz-1.  Each step of the path either
+/// consumes one nonzero or closes one row, so splitting the
+/// (numRows + nnz) steps evenly gives every thread the same amount
+/// of work regardless of the row length distribution.  Given a
+/// diagonal of the merge grid, return the row and nonzero coordinates
+/// where the path crosses it.
+template<class RowMapType, class OrdinalType, class SizeType>
+KOKKOS_INLINE_FUNCTION void
+merge_path_search (const RowMapType& row_map,
+                   const OrdinalType numRows,
+                   const SizeType nnz,
+                   const SizeType diagonal,
+                   OrdinalType& row,
+                   SizeType& nz)
+{
+  SizeType lo = (diagonal > nnz) ? diagonal - nnz : SizeType(0);
+  SizeType hi = (diagonal < static_cast<SizeType> (numRows)) ? diagonal : static_cast<SizeType> (numRows);
+  while (lo < hi) {
+    const SizeType pivot = (lo + hi) / 2;
+    if (static_cast<SizeType> (row_map(pivot + 1)) <= diagonal - pivot - 1) {
+      lo = pivot + 1;
+    } else {
+      hi = pivot;
+    }
+  }
+  row = static_cast<OrdinalType> (lo);
+  nz  = diagonal - lo;
+}
+
+/// \brief Number of merge-path steps assigned to each partition.
+///
+/// On host every thread gets one contiguous piece of the path; on GPUs
+/// each thread walks a short segment.  The user can override the
+/// default with the "merge items per thread" control.
+template<class execution_space, class SizeType>
+SizeType spmv_merge_items_per_partition (const KokkosKernels::Experimental::Controls& controls,
+                                         const SizeType total_work)
+{
+  SizeType items = 0;
+  if(controls.isParameter("merge items per thread")) {
+    items = static_cast<SizeType> (std::stoll(controls.getParameter("merge items per thread")));
+  }
+  if(items < 1) {
+    if(KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+      items = 8;
+    } else {
+      const SizeType conc = static_cast<SizeType> (execution_space::concurrency());
+      items = (total_work + conc - 1) / conc;
+    }
+  }
+  if(items < 1) items = 1;
+  return items;
+}
+
+struct MergePathFixupTag {};
+
+// Merge-path SpMV for single vectors.  The first pass computes every
+// row that ends inside a partition and records the partial sum of the
+// (at most one) row that is still open when the partition ends.  The
+// second pass adds those carry-out values into y.
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate>
+struct SPMV_MergePath_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_size_type        size_type;
+  typedef typename AMatrix::non_const_value_type       value_type;
+  typedef typename YVector::non_const_value_type       y_value_type;
+  typedef Kokkos::Details::ArithTraits<value_type>     ATV;
+  typedef Kokkos::View<ordinal_type*, typename AMatrix::device_type> carry_row_view;
+  typedef Kokkos::View<y_value_type*, typename AMatrix::device_type> carry_value_view;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+
+  const size_type items_per_partition;
+  carry_row_view   carry_row;
+  carry_value_view carry_val;
+
+  SPMV_MergePath_Functor (const y_value_type alpha_,
+                          const AMatrix m_A_,
+                          const XVector m_x_,
+                          const y_value_type beta_,
+                          const YVector m_y_,
+                          const size_type items_per_partition_,
+                          const carry_row_view carry_row_,
+                          const carry_value_view carry_val_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_), beta (beta_), m_y (m_y_),
+    items_per_partition (items_per_partition_),
+    carry_row (carry_row_), carry_val (carry_val_)
+  {
+    static_assert (static_cast<int> (XVector::rank) == 1,
+                   "XVector must be a rank 1 View.");
+    static_assert (static_cast<int> (YVector::rank) == 1,
+                   "YVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const size_type partition) const
+  {
+    const ordinal_type numRows = m_A.numRows ();
+    const size_type nnz = m_A.nnz ();
+    const size_type total = static_cast<size_type> (numRows) + nnz;
+
+    size_type d_begin = partition * items_per_partition;
+    size_type d_end   = d_begin + items_per_partition;
+    if (d_begin > total) d_begin = total;
+    if (d_end   > total) d_end   = total;
+
+    ordinal_type row, row_end;
+    size_type nz, nz_end;
+    merge_path_search (m_A.graph.row_map, numRows, nnz, d_begin, row, nz);
+    merge_path_search (m_A.graph.row_map, numRows, nnz, d_end, row_end, nz_end);
+
+    y_value_type sum = Kokkos::Details::ArithTraits<y_value_type>::zero ();
+    for (; row < row_end; ++row) {
+      const size_type row_stop = m_A.graph.row_map(row + 1);
+      for (; nz < row_stop; ++nz) {
+        const value_type val = conjugate ? ATV::conj (m_A.values(nz)) : m_A.values(nz);
+        sum += static_cast<y_value_type> (val) * m_x(m_A.graph.entries(nz));
+      }
+      if (dobeta == 0) {
+        m_y(row) = alpha * sum;
+      } else {
+        m_y(row) = beta * m_y(row) + alpha * sum;
+      }
+      sum = Kokkos::Details::ArithTraits<y_value_type>::zero ();
+    }
+    // Partial sum of the row that continues into the next partition
+    for (; nz < nz_end; ++nz) {
+      const value_type val = conjugate ? ATV::conj (m_A.values(nz)) : m_A.values(nz);
+      sum += static_cast<y_value_type> (val) * m_x(m_A.graph.entries(nz));
+    }
+    carry_row(partition) = row_end;
+    carry_val(partition) = sum;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const MergePathFixupTag&, const size_type partition) const
+  {
+    const ordinal_type row = carry_row(partition);
+    if (row < m_A.numRows ()) {
+      Kokkos::atomic_add (&m_y(row), static_cast<y_value_type> (alpha * carry_val(partition)));
+    }
+  }
+};
+
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate>
+static void
+spmv_merge_no_transpose (const KokkosKernels::Experimental::Controls& controls,
+                         typename YVector::const_value_type& alpha,
+                         const AMatrix& A,
+                         const XVector& x,
+                         typename YVector::const_value_type& beta,
+                         const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef SPMV_MergePath_Functor<AMatrix,XVector,YVector,dobeta,conjugate> functor_type;
+
+  const size_type total = static_cast<size_type> (A.numRows ()) + A.nnz ();
+  const size_type items = spmv_merge_items_per_partition<execution_space, size_type> (controls, total);
+  const size_type num_partitions = (total + items - 1) / items;
+
+  typename functor_type::carry_row_view   carry_row (Kokkos::ViewAllocateWithoutInitializing ("SpMV merge carry row"), num_partitions);
+  typename functor_type::carry_value_view carry_val (Kokkos::ViewAllocateWithoutInitializing ("SpMV merge carry value"), num_partitions);
+
+  functor_type func (alpha, A, x, beta, y, items, carry_row, carry_val);
+  Kokkos::parallel_for ("KokkosSparse::spmv<NoTranspose,Merge>",
+                        Kokkos::RangePolicy<execution_space> (0, num_partitions), func);
+  Kokkos::parallel_for ("KokkosSparse::spmv<NoTranspose,MergeFixup>",
+                        Kokkos::RangePolicy<execution_space, MergePathFixupTag> (0, num_partitions), func);
+}
+
+// Merge-path SpMV for multivectors.  Each partition searches the path
+// once and then walks its segment for strips of up to four columns,
+// so the row/nonzero split is shared by all the columns of x and y.
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate>
+struct SPMV_MV_MergePath_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_size_type        size_type;
+  typedef typename AMatrix::non_const_value_type       value_type;
+  typedef typename YVector::non_const_value_type       y_value_type;
+  typedef Kokkos::Details::ArithTraits<value_type>     ATV;
+  typedef Kokkos::View<ordinal_type*, typename AMatrix::device_type> carry_row_view;
+  typedef Kokkos::View<y_value_type**, Kokkos::LayoutRight, typename AMatrix::device_type> carry_value_view;
+
+  static constexpr int strip_size = 4;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+  const ordinal_type n;
+
+  const size_type items_per_partition;
+  carry_row_view   carry_row;
+  carry_value_view carry_val;
+
+  SPMV_MV_MergePath_Functor (const y_value_type alpha_,
+                             const AMatrix m_A_,
+                             const XVector m_x_,
+                             const y_value_type beta_,
+                             const YVector m_y_,
+                             const size_type items_per_partition_,
+                             const carry_row_view carry_row_,
+                             const carry_value_view carry_val_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_), beta (beta_), m_y (m_y_),
+    n (m_x_.extent(1)), items_per_partition (items_per_partition_),
+    carry_row (carry_row_), carry_val (carry_val_)
+  {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const size_type partition) const
+  {
+    const ordinal_type numRows = m_A.numRows ();
+    const size_type nnz = m_A.nnz ();
+    const size_type total = static_cast<size_type> (numRows) + nnz;
+
+    size_type d_begin = partition * items_per_partition;
+    size_type d_end   = d_begin + items_per_partition;
+    if (d_begin > total) d_begin = total;
+    if (d_end   > total) d_end   = total;
+
+    ordinal_type row_begin, row_end;
+    size_type nz_begin, nz_end;
+    merge_path_search (m_A.graph.row_map, numRows, nnz, d_begin, row_begin, nz_begin);
+    merge_path_search (m_A.graph.row_map, numRows, nnz, d_end, row_end, nz_end);
+    carry_row(partition) = row_end;
+
+    for (ordinal_type kk = 0; kk < n; kk += strip_size) {
+      const int nk = (n - kk < strip_size) ? static_cast<int> (n - kk) : strip_size;
+      y_value_type sum[strip_size];
+      for (int k = 0; k < strip_size; ++k) {
+        sum[k] = Kokkos::Details::ArithTraits<y_value_type>::zero ();
+      }
+
+      ordinal_type row = row_begin;
+      size_type nz = nz_begin;
+      for (; row < row_end; ++row) {
+        const size_type row_stop = m_A.graph.row_map(row + 1);
+        for (; nz < row_stop; ++nz) {
+          const value_type val = conjugate ? ATV::conj (m_A.values(nz)) : m_A.values(nz);
+          const ordinal_type col = m_A.graph.entries(nz);
+          for (int k = 0; k < nk; ++k) {
+            sum[k] += static_cast<y_value_type> (val) * m_x(col, kk + k);
+          }
+        }
+        for (int k = 0; k < nk; ++k) {
+          if (dobeta == 0) {
+            m_y(row, kk + k) = alpha * sum[k];
+          } else {
+            m_y(row, kk + k) = beta * m_y(row, kk + k) + alpha * sum[k];
+          }
+          sum[k] = Kokkos::Details::ArithTraits<y_value_type>::zero ();
+        }
+      }
+      for (; nz < nz_end; ++nz) {
+        const value_type val = conjugate ? ATV::conj (m_A.values(nz)) : m_A.values(nz);
+        const ordinal_type col = m_A.graph.entries(nz);
+        for (int k = 0; k < nk; ++k) {
+          sum[k] += static_cast<y_value_type> (val) * m_x(col, kk + k);
+        }
+      }
+      for (int k = 0; k < nk; ++k) {
+        carry_val(partition, kk + k) = sum[k];
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const MergePathFixupTag&, const size_type partition) const
+  {
+    const ordinal_type row = carry_row(partition);
+    if (row < m_A.numRows ()) {
+      for (ordinal_type k = 0; k < n; ++k) {
+        Kokkos::atomic_add (&m_y(row, k), static_cast<y_value_type> (alpha * carry_val(partition, k)));
+      }
+    }
+  }
+};
+
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate>
+static void
+spmv_merge_mv_no_transpose (const KokkosKernels::Experimental::Controls& controls,
+                            const typename YVector::non_const_value_type& alpha,
+                            const AMatrix& A,
+                            const XVector& x,
+                            const typename YVector::non_const_value_type& beta,
+                            const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef SPMV_MV_MergePath_Functor<AMatrix,XVector,YVector,dobeta,conjugate> functor_type;
+
+  const size_type total = static_cast<size_type> (A.numRows ()) + A.nnz ();
+  const size_type items = spmv_merge_items_per_partition<execution_space, size_type> (controls, total);
+  const size_type num_partitions = (total + items - 1) / items;
+
+  typename functor_type::carry_row_view   carry_row (Kokkos::ViewAllocateWithoutInitializing ("SpMV merge carry row"), num_partitions);
+  typename functor_type::carry_value_view carry_val (Kokkos::ViewAllocateWithoutInitializing ("SpMV merge carry value"), num_partitions, x.extent(1));
+
+  functor_type func (alpha, A, x, beta, y, items, carry_row, carry_val);
+  Kokkos::parallel_for ("KokkosSparse::spmv<MV,NoTranspose,Merge>",
+                        Kokkos::RangePolicy<execution_space> (0, num_partitions), func);
+  Kokkos::parallel_for ("KokkosSparse::spmv<MV,NoTranspose,MergeFixup>",
+                        Kokkos::RangePolicy<execution_space, MergePathFixupTag> (0, num_partitions), func);
+}
+
+/// \brief Whether the controls request the merge-path algorithm.
+inline bool spmv_use_merge_path (const KokkosKernels::Experimental::Controls& controls)
+{
+  if(!controls.isParameter("algorithm")) return false;
+  const std::string algName = controls.getParameter("algorithm");
+  return (algName == "merge") || (algName == "native-merge");
+}
+
+} // namespace Impl
+} // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_MERGE_HPP_
@@ -86,7 +86,7 @@ void spmv_raw_openmp_no_transpose(typename YVector::const_value_type& s_a, AMatr
 
       for(size_type i = rowStart; i < rowEnd; ++i) {
         const ordinal_type x_entry =  matrixCols[i];
-        const value_type alpha_MC  =  s_a * matrixCoeffs[i];
+        const value_type alpha_MC  =  s_a * static_cast<value_type> (matrixCoeffs[i]);
         sum                    += alpha_MC * x_ptr[x_entry];
       }
 
@@ -105,6 +105,84 @@ void spmv_raw_openmp_no_transpose(typename YVector::const_value_type& s_a, AMatr
 
 }
 
+/// \brief Copy src into dst (both host arrays) such that each OpenMP
+///   thread writes, and therefore first-touches, the chunk it will
+///   later read.
+///
+/// Thread t copies [starts[t], starts[t+1]).  If the parallel region
+/// has fewer threads than chunks, chunks are dealt out round-robin.
+template<typename DstType, typename SrcType, typename OffsetType>
+void spmv_openmp_first_touch_copy(DstType* dst, const SrcType* src, const OffsetType* starts, const int nchunks) {
+  #pragma omp parallel
+  {
+    const int nthreads = omp_get_num_threads();
+    for(int chunk = omp_get_thread_num(); chunk < nchunks; chunk += nthreads) {
+      for(OffsetType i = starts[chunk]; i < starts[chunk + 1]; ++i) {
+        dst[i] = src[i];
+      }
+    }
+  }
+}
+
+/// \brief y := beta*y + alpha*op(A)*x, op = N or C, on a matrix whose
+///   arrays were first-touched by the threads that own their rows.
+///
+/// threadRows has nparts+1 entries; thread t processes rows
+/// [threadRows[t], threadRows[t+1]), which is the same chunk it
+/// copied in spmv_openmp_first_touch_copy, so that with bound threads
+/// (OMP_PROC_BIND) its matrix and y reads stay on its own socket.
+template<bool conjugate, typename ScalarType, typename OrdinalType, typename OffsetType, typename XVector, typename YVector>
+void spmv_raw_openmp_numa(const OrdinalType* KOKKOS_RESTRICT threadRows,
+                          const int nparts,
+                          const OffsetType* KOKKOS_RESTRICT matrixRowOffsets,
+                          const OrdinalType* KOKKOS_RESTRICT matrixCols,
+                          const ScalarType* KOKKOS_RESTRICT matrixCoeffs,
+                          typename YVector::const_value_type& s_a, XVector x,
+                          typename YVector::const_value_type& s_b, YVector y) {
+  typedef typename YVector::non_const_value_type value_type;
+  typedef Kokkos::Details::ArithTraits<ScalarType> ATV;
+
+  typename XVector::const_value_type* KOKKOS_RESTRICT x_ptr = x.data();
+  typename YVector::non_const_value_type* KOKKOS_RESTRICT y_ptr = y.data();
+
+#if defined(KOKKOS_ENABLE_PROFILING)
+    uint64_t kpID = 0;
+     if(Kokkos::Profiling::profileLibraryLoaded()) {
+      Kokkos::Profiling::beginParallelFor("KokkosSparse::spmv<RawOpenMP,NUMA>", 0, &kpID);
+     }
+#endif
+
+  typename YVector::const_value_type zero = 0;
+  #pragma omp parallel
+  {
+    const int nthreads = omp_get_num_threads();
+    for(int part = omp_get_thread_num(); part < nparts; part += nthreads) {
+      for(OrdinalType row = threadRows[part]; row < threadRows[part + 1]; ++row) {
+        const OffsetType rowStart = matrixRowOffsets[row];
+        const OffsetType rowEnd   = matrixRowOffsets[row + 1];
+
+        value_type sum = 0.0;
+
+        for(OffsetType i = rowStart; i < rowEnd; ++i) {
+          const ScalarType val = conjugate ? ATV::conj(matrixCoeffs[i]) : matrixCoeffs[i];
+          sum += static_cast<value_type> (val) * x_ptr[matrixCols[i]];
+        }
+
+        if(zero == s_b) {
+          y_ptr[row] = s_a * sum;
+        } else {
+          y_ptr[row] = s_b * y_ptr[row] + s_a * sum;
+        }
+      }
+    }
+  }
+#if defined(KOKKOS_ENABLE_PROFILING)
+     if(Kokkos::Profiling::profileLibraryLoaded()) {
+        Kokkos::Profiling::endParallelFor(kpID);
+     }
+#endif
+}
+
 #endif
 }
 }
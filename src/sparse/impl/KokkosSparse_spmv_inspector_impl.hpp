@@ -0,0 +1,583 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_INSPECTOR_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_INSPECTOR_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv_handle.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+#include "KokkosKernels_SparseUtils.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Compute the first row of each of num_partitions blocks such that
+// every block holds about nnz/num_partitions entries.  Entry p is the
+// first row whose offset reaches the p-th nnz target.
+template<class RowMapType, class PartitionType>
+struct SPMV_RowPartition_Functor {
+  typedef typename PartitionType::non_const_value_type ordinal_type;
+  typedef typename RowMapType::non_const_value_type    size_type;
+
+  RowMapType row_map;
+  PartitionType row_partition;
+  ordinal_type num_rows;
+  ordinal_type num_partitions;
+  size_type nnz;
+
+  SPMV_RowPartition_Functor (const RowMapType& row_map_, const PartitionType& row_partition_,
+                             const ordinal_type num_rows_, const ordinal_type num_partitions_,
+                             const size_type nnz_) :
+    row_map (row_map_), row_partition (row_partition_), num_rows (num_rows_),
+    num_partitions (num_partitions_), nnz (nnz_)
+  {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type p) const
+  {
+    if (p == num_partitions) {
+      row_partition(p) = num_rows;
+      return;
+    }
+    const size_type np = static_cast<size_type> (num_partitions);
+    const size_type sp = static_cast<size_type> (p);
+    const size_type target = (nnz / np) * sp + ((sp < nnz % np) ? sp : nnz % np);
+
+    // smallest row r with row_map(r) >= target
+    ordinal_type lo = 0, hi = num_rows;
+    while (lo < hi) {
+      const ordinal_type mid = lo + (hi - lo) / 2;
+      if (static_cast<size_type> (row_map(mid)) < target) lo = mid + 1;
+      else hi = mid;
+    }
+    row_partition(p) = lo;
+  }
+};
+
+template<class RowMapType, class OrdinalType>
+struct SPMV_MaxRowLength_Functor {
+  typedef OrdinalType value_type;
+  RowMapType row_map;
+
+  SPMV_MaxRowLength_Functor (const RowMapType& row_map_) : row_map (row_map_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const OrdinalType i, value_type& lmax) const
+  {
+    const OrdinalType len = static_cast<OrdinalType> (row_map(i + 1) - row_map(i));
+    if (len > lmax) lmax = len;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void join (volatile value_type& dst, const volatile value_type& src) const
+  {
+    if (src > dst) dst = src;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void init (value_type& dst) const { dst = 0; }
+};
+
+/// \brief Copies A's values into A^T: t_values(i) = values(perm(i)).
+template<class PermType, class ValuesType, class TransposeValuesType>
+struct SPMV_TransposeGather_Functor {
+  typedef typename PermType::non_const_value_type size_type;
+
+  PermType perm;
+  ValuesType values;
+  TransposeValuesType t_values;
+
+  SPMV_TransposeGather_Functor (const PermType& perm_, const ValuesType& values_,
+                                const TransposeValuesType& t_values_) :
+    perm (perm_), values (values_), t_values (t_values_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const size_type i) const {
+    t_values(i) = values(perm(i));
+  }
+};
+
+template<class IndexType>
+struct SPMV_EntryIndex_Functor {
+  typedef typename IndexType::non_const_value_type size_type;
+
+  IndexType index;
+
+  SPMV_EntryIndex_Functor (const IndexType& index_) : index (index_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const size_type i) const {
+    index(i) = i;
+  }
+};
+
+// Refresh the values of the cached A^T from the values of A.
+template<class SPMVHandleType, class AMatrix>
+void spmv_transpose_numeric_impl (SPMVHandleType* handle, const AMatrix& A)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename SPMVHandleType::size_type_view_t size_type_view_t;
+  typedef typename SPMVHandleType::scalar_view_t    scalar_view_t;
+
+  size_type_view_t perm = handle->get_transpose_perm ();
+  Kokkos::parallel_for ("KokkosSparse::spmv_numeric::transpose_values",
+                        Kokkos::RangePolicy<execution_space> (0, perm.extent(0)),
+                        SPMV_TransposeGather_Functor<size_type_view_t, typename AMatrix::values_type, scalar_view_t>
+                          (perm, A.values, handle->get_transpose_values ()));
+}
+
+// Build A^T, with its rows sorted, along with the map from its entries
+// back to the entries of A.  The map is obtained by transposing the
+// entry indices of A as if they were the values.
+template<class SPMVHandleType, class AMatrix>
+void spmv_transpose_symbolic_impl (SPMVHandleType* handle, const AMatrix& A)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename SPMVHandleType::size_type_view_t size_type_view_t;
+  typedef typename SPMVHandleType::nnz_lno_view_t   nnz_lno_view_t;
+  typedef typename SPMVHandleType::scalar_view_t    scalar_view_t;
+
+  const auto nnz = A.nnz ();
+  size_type_view_t t_row_map ("SpMV transpose row map", A.numCols () + 1);
+  nnz_lno_view_t t_entries (Kokkos::ViewAllocateWithoutInitializing ("SpMV transpose entries"), nnz);
+  scalar_view_t t_values (Kokkos::ViewAllocateWithoutInitializing ("SpMV transpose values"), nnz);
+  size_type_view_t perm (Kokkos::ViewAllocateWithoutInitializing ("SpMV transpose permutation"), nnz);
+  size_type_view_t entry_index (Kokkos::ViewAllocateWithoutInitializing ("SpMV entry index"), nnz);
+
+  Kokkos::parallel_for ("KokkosSparse::spmv_symbolic::entry_index",
+                        Kokkos::RangePolicy<execution_space> (0, nnz),
+                        SPMV_EntryIndex_Functor<size_type_view_t> (entry_index));
+
+  KokkosKernels::Impl::transpose_matrix<
+    typename AMatrix::row_map_type, typename AMatrix::index_type, size_type_view_t,
+    size_type_view_t, nnz_lno_view_t, size_type_view_t,
+    size_type_view_t, execution_space>
+      (A.numRows (), A.numCols (), A.graph.row_map, A.graph.entries, entry_index,
+       t_row_map, t_entries, perm);
+
+  // Sorted rows make the result independent of the order in which
+  // the transpose was filled, and read x in order.
+  KokkosKernels::Impl::sort_crs_matrix<execution_space, size_type_view_t, nnz_lno_view_t, size_type_view_t>
+    (t_row_map, t_entries, perm);
+
+  handle->set_transpose (t_row_map, t_entries, t_values, perm);
+  spmv_transpose_numeric_impl (handle, A);
+}
+
+// Offset in the entries of the first entry of each thread's rows.
+template<class SPMVHandleType, class AMatrix>
+std::vector<typename SPMVHandleType::size_type>
+spmv_numa_entry_starts (SPMVHandleType* handle, const AMatrix& A)
+{
+  typename SPMVHandleType::nnz_lno_view_t thread_rows = handle->get_numa_thread_rows ();
+  const int nparts = static_cast<int> (thread_rows.extent(0)) - 1;
+  std::vector<typename SPMVHandleType::size_type> entry_starts (nparts + 1);
+  for (int t = 0; t <= nparts; ++t) {
+    entry_starts[t] = A.graph.row_map(thread_rows(t));
+  }
+  return entry_starts;
+}
+
+// Refresh the values of the first-touched copy of A, keeping each
+// thread's values on the pages it touched first.
+template<class SPMVHandleType, class AMatrix>
+void spmv_numa_numeric_impl (SPMVHandleType* handle, const AMatrix& A)
+{
+#ifdef KOKKOS_ENABLE_OPENMP
+  const auto entry_starts = spmv_numa_entry_starts (handle, A);
+  spmv_openmp_first_touch_copy (handle->get_numa_values ().data (), A.values.data (),
+                                entry_starts.data (), static_cast<int> (entry_starts.size ()) - 1);
+#else
+  (void) handle;
+  (void) A;
+#endif
+}
+
+// Split the rows in one nnz-balanced block per OpenMP thread and copy
+// A so that each thread first-touches its own block.  Only done for
+// the OpenMP execution space; elsewhere the copy is dropped.
+template<class SPMVHandleType, class AMatrix>
+void spmv_numa_symbolic_impl (SPMVHandleType* handle, const AMatrix& A)
+{
+#ifdef KOKKOS_ENABLE_OPENMP
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename SPMVHandleType::nnz_lno_t        nnz_lno_t;
+  typedef typename SPMVHandleType::nnz_lno_view_t   nnz_lno_view_t;
+  typedef typename SPMVHandleType::size_type_view_t size_type_view_t;
+  typedef typename SPMVHandleType::scalar_view_t    scalar_view_t;
+
+  const nnz_lno_t numRows = A.numRows ();
+  if (!std::is_same<execution_space, Kokkos::OpenMP>::value || numRows <= 0) {
+    handle->reset_numa_matrix ();
+    return;
+  }
+
+  nnz_lno_t nparts = static_cast<nnz_lno_t> (omp_get_max_threads ());
+  if (nparts > numRows) nparts = numRows;
+
+  nnz_lno_view_t thread_rows ("SpMV NUMA thread rows", nparts + 1);
+  Kokkos::parallel_for ("KokkosSparse::spmv_symbolic::numa_partition",
+                        Kokkos::RangePolicy<execution_space> (0, nparts + 1),
+                        SPMV_RowPartition_Functor<typename AMatrix::row_map_type, nnz_lno_view_t>
+                          (A.graph.row_map, thread_rows, numRows, nparts, A.nnz ()));
+  execution_space ().fence ();
+
+  // Allocated without initialization, so no page is touched before
+  // the owning thread writes it.
+  size_type_view_t row_map (Kokkos::ViewAllocateWithoutInitializing ("SpMV NUMA row map"), numRows + 1);
+  nnz_lno_view_t entries (Kokkos::ViewAllocateWithoutInitializing ("SpMV NUMA entries"), A.nnz ());
+  scalar_view_t values (Kokkos::ViewAllocateWithoutInitializing ("SpMV NUMA values"), A.nnz ());
+
+  spmv_openmp_first_touch_copy (row_map.data (), A.graph.row_map.data (), thread_rows.data (), static_cast<int> (nparts));
+  row_map(numRows) = A.graph.row_map(numRows);
+  handle->set_numa_matrix (thread_rows, row_map, entries, values);
+
+  const auto entry_starts = spmv_numa_entry_starts (handle, A);
+  spmv_openmp_first_touch_copy (entries.data (), A.graph.entries.data (), entry_starts.data (), static_cast<int> (nparts));
+  spmv_numa_numeric_impl (handle, A);
+#else
+  (void) A;
+  handle->reset_numa_matrix ();
+#endif
+}
+
+// Copy v to a new vector that each OpenMP thread first-touches in the
+// chunk matching its block of rows.  Vectors of length numRows (y, and
+// x for square matrices) use the row blocks; other lengths are split
+// evenly.  Without a first-touched matrix this is a plain copy.
+template<class SPMVHandleType, class VectorType>
+Kokkos::View<typename VectorType::non_const_value_type*, Kokkos::LayoutLeft, typename VectorType::device_type>
+spmv_numa_first_touch_vector (SPMVHandleType* handle, const VectorType& v)
+{
+  typedef Kokkos::View<typename VectorType::non_const_value_type*, Kokkos::LayoutLeft,
+                       typename VectorType::device_type> vector_type;
+
+  vector_type out (Kokkos::ViewAllocateWithoutInitializing (v.label ()), v.extent(0));
+#ifdef KOKKOS_ENABLE_OPENMP
+  if (handle->is_numa_complete () && v.span_is_contiguous ()) {
+    typename SPMVHandleType::nnz_lno_view_t thread_rows = handle->get_numa_thread_rows ();
+    const int nparts = static_cast<int> (thread_rows.extent(0)) - 1;
+    const size_t n = v.extent(0);
+    std::vector<size_t> starts (nparts + 1);
+    for (int t = 0; t <= nparts; ++t) {
+      starts[t] = (n == static_cast<size_t> (handle->get_nrows ())) ?
+        static_cast<size_t> (thread_rows(t)) : (n / nparts) * t + std::min (static_cast<size_t> (t), n % nparts);
+    }
+    spmv_openmp_first_touch_copy (out.data (), v.data (), starts.data (), nparts);
+    return out;
+  }
+#endif
+  Kokkos::deep_copy (out, v);
+  return out;
+}
+
+// A view of the graph of A that the SpMV handle can hold: managed, of
+// the same value type, in the handle's memory space and with a
+// contiguous layout.  Other views are not held, and the analysis of
+// their matrix is never reused.
+template<class HandleViewType, class GraphViewType,
+         bool holdable =
+           std::is_same<typename HandleViewType::non_const_value_type, typename GraphViewType::non_const_value_type>::value &&
+           std::is_same<typename HandleViewType::memory_space, typename GraphViewType::memory_space>::value &&
+           (std::is_same<typename GraphViewType::array_layout, Kokkos::LayoutLeft>::value ||
+            std::is_same<typename GraphViewType::array_layout, Kokkos::LayoutRight>::value) &&
+           !GraphViewType::memory_traits::is_unmanaged>
+struct SPMV_GraphViewRef {
+  static HandleViewType get (const GraphViewType& v) { return HandleViewType (v); }
+};
+
+template<class HandleViewType, class GraphViewType>
+struct SPMV_GraphViewRef<HandleViewType, GraphViewType, false> {
+  static HandleViewType get (const GraphViewType&) { return HandleViewType (); }
+};
+
+/// \brief Inspector: analyze A once and store the row partition and
+///   kernel variant in the SpMV handle.
+template<class SPMVHandleType, class AMatrix>
+void spmv_symbolic_impl (SPMVHandleType* handle, const AMatrix& A)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename SPMVHandleType::nnz_lno_t      nnz_lno_t;
+  typedef typename SPMVHandleType::nnz_lno_view_t nnz_lno_view_t;
+  using KokkosSparse::Experimental::SPMVAlgorithm;
+
+  const nnz_lno_t numRows = A.numRows ();
+  const int64_t nnz = A.nnz ();
+
+  int team_size     = handle->get_team_size ();
+  int vector_length = handle->get_vector_size ();
+  nnz_lno_t num_partitions = 1;
+
+  if (numRows > 0) {
+    if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space> ()) {
+      const int64_t rows_per_team =
+        spmv_launch_parameters<execution_space> (numRows, nnz, -1, team_size, vector_length);
+      int64_t nnz_per_row = nnz / numRows;
+      if (nnz_per_row < 1) nnz_per_row = 1;
+      const int64_t nnz_per_team = rows_per_team * nnz_per_row;
+      num_partitions = static_cast<nnz_lno_t> ((nnz + nnz_per_team - 1) / nnz_per_team);
+    }
+    else {
+      // A few blocks per thread leaves room for the dynamic schedule
+      // to even out cache and NUMA effects.
+      team_size = 1;
+      vector_length = 1;
+      num_partitions = static_cast<nnz_lno_t> (execution_space::concurrency () * 16);
+    }
+    if (num_partitions > numRows) num_partitions = numRows;
+    if (num_partitions < 1) num_partitions = 1;
+  }
+
+  nnz_lno_view_t row_partition ("SpMV row partition", num_partitions + 1);
+  if (numRows > 0) {
+    Kokkos::parallel_for ("KokkosSparse::spmv_symbolic::partition",
+                          Kokkos::RangePolicy<execution_space> (0, num_partitions + 1),
+                          SPMV_RowPartition_Functor<typename AMatrix::row_map_type, nnz_lno_view_t>
+                            (A.graph.row_map, row_partition, numRows, num_partitions, A.nnz ()));
+  }
+
+  nnz_lno_t max_row_length = 0;
+  if (numRows > 0) {
+    Kokkos::parallel_reduce ("KokkosSparse::spmv_symbolic::max_row_length",
+                             Kokkos::RangePolicy<execution_space> (0, numRows),
+                             SPMV_MaxRowLength_Functor<typename AMatrix::row_map_type, nnz_lno_t> (A.graph.row_map),
+                             max_row_length);
+  }
+
+  SPMVAlgorithm selected = handle->get_algorithm ();
+  if (selected == SPMVAlgorithm::SPMV_DEFAULT) {
+    // A row longer than several blocks' worth of nonzeros would leave
+    // one team doing most of the work; merge-path splits such rows.
+    const int64_t nnz_per_partition = nnz / num_partitions;
+    selected = (static_cast<int64_t> (max_row_length) > 4 * nnz_per_partition + 32)
+             ? SPMVAlgorithm::SPMV_MERGE_PATH : SPMVAlgorithm::SPMV_PARTITIONED;
+  }
+
+  handle->set_row_partition (row_partition);
+  handle->set_max_row_length (max_row_length);
+  handle->set_matrix_size (numRows, A.numCols (), A.nnz ());
+  handle->set_matrix_graph (
+    SPMV_GraphViewRef<typename SPMVHandleType::const_size_type_view_t, typename AMatrix::row_map_type>::get (A.graph.row_map),
+    SPMV_GraphViewRef<typename SPMVHandleType::const_nnz_lno_view_t, typename AMatrix::index_type>::get (A.graph.entries));
+  handle->set_team_size (team_size);
+  handle->set_vector_size (vector_length);
+  handle->set_selected_algorithm (selected);
+
+  if (handle->use_explicit_transpose ())
+    spmv_transpose_symbolic_impl (handle, A);
+  else
+    handle->reset_transpose ();
+  if (handle->use_numa_first_touch ())
+    spmv_numa_symbolic_impl (handle, A);
+  else
+    handle->reset_numa_matrix ();
+  handle->reset_symmetric_partition ();
+  handle->set_symbolic_complete ();
+}
+
+/// \brief Executor functor: one team per block of the cached row
+///   partition, one thread per row and vector lanes over the entries.
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         class PartitionType,
+         int dobeta,
+         bool conjugate>
+struct SPMV_Partitioned_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_value_type       value_type;
+  typedef typename YVector::non_const_value_type       y_value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<value_type>     ATV;
+
+  const y_value_type alpha;
+  AMatrix  m_A;
+  XVector  m_x;
+  PartitionType m_row_partition;
+  const y_value_type beta;
+  YVector  m_y;
+
+  SPMV_Partitioned_Functor (const y_value_type alpha_,
+                            const AMatrix m_A_,
+                            const XVector m_x_,
+                            const PartitionType m_row_partition_,
+                            const y_value_type beta_,
+                            const YVector m_y_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_),
+    m_row_partition (m_row_partition_),
+    beta (beta_), m_y (m_y_)
+  {
+    static_assert (static_cast<int> (XVector::rank) == 1,
+                   "XVector must be a rank 1 View.");
+    static_assert (static_cast<int> (YVector::rank) == 1,
+                   "YVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  operator() (const team_member& dev) const
+  {
+    const ordinal_type first = m_row_partition(dev.league_rank ());
+    const ordinal_type last  = m_row_partition(dev.league_rank () + 1);
+
+    Kokkos::parallel_for (Kokkos::TeamThreadRange (dev, first, last), [&] (const ordinal_type& iRow) {
+      const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst (iRow);
+      const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+      y_value_type sum = 0;
+
+      Kokkos::parallel_reduce (Kokkos::ThreadVectorRange (dev, row_length), [&] (const ordinal_type& iEntry, y_value_type& lsum) {
+        const value_type val = conjugate ?
+          ATV::conj (row.value(iEntry)) :
+          row.value(iEntry);
+        lsum += val * m_x(row.colidx(iEntry));
+      }, sum);
+
+      Kokkos::single (Kokkos::PerThread (dev), [&] () {
+        sum *= alpha;
+        if (dobeta == 0) {
+          m_y(iRow) = sum;
+        } else {
+          m_y(iRow) = beta * m_y(iRow) + sum;
+        }
+      });
+    });
+  }
+};
+
+template<class AMatrix, class XVector, class YVector, class PartitionType, int dobeta, bool conjugate>
+void spmv_partitioned_launch (const typename YVector::non_const_value_type& alpha,
+                              const AMatrix& A,
+                              const XVector& x,
+                              const PartitionType& row_partition,
+                              const typename YVector::non_const_value_type& beta,
+                              const YVector& y,
+                              const int team_size,
+                              const int vector_length)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef Kokkos::TeamPolicy<execution_space, Kokkos::Schedule<Kokkos::Dynamic> > policy_type;
+
+  const int num_partitions = static_cast<int> (row_partition.extent (0)) - 1;
+  SPMV_Partitioned_Functor<AMatrix, XVector, YVector, PartitionType, dobeta, conjugate>
+    func (alpha, A, x, row_partition, beta, y);
+
+  policy_type policy (1, 1);
+  if (team_size < 1)
+    policy = policy_type (num_partitions, Kokkos::AUTO, vector_length < 1 ? 1 : vector_length);
+  else
+    policy = policy_type (num_partitions, team_size, vector_length < 1 ? 1 : vector_length);
+  Kokkos::parallel_for ("KokkosSparse::spmv<NoTranspose,Partitioned>", policy, func);
+}
+
+/// \brief Executor: y := beta*y + alpha*op(A)*x with op N or C, using
+///   the row partition cached in the handle.
+template<class SPMVHandleType, class AMatrix, class XVector, class YVector>
+void spmv_partitioned (SPMVHandleType* handle,
+                       const bool conjugate,
+                       const typename YVector::non_const_value_type& alpha,
+                       const AMatrix& A,
+                       const XVector& x,
+                       const typename YVector::non_const_value_type& beta,
+                       const YVector& y)
+{
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef typename SPMVHandleType::nnz_lno_view_t partition_type;
+
+  if (A.numRows () <= 0) {
+    return;
+  }
+
+#ifdef KOKKOS_ENABLE_OPENMP
+  if (handle->is_numa_complete () && x.span_is_contiguous () && y.span_is_contiguous ()) {
+    typedef typename SPMVHandleType::nnz_scalar_t scalar_type;
+    typedef typename SPMVHandleType::nnz_lno_t    ordinal_type;
+    typedef typename SPMVHandleType::size_type    offset_type;
+    const partition_type thread_rows = handle->get_numa_thread_rows ();
+    const int nparts = static_cast<int> (thread_rows.extent(0)) - 1;
+    if (conjugate)
+      spmv_raw_openmp_numa<true, scalar_type, ordinal_type, offset_type, XVector, YVector>
+        (thread_rows.data (), nparts, handle->get_numa_row_map ().data (), handle->get_numa_entries ().data (),
+         handle->get_numa_values ().data (), alpha, x, beta, y);
+    else
+      spmv_raw_openmp_numa<false, scalar_type, ordinal_type, offset_type, XVector, YVector>
+        (thread_rows.data (), nparts, handle->get_numa_row_map ().data (), handle->get_numa_entries ().data (),
+         handle->get_numa_values ().data (), alpha, x, beta, y);
+    return;
+  }
+#endif
+
+  const partition_type row_partition = handle->get_row_partition ();
+  const int team_size     = handle->get_team_size ();
+  const int vector_length = handle->get_vector_size ();
+  const bool dobeta = (beta != Kokkos::Details::ArithTraits<y_value_type>::zero ());
+
+  if (conjugate) {
+    if (dobeta)
+      spmv_partitioned_launch<AMatrix, XVector, YVector, partition_type, 2, true>
+        (alpha, A, x, row_partition, beta, y, team_size, vector_length);
+    else
+      spmv_partitioned_launch<AMatrix, XVector, YVector, partition_type, 0, true>
+        (alpha, A, x, row_partition, beta, y, team_size, vector_length);
+  }
+  else {
+    if (dobeta)
+      spmv_partitioned_launch<AMatrix, XVector, YVector, partition_type, 2, false>
+        (alpha, A, x, row_partition, beta, y, team_size, vector_length);
+    else
+      spmv_partitioned_launch<AMatrix, XVector, YVector, partition_type, 0, false>
+        (alpha, A, x, row_partition, beta, y, team_size, vector_length);
+  }
+}
+
+} // namespace Impl
+} // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_INSPECTOR_HPP_
@@ -0,0 +1,251 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_SELLC_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_SELLC_HPP_
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosSparse_SellCMatrix.hpp"
+#include <type_traits>
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief y := beta*y + alpha*A*x for a SellCMatrix A, one chunk per
+///   work item.
+///
+/// The chunk height C is a template parameter so that the inner loop
+/// over the C lanes of a chunk has a compile-time trip count and
+/// unit-stride accesses to the padded entries and values; this is the
+/// loop the compiler vectorizes on CPUs.  Padding is still loaded, but
+/// masked out by the row length, so that 0*x(c) never reaches y when
+/// x(c) is Inf or NaN.
+template<class AMatrix, class XVector, class YVector, int C>
+struct SPMV_SellC_Chunk_Functor {
+  typedef typename AMatrix::ordinal_type          ordinal_type;
+  typedef typename AMatrix::size_type             size_type;
+  typedef typename YVector::non_const_value_type  value_type;
+  typedef Kokkos::Details::ArithTraits<value_type> ATV;
+
+  value_type alpha;
+  AMatrix  m_A;
+  XVector  m_x;
+  value_type beta;
+  YVector  m_y;
+
+  SPMV_SellC_Chunk_Functor (const value_type alpha_,
+                            const AMatrix m_A_,
+                            const XVector m_x_,
+                            const value_type beta_,
+                            const YVector m_y_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_), beta (beta_), m_y (m_y_)
+  {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type chunk) const
+  {
+    const ordinal_type first = chunk * C;
+    value_type sum[C];
+    ordinal_type len[C];
+    for (int r = 0; r < C; ++r) {
+      sum[r] = ATV::zero ();
+      len[r] = (first + r < m_A.numRows ()) ? m_A.row_len(first + r) : 0;
+    }
+
+    const size_type base = m_A.chunk_ptr(chunk);
+    const ordinal_type width = m_A.chunk_len(chunk);
+    for (ordinal_type j = 0; j < width; ++j) {
+      const size_type off = base + static_cast<size_type> (j) * C;
+#ifdef KOKKOS_ENABLE_PRAGMA_IVDEP
+#pragma ivdep
+#endif
+      for (int r = 0; r < C; ++r) {
+        const value_type prod = m_A.values(off + r) * m_x(m_A.entries(off + r));
+        sum[r] += (j < len[r]) ? prod : ATV::zero ();
+      }
+    }
+
+    for (int r = 0; r < C; ++r) {
+      const ordinal_type pos = first + r;
+      if (pos >= m_A.numRows ()) break;
+      const ordinal_type row = m_A.row_perm(pos);
+      if (beta == ATV::zero ()) {
+        m_y(row) = alpha * sum[r];
+      } else {
+        m_y(row) = beta * m_y(row) + alpha * sum[r];
+      }
+    }
+  }
+};
+
+/// \brief y := beta*y + alpha*A*x for a SellCMatrix A, one (sorted)
+///   row per work item.
+///
+/// Consecutive work items read consecutive entries of each chunk
+/// column, so the loads are coalesced on GPUs.  Padding beyond the
+/// row's own length is skipped.
+template<class AMatrix, class XVector, class YVector>
+struct SPMV_SellC_Row_Functor {
+  typedef typename AMatrix::ordinal_type          ordinal_type;
+  typedef typename AMatrix::size_type             size_type;
+  typedef typename YVector::non_const_value_type  value_type;
+  typedef Kokkos::Details::ArithTraits<value_type> ATV;
+
+  value_type alpha;
+  AMatrix  m_A;
+  XVector  m_x;
+  value_type beta;
+  YVector  m_y;
+
+  SPMV_SellC_Row_Functor (const value_type alpha_,
+                          const AMatrix m_A_,
+                          const XVector m_x_,
+                          const value_type beta_,
+                          const YVector m_y_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_), beta (beta_), m_y (m_y_)
+  {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type pos) const
+  {
+    const ordinal_type C = m_A.chunkSize ();
+    const size_type start = m_A.chunk_ptr(pos / C) + (pos % C);
+    const ordinal_type len = m_A.row_len(pos);
+
+    value_type sum = ATV::zero ();
+    for (ordinal_type j = 0; j < len; ++j) {
+      const size_type idx = start + static_cast<size_type> (j) * C;
+      sum += m_A.values(idx) * m_x(m_A.entries(idx));
+    }
+
+    const ordinal_type row = m_A.row_perm(pos);
+    if (beta == ATV::zero ()) {
+      m_y(row) = alpha * sum;
+    } else {
+      m_y(row) = beta * m_y(row) + alpha * sum;
+    }
+  }
+};
+
+template<int C, class AMatrix, class XVector, class YVector>
+void spmv_sellc_chunks (const typename YVector::non_const_value_type& alpha,
+                        const AMatrix& A,
+                        const XVector& x,
+                        const typename YVector::non_const_value_type& beta,
+                        const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  Kokkos::parallel_for ("KokkosSparse::spmv<SellC,Chunk>",
+                        Kokkos::RangePolicy<execution_space> (0, A.numChunks ()),
+                        SPMV_SellC_Chunk_Functor<AMatrix, XVector, YVector, C> (alpha, A, x, beta, y));
+}
+
+/// \brief Rank-1 SpMV, no transpose, for a SellCMatrix.
+template<class AMatrix, class XVector, class YVector>
+void spmv_sellc (const typename YVector::non_const_value_type& alpha,
+                 const AMatrix& A,
+                 const XVector& x,
+                 const typename YVector::non_const_value_type& beta,
+                 const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::ordinal_type    ordinal_type;
+
+  if (A.numRows () <= static_cast<ordinal_type> (0)) {
+    return;
+  }
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space> ()) {
+    Kokkos::parallel_for ("KokkosSparse::spmv<SellC,Row>",
+                          Kokkos::RangePolicy<execution_space> (0, A.numRows ()),
+                          SPMV_SellC_Row_Functor<AMatrix, XVector, YVector> (alpha, A, x, beta, y));
+    return;
+  }
+
+  switch (A.chunkSize ()) {
+  case 1:  spmv_sellc_chunks<1>  (alpha, A, x, beta, y); break;
+  case 2:  spmv_sellc_chunks<2>  (alpha, A, x, beta, y); break;
+  case 4:  spmv_sellc_chunks<4>  (alpha, A, x, beta, y); break;
+  case 8:  spmv_sellc_chunks<8>  (alpha, A, x, beta, y); break;
+  case 16: spmv_sellc_chunks<16> (alpha, A, x, beta, y); break;
+  case 32: spmv_sellc_chunks<32> (alpha, A, x, beta, y); break;
+  case 64: spmv_sellc_chunks<64> (alpha, A, x, beta, y); break;
+  default:
+    Kokkos::Impl::throw_runtime_exception ("KokkosSparse::spmv: unsupported SellCMatrix chunk size");
+  }
+}
+
+template<class AMatrix, class XVector, class YVector>
+void spmv_sellc_mv (const typename YVector::non_const_value_type& alpha,
+                    const AMatrix& A,
+                    const XVector& x,
+                    const typename YVector::non_const_value_type& beta,
+                    const YVector& y,
+                    std::integral_constant<int, 1>)
+{
+  spmv_sellc (alpha, A, x, beta, y);
+}
+
+/// \brief Rank-2 SpMV for a SellCMatrix, one column at a time.
+template<class AMatrix, class XVector, class YVector>
+void spmv_sellc_mv (const typename YVector::non_const_value_type& alpha,
+                    const AMatrix& A,
+                    const XVector& x,
+                    const typename YVector::non_const_value_type& beta,
+                    const YVector& y,
+                    std::integral_constant<int, 2>)
+{
+  for (size_t j = 0; j < x.extent(1); ++j) {
+    auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
+    auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
+    spmv_sellc (alpha, A, x_j, beta, y_j);
+  }
+}
+
+} // namespace Impl
+} // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_SELLC_HPP_
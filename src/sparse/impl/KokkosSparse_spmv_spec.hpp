@@ -113,10 +113,48 @@ struct spmv_mv_eti_spec_avail {
       { enum : bool { value = true }; };
 
 
+// Mixed-precision variants: the matrix stores its values in
+// MAT_SCALAR_TYPE while x, y and the accumulation use VEC_SCALAR_TYPE.
+#define KOKKOSSPARSE_SPMV_MIXED_ETI_SPEC_AVAIL( MAT_SCALAR_TYPE, VEC_SCALAR_TYPE, ORDINAL_TYPE, OFFSET_TYPE, LAYOUT_TYPE, EXEC_SPACE_TYPE, MEM_SPACE_TYPE) \
+    template<> \
+    struct spmv_eti_spec_avail<const MAT_SCALAR_TYPE, \
+                  const ORDINAL_TYPE, \
+                  Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+                  Kokkos::MemoryTraits<Kokkos::Unmanaged>, \
+                  const OFFSET_TYPE, \
+                  VEC_SCALAR_TYPE const*, \
+                  LAYOUT_TYPE, \
+                  Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+                  Kokkos::MemoryTraits<Kokkos::Unmanaged|Kokkos::RandomAccess>, \
+                  VEC_SCALAR_TYPE*, \
+                  LAYOUT_TYPE, \
+                  Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+                  Kokkos::MemoryTraits<Kokkos::Unmanaged> > \
+    { enum : bool { value = true }; };
+
+#define KOKKOSSPARSE_SPMV_MV_MIXED_ETI_SPEC_AVAIL( MAT_SCALAR_TYPE, VEC_SCALAR_TYPE, ORDINAL_TYPE, OFFSET_TYPE, LAYOUT_TYPE, EXEC_SPACE_TYPE, MEM_SPACE_TYPE ) \
+    template<> \
+    struct spmv_mv_eti_spec_avail <const MAT_SCALAR_TYPE, \
+                                       const ORDINAL_TYPE, \
+                                       Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+                                       Kokkos::MemoryTraits<Kokkos::Unmanaged>, \
+                                       const OFFSET_TYPE, \
+                                       VEC_SCALAR_TYPE const**, \
+                                       LAYOUT_TYPE, \
+                                       Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+                                       Kokkos::MemoryTraits<Kokkos::Unmanaged|Kokkos::RandomAccess>, \
+                                       VEC_SCALAR_TYPE**, \
+                                       LAYOUT_TYPE, \
+                                       Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+                                       Kokkos::MemoryTraits<Kokkos::Unmanaged> > \
+      { enum : bool { value = true }; };
+
 // Include the actual specialization declarations
 #include<KokkosSparse_spmv_tpl_spec_avail.hpp>
 #include<generated_specializations_hpp/KokkosSparse_spmv_eti_spec_avail.hpp>
 #include<generated_specializations_hpp/KokkosSparse_spmv_mv_eti_spec_avail.hpp>
+#include<generated_specializations_hpp/KokkosSparse_spmv_mixed_eti_spec_avail.hpp>
+#include<generated_specializations_hpp/KokkosSparse_spmv_mv_mixed_eti_spec_avail.hpp>
 
 namespace KokkosSparse {
 namespace Impl {
@@ -223,7 +261,8 @@ struct SPMV_MV{
   typedef typename YVector::non_const_value_type coefficient_type;
 
   static void
-  spmv_mv (const char mode[],
+  spmv_mv (const KokkosKernels::Experimental::Controls& controls,
+           const char mode[],
            const coefficient_type& alpha,
            const AMatrix& A,
            const XVector& x,
@@ -295,7 +334,8 @@ struct SPMV_MV<AT, AO, AD, AM, AS,
   typedef typename YVector::non_const_value_type coefficient_type;
 
   static void
-  spmv_mv (const char mode[],
+  spmv_mv (const KokkosKernels::Experimental::Controls& controls,
+           const char mode[],
            const coefficient_type& alpha,
            const AMatrix& A,
            const XVector& x,
@@ -305,16 +345,16 @@ struct SPMV_MV<AT, AO, AD, AM, AS,
     typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
 
     if (alpha == KAT::zero ()) {
-      spmv_alpha_mv<AMatrix, XVector, YVector, 0> (mode, alpha, A, x, beta, y);
+      spmv_alpha_mv<AMatrix, XVector, YVector, 0> (controls, mode, alpha, A, x, beta, y);
     }
     else if (alpha == KAT::one ()) {
-      spmv_alpha_mv<AMatrix, XVector, YVector, 1> (mode, alpha, A, x, beta, y);
+      spmv_alpha_mv<AMatrix, XVector, YVector, 1> (controls, mode, alpha, A, x, beta, y);
     }
     else if (alpha == -KAT::one ()) {
-      spmv_alpha_mv<AMatrix, XVector, YVector, -1> (mode, alpha, A, x, beta, y);
+      spmv_alpha_mv<AMatrix, XVector, YVector, -1> (controls, mode, alpha, A, x, beta, y);
     }
     else {
-      spmv_alpha_mv<AMatrix, XVector, YVector, 2> (mode, alpha, A, x, beta, y);
+      spmv_alpha_mv<AMatrix, XVector, YVector, 2> (controls, mode, alpha, A, x, beta, y);
     }
   }
 };
@@ -333,7 +373,8 @@ struct SPMV_MV<AT, AO, AD, AM, AS,
   typedef typename YVector::non_const_value_type coefficient_type;
 
   static void
-  spmv_mv (const char mode[],
+  spmv_mv (const KokkosKernels::Experimental::Controls& controls,
+           const char mode[],
            const coefficient_type& alpha,
            const AMatrix& A,
            const XVector& x,
@@ -345,11 +386,10 @@ struct SPMV_MV<AT, AO, AD, AM, AS,
     typedef SPMV<AT, AO, AD, AM, AS,
       typename XVector::value_type*, XL, XD, XM,
       typename YVector::value_type*, YL, YD, YM> impl_type;
-    KokkosKernels::Experimental::Controls defaultControls;
     for (typename AMatrix::non_const_size_type j = 0; j < x.extent(1); ++j) {
       auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
       auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
-      impl_type::spmv (defaultControls, mode, alpha, A, x_j, beta, y_j);
+      impl_type::spmv (controls, mode, alpha, A, x_j, beta, y_j);
     }
   }
 };
@@ -433,8 +473,74 @@ struct SPMV_MV<AT, AO, AD, AM, AS,
          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
          Kokkos::MemoryTraits<Kokkos::Unmanaged>, std::is_integral<typename std::decay<SCALAR_TYPE>::type>::value, false, true >;
 
+#define KOKKOSSPARSE_SPMV_MIXED_ETI_SPEC_DECL( MAT_SCALAR_TYPE, VEC_SCALAR_TYPE, ORDINAL_TYPE, OFFSET_TYPE, LAYOUT_TYPE, EXEC_SPACE_TYPE, MEM_SPACE_TYPE ) \
+    extern template struct  \
+    SPMV<const MAT_SCALAR_TYPE, \
+         const ORDINAL_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, \
+         const OFFSET_TYPE, \
+         VEC_SCALAR_TYPE const*, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged|Kokkos::RandomAccess>, \
+         VEC_SCALAR_TYPE*, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, false, true >;
+
+#define KOKKOSSPARSE_SPMV_MIXED_ETI_SPEC_INST( MAT_SCALAR_TYPE, VEC_SCALAR_TYPE, ORDINAL_TYPE, OFFSET_TYPE, LAYOUT_TYPE, EXEC_SPACE_TYPE, MEM_SPACE_TYPE ) \
+    template struct  \
+    SPMV<const MAT_SCALAR_TYPE, \
+         const ORDINAL_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, \
+         const OFFSET_TYPE, \
+         VEC_SCALAR_TYPE const*, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged|Kokkos::RandomAccess>, \
+         VEC_SCALAR_TYPE*, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, false, true >;
+
+#define KOKKOSSPARSE_SPMV_MV_MIXED_ETI_SPEC_DECL( MAT_SCALAR_TYPE, VEC_SCALAR_TYPE, ORDINAL_TYPE, OFFSET_TYPE, LAYOUT_TYPE, EXEC_SPACE_TYPE, MEM_SPACE_TYPE ) \
+    extern template struct  \
+    SPMV_MV<const MAT_SCALAR_TYPE, \
+         const ORDINAL_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, \
+         const OFFSET_TYPE, \
+         VEC_SCALAR_TYPE const**, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged|Kokkos::RandomAccess>, \
+         VEC_SCALAR_TYPE**, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, false, false, true >;
+
+#define KOKKOSSPARSE_SPMV_MV_MIXED_ETI_SPEC_INST( MAT_SCALAR_TYPE, VEC_SCALAR_TYPE, ORDINAL_TYPE, OFFSET_TYPE, LAYOUT_TYPE, EXEC_SPACE_TYPE, MEM_SPACE_TYPE ) \
+    template struct  \
+    SPMV_MV<const MAT_SCALAR_TYPE, \
+         const ORDINAL_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, \
+         const OFFSET_TYPE, \
+         VEC_SCALAR_TYPE const**, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged|Kokkos::RandomAccess>, \
+         VEC_SCALAR_TYPE**, \
+         LAYOUT_TYPE, \
+         Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>, \
+         Kokkos::MemoryTraits<Kokkos::Unmanaged>, false, false, true >;
+
 #include<KokkosSparse_spmv_tpl_spec_decl.hpp>
 #include<generated_specializations_hpp/KokkosSparse_spmv_eti_spec_decl.hpp>
 #include<generated_specializations_hpp/KokkosSparse_spmv_mv_eti_spec_decl.hpp>
+#include<generated_specializations_hpp/KokkosSparse_spmv_mixed_eti_spec_decl.hpp>
+#include<generated_specializations_hpp/KokkosSparse_spmv_mv_mixed_eti_spec_decl.hpp>
 
 #endif // KOKKOSSPARSE_IMPL_SPMV_SPEC_HPP_
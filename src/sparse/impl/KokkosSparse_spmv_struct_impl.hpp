@@ -1215,6 +1215,375 @@ struct SPMV_MV_Struct_LayoutLeft_Functor {
   }
 };
 
+// Functor for implementing no-transpose and conjugate structured
+// sparse matrix-vector multiply with multivector (2-D View) input and
+// output, in either LayoutLeft or LayoutRight.  Interior rows use the
+// grid stencil offsets instead of A's column indices, and each vector
+// lane accumulates a block of columns of x in registers so that every
+// matrix entry is loaded once per block.  Boundary rows are handled as
+// general CRS rows with the same column blocking.
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate>
+struct SPMV_MV_Struct_Functor {
+  typedef typename AMatrix::non_const_size_type        size_type;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_value_type       value_type;
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<value_type>     ATV;
+  using y_value_type = typename YVector::non_const_value_type;
+
+  // Tags to perform SPMV on interior and boundaries
+  struct interiorTag{};
+  struct exteriorTag{};
+
+  // Largest supported stencil (3D FE discretization)
+  static constexpr int max_stencil_size = 27;
+
+  // Classic spmv params
+  const y_value_type alpha;
+  AMatrix  m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+
+  // Additional structured spmv params
+  int numDimensions = 0;
+  ordinal_type ni = 0, nj = 0, nk = 0;
+  ordinal_type numInterior = 0, numExterior = 0;
+  ordinal_type numVecs = 0;
+  int stencil_size = 0;
+  ordinal_type columnOffsets[max_stencil_size];
+  const int64_t rows_per_team;
+  const int64_t rows_per_team_ext;
+
+  SPMV_MV_Struct_Functor (const Kokkos::View<ordinal_type*, Kokkos::HostSpace> structure_,
+                          const int stencil_type_,
+                          const y_value_type alpha_,
+                          const AMatrix m_A_,
+                          const XVector m_x_,
+                          const y_value_type beta_,
+                          const YVector m_y_,
+                          const int64_t rows_per_team_,
+                          const int64_t rows_per_team_ext_) :
+    alpha (alpha_), m_A (m_A_), m_x (m_x_),
+    beta (beta_), m_y (m_y_),
+    numVecs (static_cast<ordinal_type>(m_x_.extent(1))),
+    rows_per_team (rows_per_team_),
+    rows_per_team_ext (rows_per_team_ext_)
+  {
+    static_assert (static_cast<int> (XVector::rank) == 2,
+                   "XVector must be a rank 2 View.");
+    static_assert (static_cast<int> (YVector::rank) == 2,
+                   "YVector must be a rank 2 View.");
+
+    numDimensions = structure_.extent(0);
+    if(numDimensions == 1) {
+      ni = static_cast<ordinal_type>(structure_(0));
+      numInterior = ni - 2;
+      numExterior = 2;
+      for(ordinal_type di = -1; di < 2; ++di) {
+        columnOffsets[stencil_size++] = di;
+      }
+    } else if(numDimensions == 2) {
+      ni = static_cast<ordinal_type>(structure_(0));
+      nj = static_cast<ordinal_type>(structure_(1));
+      numInterior = (ni - 2)*(nj - 2);
+      numExterior = 2*(nj + ni - 2);
+      // Offsets are listed in increasing column order, matching the
+      // storage order of the interior rows.
+      for(ordinal_type dj = -1; dj < 2; ++dj) {
+        for(ordinal_type di = -1; di < 2; ++di) {
+          if((stencil_type_ == 2) || (dj == 0) || (di == 0)) {
+            columnOffsets[stencil_size++] = dj*ni + di;
+          }
+        }
+      }
+    } else if(numDimensions == 3) {
+      ni = static_cast<ordinal_type>(structure_(0));
+      nj = static_cast<ordinal_type>(structure_(1));
+      nk = static_cast<ordinal_type>(structure_(2));
+      numInterior = (ni - 2)*(nj - 2)*(nk - 2);
+      numExterior = ni*nj*nk - numInterior;
+      for(ordinal_type dk = -1; dk < 2; ++dk) {
+        for(ordinal_type dj = -1; dj < 2; ++dj) {
+          for(ordinal_type di = -1; di < 2; ++di) {
+            const int numZeros = (dk == 0) + (dj == 0) + (di == 0);
+            if((stencil_type_ == 2) || (numZeros >= 2)) {
+              columnOffsets[stencil_size++] = dk*ni*nj + dj*ni + di;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void compute_interior(const int64_t worksets, const int team_size, const int vector_length) {
+    if(numInterior > 0) {
+      Kokkos::TeamPolicy<interiorTag,
+                         execution_space,
+                         Kokkos::Schedule<Kokkos::Static> > policy(1,1);
+      if(team_size < 0) {
+        policy = Kokkos::TeamPolicy<interiorTag, execution_space, Kokkos::Schedule<Kokkos::Static> >(worksets,Kokkos::AUTO,vector_length);
+      } else {
+        policy = Kokkos::TeamPolicy<interiorTag, execution_space, Kokkos::Schedule<Kokkos::Static> >(worksets,team_size,vector_length);
+      }
+      Kokkos::parallel_for("KokkosSparse::spmv_struct<MV,NoTranspose,Static>: interior", policy, *this);
+    }
+  } // compute_interior
+
+  void compute_exterior(const int64_t worksets, const int team_size, const int vector_length) {
+    if(numExterior > 0) {
+      Kokkos::TeamPolicy<exteriorTag,
+                         execution_space,
+                         Kokkos::Schedule<Kokkos::Static> > policy(1,1);
+      if(team_size < 0) {
+        policy = Kokkos::TeamPolicy<exteriorTag, execution_space, Kokkos::Schedule<Kokkos::Static> >(worksets,Kokkos::AUTO,vector_length);
+      } else {
+        policy = Kokkos::TeamPolicy<exteriorTag, execution_space, Kokkos::Schedule<Kokkos::Static> >(worksets,team_size,vector_length);
+      }
+      Kokkos::parallel_for("KokkosSparse::spmv_struct<MV,NoTranspose,Static>: exterior", policy, *this);
+    }
+  } // compute_exterior
+
+  KOKKOS_INLINE_FUNCTION
+  ordinal_type interior_row (const ordinal_type interiorIdx) const
+  {
+    if(numDimensions == 1) {
+      return interiorIdx + 1;
+    } else if(numDimensions == 2) {
+      const ordinal_type j = interiorIdx / (ni - 2);
+      const ordinal_type i = interiorIdx % (ni - 2);
+      return (j + 1)*ni + i + 1;
+    }
+    const ordinal_type k   = interiorIdx / ((ni - 2)*(nj - 2));
+    const ordinal_type rem = interiorIdx % ((ni - 2)*(nj - 2));
+    const ordinal_type j   = rem / (ni - 2);
+    const ordinal_type i   = rem % (ni - 2);
+    return (k + 1)*nj*ni + (j + 1)*ni + (i + 1);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  ordinal_type exterior_row (const ordinal_type exteriorIdx) const
+  {
+    ordinal_type rowIdx = 0;
+    if(numDimensions == 1) {
+      rowIdx = exteriorIdx*(ni - 1);
+    } else if(numDimensions == 2) {
+      const ordinal_type topFlag = exteriorIdx / (ni + 2*nj - 4);
+      const ordinal_type bottomFlag = static_cast<ordinal_type>((exteriorIdx / ni) == 0);
+      if(bottomFlag == 1) {
+        rowIdx = exteriorIdx;
+      } else if(topFlag == 1) {
+        rowIdx = exteriorIdx - (ni + 2*nj - 4) + ni*(nj - 1);
+      } else {
+        ordinal_type edgeIdx = (exteriorIdx - ni) / 2;
+        ordinal_type edgeFlg = (exteriorIdx - ni) % 2;
+        rowIdx = (edgeIdx + 1)*ni + edgeFlg*(ni - 1);
+      }
+    } else {
+      const ordinal_type topFlag = static_cast<ordinal_type>(numExterior - exteriorIdx - 1 < ni*nj);
+      const ordinal_type bottomFlag = static_cast<ordinal_type>(exteriorIdx / (ni*nj) == 0);
+      if(bottomFlag == 1) {
+        rowIdx = exteriorIdx;
+      } else if(topFlag == 1) {
+        rowIdx = exteriorIdx - ni*nj - 2*(nk - 2)*(nj + ni - 2) + (nk - 1)*ni*nj;
+      } else {
+        ordinal_type k   = (exteriorIdx - ni*nj) / (2*(ni - 1 + nj - 1));
+        ordinal_type rem = (exteriorIdx - ni*nj) % (2*(ni - 1 + nj - 1));
+        if(rem < ni) {
+          rowIdx = (k + 1)*ni*nj + rem;
+        } else if(rem < ni + 2*(nj - 2)) {
+          ordinal_type edgeIdx = (rem - ni) / 2;
+          ordinal_type edgeFlg = (rem - ni) % 2;
+          if(edgeFlg == 0) {
+            rowIdx = (k + 1)*ni*nj + (edgeIdx + 1)*ni;
+          } else {
+            rowIdx = (k + 1)*ni*nj + (edgeIdx + 2)*ni - 1;
+          }
+        } else {
+          rowIdx = (k + 1)*ni*nj + rem - ni - 2*(nj - 2) + (nj - 1)*ni;
+        }
+      }
+    }
+    return rowIdx;
+  }
+
+  // Compute columns [kk, kk + UNROLL) of row rowIdx.  When structured
+  // is true the column indices come from the stencil offsets.
+  template<int UNROLL, bool structured>
+  KOKKOS_INLINE_FUNCTION void
+  strip_mine (const ordinal_type rowIdx, const ordinal_type kk) const
+  {
+    const size_type rowOffset = m_A.graph.row_map(rowIdx);
+    const ordinal_type row_length = structured ? static_cast<ordinal_type>(stencil_size)
+      : static_cast<ordinal_type>(m_A.graph.row_map(rowIdx + 1) - rowOffset);
+
+    y_value_type sum[UNROLL];
+#ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
+#pragma unroll
+#endif
+    for (int k = 0; k < UNROLL; ++k) {
+      sum[k] = Kokkos::Details::ArithTraits<y_value_type>::zero ();
+    }
+
+    for(ordinal_type idx = 0; idx < row_length; ++idx) {
+      const value_type val = conjugate ? ATV::conj(m_A.values(rowOffset + idx)) : m_A.values(rowOffset + idx);
+      const ordinal_type colIdx = structured ? rowIdx + columnOffsets[idx]
+        : m_A.graph.entries(rowOffset + idx);
+#ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
+#pragma unroll
+#endif
+      for (int k = 0; k < UNROLL; ++k) {
+        sum[k] += val * m_x(colIdx, kk + k);
+      }
+    }
+
+#ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
+#pragma unroll
+#endif
+    for (int k = 0; k < UNROLL; ++k) {
+      if (dobeta == 0) {
+        m_y(rowIdx, kk + k) = alpha*sum[k];
+      } else if (dobeta == 1) {
+        m_y(rowIdx, kk + k) += alpha*sum[k];
+      } else if (dobeta == -1) {
+        m_y(rowIdx, kk + k) = -m_y(rowIdx, kk + k) + alpha*sum[k];
+      } else {
+        m_y(rowIdx, kk + k) = beta*m_y(rowIdx, kk + k) + alpha*sum[k];
+      }
+    }
+  }
+
+  // Blocks of 8 columns are spread over the vector lanes, the remaining
+  // columns are done as one block of 4 and then one column per lane.
+  template<bool structured>
+  KOKKOS_INLINE_FUNCTION void
+  multiply_row (const team_member& dev, const ordinal_type rowIdx) const
+  {
+    const ordinal_type numBlocks = numVecs / 8;
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange(dev, numBlocks), [&] (const ordinal_type& blockIdx) {
+        strip_mine<8, structured>(rowIdx, 8*blockIdx);
+      });
+
+    ordinal_type kk = 8*numBlocks;
+    if(numVecs - kk >= 4) {
+      Kokkos::single(Kokkos::PerThread(dev), [&] () {
+          strip_mine<4, structured>(rowIdx, kk);
+        });
+      kk += 4;
+    }
+
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange(dev, kk, numVecs), [&] (const ordinal_type& vecIdx) {
+        strip_mine<1, structured>(rowIdx, vecIdx);
+      });
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const interiorTag&, const team_member& dev) const
+  {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(dev, 0, rows_per_team), [&] (const ordinal_type& loop) {
+        const ordinal_type interiorIdx = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+        if(interiorIdx >= numInterior) { return; }
+
+        multiply_row<true>(dev, interior_row(interiorIdx));
+      });
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const exteriorTag&, const team_member& dev) const
+  {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(dev, 0, rows_per_team_ext), [&] (const ordinal_type& loop) {
+        const ordinal_type exteriorIdx = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team_ext + loop;
+        if(exteriorIdx >= numExterior) { return; }
+
+        multiply_row<false>(dev, exterior_row(exteriorIdx));
+      });
+  }
+}; // SPMV_MV_Struct_Functor
+
+// Check that structure describes a 1D, 2D or 3D grid of numRows points
+// with a stencil the structured kernels know about.
+template<class ordinal_type>
+bool spmv_struct_is_stencil (const int stencil_type,
+                             const Kokkos::View<ordinal_type*, Kokkos::HostSpace>& structure,
+                             const int64_t numRows)
+{
+  const int numDimensions = static_cast<int>(structure.extent(0));
+  if((numDimensions < 1) || (numDimensions > 3)) { return false; }
+  if((numDimensions > 1) && (stencil_type != 1) && (stencil_type != 2)) { return false; }
+
+  int64_t numPoints = 1;
+  for(int dim = 0; dim < numDimensions; ++dim) {
+    if(structure(dim) < 2) { return false; }
+    numPoints *= static_cast<int64_t>(structure(dim));
+  }
+  return numPoints == numRows;
+}
+
+template<class AMatrix,
+         class XVector,
+         class YVector,
+         int dobeta,
+         bool conjugate>
+static void
+spmv_mv_struct_beta_no_transpose (const int stencil_type,
+                                  const Kokkos::View<typename AMatrix::non_const_ordinal_type*, Kokkos::HostSpace>& structure,
+                                  typename YVector::const_value_type& alpha,
+                                  const AMatrix& A,
+                                  const XVector& x,
+                                  typename YVector::const_value_type& beta,
+                                  const YVector& y)
+{
+  typedef typename AMatrix::ordinal_type ordinal_type;
+  typedef typename AMatrix::execution_space execution_space;
+  if (A.numRows () <= static_cast<ordinal_type> (0)) {
+    return;
+  }
+
+  typedef SPMV_MV_Struct_Functor<AMatrix,XVector,YVector,dobeta,conjugate> OpType;
+  OpType op_sizes(structure, stencil_type, alpha, A, x, beta, y, 1, 1);
+
+  // One vector lane per block of 8 columns on GPUs, the blocks are
+  // simply looped over on CPUs.
+  int vector_length = 1;
+  if(KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+    while((vector_length < 8) && (8*vector_length < static_cast<int64_t>(x.extent(1)))) vector_length *= 2;
+  }
+
+  int team_size_int = -1;
+  int team_size_ext = -1;
+  int64_t rows_per_thread_int = -1;
+  int64_t rows_per_thread_ext = -1;
+  const int64_t numInteriorPts = op_sizes.numInterior > 0 ? op_sizes.numInterior : 0;
+  const int64_t numExteriorPts = op_sizes.numExterior;
+
+  int64_t rows_per_team_int = spmv_struct_launch_parameters<execution_space>(numInteriorPts,
+                                                                             A.nnz(),
+                                                                             op_sizes.stencil_size,
+                                                                             rows_per_thread_int,
+                                                                             team_size_int,
+                                                                             vector_length);
+  int64_t worksets_interior = (numInteriorPts + rows_per_team_int - 1) / rows_per_team_int;
+
+  int64_t rows_per_team_ext = spmv_struct_launch_parameters<execution_space>(numExteriorPts,
+                                                                             A.nnz(),
+                                                                             op_sizes.stencil_size,
+                                                                             rows_per_thread_ext,
+                                                                             team_size_ext,
+                                                                             vector_length);
+  int64_t worksets_exterior = (numExteriorPts + rows_per_team_ext - 1) / rows_per_team_ext;
+
+  OpType spmv_mv_struct(structure, stencil_type, alpha, A, x, beta, y, rows_per_team_int, rows_per_team_ext);
+
+  spmv_mv_struct.compute_interior(worksets_interior, team_size_int, vector_length);
+  spmv_mv_struct.compute_exterior(worksets_exterior, team_size_ext, vector_length);
+} // spmv_mv_struct_beta_no_transpose
+
 
   template<class AMatrix,
            class XVector,
@@ -1223,7 +1592,9 @@ struct SPMV_MV_Struct_LayoutLeft_Functor {
            int dobeta,
            bool conjugate>
   static void
-  spmv_alpha_beta_mv_struct_no_transpose (const typename YVector::non_const_value_type& alpha,
+  spmv_alpha_beta_mv_struct_no_transpose (const int stencil_type,
+                                          const Kokkos::View<typename AMatrix::non_const_ordinal_type*, Kokkos::HostSpace>& structure,
+                                          const typename YVector::non_const_value_type& alpha,
                                           const AMatrix& A,
                                           const XVector& x,
                                           const typename YVector::non_const_value_type& beta,
@@ -1240,6 +1611,10 @@ struct SPMV_MV_Struct_LayoutLeft_Functor {
       }
       return;
     }
+    else if (spmv_struct_is_stencil(stencil_type, structure, A.numRows ())) {
+      spmv_mv_struct_beta_no_transpose<AMatrix, XVector, YVector, dobeta, conjugate>
+        (stencil_type, structure, alpha, A, x, beta, y);
+    }
     else {
       typedef typename AMatrix::size_type size_type;
 
@@ -1383,6 +1758,8 @@ struct SPMV_MV_Struct_LayoutLeft_Functor {
            int dobeta>
   static void
   spmv_alpha_beta_mv_struct (const char mode[],
+                             const int stencil_type,
+                             const Kokkos::View<typename AMatrix::non_const_ordinal_type*, Kokkos::HostSpace>& structure,
                              const typename YVector::non_const_value_type& alpha,
                              const AMatrix& A,
                              const XVector& x,
@@ -1390,10 +1767,10 @@ struct SPMV_MV_Struct_LayoutLeft_Functor {
                              const YVector& y)
   {
     if (mode[0] == NoTranspose[0]) {
-      spmv_alpha_beta_mv_struct_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, false> (alpha, A, x, beta, y);
+      spmv_alpha_beta_mv_struct_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, false> (stencil_type, structure, alpha, A, x, beta, y);
     }
     else if (mode[0] == Conjugate[0]) {
-      spmv_alpha_beta_mv_struct_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, true> (alpha, A, x, beta, y);
+      spmv_alpha_beta_mv_struct_no_transpose<AMatrix, XVector, YVector, doalpha, dobeta, true> (stencil_type, structure, alpha, A, x, beta, y);
     }
     else if (mode[0] == Transpose[0]) {
       spmv_alpha_beta_mv_struct_transpose<AMatrix, XVector, YVector, doalpha, dobeta, false> (alpha, A, x, beta, y);
@@ -1412,6 +1789,8 @@ struct SPMV_MV_Struct_LayoutLeft_Functor {
            int doalpha>
   void
   spmv_alpha_mv_struct (const char mode[],
+                        const int stencil_type,
+                        const Kokkos::View<typename AMatrix::non_const_ordinal_type*, Kokkos::HostSpace>& structure,
                         const typename YVector::non_const_value_type& alpha,
                         const AMatrix& A,
                         const XVector& x,
@@ -1422,16 +1801,16 @@ struct SPMV_MV_Struct_LayoutLeft_Functor {
     typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
 
     if (beta == KAT::zero ()) {
-      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, 0> (mode, alpha, A, x, beta, y);
+      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, 0> (mode, stencil_type, structure, alpha, A, x, beta, y);
     }
     else if (beta == KAT::one ()) {
-      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, 1> (mode, alpha, A, x, beta, y);
+      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, 1> (mode, stencil_type, structure, alpha, A, x, beta, y);
     }
     else if (beta == -KAT::one ()) {
-      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, -1> (mode, alpha, A, x, beta, y);
+      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, -1> (mode, stencil_type, structure, alpha, A, x, beta, y);
     }
     else {
-      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, 2> (mode, alpha, A, x, beta, y);
+      spmv_alpha_beta_mv_struct<AMatrix, XVector, YVector, doalpha, 2> (mode, stencil_type, structure, alpha, A, x, beta, y);
     }
   }
 
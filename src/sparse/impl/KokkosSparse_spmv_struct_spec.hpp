@@ -225,6 +225,8 @@ namespace KokkosSparse {
 
       static void
       spmv_mv_struct (const char mode[],
+                      const int stencil_type,
+                      const Kokkos::View<typename AMatrix::non_const_ordinal_type*, Kokkos::HostSpace>& structure,
                       const coefficient_type& alpha,
                       const AMatrix& A,
                       const XVector& x,
@@ -304,6 +306,8 @@ namespace KokkosSparse {
 
       static void
       spmv_mv_struct (const char mode[],
+                      const int stencil_type,
+                      const Kokkos::View<typename AMatrix::non_const_ordinal_type*, Kokkos::HostSpace>& structure,
                       const coefficient_type& alpha,
                       const AMatrix& A,
                       const XVector& x,
@@ -313,16 +317,16 @@ namespace KokkosSparse {
         typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
 
         if (alpha == KAT::zero ()) {
-          spmv_alpha_mv_struct<AMatrix, XVector, YVector, 0> (mode, alpha, A, x, beta, y);
+          spmv_alpha_mv_struct<AMatrix, XVector, YVector, 0> (mode, stencil_type, structure, alpha, A, x, beta, y);
         }
         else if (alpha == KAT::one ()) {
-          spmv_alpha_mv_struct<AMatrix, XVector, YVector, 1> (mode, alpha, A, x, beta, y);
+          spmv_alpha_mv_struct<AMatrix, XVector, YVector, 1> (mode, stencil_type, structure, alpha, A, x, beta, y);
         }
         else if (alpha == -KAT::one ()) {
-          spmv_alpha_mv_struct<AMatrix, XVector, YVector, -1> (mode, alpha, A, x, beta, y);
+          spmv_alpha_mv_struct<AMatrix, XVector, YVector, -1> (mode, stencil_type, structure, alpha, A, x, beta, y);
         }
         else {
-          spmv_alpha_mv_struct<AMatrix, XVector, YVector, 2> (mode, alpha, A, x, beta, y);
+          spmv_alpha_mv_struct<AMatrix, XVector, YVector, 2> (mode, stencil_type, structure, alpha, A, x, beta, y);
         }
       }
     };
@@ -342,6 +346,8 @@ namespace KokkosSparse {
 
       static void
       spmv_mv_struct (const char mode[],
+                      const int stencil_type,
+                      const Kokkos::View<typename AMatrix::non_const_ordinal_type*, Kokkos::HostSpace>& structure,
                       const coefficient_type& alpha,
                       const AMatrix& A,
                       const XVector& x,
@@ -356,7 +362,7 @@ namespace KokkosSparse {
         for (typename AMatrix::non_const_size_type j = 0; j < x.extent(1); ++j) {
           auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
           auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
-          impl_type::spmv_struct (mode, alpha, A, x_j, beta, y_j);
+          impl_type::spmv_struct (mode, stencil_type, structure, alpha, A, x_j, beta, y_j);
         }
       }
     };
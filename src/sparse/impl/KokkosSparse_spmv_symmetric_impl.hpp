@@ -0,0 +1,633 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_SYMMETRIC_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_SYMMETRIC_HPP_
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+#include "KokkosBlas1_scal.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Symmetric (or Hermitian) SpMV from one stored triangle.  Every
+// stored entry (i,j) with i != j contributes A(i,j)*x(j) to y(i) and
+// A(j,i)*x(i) = A(i,j)*x(i) (conj(A(i,j)) for Hermitian) to y(j);
+// diagonal entries contribute once.  The mirrored updates of different
+// rows collide on y(j), which the kernels below resolve either with
+// per-block partial results (host) or atomics (GPU).
+
+/// \brief Index range [lo, hi) of y that the rows in block b may touch.
+template<class AMatrix, class BlockView>
+struct SPMV_SymmetricRange_Functor {
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+
+  AMatrix m_A;
+  BlockView block_start;
+  BlockView range_lo;
+  BlockView range_hi;
+
+  SPMV_SymmetricRange_Functor (const AMatrix& A_, const BlockView& block_start_,
+                               const BlockView& range_lo_, const BlockView& range_hi_) :
+    m_A (A_), block_start (block_start_), range_lo (range_lo_), range_hi (range_hi_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type b) const
+  {
+    const ordinal_type start = block_start(b);
+    const ordinal_type end = block_start(b + 1);
+    ordinal_type lo = start;
+    ordinal_type hi = end;
+    for (ordinal_type iRow = start; iRow < end; ++iRow) {
+      const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+      for (ordinal_type iEntry = 0; iEntry < static_cast<ordinal_type> (row.length); ++iEntry) {
+        const ordinal_type j = row.colidx(iEntry);
+        if (j < lo) lo = j;
+        if (j + 1 > hi) hi = j + 1;
+      }
+    }
+    range_lo(b) = lo;
+    range_hi(b) = hi;
+  }
+};
+
+/// \brief First pass of the host kernel: each block of rows runs
+///   sequentially and writes its own rows' sums, as well as mirrored
+///   updates that land inside the block, to z.  Mirrored updates that
+///   land outside the block go to the block's private slice of buf.
+///   No two blocks write the same entry, so no atomics are needed.
+template<class AMatrix, class XVector, class ZVector, class BlockView, class OffsetView, bool hermitian>
+struct SPMV_SymmetricBlock_Functor {
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_value_type   A_value_type;
+  typedef typename ZVector::non_const_value_type   y_value_type;
+  typedef Kokkos::Details::ArithTraits<A_value_type> ATV;
+  typedef Kokkos::Details::ArithTraits<y_value_type> ATY;
+
+  AMatrix m_A;
+  XVector m_x;
+  ZVector m_z;
+  ZVector m_buf;
+  BlockView block_start;
+  BlockView range_lo;
+  OffsetView buf_ptr;
+
+  SPMV_SymmetricBlock_Functor (const AMatrix& A_, const XVector& x_, const ZVector& z_, const ZVector& buf_,
+                               const BlockView& block_start_, const BlockView& range_lo_,
+                               const OffsetView& buf_ptr_) :
+    m_A (A_), m_x (x_), m_z (z_), m_buf (buf_),
+    block_start (block_start_), range_lo (range_lo_), buf_ptr (buf_ptr_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type b) const
+  {
+    const ordinal_type start = block_start(b);
+    const ordinal_type end = block_start(b + 1);
+    const ordinal_type lo = range_lo(b);
+    const size_t offset = buf_ptr(b);
+
+    for (ordinal_type iRow = start; iRow < end; ++iRow) {
+      const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+      const y_value_type x_i = m_x(iRow);
+      y_value_type sum = ATY::zero ();
+
+      for (ordinal_type iEntry = 0; iEntry < static_cast<ordinal_type> (row.length); ++iEntry) {
+        const ordinal_type j = row.colidx(iEntry);
+        const A_value_type val = row.value(iEntry);
+        sum += static_cast<y_value_type> (val) * m_x(j);
+        if (j != iRow) {
+          const y_value_type mirrored =
+            static_cast<y_value_type> (hermitian ? ATV::conj (val) : val) * x_i;
+          if (start <= j && j < end)
+            m_z(j) += mirrored;
+          else
+            m_buf(offset + static_cast<size_t> (j - lo)) += mirrored;
+        }
+      }
+      m_z(iRow) += sum;
+    }
+  }
+};
+
+/// \brief Second pass of the host kernel: y(i) := beta*y(i) +
+///   alpha*(z(i) + partial results of the other blocks for row i).
+///
+/// The rows are cut into segments on which the set of blocks whose
+/// buffers cover the row does not change; seg_blocks lists, for each
+/// segment, the blocks other than the row's own one.  A row only visits
+/// the blocks of its segment, instead of testing every block.
+template<class YVector, class ZVector, class OrdinalView, class OffsetView, int dobeta>
+struct SPMV_SymmetricReduce_Functor {
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef typename OrdinalView::non_const_value_type ordinal_type;
+
+  const y_value_type alpha;
+  const y_value_type beta;
+  YVector m_y;
+  ZVector m_z;
+  ZVector m_buf;
+  OrdinalView range_lo;
+  OffsetView buf_ptr;
+  OrdinalView seg_start;
+  OffsetView seg_ptr;
+  OrdinalView seg_blocks;
+  const ordinal_type num_segs;
+
+  SPMV_SymmetricReduce_Functor (const y_value_type alpha_, const y_value_type beta_,
+                                const YVector& y_, const ZVector& z_, const ZVector& buf_,
+                                const OrdinalView& range_lo_, const OffsetView& buf_ptr_,
+                                const OrdinalView& seg_start_, const OffsetView& seg_ptr_,
+                                const OrdinalView& seg_blocks_) :
+    alpha (alpha_), beta (beta_), m_y (y_), m_z (z_), m_buf (buf_),
+    range_lo (range_lo_), buf_ptr (buf_ptr_),
+    seg_start (seg_start_), seg_ptr (seg_ptr_), seg_blocks (seg_blocks_),
+    num_segs (static_cast<ordinal_type> (seg_start_.extent(0)) - 1) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const ordinal_type iRow) const
+  {
+    // last segment starting at or before iRow.
+    ordinal_type lo = 0, hi = num_segs;
+    while (hi - lo > 1) {
+      const ordinal_type mid = (lo + hi) / 2;
+      if (seg_start(mid) <= iRow) lo = mid;
+      else hi = mid;
+    }
+    y_value_type sum = m_z(iRow);
+    for (size_t p = seg_ptr(lo); p < static_cast<size_t> (seg_ptr(lo + 1)); ++p) {
+      const ordinal_type b = seg_blocks(p);
+      sum += m_buf(static_cast<size_t> (buf_ptr(b)) + static_cast<size_t> (iRow - range_lo(b)));
+    }
+    if (dobeta == 0)
+      m_y(iRow) = alpha * sum;
+    else
+      m_y(iRow) = beta * m_y(iRow) + alpha * sum;
+  }
+};
+
+/// \brief GPU kernel: y has already been scaled by beta; each row adds
+///   alpha*(its row sum) to y(i) and its mirrored updates to y(j)
+///   with atomics.
+template<class AMatrix, class XVector, class YVector, bool hermitian>
+struct SPMV_SymmetricAtomic_Functor {
+  typedef typename AMatrix::execution_space            execution_space;
+  typedef typename AMatrix::non_const_ordinal_type     ordinal_type;
+  typedef typename AMatrix::non_const_value_type       A_value_type;
+  typedef typename YVector::non_const_value_type       y_value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type            team_member;
+  typedef Kokkos::Details::ArithTraits<A_value_type>   ATV;
+  typedef Kokkos::Details::ArithTraits<y_value_type>   ATY;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  YVector m_y;
+  const ordinal_type rows_per_team;
+
+  SPMV_SymmetricAtomic_Functor (const y_value_type alpha_, const AMatrix& A_,
+                                const XVector& x_, const YVector& y_,
+                                const ordinal_type rows_per_team_) :
+    alpha (alpha_), m_A (A_), m_x (x_), m_y (y_), rows_per_team (rows_per_team_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator() (const team_member& dev) const
+  {
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(dev,0,rows_per_team), [&] (const ordinal_type& loop) {
+      const ordinal_type iRow = static_cast<ordinal_type> ( dev.league_rank() ) * rows_per_team + loop;
+      if (iRow >= m_A.numRows ()) {
+        return;
+      }
+      const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+      const ordinal_type row_length = static_cast<ordinal_type> (row.length);
+      const y_value_type alpha_x_i = alpha * static_cast<y_value_type> (m_x(iRow));
+      y_value_type sum = ATY::zero ();
+
+      Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(dev,row_length), [&] (const ordinal_type& iEntry, y_value_type& lsum) {
+        const ordinal_type j = row.colidx(iEntry);
+        const A_value_type val = row.value(iEntry);
+        lsum += static_cast<y_value_type> (val) * m_x(j);
+        if (j != iRow) {
+          Kokkos::atomic_add (&m_y(j), static_cast<y_value_type> (hermitian ? ATV::conj (val) : val) * alpha_x_i);
+        }
+      },sum);
+
+      Kokkos::single(Kokkos::PerThread(dev), [&] () {
+        Kokkos::atomic_add (&m_y(iRow), alpha * sum);
+      });
+    });
+  }
+};
+
+/// \brief Build the partition of the host kernel: nnz-balanced
+///   contiguous row blocks, one per thread, the start of each block's
+///   range of y in its private buffer, and the segments of rows used
+///   by the reduce.  Depends only on the graph of A.
+///
+/// \return The total size of the private buffers.
+template<class AMatrix, class OrdinalView, class OffsetView>
+size_t spmv_symmetric_partition (const AMatrix& A,
+                                 OrdinalView& block_start,
+                                 OrdinalView& range_lo,
+                                 OffsetView& buf_ptr,
+                                 OrdinalView& seg_start,
+                                 OffsetView& seg_ptr,
+                                 OrdinalView& seg_blocks)
+{
+  typedef typename AMatrix::execution_space             execution_space;
+  typedef typename OrdinalView::non_const_value_type    ordinal_type;
+  typedef typename OffsetView::non_const_value_type     offset_type;
+
+  const ordinal_type nrows = A.numRows ();
+  const ordinal_type num_blocks =
+    std::max (ordinal_type (1), std::min (static_cast<ordinal_type> (execution_space::concurrency ()), nrows));
+
+  block_start = OrdinalView ("KokkosSparse::spmv_symmetric block_start", num_blocks + 1);
+  auto h_block_start = Kokkos::create_mirror_view (block_start);
+  {
+    auto row_map = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), A.graph.row_map);
+    const double nnz_per_block = static_cast<double> (A.nnz ()) / num_blocks;
+    h_block_start(0) = 0;
+    for (ordinal_type b = 1; b < num_blocks; ++b) {
+      const auto target = static_cast<typename AMatrix::non_const_size_type> (b * nnz_per_block);
+      const auto it = std::upper_bound (row_map.data (), row_map.data () + nrows + 1, target);
+      const ordinal_type r = static_cast<ordinal_type> (it - row_map.data ()) - 1;
+      h_block_start(b) = std::max (h_block_start(b - 1), std::min (r, nrows));
+    }
+    h_block_start(num_blocks) = nrows;
+    Kokkos::deep_copy (block_start, h_block_start);
+  }
+
+  range_lo = OrdinalView ("KokkosSparse::spmv_symmetric range_lo", num_blocks);
+  OrdinalView range_hi ("KokkosSparse::spmv_symmetric range_hi", num_blocks);
+  Kokkos::parallel_for ("KokkosSparse::spmv_symmetric<range>",
+                        Kokkos::RangePolicy<execution_space> (0, num_blocks),
+                        SPMV_SymmetricRange_Functor<AMatrix, OrdinalView> (A, block_start, range_lo, range_hi));
+  auto h_lo = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), range_lo);
+  auto h_hi = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), range_hi);
+
+  buf_ptr = OffsetView ("KokkosSparse::spmv_symmetric buf_ptr", num_blocks + 1);
+  auto h_ptr = Kokkos::create_mirror_view (buf_ptr);
+  h_ptr(0) = 0;
+  for (ordinal_type b = 0; b < num_blocks; ++b)
+    h_ptr(b + 1) = h_ptr(b) + static_cast<offset_type> (h_hi(b) - h_lo(b));
+  Kokkos::deep_copy (buf_ptr, h_ptr);
+
+  // Segments start at every block start and range end point, so each
+  // segment lies entirely inside or outside of every block and range.
+  std::vector<ordinal_type> points;
+  points.reserve (3 * num_blocks + 2);
+  for (ordinal_type b = 0; b <= num_blocks; ++b)
+    points.push_back (h_block_start(b));
+  for (ordinal_type b = 0; b < num_blocks; ++b) {
+    points.push_back (h_lo(b));
+    points.push_back (h_hi(b));
+  }
+  std::sort (points.begin (), points.end ());
+  points.erase (std::unique (points.begin (), points.end ()), points.end ());
+  points.erase (std::remove_if (points.begin (), points.end (),
+                                [nrows] (const ordinal_type p) { return p < 0 || p > nrows; }),
+                points.end ());
+  if (points.size () < 2) {
+    points.assign (1, ordinal_type (0));
+    points.push_back (nrows);
+  }
+  const ordinal_type num_segs = static_cast<ordinal_type> (points.size ()) - 1;
+
+  std::vector<offset_type> h_seg_ptr (1, 0);
+  std::vector<ordinal_type> h_seg_blocks;
+  for (ordinal_type k = 0; k < num_segs; ++k) {
+    const ordinal_type first = points[k];
+    const ordinal_type last = points[k + 1];
+    for (ordinal_type b = 0; b < num_blocks; ++b) {
+      const bool own = (h_block_start(b) <= first) && (first < h_block_start(b + 1));
+      if (!own && h_lo(b) <= first && last <= h_hi(b))
+        h_seg_blocks.push_back (b);
+    }
+    h_seg_ptr.push_back (static_cast<offset_type> (h_seg_blocks.size ()));
+  }
+
+  seg_start = OrdinalView ("KokkosSparse::spmv_symmetric seg_start", num_segs + 1);
+  seg_ptr = OffsetView ("KokkosSparse::spmv_symmetric seg_ptr", num_segs + 1);
+  seg_blocks = OrdinalView ("KokkosSparse::spmv_symmetric seg_blocks", h_seg_blocks.size ());
+  auto h_seg_start = Kokkos::create_mirror_view (seg_start);
+  auto h_seg_ptr_v = Kokkos::create_mirror_view (seg_ptr);
+  auto h_seg_blocks_v = Kokkos::create_mirror_view (seg_blocks);
+  for (ordinal_type k = 0; k <= num_segs; ++k) {
+    h_seg_start(k) = points[k];
+    h_seg_ptr_v(k) = h_seg_ptr[k];
+  }
+  for (size_t p = 0; p < h_seg_blocks.size (); ++p)
+    h_seg_blocks_v(p) = h_seg_blocks[p];
+  Kokkos::deep_copy (seg_start, h_seg_start);
+  Kokkos::deep_copy (seg_ptr, h_seg_ptr_v);
+  Kokkos::deep_copy (seg_blocks, h_seg_blocks_v);
+
+  return static_cast<size_t> (h_ptr(num_blocks));
+}
+
+/// \brief Host kernel on a partition from spmv_symmetric_partition.
+template<class AMatrix, class XVector, class YVector, bool hermitian, class OrdinalView, class OffsetView>
+void spmv_symmetric_host (typename YVector::const_value_type& alpha,
+                          const AMatrix& A,
+                          const XVector& x,
+                          typename YVector::const_value_type& beta,
+                          const YVector& y,
+                          const OrdinalView& block_start,
+                          const OrdinalView& range_lo,
+                          const OffsetView& buf_ptr,
+                          const OrdinalView& seg_start,
+                          const OffsetView& seg_ptr,
+                          const OrdinalView& seg_blocks,
+                          const size_t buf_size)
+{
+  typedef typename AMatrix::execution_space             execution_space;
+  typedef typename AMatrix::device_type                 device_type;
+  typedef typename AMatrix::non_const_ordinal_type      ordinal_type;
+  typedef typename YVector::non_const_value_type        y_value_type;
+  typedef Kokkos::View<y_value_type*, device_type>      work_view_t;
+  typedef Kokkos::Details::ArithTraits<y_value_type>    ATY;
+
+  const ordinal_type nrows = A.numRows ();
+  const ordinal_type num_blocks = static_cast<ordinal_type> (block_start.extent(0)) - 1;
+
+  work_view_t z ("KokkosSparse::spmv_symmetric z", nrows);
+  work_view_t buf ("KokkosSparse::spmv_symmetric partial results", buf_size);
+
+  Kokkos::parallel_for ("KokkosSparse::spmv_symmetric<block>",
+                        Kokkos::RangePolicy<execution_space> (0, num_blocks),
+                        SPMV_SymmetricBlock_Functor<AMatrix, XVector, work_view_t, OrdinalView, OffsetView, hermitian>
+                        (A, x, z, buf, block_start, range_lo, buf_ptr));
+
+  if (beta == ATY::zero ()) {
+    Kokkos::parallel_for ("KokkosSparse::spmv_symmetric<reduce>",
+                          Kokkos::RangePolicy<execution_space> (0, nrows),
+                          SPMV_SymmetricReduce_Functor<YVector, work_view_t, OrdinalView, OffsetView, 0>
+                          (alpha, beta, y, z, buf, range_lo, buf_ptr, seg_start, seg_ptr, seg_blocks));
+  }
+  else {
+    Kokkos::parallel_for ("KokkosSparse::spmv_symmetric<reduce>",
+                          Kokkos::RangePolicy<execution_space> (0, nrows),
+                          SPMV_SymmetricReduce_Functor<YVector, work_view_t, OrdinalView, OffsetView, 2>
+                          (alpha, beta, y, z, buf, range_lo, buf_ptr, seg_start, seg_ptr, seg_blocks));
+  }
+}
+
+/// \brief Host kernel with a partition built for this call only.
+template<class AMatrix, class XVector, class YVector, bool hermitian>
+void spmv_symmetric_host (typename YVector::const_value_type& alpha,
+                          const AMatrix& A,
+                          const XVector& x,
+                          typename YVector::const_value_type& beta,
+                          const YVector& y)
+{
+  typedef typename AMatrix::device_type                 device_type;
+  typedef typename AMatrix::non_const_ordinal_type      ordinal_type;
+  typedef Kokkos::View<ordinal_type*, device_type>      ordinal_view_t;
+  typedef Kokkos::View<size_t*, device_type>            offset_view_t;
+
+  ordinal_view_t block_start, range_lo, seg_start, seg_blocks;
+  offset_view_t buf_ptr, seg_ptr;
+  const size_t buf_size =
+    spmv_symmetric_partition (A, block_start, range_lo, buf_ptr, seg_start, seg_ptr, seg_blocks);
+  spmv_symmetric_host<AMatrix, XVector, YVector, hermitian>
+    (alpha, A, x, beta, y, block_start, range_lo, buf_ptr, seg_start, seg_ptr, seg_blocks, buf_size);
+}
+
+template<class AMatrix, class XVector, class YVector, bool hermitian>
+void spmv_symmetric_atomic (const KokkosKernels::Experimental::Controls& controls,
+                            typename YVector::const_value_type& alpha,
+                            const AMatrix& A,
+                            const XVector& x,
+                            typename YVector::const_value_type& beta,
+                            const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+
+  KokkosBlas::scal (y, beta, y);
+
+  int team_size = -1;
+  int vector_length = -1;
+  int64_t rows_per_thread = -1;
+  if(controls.isParameter("team size"))       {team_size       = std::stoi(controls.getParameter("team size"));}
+  if(controls.isParameter("vector length"))   {vector_length   = std::stoi(controls.getParameter("vector length"));}
+  if(controls.isParameter("rows per thread")) {rows_per_thread = std::stoll(controls.getParameter("rows per thread"));}
+
+  int64_t rows_per_team = spmv_launch_parameters<execution_space>(A.numRows(),A.nnz(),rows_per_thread,team_size,vector_length);
+  int64_t worksets = (A.numRows()+rows_per_team-1)/rows_per_team;
+
+  SPMV_SymmetricAtomic_Functor<AMatrix, XVector, YVector, hermitian> func (alpha, A, x, y, rows_per_team);
+  Kokkos::TeamPolicy<execution_space> policy(1,1);
+  if(team_size<0)
+    policy = Kokkos::TeamPolicy<execution_space>(worksets,Kokkos::AUTO,vector_length);
+  else
+    policy = Kokkos::TeamPolicy<execution_space>(worksets,team_size,vector_length);
+  Kokkos::parallel_for("KokkosSparse::spmv_symmetric<atomic>",policy,func);
+}
+
+/// \brief y := beta*y + alpha*A*x, where A is symmetric (or Hermitian)
+///   and only one triangle of it is stored in \c A.
+template<class AMatrix, class XVector, class YVector>
+void spmv_symmetric (const KokkosKernels::Experimental::Controls& controls,
+                     const bool hermitian,
+                     typename YVector::const_value_type& alpha,
+                     const AMatrix& A,
+                     const XVector& x,
+                     typename YVector::const_value_type& beta,
+                     const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+
+  if (A.numRows () <= 0) {
+    return;
+  }
+  if (alpha == Kokkos::Details::ArithTraits<typename YVector::non_const_value_type>::zero ()) {
+    KokkosBlas::scal (y, beta, y);
+    return;
+  }
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>() ||
+      (controls.isParameter ("algorithm") && controls.getParameter ("algorithm") == "atomic")) {
+    if (hermitian)
+      spmv_symmetric_atomic<AMatrix, XVector, YVector, true> (controls, alpha, A, x, beta, y);
+    else
+      spmv_symmetric_atomic<AMatrix, XVector, YVector, false> (controls, alpha, A, x, beta, y);
+  }
+  else {
+    if (hermitian)
+      spmv_symmetric_host<AMatrix, XVector, YVector, true> (alpha, A, x, beta, y);
+    else
+      spmv_symmetric_host<AMatrix, XVector, YVector, false> (alpha, A, x, beta, y);
+  }
+}
+
+template<class AMatrix, class XVector, class YVector>
+void spmv_symmetric_mv (const KokkosKernels::Experimental::Controls& controls,
+                        const bool hermitian,
+                        typename YVector::const_value_type& alpha,
+                        const AMatrix& A,
+                        const XVector& x,
+                        typename YVector::const_value_type& beta,
+                        const YVector& y,
+                        std::integral_constant<int, 1>)
+{
+  spmv_symmetric (controls, hermitian, alpha, A, x, beta, y);
+}
+
+// Multivectors run the rank-1 kernel column by column.
+template<class AMatrix, class XVector, class YVector>
+void spmv_symmetric_mv (const KokkosKernels::Experimental::Controls& controls,
+                        const bool hermitian,
+                        typename YVector::const_value_type& alpha,
+                        const AMatrix& A,
+                        const XVector& x,
+                        typename YVector::const_value_type& beta,
+                        const YVector& y,
+                        std::integral_constant<int, 2>)
+{
+  for (size_t j = 0; j < y.extent(1); ++j) {
+    auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
+    auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
+    spmv_symmetric (controls, hermitian, alpha, A, x_j, beta, y_j);
+  }
+}
+
+/// \brief Build the partition of the host kernel and keep it in the
+///   SpMV handle.
+template<class SPMVHandleType, class AMatrix>
+void spmv_symmetric_symbolic_impl (SPMVHandleType* handle, const AMatrix& A)
+{
+  typename SPMVHandleType::nnz_lno_view_t block_start, range_lo, seg_start, seg_blocks;
+  typename SPMVHandleType::size_type_view_t buf_ptr, seg_ptr;
+  const size_t buf_size =
+    spmv_symmetric_partition (A, block_start, range_lo, buf_ptr, seg_start, seg_ptr, seg_blocks);
+  handle->set_symmetric_partition (block_start, range_lo, buf_ptr, seg_start, seg_ptr, seg_blocks,
+                                   static_cast<typename SPMVHandleType::size_type> (buf_size));
+}
+
+/// \brief spmv_symmetric with the partition cached in an SpMV handle.
+template<class SPMVHandleType, class AMatrix, class XVector, class YVector>
+void spmv_symmetric (SPMVHandleType* handle,
+                     const bool hermitian,
+                     typename YVector::const_value_type& alpha,
+                     const AMatrix& A,
+                     const XVector& x,
+                     typename YVector::const_value_type& beta,
+                     const YVector& y)
+{
+  typedef typename AMatrix::execution_space execution_space;
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+    KokkosKernels::Experimental::Controls controls;
+    spmv_symmetric (controls, hermitian, alpha, A, x, beta, y);
+    return;
+  }
+  if (A.numRows () <= 0) {
+    return;
+  }
+  if (alpha == Kokkos::Details::ArithTraits<typename YVector::non_const_value_type>::zero ()) {
+    KokkosBlas::scal (y, beta, y);
+    return;
+  }
+  if (!handle->is_symmetric_partition_complete ()) {
+    spmv_symmetric_symbolic_impl (handle, A);
+  }
+
+  const size_t buf_size = static_cast<size_t> (handle->get_symmetric_buf_size ());
+  if (hermitian)
+    spmv_symmetric_host<AMatrix, XVector, YVector, true>
+      (alpha, A, x, beta, y,
+       handle->get_symmetric_block_start (), handle->get_symmetric_range_lo (), handle->get_symmetric_buf_ptr (),
+       handle->get_symmetric_seg_start (), handle->get_symmetric_seg_ptr (), handle->get_symmetric_seg_blocks (),
+       buf_size);
+  else
+    spmv_symmetric_host<AMatrix, XVector, YVector, false>
+      (alpha, A, x, beta, y,
+       handle->get_symmetric_block_start (), handle->get_symmetric_range_lo (), handle->get_symmetric_buf_ptr (),
+       handle->get_symmetric_seg_start (), handle->get_symmetric_seg_ptr (), handle->get_symmetric_seg_blocks (),
+       buf_size);
+}
+
+template<class SPMVHandleType, class AMatrix, class XVector, class YVector>
+void spmv_symmetric_mv (SPMVHandleType* handle,
+                        const bool hermitian,
+                        typename YVector::const_value_type& alpha,
+                        const AMatrix& A,
+                        const XVector& x,
+                        typename YVector::const_value_type& beta,
+                        const YVector& y,
+                        std::integral_constant<int, 1>)
+{
+  spmv_symmetric (handle, hermitian, alpha, A, x, beta, y);
+}
+
+template<class SPMVHandleType, class AMatrix, class XVector, class YVector>
+void spmv_symmetric_mv (SPMVHandleType* handle,
+                        const bool hermitian,
+                        typename YVector::const_value_type& alpha,
+                        const AMatrix& A,
+                        const XVector& x,
+                        typename YVector::const_value_type& beta,
+                        const YVector& y,
+                        std::integral_constant<int, 2>)
+{
+  for (size_t j = 0; j < y.extent(1); ++j) {
+    auto x_j = Kokkos::subview (x, Kokkos::ALL (), j);
+    auto y_j = Kokkos::subview (y, Kokkos::ALL (), j);
+    spmv_symmetric (handle, hermitian, alpha, A, x_j, beta, y_j);
+  }
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_SYMMETRIC_HPP_
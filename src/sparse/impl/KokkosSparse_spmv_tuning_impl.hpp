@@ -0,0 +1,394 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_SPMV_TUNING_HPP_
+#define KOKKOSSPARSE_IMPL_SPMV_TUNING_HPP_
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Controls.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Number of row length bins in a tuning signature.  Bin 0 counts empty
+// rows, bin b > 0 counts rows with length in [2^(b-1), 2^b) and the
+// last bin also collects all longer rows.
+constexpr int spmv_tuning_num_bins = 16;
+
+// Histogram of the row lengths of a matrix, reduced into an array of
+// spmv_tuning_num_bins counters.
+template<class RowMap>
+struct SpmvRowLengthHistogram {
+  typedef typename RowMap::execution_space execution_space;
+  typedef typename RowMap::non_const_value_type size_type;
+  typedef int64_t value_type[];
+
+  const int value_count;
+  RowMap row_map;
+
+  SpmvRowLengthHistogram (const RowMap& row_map_) :
+    value_count (spmv_tuning_num_bins), row_map (row_map_)
+  {}
+
+  KOKKOS_INLINE_FUNCTION void
+  operator() (const int64_t rowIdx, value_type bins) const
+  {
+    const int64_t length = static_cast<int64_t> (row_map(rowIdx + 1) - row_map(rowIdx));
+    int bin = 0;
+    while((bin < spmv_tuning_num_bins - 1) && ((int64_t(1) << bin) <= length)) { ++bin; }
+    bins[bin] += 1;
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  init (value_type bins) const
+  {
+    for(int bin = 0; bin < value_count; ++bin) { bins[bin] = 0; }
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  join (volatile value_type update, const volatile value_type source) const
+  {
+    for(int bin = 0; bin < value_count; ++bin) { update[bin] += source[bin]; }
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  join (value_type update, const value_type source) const
+  {
+    for(int bin = 0; bin < value_count; ++bin) { update[bin] += source[bin]; }
+  }
+};
+
+/// \brief One point of the SpMV tuning space.
+///
+/// A default constructed entry stands for the settings spmv would use
+/// on its own; it leaves the controls untouched when applied.
+struct SpmvTuningEntry {
+  std::string schedule = "default";
+  int team_size = -1;
+  int vector_length = -1;
+  int64_t rows_per_thread = -1;
+
+  // Write the launch parameters of this entry into controls.  Tuned
+  // entries also select the native kernel, unless the caller already
+  // chose an algorithm, since a TPL would ignore these parameters.
+  void apply (KokkosKernels::Experimental::Controls& controls) const {
+    if(schedule == "default") { return; }
+    controls.setParameter("schedule", schedule);
+    if(team_size > 0)       { controls.setParameter("team size", std::to_string(team_size)); }
+    if(vector_length > 0)   { controls.setParameter("vector length", std::to_string(vector_length)); }
+    if(rows_per_thread > 0) { controls.setParameter("rows per thread", std::to_string(rows_per_thread)); }
+    if(!controls.isParameter("algorithm")) { controls.setParameter("algorithm", "native"); }
+  }
+};
+
+/// \brief Tuning results, indexed by database file and matrix signature.
+///
+/// Each database file is read the first time it is used; results found
+/// later in the process are appended to it so that other processes can
+/// reuse them.  Lines hold a signature followed by the schedule, team
+/// size, vector length and rows per thread, and later lines override
+/// earlier ones.  spmv may be called from several host threads at
+/// once, so every access to the tables goes through a mutex.
+class SpmvTuningDatabase {
+public:
+  static SpmvTuningDatabase& singleton () {
+    static SpmvTuningDatabase database;
+    return database;
+  }
+
+  bool find (const std::string& file, const std::string& signature, SpmvTuningEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& table = load(file);
+    auto search = table.find(signature);
+    if(search == table.end()) { return false; }
+    entry = search->second;
+    return true;
+  }
+
+  void store (const std::string& file, const std::string& signature, const SpmvTuningEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    load(file)[signature] = entry;
+
+    // Failing to write the file only costs a new search in the next
+    // process, so errors are not reported.
+    std::ofstream out(file, std::ios::app);
+    if(out) {
+      out << signature << " " << entry.schedule << " " << entry.team_size << " "
+          << entry.vector_length << " " << entry.rows_per_thread << "\n";
+    }
+  }
+
+  // Signatures already computed in this process, keyed by the
+  // caller's "autotune key" and the dimensions, so that repeated calls
+  // skip the histogram.
+  bool find_signature (const std::string& key, std::string& signature) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto search = signatures.find(key);
+    if(search == signatures.end()) { return false; }
+    signature = search->second;
+    return true;
+  }
+
+  void store_signature (const std::string& key, const std::string& signature) {
+    std::lock_guard<std::mutex> lock(mutex);
+    signatures[key] = signature;
+  }
+
+private:
+  typedef std::unordered_map<std::string, SpmvTuningEntry> table_type;
+
+  // Called with the mutex held.
+  table_type& load (const std::string& file) {
+    auto search = tables.find(file);
+    if(search != tables.end()) { return search->second; }
+
+    table_type& table = tables[file];
+    std::ifstream in(file);
+    std::string line;
+    while(std::getline(in, line)) {
+      std::istringstream is(line);
+      std::string signature;
+      SpmvTuningEntry entry;
+      if(is >> signature >> entry.schedule >> entry.team_size
+         >> entry.vector_length >> entry.rows_per_thread) {
+        table[signature] = entry;
+      }
+    }
+    return table;
+  }
+
+  std::unordered_map<std::string, table_type> tables;
+  std::unordered_map<std::string, std::string> signatures;
+  std::mutex mutex;
+};
+
+// Path of the tuning database: the "autotune file" control, then the
+// KOKKOSKERNELS_SPMV_TUNING_FILE environment variable, then a file in
+// the working directory.
+inline std::string
+spmv_tuning_file (const KokkosKernels::Experimental::Controls& controls)
+{
+  if(controls.isParameter("autotune file")) { return controls.getParameter("autotune file"); }
+  const char* env = std::getenv("KOKKOSKERNELS_SPMV_TUNING_FILE");
+  if(env != nullptr) { return std::string(env); }
+  return "kokkoskernels_spmv_tuning.txt";
+}
+
+/// \brief Row length signature of A used to index the tuning database.
+///
+/// Matrices with the same signature share tuned parameters: it records
+/// the execution space, scalar type and mode, the number of rows rounded
+/// to a power of two, and the share of rows in each row length bin,
+/// rounded to 5%.
+///
+/// The histogram costs one pass over the row map, and is recomputed on
+/// every call unless the caller names the matrix with the "autotune
+/// key" control: the signature is then remembered for that key and
+/// A's dimensions.  The caller must change the key when the matrix
+/// structure changes.  The address of the row map is not used as a
+/// key, since a freed matrix may be replaced by another one at the
+/// same address.
+template<class AMatrix>
+std::string
+spmv_tuning_signature (const KokkosKernels::Experimental::Controls& controls,
+                       const char mode[], const AMatrix& A)
+{
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_value_type value_type;
+  typedef typename AMatrix::row_map_type row_map_type;
+
+  const int64_t numRows = static_cast<int64_t> (A.numRows());
+
+  const bool memoize = controls.isParameter("autotune key");
+  std::ostringstream key;
+  if(memoize) {
+    key << controls.getParameter("autotune key") << ":" << execution_space::name()
+        << ":" << Kokkos::ArithTraits<value_type>::name()
+        << ":" << numRows << ":" << A.nnz() << ":" << mode[0];
+  }
+
+  SpmvTuningDatabase& database = SpmvTuningDatabase::singleton();
+  std::string signature;
+  if(memoize && database.find_signature(key.str(), signature)) { return signature; }
+
+  Kokkos::View<int64_t*, Kokkos::HostSpace> bins("row length bins", spmv_tuning_num_bins);
+  Kokkos::parallel_reduce("KokkosSparse::spmv_tuning_signature",
+                          Kokkos::RangePolicy<execution_space>(0, numRows),
+                          SpmvRowLengthHistogram<row_map_type>(A.graph.row_map), bins);
+
+  int rowsLog2 = 0;
+  while((int64_t(1) << (rowsLog2 + 1)) <= numRows) { ++rowsLog2; }
+
+  std::ostringstream os;
+  os << execution_space::name() << ":" << Kokkos::ArithTraits<value_type>::name()
+     << ":" << mode[0] << ":r" << rowsLog2 << ":h";
+  for(int bin = 0; bin < spmv_tuning_num_bins; ++bin) {
+    const int64_t share = numRows > 0 ? 5*((20*bins(bin) + numRows/2) / numRows) : 0;
+    os << (bin == 0 ? "" : "-") << share;
+  }
+  signature = os.str();
+  for(auto& c : signature) {
+    if(c == ' ') { c = '_'; }
+  }
+
+  if(memoize) { database.store_signature(key.str(), signature); }
+  return signature;
+}
+
+// Look up the tuned parameters stored for signature.
+inline bool
+spmv_tuning_lookup (const KokkosKernels::Experimental::Controls& controls,
+                    const std::string& signature,
+                    SpmvTuningEntry& entry)
+{
+  return SpmvTuningDatabase::singleton().find(spmv_tuning_file(controls), signature, entry);
+}
+
+/// \brief Candidate launch parameters for the native SpMV kernel.
+///
+/// The first candidate is always the default behavior.  On GPUs the
+/// candidates sweep schedule, vector length, team size and rows per
+/// thread; vector lengths far above the average row length are
+/// skipped.  The host kernel runs a RangePolicy over rows, so only the
+/// schedule is tuned there.
+template<class execution_space>
+std::vector<SpmvTuningEntry>
+spmv_tuning_candidates (const int64_t numRows, const int64_t nnz)
+{
+  std::vector<SpmvTuningEntry> candidates(1);
+  const std::string schedules[2] = {"static", "dynamic"};
+
+  if(KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+    const int64_t nnz_per_row = numRows > 0 ? nnz / numRows : 0;
+    const int max_vector_length = Kokkos::TeamPolicy<execution_space>::vector_length_max();
+    const int team_threads[2] = {128, 256};
+    const int64_t rows_per_thread[2] = {1, 4};
+
+    for(const auto& schedule : schedules) {
+      for(int vector_length = 1; vector_length <= max_vector_length; vector_length *= 2) {
+        if((vector_length > 1) && (vector_length > 2*nnz_per_row)) { break; }
+        for(const int threads : team_threads) {
+          for(const int64_t rpt : rows_per_thread) {
+            SpmvTuningEntry candidate;
+            candidate.schedule        = schedule;
+            candidate.team_size       = threads / vector_length > 0 ? threads / vector_length : 1;
+            candidate.vector_length   = vector_length;
+            candidate.rows_per_thread = rpt;
+            candidates.push_back(candidate);
+          }
+        }
+      }
+    }
+  } else {
+    for(const auto& schedule : schedules) {
+      SpmvTuningEntry candidate;
+      candidate.schedule = schedule;
+      candidates.push_back(candidate);
+    }
+  }
+
+  return candidates;
+}
+
+/// \brief Time every candidate with run and store the fastest one.
+///
+/// run(controls) must launch one SpMV with the given controls.  Each
+/// candidate is run once to warm up and then "autotune repeats" times
+/// (default 5).  Candidates whose launch is rejected, for instance
+/// because the team is too large for the kernel, are skipped.
+template<class execution_space, class Runner>
+SpmvTuningEntry
+spmv_tuning_search (const KokkosKernels::Experimental::Controls& controls,
+                    const std::string& signature,
+                    const int64_t numRows,
+                    const int64_t nnz,
+                    const Runner& run)
+{
+  int repeats = 5;
+  if(controls.isParameter("autotune repeats")) { repeats = std::stoi(controls.getParameter("autotune repeats")); }
+  if(repeats < 1) { repeats = 1; }
+
+  const std::vector<SpmvTuningEntry> candidates = spmv_tuning_candidates<execution_space>(numRows, nnz);
+  SpmvTuningEntry best = candidates[0];
+  double best_time = std::numeric_limits<double>::max();
+
+  for(const auto& candidate : candidates) {
+    KokkosKernels::Experimental::Controls trial = controls;
+    candidate.apply(trial);
+    try {
+      run(trial);
+      execution_space().fence();
+      Kokkos::Timer timer;
+      for(int rep = 0; rep < repeats; ++rep) { run(trial); }
+      execution_space().fence();
+      const double time = timer.seconds();
+      if(time < best_time) {
+        best_time = time;
+        best = candidate;
+      }
+    } catch(const std::runtime_error&) {
+      continue;
+    }
+  }
+
+  SpmvTuningDatabase::singleton().store(spmv_tuning_file(controls), signature, best);
+  return best;
+}
+
+} // namespace Impl
+} // namespace KokkosSparse
+
+#endif // KOKKOSSPARSE_IMPL_SPMV_TUNING_HPP_
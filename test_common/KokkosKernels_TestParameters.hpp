@@ -67,6 +67,8 @@ struct Parameters{
   int calculate_read_write_cost;
   char *coloring_input_file;
   char *coloring_output_file;
+  bool balance_colors;
+  int gs_sweeps;
 
   int minhashscale;
   int use_threads;
@@ -118,6 +120,8 @@ struct Parameters{
     calculate_read_write_cost = 0;
     coloring_input_file = NULL;
     coloring_output_file = NULL;
+    balance_colors = false;
+    gs_sweeps = 1;
     minhashscale = 1;
     use_threads = 0;
     use_openmp = 0;
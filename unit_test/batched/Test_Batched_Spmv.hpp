@@ -0,0 +1,218 @@
+#include "gtest/gtest.h"
+#include "Kokkos_Core.hpp"
+
+#include "KokkosBatched_Vector.hpp"
+
+#include "KokkosBatched_Spmv_Decl.hpp"
+
+#include "KokkosKernels_TestUtils.hpp"
+
+using namespace KokkosBatched;
+
+namespace Test {
+
+  template<typename T, typename M>
+  struct ParamTag {
+    typedef T trans;
+    typedef M mode;
+  };
+
+  /// access to the individual matrices packed in one value of the batch
+  template<typename T>
+  struct SpmvTestValue {
+    enum : int { length = 1 };
+    typedef T scalar_type;
+    static T    get(const T &v, const int)             { return v; }
+    static void set(T &v, const int, const T &val)     { v = val;  }
+  };
+
+  template<typename T, int l>
+  struct SpmvTestValue<Vector<SIMD<T>,l> > {
+    enum : int { length = l };
+    typedef T scalar_type;
+    static T    get(const Vector<SIMD<T>,l> &v, const int i)         { return v[i]; }
+    static void set(Vector<SIMD<T>,l> &v, const int i, const T &val) { v[i] = val;  }
+  };
+
+  template<typename DeviceType,
+           typename ValuesViewType,
+           typename IntView,
+           typename VectorViewType,
+           typename ScalarType,
+           typename ParamTagType>
+  struct Functor_TestBatchedSpmv {
+    ValuesViewType _values;
+    IntView _row_ptr, _colIndices;
+    VectorViewType _x, _y;
+    ScalarType _alpha, _beta;
+    int _matrices_per_team;
+
+    KOKKOS_INLINE_FUNCTION
+    Functor_TestBatchedSpmv(const ScalarType alpha,
+                            const ValuesViewType &values,
+                            const IntView &row_ptr,
+                            const IntView &colIndices,
+                            const VectorViewType &x,
+                            const ScalarType beta,
+                            const VectorViewType &y,
+                            const int matrices_per_team)
+      : _values(values), _row_ptr(row_ptr), _colIndices(colIndices),
+        _x(x), _y(y), _alpha(alpha), _beta(beta),
+        _matrices_per_team(matrices_per_team) {}
+
+    template<typename MemberType>
+    KOKKOS_INLINE_FUNCTION
+    void operator()(const ParamTagType &, const MemberType &member) const {
+      const int first = member.league_rank()*_matrices_per_team;
+      const int last  = (first + _matrices_per_team) < int(_y.extent(0)) ?
+        (first + _matrices_per_team) : int(_y.extent(0));
+      const Kokkos::pair<int,int> range(first, last);
+
+      auto vv = Kokkos::subview(_values, range, Kokkos::ALL());
+      auto xx = Kokkos::subview(_x, range, Kokkos::ALL());
+      auto yy = Kokkos::subview(_y, range, Kokkos::ALL());
+
+      Spmv<MemberType,
+        typename ParamTagType::trans,
+        typename ParamTagType::mode>::
+        invoke(member, _alpha, vv, _row_ptr, _colIndices, xx, _beta, yy);
+    }
+
+    inline
+    void run() {
+      std::string name("KokkosBatched::Test::Spmv");
+      Kokkos::Profiling::pushRegion( name.c_str() );
+      const int league_size = (_y.extent(0) + _matrices_per_team - 1)/_matrices_per_team;
+      typedef typename ParamTagType::mode mode_type;
+      /// serial runs on one thread and team does not use vector lanes
+      if (std::is_same<mode_type,Mode::Serial>::value) {
+        Kokkos::TeamPolicy<DeviceType,ParamTagType> policy(league_size, 1, 1);
+        Kokkos::parallel_for(name.c_str(), policy, *this);
+      } else if (std::is_same<mode_type,Mode::Team>::value) {
+        Kokkos::TeamPolicy<DeviceType,ParamTagType> policy(league_size, Kokkos::AUTO, 1);
+        Kokkos::parallel_for(name.c_str(), policy, *this);
+      } else {
+        Kokkos::TeamPolicy<DeviceType,ParamTagType> policy(league_size, Kokkos::AUTO, Kokkos::AUTO);
+        Kokkos::parallel_for(name.c_str(), policy, *this);
+      }
+      Kokkos::Profiling::popRegion();
+    }
+  };
+
+  template<typename DeviceType,
+           typename ValueType,
+           typename ScalarType,
+           typename LayoutType,
+           typename ParamTagType>
+  void impl_test_batched_spmv(const int N, const int BlkSize, const int matrices_per_team) {
+    typedef Kokkos::View<ValueType**,LayoutType,DeviceType> ValuesViewType;
+    typedef Kokkos::View<int*,LayoutType,DeviceType> IntView;
+    typedef SpmvTestValue<ValueType> value_traits;
+    typedef typename value_traits::scalar_type scalar_type;
+    typedef Kokkos::Details::ArithTraits<scalar_type> ats;
+
+    const int l = value_traits::length;
+    const ScalarType alpha = 1.5, beta = 3.0;
+
+    /// one graph shared by all matrices: a band of width 3 plus a far entry
+    const int nnz_per_row = BlkSize > 0 ? 4 : 0;
+    const int nnz = BlkSize*nnz_per_row;
+
+    IntView row_ptr("row_ptr", BlkSize+1), colIndices("colIndices", nnz);
+    auto row_ptr_host    = Kokkos::create_mirror_view(row_ptr);
+    auto colIndices_host = Kokkos::create_mirror_view(colIndices);
+    for (int i=0;i<=BlkSize;++i)
+      row_ptr_host(i) = i*nnz_per_row;
+    for (int i=0;i<BlkSize;++i) {
+      colIndices_host(i*nnz_per_row+0) = (i+BlkSize-1)%BlkSize;
+      colIndices_host(i*nnz_per_row+1) = i;
+      colIndices_host(i*nnz_per_row+2) = (i+1)%BlkSize;
+      colIndices_host(i*nnz_per_row+3) = (i*7+3)%BlkSize;
+    }
+    Kokkos::deep_copy(row_ptr, row_ptr_host);
+    Kokkos::deep_copy(colIndices, colIndices_host);
+
+    ValuesViewType
+      values("values", N, nnz),
+      x("x", N, BlkSize),
+      y("y", N, BlkSize);
+
+    auto values_host = Kokkos::create_mirror_view(values);
+    auto x_host      = Kokkos::create_mirror_view(x);
+    auto y_host      = Kokkos::create_mirror_view(y);
+
+    /// every matrix of the batch gets different values
+    for (int k=0;k<N;++k)
+      for (int v=0;v<l;++v) {
+        const int kk = k*l+v;
+        for (int e=0;e<nnz;++e)
+          value_traits::set(values_host(k,e), v, scalar_type(((kk+1)*(e+3))%17)/scalar_type(8) - scalar_type(1));
+        for (int i=0;i<BlkSize;++i) {
+          value_traits::set(x_host(k,i), v, scalar_type(((kk+5)*(i+1))%13)/scalar_type(6) - scalar_type(1));
+          value_traits::set(y_host(k,i), v, scalar_type(((kk+2)*(i+7))%11)/scalar_type(5) - scalar_type(1));
+        }
+      }
+    Kokkos::deep_copy(values, values_host);
+    Kokkos::deep_copy(x, x_host);
+    Kokkos::deep_copy(y, y_host);
+
+    /// reference on host, one matrix at a time
+    Kokkos::View<scalar_type***,Kokkos::HostSpace> y_ref("y_ref", N, l, BlkSize);
+    for (int k=0;k<N;++k)
+      for (int v=0;v<l;++v)
+        for (int i=0;i<BlkSize;++i) {
+          scalar_type sum(0);
+          for (int e=row_ptr_host(i);e<row_ptr_host(i+1);++e)
+            sum += value_traits::get(values_host(k,e), v)*value_traits::get(x_host(k,colIndices_host(e)), v);
+          y_ref(k,v,i) = beta*value_traits::get(y_host(k,i), v) + alpha*sum;
+        }
+
+    /// test body
+    Functor_TestBatchedSpmv<DeviceType,ValuesViewType,IntView,ValuesViewType,ScalarType,ParamTagType>
+      (alpha, values, row_ptr, colIndices, x, beta, y, matrices_per_team).run();
+
+    Kokkos::fence();
+
+    Kokkos::deep_copy(y_host, y);
+
+    /// check y = y_ref
+    typedef typename ats::mag_type mag_type;
+    mag_type sum(1), diff(0);
+    const mag_type eps = 1.0e3 * ats::epsilon();
+
+    for (int k=0;k<N;++k)
+      for (int v=0;v<l;++v)
+        for (int i=0;i<BlkSize;++i) {
+          sum  += ats::abs(y_ref(k,v,i));
+          diff += ats::abs(y_ref(k,v,i)-value_traits::get(y_host(k,i), v));
+        }
+    EXPECT_NEAR_KK( diff/sum, 0, eps);
+  }
+}
+
+template<typename DeviceType,
+         typename ValueType,
+         typename ScalarType,
+         typename ParamTagType>
+int test_batched_spmv() {
+#if defined(KOKKOSKERNELS_INST_LAYOUTLEFT)
+  {
+    Test::impl_test_batched_spmv<DeviceType,ValueType,ScalarType,Kokkos::LayoutLeft,ParamTagType>(   0, 10,  1);
+    for (int i=1;i<10;++i) {
+      Test::impl_test_batched_spmv<DeviceType,ValueType,ScalarType,Kokkos::LayoutLeft,ParamTagType>(1024, i,  1);
+      Test::impl_test_batched_spmv<DeviceType,ValueType,ScalarType,Kokkos::LayoutLeft,ParamTagType>(1023, i*7, 16);
+    }
+  }
+#endif
+#if defined(KOKKOSKERNELS_INST_LAYOUTRIGHT)
+  {
+    Test::impl_test_batched_spmv<DeviceType,ValueType,ScalarType,Kokkos::LayoutRight,ParamTagType>(   0, 10,  1);
+    for (int i=1;i<10;++i) {
+      Test::impl_test_batched_spmv<DeviceType,ValueType,ScalarType,Kokkos::LayoutRight,ParamTagType>(1024, i,  1);
+      Test::impl_test_batched_spmv<DeviceType,ValueType,ScalarType,Kokkos::LayoutRight,ParamTagType>(1023, i*7, 16);
+    }
+  }
+#endif
+
+  return 0;
+}
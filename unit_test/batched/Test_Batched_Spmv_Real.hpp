@@ -0,0 +1,38 @@
+
+#if defined(KOKKOSKERNELS_INST_FLOAT)
+TEST_F( TestCategory, batched_scalar_serial_spmv_nt_float_float ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::Serial> param_tag_type;
+  test_batched_spmv<TestExecSpace,float,float,param_tag_type>();
+}
+TEST_F( TestCategory, batched_scalar_team_spmv_nt_float_float ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::Team> param_tag_type;
+  test_batched_spmv<TestExecSpace,float,float,param_tag_type>();
+}
+TEST_F( TestCategory, batched_scalar_teamvector_spmv_nt_float_float ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::TeamVector> param_tag_type;
+  test_batched_spmv<TestExecSpace,float,float,param_tag_type>();
+}
+#endif
+
+#if defined(KOKKOSKERNELS_INST_DOUBLE)
+TEST_F( TestCategory, batched_scalar_serial_spmv_nt_double_double ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::Serial> param_tag_type;
+  test_batched_spmv<TestExecSpace,double,double,param_tag_type>();
+}
+TEST_F( TestCategory, batched_scalar_team_spmv_nt_double_double ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::Team> param_tag_type;
+  test_batched_spmv<TestExecSpace,double,double,param_tag_type>();
+}
+TEST_F( TestCategory, batched_scalar_teamvector_spmv_nt_double_double ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::TeamVector> param_tag_type;
+  test_batched_spmv<TestExecSpace,double,double,param_tag_type>();
+}
+TEST_F( TestCategory, batched_vector_serial_spmv_nt_simd_double4_double ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::Serial> param_tag_type;
+  test_batched_spmv<TestExecSpace,Vector<SIMD<double>,4>,double,param_tag_type>();
+}
+TEST_F( TestCategory, batched_vector_teamvector_spmv_nt_simd_double4_double ) {
+  typedef ::Test::ParamTag<Trans::NoTranspose,Mode::TeamVector> param_tag_type;
+  test_batched_spmv<TestExecSpace,Vector<SIMD<double>,4>,double,param_tag_type>();
+}
+#endif
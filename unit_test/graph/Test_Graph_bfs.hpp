@@ -0,0 +1,192 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+
+#include "KokkosGraph_BFS.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+
+#include <vector>
+#include <queue>
+
+//Generates the graph of a 2D 5-pt stencil, with the columns x = gridX / 2 and
+//x = gridX / 2 + 1 disconnected so that the graph has 2 connected components.
+template<typename rowmap_t, typename entries_t>
+void generate5ptSliced(rowmap_t& rowmapView, entries_t& entriesView, int gridX, int gridY)
+{
+  using size_type = typename rowmap_t::non_const_value_type;
+  using lno_t = typename entries_t::non_const_value_type;
+  lno_t numVertices = gridX * gridY;
+  std::vector<size_type> rowmap(numVertices + 1);
+  std::vector<lno_t> entries;
+  rowmap[0] = 0;
+  lno_t xslice = gridX / 2;
+  for(lno_t j = 0; j < gridY; j++)
+  {
+    for(lno_t i = 0; i < gridX; i++)
+    {
+      lno_t v = i + j * gridX;
+      if(i != 0 && i != xslice + 1)
+        entries.push_back(v - 1);
+      if(i != gridX - 1 && i != xslice)
+        entries.push_back(v + 1);
+      if(j != 0)
+        entries.push_back(v - gridX);
+      if(j != gridY - 1)
+        entries.push_back(v + gridX);
+      rowmap[v + 1] = entries.size();
+    }
+  }
+  size_type numEdges = entries.size();
+  Kokkos::View<size_type*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> rowmapHost(rowmap.data(), numVertices + 1);
+  Kokkos::View<lno_t*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> entriesHost(entries.data(), numEdges);
+  rowmapView = rowmap_t(Kokkos::ViewAllocateWithoutInitializing("Rowmap"), numVertices + 1);
+  entriesView = entries_t(Kokkos::ViewAllocateWithoutInitializing("Colinds"), numEdges);
+  Kokkos::deep_copy(rowmapView, rowmapHost);
+  Kokkos::deep_copy(entriesView, entriesHost);
+}
+
+template <typename lno_t, typename size_type, typename device>
+void test_bfs(lno_t gridX, lno_t gridY, lno_t source)
+{
+  typedef typename KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type rowmap_t;
+  typedef typename graph_t::entries_type entries_t;
+  lno_t numVerts = gridX * gridY;
+  typename rowmap_t::non_const_type rowmap;
+  typename entries_t::non_const_type entries;
+  generate5ptSliced(rowmap, entries, gridX, gridY);
+  auto rowmapHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rowmap);
+  auto entriesHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), entries);
+  //reference levels from a serial queue-based BFS
+  std::vector<lno_t> refLevels(numVerts, -1);
+  lno_t refNumLevels = 0;
+  {
+    std::queue<lno_t> q;
+    refLevels[source] = 0;
+    q.push(source);
+    while(!q.empty())
+    {
+      lno_t v = q.front();
+      q.pop();
+      if(refLevels[v] + 1 > refNumLevels)
+        refNumLevels = refLevels[v] + 1;
+      for(size_type j = rowmapHost(v); j < rowmapHost(v + 1); j++)
+      {
+        lno_t nei = entriesHost(j);
+        if(refLevels[nei] == -1)
+        {
+          refLevels[nei] = refLevels[v] + 1;
+          q.push(nei);
+        }
+      }
+    }
+  }
+  for(KokkosGraph::BFS_Direction direction :
+      {KokkosGraph::BFS_DIRECTION_OPTIMIZING, KokkosGraph::BFS_TOP_DOWN, KokkosGraph::BFS_BOTTOM_UP})
+  {
+    typename entries_t::non_const_type levels, parents;
+    lno_t numLevels = KokkosGraph::Experimental::graph_bfs<device, rowmap_t, entries_t>(rowmap, entries, source, levels, parents, direction);
+    EXPECT_EQ(numLevels, refNumLevels) << "direction " << direction;
+    auto levelsHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), levels);
+    auto parentsHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), parents);
+    for(lno_t v = 0; v < numVerts; v++)
+    {
+      ASSERT_EQ(levelsHost(v), refLevels[v]) << "vertex " << v << ", direction " << direction;
+      if(levelsHost(v) == -1)
+      {
+        EXPECT_EQ(parentsHost(v), -1);
+      }
+      else if(v == source)
+      {
+        EXPECT_EQ(parentsHost(v), source);
+      }
+      else
+      {
+        //the parent must be a neighbor one level closer to the source
+        lno_t p = parentsHost(v);
+        ASSERT_GE(p, 0);
+        ASSERT_LT(p, numVerts);
+        EXPECT_EQ(levelsHost(p) + 1, levelsHost(v));
+        bool adjacent = false;
+        for(size_type j = rowmapHost(v); j < rowmapHost(v + 1); j++)
+        {
+          if(entriesHost(j) == p)
+            adjacent = true;
+        }
+        EXPECT_TRUE(adjacent) << "vertex " << v << ", parent " << p;
+      }
+    }
+  }
+}
+
+#define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE) \
+TEST_F( TestCategory, graph ## _ ## bfs ## _ ## SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## DEVICE ) { \
+  test_bfs<ORDINAL,OFFSET,DEVICE>(1, 1, 0); \
+  test_bfs<ORDINAL,OFFSET,DEVICE>(6, 3, 0); \
+  test_bfs<ORDINAL,OFFSET,DEVICE>(100, 100, 0); \
+  test_bfs<ORDINAL,OFFSET,DEVICE>(300, 200, 30123); \
+}
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int64_t, size_t, TestExecSpace)
+#endif
@@ -0,0 +1,200 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+
+#include "KokkosGraph_ConnectedComponents.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosKernels_IOUtils.hpp"
+#include "KokkosKernels_SparseUtils.hpp"
+
+#include <vector>
+#include <queue>
+
+//Reference labels from serial BFS, visiting the sources in increasing order so that
+//components are numbered by their smallest vertex.
+template<typename rowmap_host_t, typename entries_host_t, typename lno_t>
+lno_t serialConnectedComponents(const rowmap_host_t& rowmap, const entries_host_t& entries, lno_t numVerts, std::vector<lno_t>& labels)
+{
+  labels.assign(numVerts, -1);
+  lno_t numComponents = 0;
+  std::queue<lno_t> q;
+  for(lno_t source = 0; source < numVerts; source++)
+  {
+    if(labels[source] != -1)
+      continue;
+    labels[source] = numComponents;
+    q.push(source);
+    while(!q.empty())
+    {
+      lno_t v = q.front();
+      q.pop();
+      for(auto j = rowmap(v); j < rowmap(v + 1); j++)
+      {
+        lno_t nei = entries(j);
+        if(nei < numVerts && labels[nei] == -1)
+        {
+          labels[nei] = numComponents;
+          q.push(nei);
+        }
+      }
+    }
+    numComponents++;
+  }
+  return numComponents;
+}
+
+template<typename device, typename rowmap_t, typename entries_t>
+void checkConnectedComponents(const rowmap_t& rowmap, const entries_t& entries)
+{
+  using lno_t = typename entries_t::non_const_value_type;
+  lno_t numVerts = rowmap.extent(0) - 1;
+  auto rowmapHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rowmap);
+  auto entriesHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), entries);
+  std::vector<lno_t> refLabels;
+  lno_t refNumComponents = serialConnectedComponents(rowmapHost, entriesHost, numVerts, refLabels);
+  lno_t numComponents;
+  auto labels = KokkosGraph::Experimental::graph_connected_components<device, rowmap_t, entries_t>(rowmap, entries, numComponents);
+  EXPECT_EQ(numComponents, refNumComponents);
+  auto labelsHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), labels);
+  for(lno_t v = 0; v < numVerts; v++)
+  {
+    ASSERT_EQ(labelsHost(v), refLabels[v]) << "vertex " << v;
+  }
+}
+
+//Graph made of numRings disjoint rings of ringSize vertices, followed by
+//numIsolated isolated vertices (half of them with a self-loop).
+//Ring vertices are interleaved so that the components are not contiguous.
+template<typename rowmap_t, typename entries_t>
+void generateDisjointRings(rowmap_t& rowmapView, entries_t& entriesView, int numRings, int ringSize, int numIsolated)
+{
+  using size_type = typename rowmap_t::non_const_value_type;
+  using lno_t = typename entries_t::non_const_value_type;
+  lno_t numRingVerts = numRings * ringSize;
+  lno_t numVertices = numRingVerts + numIsolated;
+  std::vector<size_type> rowmap(numVertices + 1);
+  std::vector<lno_t> entries;
+  rowmap[0] = 0;
+  for(lno_t v = 0; v < numVertices; v++)
+  {
+    if(v < numRingVerts)
+    {
+      //vertex v is position v / numRings of ring v % numRings
+      lno_t ring = v % numRings;
+      lno_t pos = v / numRings;
+      entries.push_back(ring + ((pos + ringSize - 1) % ringSize) * numRings);
+      entries.push_back(ring + ((pos + 1) % ringSize) * numRings);
+    }
+    else if(v % 2)
+      entries.push_back(v);
+    rowmap[v + 1] = entries.size();
+  }
+  size_type numEdges = entries.size();
+  Kokkos::View<size_type*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> rowmapHost(rowmap.data(), numVertices + 1);
+  Kokkos::View<lno_t*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> entriesHost(entries.data(), numEdges);
+  rowmapView = rowmap_t(Kokkos::ViewAllocateWithoutInitializing("Rowmap"), numVertices + 1);
+  entriesView = entries_t(Kokkos::ViewAllocateWithoutInitializing("Colinds"), numEdges);
+  Kokkos::deep_copy(rowmapView, rowmapHost);
+  Kokkos::deep_copy(entriesView, entriesHost);
+}
+
+template <typename lno_t, typename size_type, typename device>
+void test_connected_components_rings(int numRings, int ringSize, int numIsolated)
+{
+  typedef typename KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type rowmap_t;
+  typedef typename graph_t::entries_type entries_t;
+  typename rowmap_t::non_const_type rowmap;
+  typename entries_t::non_const_type entries;
+  generateDisjointRings(rowmap, entries, numRings, ringSize, numIsolated);
+  checkConnectedComponents<device, rowmap_t, entries_t>(rowmap, entries);
+}
+
+template <typename lno_t, typename size_type, typename device>
+void test_connected_components_random(lno_t numVerts, size_type nnz, lno_t bandwidth, lno_t row_size_variance)
+{
+  typedef typename KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type rowmap_t;
+  typedef typename graph_t::entries_type entries_t;
+  crsMat_t A = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numVerts, numVerts, nnz, row_size_variance, bandwidth);
+  typename rowmap_t::non_const_type symRowmap;
+  typename entries_t::non_const_type symEntries;
+  KokkosKernels::Impl::symmetrize_graph_symbolic_hashmap<rowmap_t, entries_t, typename rowmap_t::non_const_type, typename entries_t::non_const_type, device>
+    (numVerts, A.graph.row_map, A.graph.entries, symRowmap, symEntries);
+  checkConnectedComponents<device, rowmap_t, entries_t>(symRowmap, symEntries);
+}
+
+#define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE) \
+TEST_F( TestCategory, graph ## _ ## graph_connected_components ## _ ## SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## DEVICE ) { \
+  test_connected_components_rings<ORDINAL, OFFSET, DEVICE>(1, 1, 0); \
+  test_connected_components_rings<ORDINAL, OFFSET, DEVICE>(1, 5000, 10); \
+  test_connected_components_rings<ORDINAL, OFFSET, DEVICE>(37, 100, 500); \
+  test_connected_components_rings<ORDINAL, OFFSET, DEVICE>(1000, 3, 0); \
+  test_connected_components_random<ORDINAL, OFFSET, DEVICE>(10000, 10000 * 2, 10000, 2); \
+  test_connected_components_random<ORDINAL, OFFSET, DEVICE>(50000, 50000 * 10, 200, 10); \
+}
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int64_t, size_t, TestExecSpace)
+#endif
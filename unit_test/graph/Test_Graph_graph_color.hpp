@@ -44,6 +44,8 @@
 
 #include <gtest/gtest.h>
 #include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <vector>
 
 #include "KokkosGraph_Distance1Color.hpp"
 #include "KokkosSparse_CrsMatrix.hpp"
@@ -63,7 +65,8 @@ int run_graphcolor(
     crsMat_t input_mat,
     ColoringAlgorithm coloring_algorithm,
     size_t &num_colors,
-    typename crsMat_t::StaticCrsGraphType::entries_type::non_const_type & vertex_colors){
+    typename crsMat_t::StaticCrsGraphType::entries_type::non_const_type & vertex_colors,
+    bool balance_colors = false){
   typedef typename crsMat_t::StaticCrsGraphType graph_t;
   typedef typename graph_t::row_map_type lno_view_t;
   typedef typename graph_t::entries_type   lno_nnz_view_t;
@@ -83,7 +86,7 @@ int run_graphcolor(
   kh.set_dynamic_scheduling(true);
 
   kh.create_graph_coloring_handle(coloring_algorithm);
-
+  kh.get_graph_coloring_handle()->set_balance_colors(balance_colors);
 
   const size_t num_rows_1 = input_mat.numRows();
   const size_t num_cols_1 = input_mat.numCols();
@@ -192,10 +195,222 @@ void test_coloring(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_
 
 }
 
+template <typename color_view_t>
+size_t max_color_class_size(color_view_t colors, size_t num_colors) {
+  typename color_view_t::HostMirror hcolor = Kokkos::create_mirror_view (colors);
+  Kokkos::deep_copy (hcolor , colors);
+  std::vector<size_t> class_sizes(num_colors + 1, 0);
+  for (size_t i = 0; i < hcolor.extent(0); ++i){
+    class_sizes[hcolor(i)]++;
+  }
+  return *std::max_element(class_sizes.begin(), class_sizes.end());
+}
+
+template <typename scalar_t, typename lno_t, typename size_type, typename device>
+void test_balanced_coloring(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+  using namespace Test;
+  typedef typename KokkosSparse::CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type lno_view_t;
+  typedef typename graph_t::entries_type lno_nnz_view_t;
+  typedef typename graph_t::entries_type::non_const_type   color_view_t;
+  typedef typename crsMat_t::values_type::non_const_type scalar_view_t;
+  typedef KokkosKernelsHandle
+      <size_type,lno_t, scalar_t,
+      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
+  typedef KokkosGraph::Impl::GraphColorBalance
+      <typename KernelHandle::GraphColoringHandleType, lno_view_t, lno_nnz_view_t> BalanceGraphColoring;
+
+  lno_t numCols = numRows;
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numCols,nnz,row_size_variance, bandwidth);
+
+  typename lno_view_t::non_const_type sym_xadj;
+  typename lno_nnz_view_t::non_const_type sym_adj;
+
+  KokkosKernels::Impl::symmetrize_graph_symbolic_hashmap<lno_view_t, lno_nnz_view_t,  typename lno_view_t::non_const_type, typename lno_nnz_view_t::non_const_type, device>
+    (numRows, input_mat.graph.row_map, input_mat.graph.entries, sym_xadj, sym_adj);
+  size_type numentries = sym_adj.extent(0);
+  scalar_view_t newValues("vals", numentries);
+
+  graph_t static_graph (sym_adj, sym_xadj);
+  input_mat = crsMat_t("CrsMatrix", numCols, newValues, static_graph);
+
+  std::vector<ColoringAlgorithm> coloring_algorithms = { COLORING_SERIAL, COLORING_VB, COLORING_EB };
+
+  for (size_t ii = 0; ii < coloring_algorithms.size(); ++ii) {
+    ColoringAlgorithm coloring_algorithm = coloring_algorithms[ii];
+    color_view_t colors;
+    size_t num_colors;
+
+    //the speculative algorithms may color differently from run to run, so a single coloring is balanced in a copy.
+    run_graphcolor<crsMat_t, device>(input_mat, coloring_algorithm, num_colors, colors, false);
+    color_view_t balanced_colors(Kokkos::ViewAllocateWithoutInitializing("balanced colors"), colors.extent(0));
+    Kokkos::deep_copy(balanced_colors, colors);
+
+    KernelHandle kh;
+    kh.create_graph_coloring_handle(coloring_algorithm);
+    BalanceGraphColoring gb(numRows, input_mat.graph.row_map, input_mat.graph.entries, kh.get_graph_coloring_handle());
+    int num_balance_rounds = 0;
+    gb.balance(balanced_colors, num_balance_rounds);
+    kh.destroy_graph_coloring_handle();
+
+    lno_t num_conflict = KokkosKernels::Impl::kk_is_d1_coloring_valid
+        <lno_view_t,lno_nnz_view_t, color_view_t, typename device::execution_space>
+    (numRows, numCols, input_mat.graph.row_map, input_mat.graph.entries, balanced_colors);
+    EXPECT_EQ(num_conflict, 0);
+
+    //balancing never adds or removes colors, and never grows the largest class.
+    //The serial algorithm is deterministic and leaves its classes uneven, so balancing must strictly shrink its largest class.
+    typename color_view_t::HostMirror h_balanced = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), balanced_colors);
+    size_t balanced_num_colors = 0;
+    for (size_t i = 0; i < h_balanced.extent(0); ++i){
+      balanced_num_colors = std::max<size_t>(balanced_num_colors, h_balanced(i));
+    }
+    EXPECT_EQ(balanced_num_colors, num_colors);
+    size_t max_size = max_color_class_size(colors, num_colors);
+    size_t balanced_max_size = max_color_class_size(balanced_colors, num_colors);
+    EXPECT_LE(balanced_max_size, max_size);
+    if (coloring_algorithm == COLORING_SERIAL){
+      EXPECT_LT(balanced_max_size, max_size);
+    }
+  }
+}
+
+template <typename scalar_t, typename lno_t, typename size_type, typename device>
+void test_recoloring(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+  typedef typename KokkosSparse::CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type lno_view_t;
+  typedef typename graph_t::entries_type lno_nnz_view_t;
+  typedef typename lno_view_t::non_const_type rowmap_t;
+  typedef typename lno_nnz_view_t::non_const_type entries_t;
+  typedef typename graph_t::entries_type::non_const_type   color_view_t;
+  typedef KokkosKernelsHandle
+      <size_type,lno_t, scalar_t,
+      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  rowmap_t sym_xadj;
+  entries_t sym_adj;
+  KokkosKernels::Impl::symmetrize_graph_symbolic_hashmap<lno_view_t, lno_nnz_view_t, rowmap_t, entries_t, device>
+    (numRows, input_mat.graph.row_map, input_mat.graph.entries, sym_xadj, sym_adj);
+
+  //host adjacency lists, to be modified between the colorings.
+  std::vector<std::vector<lno_t>> adjacency(numRows);
+  {
+    auto h_xadj = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), sym_xadj);
+    auto h_adj = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), sym_adj);
+    for (lno_t i = 0; i < numRows; ++i){
+      for (size_type j = h_xadj(i); j < h_xadj(i + 1); ++j){
+        adjacency[i].push_back(h_adj(j));
+      }
+    }
+  }
+  auto build_graph = [&](rowmap_t &xadj, entries_t &adj){
+    lno_t n = adjacency.size();
+    xadj = rowmap_t("xadj", n + 1);
+    auto h_xadj = Kokkos::create_mirror_view(xadj);
+    for (lno_t i = 0; i < n; ++i){
+      h_xadj(i + 1) = h_xadj(i) + adjacency[i].size();
+    }
+    adj = entries_t("adj", h_xadj(n));
+    auto h_adj = Kokkos::create_mirror_view(adj);
+    for (lno_t i = 0; i < n; ++i){
+      for (size_t j = 0; j < adjacency[i].size(); ++j){
+        h_adj(h_xadj(i) + j) = adjacency[i][j];
+      }
+    }
+    Kokkos::deep_copy(xadj, h_xadj);
+    Kokkos::deep_copy(adj, h_adj);
+  };
+
+  KernelHandle kh;
+  kh.create_graph_coloring_handle(COLORING_VBBIT);
+  graph_color(&kh, numRows, numRows, sym_xadj, sym_adj);
+  auto h_old_colors = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), kh.get_graph_coloring_handle()->get_vertex_colors());
+
+  //add edges between vertices of the same color, and new vertices connected to old ones.
+  std::vector<lno_t> changed;
+  std::vector<char> is_changed(numRows, 0);
+  auto add_edge = [&](lno_t u, lno_t v){
+    adjacency[u].push_back(v);
+    adjacency[v].push_back(u);
+    for (lno_t w : {u, v}){
+      if (w < numRows && !is_changed[w]){
+        is_changed[w] = 1;
+        changed.push_back(w);
+      }
+    }
+  };
+  for (lno_t u = 0; u + 1 < numRows; u += 97){
+    for (lno_t v = u + 1; v < numRows; ++v){
+      if (h_old_colors(v) == h_old_colors(u)){
+        add_edge(u, v);
+        break;
+      }
+    }
+  }
+  const lno_t numNew = 100;
+  adjacency.resize(numRows + numNew);
+  for (lno_t i = 0; i < numNew; ++i){
+    add_edge(numRows + i, (i * 31) % numRows);
+    add_edge(numRows + i, (i * 31 + 7) % numRows);
+  }
+
+  rowmap_t new_xadj;
+  entries_t new_adj;
+  build_graph(new_xadj, new_adj);
+  entries_t d_changed("changed", changed.size());
+  auto h_changed = Kokkos::create_mirror_view(d_changed);
+  for (size_t i = 0; i < changed.size(); ++i) h_changed(i) = changed[i];
+  Kokkos::deep_copy(d_changed, h_changed);
+
+  const lno_t newRows = numRows + numNew;
+  graph_recolor(&kh, newRows, newRows, new_xadj, new_adj, d_changed, lno_t(changed.size()));
+  color_view_t colors = kh.get_graph_coloring_handle()->get_vertex_colors();
+  ASSERT_EQ(colors.extent(0), size_t(newRows));
+  lno_t num_conflict = KokkosKernels::Impl::kk_is_d1_coloring_valid
+      <rowmap_t, entries_t, color_view_t, typename device::execution_space>
+      (newRows, newRows, new_xadj, new_adj, colors);
+  EXPECT_EQ(num_conflict, 0);
+
+  //only changed and new vertices may change color.
+  auto h_colors = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), colors);
+  lno_t num_unchanged_recolored = 0;
+  for (lno_t i = 0; i < numRows; ++i){
+    if (!is_changed[i] && h_colors(i) != h_old_colors(i)) num_unchanged_recolored++;
+  }
+  EXPECT_EQ(num_unchanged_recolored, 0);
+  for (lno_t i = 0; i < newRows; ++i){
+    EXPECT_GT(h_colors(i), 0);
+  }
+
+  //without a list of changed vertices, all vertices are checked.
+  for (lno_t u = 1; u + 1 < numRows; u += 89){
+    for (lno_t v = u + 1; v < numRows; ++v){
+      if (h_colors(v) == h_colors(u)){
+        adjacency[u].push_back(v);
+        adjacency[v].push_back(u);
+        break;
+      }
+    }
+  }
+  build_graph(new_xadj, new_adj);
+  graph_recolor(&kh, newRows, newRows, new_xadj, new_adj);
+  colors = kh.get_graph_coloring_handle()->get_vertex_colors();
+  num_conflict = KokkosKernels::Impl::kk_is_d1_coloring_valid
+      <rowmap_t, entries_t, color_view_t, typename device::execution_space>
+      (newRows, newRows, new_xadj, new_adj, colors);
+  EXPECT_EQ(num_conflict, 0);
+  kh.destroy_graph_coloring_handle();
+}
+
 #define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE) \
 TEST_F( TestCategory, graph ## _ ## graph_color ## _ ## SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## DEVICE ) { \
   test_coloring<SCALAR,ORDINAL,OFFSET,DEVICE>(50000, 50000 * 30, 200, 10); \
   test_coloring<SCALAR,ORDINAL,OFFSET,DEVICE>(50000, 50000 * 30, 100, 10); \
+  test_balanced_coloring<SCALAR,ORDINAL,OFFSET,DEVICE>(50000, 50000 * 30, 100, 10); \
+  test_recoloring<SCALAR,ORDINAL,OFFSET,DEVICE>(5000, 5000 * 20, 100, 10); \
 }
 
 #if (defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
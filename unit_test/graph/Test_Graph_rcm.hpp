@@ -167,6 +167,130 @@ void test_rcm(lno_t gridX, lno_t gridY, lno_t gridZ)
   size_t origBW = maxBandwidth(rowmapHost, entriesHost, identityOrder, identityOrder);
   size_t rcmBW = maxBandwidth(rowmapHost, entriesHost, rcmHost, rcmPermHost);
   EXPECT_LE(rcmBW, origBW);
+  //the parallel ordering should be about as good as the serial one
+  KokkosGraph::Experimental::Impl::SerialRCM<rowmap_t, entries_t, decltype(rcmHost)> serialAlgo(rowmap, entries);
+  auto serialHost = serialAlgo.rcm();
+  decltype(rcmHost) serialPermHost(Kokkos::ViewAllocateWithoutInitializing("SerialRCMPerm"), numVerts);
+  for(lno_t i = 0; i < numVerts; i++)
+    serialPermHost(serialHost(i)) = i;
+  size_t serialBW = maxBandwidth(rowmapHost, entriesHost, serialHost, serialPermHost);
+  EXPECT_LE(rcmBW, 2 * serialBW);
+}
+
+//Two 7-pt grids side by side with isolated vertices before, between and after them.
+//The middle one keeps only its diagonal entry, like a dropped Dirichlet row. The
+//isolated vertices are all labeled up front, and the second grid's root comes from
+//findNextUnlabeled, past the first 1024-vertex chunk it scans.
+template <typename lno_t, typename size_type, typename device>
+void test_rcm_disconnected(lno_t gridA, lno_t gridB)
+{
+  typedef typename KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type rowmap_t;
+  typedef typename graph_t::entries_type entries_t;
+  typename rowmap_t::non_const_type rowmapA, rowmapB;
+  typename entries_t::non_const_type entriesA, entriesB;
+  generate7pt(rowmapA, entriesA, gridA, gridA, gridA);
+  generate7pt(rowmapB, entriesB, gridB, gridB, gridB);
+  auto rowmapAHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rowmapA);
+  auto entriesAHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), entriesA);
+  auto rowmapBHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rowmapB);
+  auto entriesBHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), entriesB);
+  lno_t numA = rowmapAHost.extent(0) - 1;
+  lno_t numB = rowmapBHost.extent(0) - 1;
+  //layout: isolated, grid A, isolated, grid B, isolated
+  lno_t offsetA = 1;
+  lno_t offsetB = offsetA + numA + 1;
+  lno_t numVerts = offsetB + numB + 1;
+  std::vector<size_type> rowmapVec(numVerts + 1, 0);
+  std::vector<lno_t> entriesVec;
+  for(lno_t v = 0; v < numVerts; v++)
+  {
+    if(v >= offsetA && v < offsetA + numA)
+    {
+      for(size_type j = rowmapAHost(v - offsetA); j < rowmapAHost(v - offsetA + 1); j++)
+        entriesVec.push_back(entriesAHost(j) + offsetA);
+    }
+    else if(v >= offsetB && v < offsetB + numB)
+    {
+      for(size_type j = rowmapBHost(v - offsetB); j < rowmapBHost(v - offsetB + 1); j++)
+        entriesVec.push_back(entriesBHost(j) + offsetB);
+    }
+    else if(v == offsetA + numA)
+      entriesVec.push_back(v);
+    rowmapVec[v + 1] = entriesVec.size();
+  }
+  typename rowmap_t::non_const_type rowmap(Kokkos::ViewAllocateWithoutInitializing("Rowmap"), numVerts + 1);
+  typename entries_t::non_const_type entries(Kokkos::ViewAllocateWithoutInitializing("Colinds"), entriesVec.size());
+  auto rowmapHost = Kokkos::create_mirror_view(rowmap);
+  auto entriesHost = Kokkos::create_mirror_view(entries);
+  for(lno_t v = 0; v <= numVerts; v++)
+    rowmapHost(v) = rowmapVec[v];
+  for(size_t j = 0; j < entriesVec.size(); j++)
+    entriesHost(j) = entriesVec[j];
+  Kokkos::deep_copy(rowmap, rowmapHost);
+  Kokkos::deep_copy(entries, entriesHost);
+
+  auto rcm = KokkosGraph::Experimental::graph_rcm<device, rowmap_t, entries_t>(rowmap, entries);
+  auto rcmHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rcm);
+  decltype(rcmHost) rcmPermHost(Kokkos::ViewAllocateWithoutInitializing("RCMPerm"), numVerts);
+  //make sure each row index shows up exactly once
+  {
+    std::vector<int> counts(numVerts);
+    for(lno_t i = 0; i < numVerts; i++)
+    {
+      lno_t orig = rcmHost(i);
+      ASSERT_GE(orig, 0);
+      ASSERT_LT(orig, numVerts);
+      counts[orig]++;
+    }
+    for(lno_t i = 0; i < numVerts; i++)
+      ASSERT_EQ(counts[i], 1);
+  }
+  for(lno_t i = 0; i < numVerts; i++)
+    rcmPermHost(rcmHost(i)) = i;
+  //label the connected components on host
+  std::vector<lno_t> component(numVerts, -1);
+  lno_t numComponents = 0;
+  for(lno_t root = 0; root < numVerts; root++)
+  {
+    if(component[root] != -1)
+      continue;
+    std::vector<lno_t> stack(1, root);
+    component[root] = numComponents;
+    while(!stack.empty())
+    {
+      lno_t v = stack.back();
+      stack.pop_back();
+      for(size_type j = rowmapHost(v); j < rowmapHost(v + 1); j++)
+      {
+        lno_t nei = entriesHost(j);
+        if(component[nei] == -1)
+        {
+          component[nei] = numComponents;
+          stack.push_back(nei);
+        }
+      }
+    }
+    numComponents++;
+  }
+  //each component must get a contiguous range of new labels
+  lno_t numRuns = numVerts > 0 ? 1 : 0;
+  for(lno_t i = 1; i < numVerts; i++)
+  {
+    if(component[rcmPermHost(i)] != component[rcmPermHost(i - 1)])
+      numRuns++;
+  }
+  EXPECT_EQ(numRuns, numComponents);
+  //bandwidth is still comparable to the serial ordering
+  KokkosGraph::Experimental::Impl::SerialRCM<rowmap_t, entries_t, decltype(rcmHost)> serialAlgo(rowmap, entries);
+  auto serialHost = serialAlgo.rcm();
+  decltype(rcmHost) serialPermHost(Kokkos::ViewAllocateWithoutInitializing("SerialRCMPerm"), numVerts);
+  for(lno_t i = 0; i < numVerts; i++)
+    serialPermHost(serialHost(i)) = i;
+  size_t rcmBW = maxBandwidth(rowmapHost, entriesHost, rcmHost, rcmPermHost);
+  size_t serialBW = maxBandwidth(rowmapHost, entriesHost, serialHost, serialPermHost);
+  EXPECT_LE(rcmBW, 2 * serialBW);
 }
 
 #define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE) \
@@ -174,6 +298,7 @@ TEST_F( TestCategory, graph ## _ ## rcm ## _ ## SCALAR ## _ ## ORDINAL ## _ ## O
   test_rcm<ORDINAL,OFFSET,DEVICE>(6, 3, 3); \
   test_rcm<ORDINAL,OFFSET,DEVICE>(20, 20, 20); \
   test_rcm<ORDINAL,OFFSET,DEVICE>(100, 100, 1); \
+  test_rcm_disconnected<ORDINAL,OFFSET,DEVICE>(12, 8); \
 }
 
 #if (defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
@@ -0,0 +1,3 @@
+#include "Test_HIP.hpp"
+#include "Test_Batched_Spmv.hpp"
+#include "Test_Batched_Spmv_Real.hpp"
@@ -0,0 +1,2 @@
+#include<Test_HIP.hpp>
+#include<Test_Graph_bfs.hpp>
@@ -0,0 +1,3 @@
+#include "Test_Serial.hpp"
+#include "Test_Batched_Spmv.hpp"
+#include "Test_Batched_Spmv_Real.hpp"
@@ -48,6 +48,8 @@
 #include <stdexcept>
 #include "KokkosSparse_BlockCrsMatrix.hpp"
 #include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv.hpp"
+#include "KokkosKernels_IOUtils.hpp"
 
 #ifndef kokkos_complex_double
 #define kokkos_complex_double Kokkos::complex<double>
@@ -369,9 +371,113 @@ testBlockCrsMatrix ()
 
 }
 
+// Build a point CrsMatrix with dense bs x bs blocks on a random block
+// graph, wrap it in a BlockCrsMatrix and compare the two spmv results.
+template <typename scalar_t, typename lno_t, typename size_type, typename device>
+void
+testBlockCrsMatrixSpmv (const lno_t numBlockRows, const lno_t blockDim)
+{
+  typedef KokkosSparse::CrsMatrix<scalar_t, lno_t, device, void, size_type> crs_matrix_type;
+  typedef KokkosSparse::Experimental::BlockCrsMatrix<scalar_t, lno_t, device, void, size_type> block_crs_matrix_type;
+  typedef typename crs_matrix_type::values_type::non_const_type values_type;
+  typedef typename crs_matrix_type::row_map_type::non_const_type row_map_type;
+  typedef typename crs_matrix_type::index_type::non_const_type entries_type;
+  typedef Kokkos::View<scalar_t**, Kokkos::LayoutLeft, device> mv_type;
+  typedef typename Kokkos::ArithTraits<scalar_t>::mag_type mag_type;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 1e-3 : 1e-10;
+
+  crs_matrix_type blockGraph = KokkosKernels::Impl::kk_generate_sparse_matrix<crs_matrix_type>
+    (numBlockRows, numBlockRows, numBlockRows * 5, 2, numBlockRows / 4 + 1);
+  auto h_brow_map = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), blockGraph.graph.row_map);
+  auto h_bentries = Kokkos::create_mirror_view_and_copy (Kokkos::HostSpace (), blockGraph.graph.entries);
+
+  const lno_t numRows = numBlockRows * blockDim;
+  const size_type numBlocks = h_brow_map(numBlockRows);
+  const size_type nnz = numBlocks * blockDim * blockDim;
+
+  row_map_type row_map ("row_map", numRows + 1);
+  entries_type entries ("entries", nnz);
+  values_type values ("values", nnz);
+  auto h_row_map = Kokkos::create_mirror_view (row_map);
+  auto h_entries = Kokkos::create_mirror_view (entries);
+  auto h_values  = Kokkos::create_mirror_view (values);
+
+  size_type pos = 0;
+  h_row_map(0) = 0;
+  for (lno_t I = 0; I < numBlockRows; ++I) {
+    for (lno_t i = 0; i < blockDim; ++i) {
+      for (size_type K = h_brow_map(I); K < h_brow_map(I + 1); ++K) {
+        for (lno_t j = 0; j < blockDim; ++j) {
+          h_entries(pos) = h_bentries(K) * blockDim + j;
+          h_values(pos)  = scalar_t (1.0 + (pos % 7) - 0.25 * i + 0.5 * j);
+          ++pos;
+        }
+      }
+      h_row_map(I * blockDim + i + 1) = pos;
+    }
+  }
+  Kokkos::deep_copy (row_map, h_row_map);
+  Kokkos::deep_copy (entries, h_entries);
+  Kokkos::deep_copy (values, h_values);
+
+  crs_matrix_type crsA ("crsA", numRows, numRows, nnz, values, row_map, entries);
+  // The point values are laid out block-row by block-row, which is the
+  // BlockCrsMatrix storage order, so both matrices share them.
+  block_crs_matrix_type A ("A", numBlockRows, numBlockRows, nnz, values,
+                           blockGraph.graph.row_map, blockGraph.graph.entries, blockDim);
+
+  const int numVecs = 3;
+  mv_type x ("x", numRows, numVecs);
+  mv_type y ("y", numRows, numVecs);
+  mv_type y_expected ("y_expected", numRows, numVecs);
+  auto h_x = Kokkos::create_mirror_view (x);
+  for (lno_t i = 0; i < numRows; ++i) {
+    for (int k = 0; k < numVecs; ++k) {
+      h_x(i, k) = scalar_t (0.5 + ((i + 3 * k) % 11) * 0.125);
+    }
+  }
+  Kokkos::deep_copy (x, h_x);
+
+  for (char mode : {'N', 'T'}) {
+    for (double beta : {0.0, 1.5}) {
+      const double alpha = -2.0;
+      Kokkos::deep_copy (y, scalar_t (1.0));
+      Kokkos::deep_copy (y_expected, scalar_t (1.0));
+
+      // rank-1
+      auto x0 = Kokkos::subview (x, Kokkos::ALL (), 0);
+      auto y0 = Kokkos::subview (y, Kokkos::ALL (), 0);
+      auto y0_expected = Kokkos::subview (y_expected, Kokkos::ALL (), 0);
+      KokkosSparse::spmv (&mode, alpha, crsA, x0, beta, y0_expected);
+      KokkosSparse::Experimental::spmv (&mode, alpha, A, x0, beta, y0);
+      Kokkos::fence ();
+      EXPECT_TRUE ((KokkosKernels::Impl::kk_is_identical_view<decltype (y0), decltype (y0_expected), mag_type,
+                      typename device::execution_space> (y0, y0_expected, eps * nnz / numRows)))
+        << "rank-1, blockDim " << blockDim << ", mode " << mode << ", beta " << beta;
+
+      // rank-2
+      Kokkos::deep_copy (y, scalar_t (1.0));
+      Kokkos::deep_copy (y_expected, scalar_t (1.0));
+      KokkosSparse::spmv (&mode, alpha, crsA, x, beta, y_expected);
+      KokkosSparse::Experimental::spmv (&mode, alpha, A, x, beta, y);
+      Kokkos::fence ();
+      for (int k = 0; k < numVecs; ++k) {
+        auto yk = Kokkos::subview (y, Kokkos::ALL (), k);
+        auto yk_expected = Kokkos::subview (y_expected, Kokkos::ALL (), k);
+        EXPECT_TRUE ((KokkosKernels::Impl::kk_is_identical_view<decltype (yk), decltype (yk_expected), mag_type,
+                        typename device::execution_space> (yk, yk_expected, eps * nnz / numRows)))
+          << "rank-2, blockDim " << blockDim << ", mode " << mode << ", beta " << beta << ", column " << k;
+      }
+    }
+  }
+}
+
 #define EXECUTE_BLOCKCRS_TEST(SCALAR, ORDINAL, OFFSET, DEVICE) \
 TEST_F( TestCategory, sparse ## _ ## blkcrsmatrix ## _ ## SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## DEVICE ) { \
   testBlockCrsMatrix<SCALAR, ORDINAL, OFFSET, DEVICE> (); \
+  for (ORDINAL blockDim : {1, 2, 3, 4, 5, 6, 7, 8, 11}) \
+    testBlockCrsMatrixSpmv<SCALAR, ORDINAL, OFFSET, DEVICE> (200, blockDim); \
 }
 
 
@@ -62,6 +62,7 @@
 
 //This file contains the matrix for test_issue402
 #include "matrixIssue402.hpp"
+#include "Test_Sparse_spgemm_utils.hpp"
 
 //const char *input_filename = "sherman1.mtx";
 //const char *input_filename = "Si2.mtx";
@@ -79,30 +80,6 @@ using namespace KokkosKernels::Experimental;
 
 namespace Test {
 
-template <typename crsMat_t, typename device>
-int run_spgemm(crsMat_t A, crsMat_t B, KokkosSparse::SPGEMMAlgorithm spgemm_algorithm, crsMat_t &C) {
-
-  typedef typename crsMat_t::size_type size_type;
-  typedef typename crsMat_t::ordinal_type lno_t;
-  typedef typename crsMat_t::value_type scalar_t;
-
-  typedef KokkosKernels::Experimental::KokkosKernelsHandle
-      <size_type, lno_t, scalar_t,
-      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
-
-  KernelHandle kh;
-  kh.set_team_work_size(16);
-  kh.set_dynamic_scheduling(true);
-
-  kh.create_spgemm_handle(spgemm_algorithm);
-
-  KokkosSparse::spgemm_symbolic(kh, A, false, B, false, C);
-  KokkosSparse::spgemm_numeric(kh, A, false, B, false, C);
-  kh.destroy_spgemm_handle();
-
-  return 0;
-}
-
 template <typename crsMat_t, typename device>
 int run_spgemm_old_interface(crsMat_t input_mat, crsMat_t input_mat2, KokkosSparse::SPGEMMAlgorithm spgemm_algorithm, crsMat_t &result) {
   typedef typename crsMat_t::StaticCrsGraphType graph_t;
@@ -183,113 +160,6 @@ int run_spgemm_old_interface(crsMat_t input_mat, crsMat_t input_mat2, KokkosSpar
 
   return 0;
 }
-template <typename crsMat_t, typename device>
-bool is_same_matrix(crsMat_t output_mat_actual, crsMat_t output_mat_reference){
-
-  typedef typename crsMat_t::StaticCrsGraphType graph_t;
-  typedef typename graph_t::row_map_type::non_const_type lno_view_t;
-  typedef typename graph_t::entries_type::non_const_type   lno_nnz_view_t;
-  typedef typename crsMat_t::values_type::non_const_type scalar_view_t;
-
-  size_t nrows_actual = output_mat_actual.numRows();
-  size_t nentries_actual = output_mat_actual.graph.entries.extent(0) ;
-  size_t nvals_actual = output_mat_actual.values.extent(0);
-
-  size_t nrows_reference = output_mat_reference.numRows();
-  size_t nentries_reference = output_mat_reference.graph.entries.extent(0) ;
-  size_t nvals_reference = output_mat_reference.values.extent(0);
-
-
-  lno_nnz_view_t h_ent_actual (Kokkos::ViewAllocateWithoutInitializing("h_ent_actual"), nentries_actual);
-  scalar_view_t h_vals_actual (Kokkos::ViewAllocateWithoutInitializing("h_vals_actual"), nvals_actual);
-
-
-  KokkosKernels::Impl::kk_sort_graph<typename graph_t::row_map_type,
-    typename graph_t::entries_type,
-    typename crsMat_t::values_type,
-    lno_nnz_view_t,
-    scalar_view_t,
-    typename device::execution_space
-    >(
-    output_mat_actual.graph.row_map, 
-    output_mat_actual.graph.entries, 
-    output_mat_actual.values,
-    h_ent_actual, h_vals_actual
-  );
-
-  lno_nnz_view_t h_ent_reference (Kokkos::ViewAllocateWithoutInitializing("h_ent_reference"), nentries_reference);
-  scalar_view_t h_vals_reference (Kokkos::ViewAllocateWithoutInitializing("h_vals_reference"), nvals_reference);
-
-  if (nrows_actual != nrows_reference) { 
-     std::cout << "nrows_actual:" << nrows_actual << " nrows_reference:" << nrows_reference << std::endl;
-     return false;
-  }
-  if (nentries_actual != nentries_reference) {
-    std::cout << "nentries_actual:" << nentries_actual << " nentries_reference:" << nentries_reference << std::endl;
-    return false;
-  }
-  if (nvals_actual != nvals_reference) {
-    std::cout << "nvals_actual:" << nvals_actual << " nvals_reference:" << nvals_reference << std::endl;
-    return false;
-  }
-
-  KokkosKernels::Impl::kk_sort_graph
-      <typename graph_t::row_map_type,
-      typename graph_t::entries_type,
-      typename crsMat_t::values_type,
-      lno_nnz_view_t,
-      scalar_view_t,
-      typename device::execution_space
-      >(
-      output_mat_reference.graph.row_map, 
-      output_mat_reference.graph.entries, 
-      output_mat_reference.values,
-      h_ent_reference, h_vals_reference
-    );
-
-  bool is_identical = true;
-  is_identical = KokkosKernels::Impl::kk_is_identical_view
-      <typename graph_t::row_map_type, typename graph_t::row_map_type, typename lno_view_t::value_type,
-      typename device::execution_space>(output_mat_actual.graph.row_map, output_mat_reference.graph.row_map, 0);
-
-  if (!is_identical) {
-    std::cout << "rowmaps are different." << std::endl;
-    std::cout << "Actual rowmap:\n";
-    KokkosKernels::Impl::kk_print_1Dview(output_mat_actual.graph.row_map);
-    std::cout << "Correct rowmap (SPGEMM_DEBUG):\n";
-    KokkosKernels::Impl::kk_print_1Dview(output_mat_reference.graph.row_map);
-    return false;
-  }
-
-  is_identical = KokkosKernels::Impl::kk_is_identical_view
-      <lno_nnz_view_t, lno_nnz_view_t, typename lno_nnz_view_t::value_type,
-      typename device::execution_space>(h_ent_actual, h_ent_reference, 0 );
-
-  if (!is_identical) {
-    std::cout << "entries are different." << std::endl;
-    KokkosKernels::Impl::kk_print_1Dview(h_ent_actual);
-    KokkosKernels::Impl::kk_print_1Dview(h_ent_reference);
-    return false;
-  }
-
-
-  typedef typename Kokkos::Details::ArithTraits<typename scalar_view_t::non_const_value_type>::mag_type eps_type;
-  eps_type eps = std::is_same<eps_type,float>::value?2*1e-3:1e-7;
-
-
-  is_identical = KokkosKernels::Impl::kk_is_relatively_identical_view
-      <scalar_view_t, scalar_view_t, eps_type,
-      typename device::execution_space>(h_vals_actual, h_vals_reference, eps);
-
-  if (!is_identical) {
-    std::cout << "values are different." << std::endl;
-    KokkosKernels::Impl::kk_print_1Dview(output_mat_actual.values);
-    KokkosKernels::Impl::kk_print_1Dview(output_mat_reference.values);
-
-    return false;
-  }
-  return true;
-}
 }
 
 template <typename scalar_t, typename lno_t, typename size_type, typename device>
@@ -317,7 +187,7 @@ void test_spgemm(lno_t numRows, size_type nnz, lno_t bandwidth, lno_t row_size_v
   else
     run_spgemm<crsMat_t, device>(input_mat, input_mat, SPGEMM_DEBUG, output_mat2);
 
-  std::vector<SPGEMMAlgorithm> algorithms = {SPGEMM_KK_MEMORY, SPGEMM_KK_SPEED, SPGEMM_KK_MEMSPEED};
+  std::vector<SPGEMMAlgorithm> algorithms = {SPGEMM_KK_MEMORY, SPGEMM_KK_SPEED, SPGEMM_KK_MEMSPEED, SPGEMM_AUTO};
 
 #ifdef HAVE_KOKKOSKERNELS_MKL
   algorithms.push_back(SPGEMM_MKL);
@@ -368,6 +238,9 @@ void test_spgemm(lno_t numRows, size_type nnz, lno_t bandwidth, lno_t row_size_v
     case SPGEMM_KK_MEMORY:
       algo = "SPGEMM_KK_MEMORY";
       break;
+    case SPGEMM_AUTO:
+      algo = "SPGEMM_AUTO";
+      break;
     default:
       algo = "!!! UNKNOWN ALGO !!!";
     }
@@ -483,12 +356,170 @@ void test_issue402()
   EXPECT_TRUE(correctResult) << "KKMEM still has issue 402 bug; C=AA' is incorrect!\n";
 }
 
+template <typename scalar_t, typename lno_t, typename size_type, typename device>
+void test_spgemm_reuse_numeric(lno_t numRows, size_type nnz, lno_t bandwidth, lno_t row_size_variance, size_t budget) {
+
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::values_type::non_const_type scalar_view_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle
+      <size_type, lno_t, scalar_t,
+      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
+
+  lno_t numCols = numRows;
+  crsMat_t A = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numCols,nnz,row_size_variance, bandwidth);
+
+  KernelHandle kh;
+  kh.set_team_work_size(16);
+  kh.set_dynamic_scheduling(true);
+  kh.create_spgemm_handle(SPGEMM_KK_MEMORY);
+  kh.get_spgemm_handle()->set_c_position_map_budget(budget);
+
+  crsMat_t C;
+  KokkosSparse::spgemm_symbolic(kh, A, false, A, false, C);
+  KokkosSparse::spgemm_numeric(kh, A, false, A, false, C);
+
+  crsMat_t Cgold;
+  run_spgemm<crsMat_t, device>(A, A, SPGEMM_DEBUG, Cgold);
+  EXPECT_TRUE(is_same_matrix<crsMat_t, device>(C, Cgold));
+
+  //the map is only kept if it fits.
+  size_t map_bytes = (A.numRows() + 1) * sizeof(size_type);
+  {
+    auto h_rowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), A.graph.row_map);
+    auto h_entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), A.graph.entries);
+    for (size_t i = 0; i < h_entries.extent(0); i++)
+      map_bytes += (h_rowmap(h_entries(i) + 1) - h_rowmap(h_entries(i))) * sizeof(size_type);
+  }
+  EXPECT_EQ(map_bytes <= budget, kh.get_spgemm_handle()->has_c_position_map(C.graph.entries));
+
+  //same pattern, new values, for both A and B.
+  scalar_view_t values2(Kokkos::ViewAllocateWithoutInitializing("A2 values"), A.values.extent(0));
+  {
+    auto h_values = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), A.values);
+    for (size_t i = 0; i < h_values.extent(0); i++)
+      h_values(i) = h_values(i) * scalar_t(2) - scalar_t(i % 3);
+    Kokkos::deep_copy(values2, h_values);
+  }
+  crsMat_t A2("A2", A.numCols(), values2, A.graph);
+
+  for (int repeat = 0; repeat < 2; repeat++){
+    KokkosSparse::spgemm_numeric(kh, A2, false, A2, false, C);
+    crsMat_t C2gold;
+    run_spgemm<crsMat_t, device>(A2, A2, SPGEMM_DEBUG, C2gold);
+    EXPECT_TRUE(is_same_matrix<crsMat_t, device>(C, C2gold)) << "repeat " << repeat;
+  }
+
+  //another C with the same pattern, in new views, does not take the map of the first one.
+  {
+    typename crsMat_t::row_map_type::non_const_type rowmap3(Kokkos::ViewAllocateWithoutInitializing("C3 rowmap"), C.graph.row_map.extent(0));
+    typename crsMat_t::index_type::non_const_type entries3(Kokkos::ViewAllocateWithoutInitializing("C3 entries"), C.graph.entries.extent(0));
+    scalar_view_t values3("C3 values", C.values.extent(0));
+    Kokkos::deep_copy(rowmap3, C.graph.row_map);
+    Kokkos::deep_copy(entries3, C.graph.entries);
+    crsMat_t C3("C3", C.numCols(), values3, typename crsMat_t::StaticCrsGraphType(entries3, rowmap3));
+    EXPECT_FALSE(kh.get_spgemm_handle()->has_c_position_map(C3.graph.entries));
+    KokkosSparse::spgemm_numeric(kh, A2, false, A2, false, C3);
+    crsMat_t C3gold;
+    run_spgemm<crsMat_t, device>(A2, A2, SPGEMM_DEBUG, C3gold);
+    EXPECT_TRUE(is_same_matrix<crsMat_t, device>(C3, C3gold));
+    EXPECT_EQ(map_bytes <= budget, kh.get_spgemm_handle()->has_c_position_map(C.graph.entries));
+  }
+
+  //a new symbolic phase drops the map.
+  KokkosSparse::spgemm_symbolic(kh, A2, false, A2, false, C);
+  EXPECT_FALSE(kh.get_spgemm_handle()->is_c_position_map_decided());
+  kh.destroy_spgemm_handle();
+}
+
+template <typename scalar_t, typename lno_t, typename size_type, typename device>
+void test_spgemm_auto(lno_t numRows, lno_t numColsB, size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle
+      <size_type, lno_t, scalar_t,
+      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
+
+  size_type nnzB = nnz;
+  crsMat_t A = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  crsMat_t B = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numColsB,nnzB,row_size_variance, numColsB);
+
+  KernelHandle kh;
+  kh.create_spgemm_handle(SPGEMM_AUTO);
+  kh.get_spgemm_handle()->set_auto_sample_rows(256);
+  crsMat_t C;
+  KokkosSparse::spgemm_symbolic(kh, A, false, B, false, C);
+  KokkosSparse::spgemm_numeric(kh, A, false, B, false, C);
+
+  //the choice is reported and applied.
+  const SPGEMMAutoSelection &selection = kh.get_spgemm_handle()->get_auto_selection();
+  EXPECT_EQ(size_t(std::min<lno_t>(numRows, 256)), selection.num_sampled_rows);
+  EXPECT_EQ(selection.algorithm, kh.get_spgemm_handle()->get_algorithm_type());
+  EXPECT_EQ(selection.accumulator, kh.get_spgemm_handle()->get_accumulator_type());
+  EXPECT_TRUE(kh.get_spgemm_handle()->is_auto_algorithm());
+  EXPECT_TRUE(selection.b_compression_ratio > 0 && selection.b_compression_ratio <= 1);
+  //a dense accumulator is never chosen for more columns than MaxColDenseAcc.
+  if (size_t(numColsB) >= size_t(kh.get_spgemm_handle()->MaxColDenseAcc))
+    EXPECT_NE(SPGEMM_KK_DENSE, selection.algorithm);
+
+  crsMat_t Cgold;
+  run_spgemm<crsMat_t, device>(A, B, SPGEMM_DEBUG, Cgold);
+  EXPECT_TRUE(is_same_matrix<crsMat_t, device>(C, Cgold)) << selection.algorithm_name();
+}
+
+template <typename scalar_t, typename lno_t, typename size_type, typename device>
+void test_spgemm_auto_reselect(lno_t numRows) {
+
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle
+      <size_type, lno_t, scalar_t,
+      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
+
+  //a wide B with short rows needs a sparse accumulator and has few flops per row,
+  //a narrow B with long rows gives nearly dense rows of C.
+  const lno_t wideCols = 300000, narrowCols = 64;
+  crsMat_t A = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows, numRows, numRows * 20, 2, 100);
+  crsMat_t Bwide = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows, wideCols, numRows * 5, 2, wideCols);
+  crsMat_t Bnarrow = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows, narrowCols, numRows * 20, 2, narrowCols);
+
+  //the same handle, so the choice is made again at each symbolic phase.
+  KernelHandle kh;
+  kh.create_spgemm_handle(SPGEMM_AUTO);
+  kh.get_spgemm_handle()->set_auto_sample_rows(256);
+
+  crsMat_t Cwide, Cwidegold;
+  KokkosSparse::spgemm_symbolic(kh, A, false, Bwide, false, Cwide);
+  KokkosSparse::spgemm_numeric(kh, A, false, Bwide, false, Cwide);
+  const SPGEMMAlgorithm wide_algorithm = kh.get_spgemm_handle()->get_auto_selection().algorithm;
+  EXPECT_EQ(SPGEMM_KK_MEMORY, wide_algorithm);
+  EXPECT_EQ(wide_algorithm, kh.get_spgemm_handle()->get_algorithm_type());
+  run_spgemm<crsMat_t, device>(A, Bwide, SPGEMM_DEBUG, Cwidegold);
+  EXPECT_TRUE(is_same_matrix<crsMat_t, device>(Cwide, Cwidegold)) << "wide B";
+
+  crsMat_t Cnarrow, Cnarrowgold;
+  KokkosSparse::spgemm_symbolic(kh, A, false, Bnarrow, false, Cnarrow);
+  KokkosSparse::spgemm_numeric(kh, A, false, Bnarrow, false, Cnarrow);
+  const SPGEMMAlgorithm narrow_algorithm = kh.get_spgemm_handle()->get_auto_selection().algorithm;
+  EXPECT_NE(wide_algorithm, narrow_algorithm);
+  EXPECT_EQ(narrow_algorithm, kh.get_spgemm_handle()->get_algorithm_type());
+  EXPECT_TRUE(kh.get_spgemm_handle()->is_auto_algorithm());
+  run_spgemm<crsMat_t, device>(A, Bnarrow, SPGEMM_DEBUG, Cnarrowgold);
+  EXPECT_TRUE(is_same_matrix<crsMat_t, device>(Cnarrow, Cnarrowgold)) << "narrow B";
+}
+
 #define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE) \
 TEST_F( TestCategory, sparse ## _ ## spgemm ## _ ## SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## DEVICE ) { \
   test_spgemm<SCALAR,ORDINAL,OFFSET,DEVICE>(10000, 10000 * 20, 500, 10); \
   test_spgemm<SCALAR,ORDINAL,OFFSET,DEVICE>(0, 0, 10, 10); \
   test_issue402<SCALAR,ORDINAL,OFFSET,DEVICE>(); \
   test_spgemm<SCALAR,ORDINAL,OFFSET,DEVICE>(10000, 10000 * 20, 500, 10, true); \
+  test_spgemm_reuse_numeric<SCALAR,ORDINAL,OFFSET,DEVICE>(2000, 2000 * 20, 100, 10, size_t(1) << 30); \
+  test_spgemm_reuse_numeric<SCALAR,ORDINAL,OFFSET,DEVICE>(2000, 2000 * 20, 100, 10, 1); \
+  test_spgemm_auto<SCALAR,ORDINAL,OFFSET,DEVICE>(2000, 2000, 2000 * 20, 100, 10); \
+  test_spgemm_auto<SCALAR,ORDINAL,OFFSET,DEVICE>(2000, 300000, 2000 * 5, 100, 2); \
+  test_spgemm_auto_reselect<SCALAR,ORDINAL,OFFSET,DEVICE>(2000); \
 }
 
 //test_spgemm<SCALAR,ORDINAL,OFFSET,DEVICE>(50000, 50000 * 30, 100, 10);
@@ -0,0 +1,259 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include "KokkosKernels_SparseUtils.hpp"
+#include "KokkosKernels_IOUtils.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spgemm.hpp"
+#include "KokkosSparse_spgemm_chunked.hpp"
+#include "Test_Sparse_spgemm_utils.hpp"
+
+#ifndef kokkos_complex_double
+#define kokkos_complex_double Kokkos::complex<double>
+#define kokkos_complex_float Kokkos::complex<float>
+#endif
+
+template <typename scalar_t, typename lno_t, typename size_type, typename device>
+void test_spgemm_chunked(lno_t numRows, size_type nnz, lno_t bandwidth, lno_t row_size_variance, size_t budget) {
+
+  using namespace Test;
+  typedef KokkosSparse::CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle
+      <size_type, lno_t, scalar_t,
+      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
+
+  lno_t numCols = numRows;
+  crsMat_t A = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows, numCols, nnz, row_size_variance, bandwidth);
+  crsMat_t Cgold;
+  run_spgemm<crsMat_t, device>(A, A, KokkosSparse::SPGEMM_DEBUG, Cgold);
+
+  //compacted into a single matrix.
+  {
+    KernelHandle kh;
+    kh.create_spgemm_handle(KokkosSparse::SPGEMM_KK_MEMORY);
+    kh.get_spgemm_handle()->set_chunk_memory_budget(budget);
+    crsMat_t C;
+    size_t num_batches = KokkosSparse::spgemm_chunked(kh, A, A, C);
+    if (budget == 0) EXPECT_EQ(size_t(numRows > 0), num_batches);
+    if (budget == 1) EXPECT_EQ(size_t(numRows), num_batches);
+
+    EXPECT_TRUE(is_same_matrix<crsMat_t, device>(C, Cgold)) << "compacted, budget " << budget;
+  }
+
+  //streamed to a callback, which gathers the batches on the host.
+  {
+    KernelHandle kh;
+    kh.create_spgemm_handle(KokkosSparse::SPGEMM_KK_MEMORY);
+    kh.get_spgemm_handle()->set_chunk_memory_budget(budget);
+    lno_t next_row = 0;
+    std::vector<size_type> rowmap_all(1, 0);
+    std::vector<lno_t> entries_all;
+    std::vector<scalar_t> values_all;
+    size_t num_batches = KokkosSparse::Experimental::spgemm_chunked(
+        &kh, numRows, numCols, numCols,
+        A.graph.row_map, A.graph.entries, A.values,
+        A.graph.row_map, A.graph.entries, A.values,
+        [&](lno_t row_begin, lno_t row_end, const auto &rowmapC, const auto &entriesC, const auto &valuesC){
+          EXPECT_EQ(next_row, row_begin);
+          next_row = row_end;
+          auto h_rowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rowmapC);
+          auto h_entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), entriesC);
+          auto h_values = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), valuesC);
+          const size_type offset = rowmap_all.back();
+          for (lno_t r = 0; r < row_end - row_begin; r++)
+            rowmap_all.push_back(offset + h_rowmap(r + 1));
+          for (size_type j = 0; j < h_rowmap(row_end - row_begin); j++){
+            entries_all.push_back(h_entries(j));
+            values_all.push_back(h_values(j));
+          }
+        });
+    EXPECT_EQ(numRows, next_row);
+    if (budget == 1) EXPECT_EQ(size_t(numRows), num_batches);
+
+    typename crsMat_t::row_map_type::non_const_type rowmap("streamed rowmap", rowmap_all.size());
+    typename crsMat_t::index_type::non_const_type entries("streamed entries", entries_all.size());
+    typename crsMat_t::values_type::non_const_type values("streamed values", values_all.size());
+    auto h_rowmap = Kokkos::create_mirror_view(rowmap);
+    auto h_entries = Kokkos::create_mirror_view(entries);
+    auto h_values = Kokkos::create_mirror_view(values);
+    for (size_t i = 0; i < rowmap_all.size(); i++) h_rowmap(i) = rowmap_all[i];
+    for (size_t j = 0; j < entries_all.size(); j++){
+      h_entries(j) = entries_all[j];
+      h_values(j) = values_all[j];
+    }
+    Kokkos::deep_copy(rowmap, h_rowmap);
+    Kokkos::deep_copy(entries, h_entries);
+    Kokkos::deep_copy(values, h_values);
+    crsMat_t C("C streamed", numRows, numCols, entries_all.size(), values, rowmap, entries);
+    EXPECT_TRUE(is_same_matrix<crsMat_t, device>(C, Cgold)) << "callback, budget " << budget;
+  }
+
+  //the handle does not keep the symbolic phase of the last batch.
+  {
+    KernelHandle kh;
+    kh.create_spgemm_handle(KokkosSparse::SPGEMM_KK_MEMORY);
+    kh.get_spgemm_handle()->set_chunk_memory_budget(budget);
+    crsMat_t C;
+    KokkosSparse::spgemm_chunked(kh, A, A, C);
+    EXPECT_FALSE(kh.get_spgemm_handle()->is_symbolic_called());
+    EXPECT_THROW(KokkosSparse::spgemm_numeric(kh, A, false, A, false, C), std::runtime_error);
+
+    crsMat_t C2;
+    KokkosSparse::spgemm_symbolic(kh, A, false, A, false, C2);
+    KokkosSparse::spgemm_numeric(kh, A, false, A, false, C2);
+    EXPECT_TRUE(is_same_matrix<crsMat_t, device>(C2, Cgold)) << "numeric after chunked, budget " << budget;
+  }
+}
+
+#define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE) \
+TEST_F( TestCategory, sparse ## _ ## spgemm_chunked ## _ ## SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## DEVICE ) { \
+  test_spgemm_chunked<SCALAR,ORDINAL,OFFSET,DEVICE>(2000, 2000 * 20, 100, 10, 0); \
+  test_spgemm_chunked<SCALAR,ORDINAL,OFFSET,DEVICE>(2000, 2000 * 20, 100, 10, 64 * 1024); \
+  test_spgemm_chunked<SCALAR,ORDINAL,OFFSET,DEVICE>(200, 200 * 10, 50, 5, 1); \
+  test_spgemm_chunked<SCALAR,ORDINAL,OFFSET,DEVICE>(0, 0, 10, 10, 64 * 1024); \
+}
+
+#if (defined (KOKKOSKERNELS_INST_DOUBLE) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_DOUBLE) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_DOUBLE) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_DOUBLE) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(double, int64_t, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_FLOAT) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(float, int, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_FLOAT) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(float, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_FLOAT) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(float, int, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_FLOAT) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(float, int64_t, size_t, TestExecSpace)
+#endif
+
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_DOUBLE_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_double, int, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_DOUBLE_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_double, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_DOUBLE_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_double, int, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_DOUBLE_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_double, int64_t, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_float, int, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_float, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_float, int, size_t, TestExecSpace)
+#endif
+
+#if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST(kokkos_complex_float, int64_t, size_t, TestExecSpace)
+#endif
+
+
@@ -0,0 +1,195 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 3.0
+//       Copyright (2020) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY NTESS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL NTESS OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Siva Rajamanickam (srajama@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef TEST_SPARSE_SPGEMM_UTILS_HPP
+#define TEST_SPARSE_SPGEMM_UTILS_HPP
+
+#include <iostream>
+#include <type_traits>
+
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosKernels_SparseUtils.hpp"
+#include "KokkosKernels_Utils.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spgemm.hpp"
+
+//Reference product and comparison shared by the spgemm tests.
+namespace Test {
+
+template <typename crsMat_t, typename device>
+int run_spgemm(crsMat_t A, crsMat_t B, KokkosSparse::SPGEMMAlgorithm spgemm_algorithm, crsMat_t &C) {
+
+  typedef typename crsMat_t::size_type size_type;
+  typedef typename crsMat_t::ordinal_type lno_t;
+  typedef typename crsMat_t::value_type scalar_t;
+
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle
+      <size_type, lno_t, scalar_t,
+      typename device::execution_space, typename device::memory_space,typename device::memory_space > KernelHandle;
+
+  KernelHandle kh;
+  kh.set_team_work_size(16);
+  kh.set_dynamic_scheduling(true);
+
+  kh.create_spgemm_handle(spgemm_algorithm);
+
+  KokkosSparse::spgemm_symbolic(kh, A, false, B, false, C);
+  KokkosSparse::spgemm_numeric(kh, A, false, B, false, C);
+  kh.destroy_spgemm_handle();
+
+  return 0;
+}
+
+//compares two matrices whose rows are not sorted.
+template <typename crsMat_t, typename device>
+bool is_same_matrix(crsMat_t output_mat_actual, crsMat_t output_mat_reference){
+
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type::non_const_type lno_view_t;
+  typedef typename graph_t::entries_type::non_const_type   lno_nnz_view_t;
+  typedef typename crsMat_t::values_type::non_const_type scalar_view_t;
+
+  size_t nrows_actual = output_mat_actual.numRows();
+  size_t nentries_actual = output_mat_actual.graph.entries.extent(0) ;
+  size_t nvals_actual = output_mat_actual.values.extent(0);
+
+  size_t nrows_reference = output_mat_reference.numRows();
+  size_t nentries_reference = output_mat_reference.graph.entries.extent(0) ;
+  size_t nvals_reference = output_mat_reference.values.extent(0);
+
+
+  lno_nnz_view_t h_ent_actual (Kokkos::ViewAllocateWithoutInitializing("h_ent_actual"), nentries_actual);
+  scalar_view_t h_vals_actual (Kokkos::ViewAllocateWithoutInitializing("h_vals_actual"), nvals_actual);
+
+
+  KokkosKernels::Impl::kk_sort_graph<typename graph_t::row_map_type,
+    typename graph_t::entries_type,
+    typename crsMat_t::values_type,
+    lno_nnz_view_t,
+    scalar_view_t,
+    typename device::execution_space
+    >(
+    output_mat_actual.graph.row_map, 
+    output_mat_actual.graph.entries, 
+    output_mat_actual.values,
+    h_ent_actual, h_vals_actual
+  );
+
+  lno_nnz_view_t h_ent_reference (Kokkos::ViewAllocateWithoutInitializing("h_ent_reference"), nentries_reference);
+  scalar_view_t h_vals_reference (Kokkos::ViewAllocateWithoutInitializing("h_vals_reference"), nvals_reference);
+
+  if (nrows_actual != nrows_reference) { 
+     std::cout << "nrows_actual:" << nrows_actual << " nrows_reference:" << nrows_reference << std::endl;
+     return false;
+  }
+  if (nentries_actual != nentries_reference) {
+    std::cout << "nentries_actual:" << nentries_actual << " nentries_reference:" << nentries_reference << std::endl;
+    return false;
+  }
+  if (nvals_actual != nvals_reference) {
+    std::cout << "nvals_actual:" << nvals_actual << " nvals_reference:" << nvals_reference << std::endl;
+    return false;
+  }
+
+  KokkosKernels::Impl::kk_sort_graph
+      <typename graph_t::row_map_type,
+      typename graph_t::entries_type,
+      typename crsMat_t::values_type,
+      lno_nnz_view_t,
+      scalar_view_t,
+      typename device::execution_space
+      >(
+      output_mat_reference.graph.row_map, 
+      output_mat_reference.graph.entries, 
+      output_mat_reference.values,
+      h_ent_reference, h_vals_reference
+    );
+
+  bool is_identical = true;
+  is_identical = KokkosKernels::Impl::kk_is_identical_view
+      <typename graph_t::row_map_type, typename graph_t::row_map_type, typename lno_view_t::value_type,
+      typename device::execution_space>(output_mat_actual.graph.row_map, output_mat_reference.graph.row_map, 0);
+
+  if (!is_identical) {
+    std::cout << "rowmaps are different." << std::endl;
+    std::cout << "Actual rowmap:\n";
+    KokkosKernels::Impl::kk_print_1Dview(output_mat_actual.graph.row_map);
+    std::cout << "Correct rowmap (SPGEMM_DEBUG):\n";
+    KokkosKernels::Impl::kk_print_1Dview(output_mat_reference.graph.row_map);
+    return false;
+  }
+
+  is_identical = KokkosKernels::Impl::kk_is_identical_view
+      <lno_nnz_view_t, lno_nnz_view_t, typename lno_nnz_view_t::value_type,
+      typename device::execution_space>(h_ent_actual, h_ent_reference, 0 );
+
+  if (!is_identical) {
+    std::cout << "entries are different." << std::endl;
+    KokkosKernels::Impl::kk_print_1Dview(h_ent_actual);
+    KokkosKernels::Impl::kk_print_1Dview(h_ent_reference);
+    return false;
+  }
+
+
+  typedef typename Kokkos::Details::ArithTraits<typename scalar_view_t::non_const_value_type>::mag_type eps_type;
+  eps_type eps = std::is_same<eps_type,float>::value?2*1e-3:1e-7;
+
+
+  is_identical = KokkosKernels::Impl::kk_is_relatively_identical_view
+      <scalar_view_t, scalar_view_t, eps_type,
+      typename device::execution_space>(h_vals_actual, h_vals_reference, eps);
+
+  if (!is_identical) {
+    std::cout << "values are different." << std::endl;
+    KokkosKernels::Impl::kk_print_1Dview(output_mat_actual.values);
+    KokkosKernels::Impl::kk_print_1Dview(output_mat_reference.values);
+
+    return false;
+  }
+  return true;
+}
+
+}
+
+#endif
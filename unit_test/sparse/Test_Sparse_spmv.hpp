@@ -1,14 +1,22 @@
 #include<gtest/gtest.h>
 #include<Kokkos_Core.hpp>
 #include<Kokkos_Random.hpp>
+#include<cstdio>
+#include<fstream>
 
 #include<KokkosSparse_spmv.hpp>
 #include<KokkosKernels_TestUtils.hpp>
 #include<KokkosKernels_Test_Structured_Matrix.hpp>
 #include<KokkosKernels_IOUtils.hpp>
 #include<KokkosKernels_Utils.hpp>
+#include<KokkosKernels_SparseUtils.hpp>
 
 #include "KokkosKernels_Controls.hpp"
+#include "KokkosKernels_Half.hpp"
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_matrix_powers.hpp"
+#include "KokkosBlas1_axpby.hpp"
+#include "KokkosBlas1_nrm2.hpp"
 
 #ifndef kokkos_complex_double
 #define kokkos_complex_double Kokkos::complex<double>
@@ -338,6 +346,43 @@ void check_spmv_controls(KokkosKernels::Experimental::Controls controls,
   EXPECT_TRUE(num_errors==0);
 } // check_spmv_controls
 
+template <typename crsMat_t, typename x_vector_type, typename y_vector_type>
+void check_spmv_mv_controls(KokkosKernels::Experimental::Controls controls,
+                            crsMat_t input_mat, x_vector_type x, y_vector_type y, y_vector_type expected_y,
+                            typename y_vector_type::non_const_value_type alpha,
+                            typename y_vector_type::non_const_value_type beta, int numMV, char mode) {
+  using ExecSpace = typename crsMat_t::execution_space;
+  using my_exec_space = Kokkos::RangePolicy<ExecSpace>;
+  using y_value_type     = typename y_vector_type::non_const_value_type;
+  using y_value_trait    = Kokkos::ArithTraits<y_value_type>;
+  using y_value_mag_type = typename y_value_trait::mag_type;
+
+  const y_value_mag_type eps = std::is_same<y_value_mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  Kokkos::deep_copy(expected_y, y);
+  Kokkos::fence();
+
+  KokkosSparse::spmv(controls, &mode, alpha, input_mat, x, beta, y);
+  Kokkos::fence();
+
+  for (int i = 0; i < numMV; ++i){
+    auto x_i = Kokkos::subview (x, Kokkos::ALL (), i);
+    auto y_i = Kokkos::subview (expected_y, Kokkos::ALL (), i);
+    sequential_spmv(input_mat, x_i, y_i, alpha, beta, mode);
+
+    auto y_spmv = Kokkos::subview (y, Kokkos::ALL (), i);
+    int num_errors = 0;
+    Kokkos::parallel_reduce("KokkosSparse::Test::spmv_mv_controls",
+                            my_exec_space(0,y_i.extent(0)),
+                            fSPMV<decltype(y_i), decltype(y_spmv)>(y_i, y_spmv, eps),
+                            num_errors);
+    if(num_errors>0)
+      std::cout << "KokkosSparse::Test::spmv_mv_controls: " << num_errors << " errors of " << y_i.extent_int(0)
+        << " for mv " << i << " (alpha=" << alpha << ", beta=" << beta << ", mode = " << mode << ")\n";
+    EXPECT_TRUE(num_errors==0);
+  }
+} // check_spmv_mv_controls
+
 } // namespace Test
 
 template <typename scalar_t>
@@ -693,6 +738,100 @@ void test_spmv_mv_struct_1D(lno_t nx, int numMV) {
   Test::check_spmv_mv_struct(input_mat, 1, structure, input_x, output_y, output_y_copy, 1.0, 1.0, numMV);
 }
 
+template <typename scalar_t, typename lno_t, typename size_type, typename layout, class Device>
+void test_spmv_mv_struct_2D(lno_t nx, lno_t ny, int numMV) {
+
+  typedef typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type> crsMat_t;
+  typedef Kokkos::View<scalar_t**, layout, Device> x_multivector_type;
+  typedef Kokkos::View<scalar_t**, layout, Device> y_multivector_type;
+
+  Kokkos::View<lno_t*, Kokkos::HostSpace> structure("Spmv Structure", 2);
+  structure(0) = nx;
+  structure(1) = ny;
+  Kokkos::View<lno_t*[3], Kokkos::HostSpace> mat_structure("Matrix Structure", 2);
+  mat_structure(0, 0) = nx;
+  mat_structure(0, 1) = 1;
+  mat_structure(0, 2) = 1;
+  mat_structure(1, 0) = ny;
+  mat_structure(1, 1) = 1;
+  mat_structure(1, 2) = 1;
+
+  crsMat_t input_mat_FD = Test::generate_structured_matrix2D<crsMat_t>("FD", mat_structure);
+  crsMat_t input_mat_FE = Test::generate_structured_matrix2D<crsMat_t>("FE", mat_structure);
+
+  lno_t nr = input_mat_FD.numRows();
+  lno_t nc = input_mat_FD.numCols();
+
+  x_multivector_type input_x  ("x", nc, numMV);
+  y_multivector_type output_y ("y", nr, numMV);
+  y_multivector_type output_y_copy ("y_copy", nr, numMV);
+
+  Kokkos::Random_XorShift64_Pool<typename Device::execution_space> rand_pool(13718);
+
+  typedef typename x_multivector_type::value_type ScalarX;
+  typedef typename y_multivector_type::value_type ScalarY;
+
+  Kokkos::fill_random(input_x,  rand_pool, ScalarX(10));
+  Kokkos::fill_random(output_y, rand_pool, ScalarY(10));
+
+  Kokkos::deep_copy(output_y_copy, output_y);
+
+  Test::check_spmv_mv_struct(input_mat_FD, 1, structure, input_x, output_y, output_y_copy, 1.0, 0.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FD, 1, structure, input_x, output_y, output_y_copy, 0.0, 1.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FD, 1, structure, input_x, output_y, output_y_copy, 1.0, 1.0, numMV);
+
+  Test::check_spmv_mv_struct(input_mat_FE, 2, structure, input_x, output_y, output_y_copy, 1.0, 0.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FE, 2, structure, input_x, output_y, output_y_copy, 0.0, 1.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FE, 2, structure, input_x, output_y, output_y_copy, 1.0, 1.0, numMV);
+}
+
+template <typename scalar_t, typename lno_t, typename size_type, typename layout, class Device>
+void test_spmv_mv_struct_3D(lno_t nx, lno_t ny, lno_t nz, int numMV) {
+
+  typedef typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type> crsMat_t;
+  typedef Kokkos::View<scalar_t**, layout, Device> x_multivector_type;
+  typedef Kokkos::View<scalar_t**, layout, Device> y_multivector_type;
+
+  Kokkos::View<lno_t*, Kokkos::HostSpace> structure("Spmv Structure", 3);
+  structure(0) = nx;
+  structure(1) = ny;
+  structure(2) = nz;
+  Kokkos::View<lno_t*[3], Kokkos::HostSpace> mat_structure("Matrix Structure", 3);
+  mat_structure(0, 0) = nx;
+  mat_structure(1, 0) = ny;
+  mat_structure(2, 0) = nz;
+  mat_structure(2, 1) = 1;
+  mat_structure(2, 2) = 1;
+
+  crsMat_t input_mat_FD = Test::generate_structured_matrix3D<crsMat_t>("FD", mat_structure);
+  crsMat_t input_mat_FE = Test::generate_structured_matrix3D<crsMat_t>("FE", mat_structure);
+
+  lno_t nr = input_mat_FD.numRows();
+  lno_t nc = input_mat_FD.numCols();
+
+  x_multivector_type input_x  ("x", nc, numMV);
+  y_multivector_type output_y ("y", nr, numMV);
+  y_multivector_type output_y_copy ("y_copy", nr, numMV);
+
+  Kokkos::Random_XorShift64_Pool<typename Device::execution_space> rand_pool(13718);
+
+  typedef typename x_multivector_type::value_type ScalarX;
+  typedef typename y_multivector_type::value_type ScalarY;
+
+  Kokkos::fill_random(input_x,  rand_pool, ScalarX(10));
+  Kokkos::fill_random(output_y, rand_pool, ScalarY(10));
+
+  Kokkos::deep_copy(output_y_copy, output_y);
+
+  Test::check_spmv_mv_struct(input_mat_FD, 1, structure, input_x, output_y, output_y_copy, 1.0, 0.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FD, 1, structure, input_x, output_y, output_y_copy, 0.0, 1.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FD, 1, structure, input_x, output_y, output_y_copy, 1.0, 1.0, numMV);
+
+  Test::check_spmv_mv_struct(input_mat_FE, 2, structure, input_x, output_y, output_y_copy, 1.0, 0.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FE, 2, structure, input_x, output_y, output_y_copy, 0.0, 1.0, numMV);
+  Test::check_spmv_mv_struct(input_mat_FE, 2, structure, input_x, output_y, output_y_copy, 1.0, 1.0, numMV);
+}
+
 // check that the controls are flowing down correctly in the spmv kernel
 template <typename scalar_t, typename lno_t, typename size_type, class Device>
 void test_spmv_controls(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
@@ -728,6 +867,1006 @@ void test_spmv_controls(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_
   Test::check_spmv_controls(controls, input_mat, input_x, output_y, 1.0, 1.0);
 } // test_spmv_controls
 
+// check that autotuned spmv gives the right result and searches only once
+template <typename scalar_t, typename lno_t, typename size_type, class Device>
+void test_spmv_autotune(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using x_vector_type = scalar_view_t;
+  using y_vector_type = scalar_view_t;
+  using Controls      = KokkosKernels::Experimental::Controls;
+
+  lno_t numCols = numRows;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numCols,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  x_vector_type input_x ("x", nc);
+  y_vector_type output_y ("y", nr);
+
+  Kokkos::Random_XorShift64_Pool<typename Device::execution_space> rand_pool(13718);
+
+  using ScalarX = typename x_vector_type::value_type;
+  using ScalarY = typename y_vector_type::value_type;
+
+  Kokkos::fill_random(input_x,rand_pool,ScalarX(10));
+  Kokkos::fill_random(output_y,rand_pool,ScalarY(10));
+
+  // One database per type combination so that every test starts cold
+  const std::string tuning_file = "kokkoskernels_spmv_tuning_test_" + std::to_string(sizeof(scalar_t))
+    + (Kokkos::ArithTraits<scalar_t>::is_complex ? "c_" : "r_") + std::to_string(sizeof(lno_t))
+    + "_" + std::to_string(sizeof(size_type)) + ".txt";
+  std::remove(tuning_file.c_str());
+
+  auto count_entries = [&] () {
+    std::ifstream in(tuning_file);
+    std::string line;
+    int numEntries = 0;
+    while(std::getline(in, line)) { ++numEntries; }
+    return numEntries;
+  };
+
+  Controls controls;
+  controls.setParameter("autotune", "true");
+  controls.setParameter("autotune file", tuning_file);
+  controls.setParameter("autotune repeats", "1");
+
+  // The first call searches and records the result, later calls reuse it
+  Test::check_spmv_controls(controls, input_mat, input_x, output_y, 1.0, 0.0);
+  EXPECT_EQ(count_entries(), 1);
+  Test::check_spmv_controls(controls, input_mat, input_x, output_y, 1.0, 1.0);
+  Test::check_spmv_controls(controls, input_mat, input_x, output_y, 0.0, 1.0);
+  EXPECT_EQ(count_entries(), 1);
+
+  // Naming the matrix only memoizes its signature, which stays the same
+  controls.setParameter("autotune key", "test matrix");
+  Test::check_spmv_controls(controls, input_mat, input_x, output_y, 1.0, 1.0);
+  Test::check_spmv_controls(controls, input_mat, input_x, output_y, 1.0, 0.0);
+  EXPECT_EQ(count_entries(), 1);
+
+  std::remove(tuning_file.c_str());
+} // test_spmv_autotune
+
+// check the native merge-path algorithm on matrices with a few very long rows
+template <typename scalar_t, typename lno_t, typename size_type, class Device>
+void test_spmv_merge(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using x_vector_type = scalar_view_t;
+  using y_vector_type = scalar_view_t;
+  using mv_type       = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using Controls      = KokkosKernels::Experimental::Controls;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  x_vector_type input_x ("x", nc);
+  y_vector_type output_y ("y", nr);
+  mv_type input_xmv ("x", nc, 5);
+  mv_type output_ymv ("y", nr, 5);
+  mv_type output_ymv_copy ("y", nr, 5);
+
+  Kokkos::Random_XorShift64_Pool<typename Device::execution_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(output_y,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(input_xmv,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(output_ymv,rand_pool,randomUpperBound<scalar_t>(10));
+
+  // Use a small number of items per thread so that rows get split
+  // across many partitions and the carry-out fixup is exercised.
+  for(std::string items : {"", "3", "64"}) {
+    Controls controls;
+    controls.setParameter("algorithm", "native-merge");
+    if(!items.empty()) controls.setParameter("merge items per thread", items);
+
+    for(double alpha : {1.0, -1.0, 2.5}) {
+      for(double beta : {0.0, 1.0, 2.5}) {
+        Test::check_spmv_controls(controls, input_mat, input_x, output_y, alpha, beta);
+        for(char mode : {'N', 'C'}) {
+          Test::check_spmv_mv_controls(controls, input_mat, input_xmv, output_ymv, output_ymv_copy, alpha, beta, 5, mode);
+        }
+      }
+    }
+  }
+} // test_spmv_merge
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_sellc(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using sellMat_t     = typename KokkosSparse::Experimental::SellCMatrix<scalar_t, lno_t, Device, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using mv_type       = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using exec_space    = typename Device::execution_space;
+  using mag_type      = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  scalar_view_t input_x ("x", nc);
+  scalar_view_t output_y ("y", nr);
+  scalar_view_t expected_y ("expected", nr);
+  mv_type input_xmv ("x", nc, 3);
+  mv_type output_ymv ("y", nr, 3);
+  mv_type expected_ymv ("expected", nr, 3);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(input_xmv,rand_pool,randomUpperBound<scalar_t>(10));
+
+  for(lno_t C : {1, 4, 8, 32}) {
+    for(lno_t sigma : {1, 128}) {
+      sellMat_t A = KokkosSparse::Experimental::crs_to_sellc<sellMat_t>(input_mat, C, sigma);
+      EXPECT_EQ(A.nnz(), input_mat.nnz());
+      EXPECT_GE(A.numStoredEntries(), A.nnz());
+
+      for(double beta : {0.0, 2.5}) {
+        const double alpha = 1.5;
+        Kokkos::fill_random(output_y,rand_pool,randomUpperBound<scalar_t>(10));
+        Kokkos::deep_copy(expected_y, output_y);
+        KokkosSparse::spmv("N", alpha, input_mat, input_x, beta, expected_y);
+        KokkosSparse::Experimental::spmv("N", alpha, A, input_x, beta, output_y);
+        Kokkos::fence();
+
+        int num_errors = 0;
+        Kokkos::parallel_reduce("KokkosSparse::Test::spmv_sellc",
+                                Kokkos::RangePolicy<exec_space>(0, nr),
+                                fSPMV<scalar_view_t, scalar_view_t>(expected_y, output_y, eps),
+                                num_errors);
+        EXPECT_EQ(num_errors, 0) << "SellC spmv, C = " << C << ", sigma = " << sigma << ", beta = " << beta;
+
+        Kokkos::fill_random(output_ymv,rand_pool,randomUpperBound<scalar_t>(10));
+        Kokkos::deep_copy(expected_ymv, output_ymv);
+        KokkosSparse::spmv("N", alpha, input_mat, input_xmv, beta, expected_ymv);
+        KokkosSparse::Experimental::spmv("N", alpha, A, input_xmv, beta, output_ymv);
+        Kokkos::fence();
+
+        for(int j = 0; j < 3; ++j) {
+          auto expected_j = Kokkos::subview(expected_ymv, Kokkos::ALL(), j);
+          auto y_j        = Kokkos::subview(output_ymv, Kokkos::ALL(), j);
+          num_errors = 0;
+          Kokkos::parallel_reduce("KokkosSparse::Test::spmv_sellc_mv",
+                                  Kokkos::RangePolicy<exec_space>(0, nr),
+                                  fSPMV<decltype(expected_j), decltype(y_j)>(expected_j, y_j, eps),
+                                  num_errors);
+          EXPECT_EQ(num_errors, 0) << "SellC spmv_mv, C = " << C << ", sigma = " << sigma << ", column " << j;
+        }
+      }
+
+      // Converting back must reproduce the original matrix exactly
+      crsMat_t B = KokkosSparse::Experimental::sellc_to_crs<crsMat_t>(A);
+      EXPECT_TRUE(KokkosKernels::Impl::kk_is_identical_view<
+                    typename crsMat_t::row_map_type, typename crsMat_t::row_map_type, size_type, exec_space>
+                  (input_mat.graph.row_map, B.graph.row_map, size_type(0)));
+      EXPECT_TRUE(KokkosKernels::Impl::kk_is_identical_view<
+                    typename crsMat_t::index_type, typename crsMat_t::index_type, lno_t, exec_space>
+                  (input_mat.graph.entries, B.graph.entries, lno_t(0)));
+      EXPECT_TRUE(KokkosKernels::Impl::kk_is_identical_view<
+                    scalar_view_t, scalar_view_t, mag_type, exec_space>
+                  (input_mat.values, B.values, mag_type(0)));
+    }
+  }
+} // test_spmv_sellc
+
+// Empty rows are padded with column 0; a NaN in x(0), which no row reads,
+// must not end up in y.
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_sellc_empty_rows() {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using graph_t       = typename crsMat_t::StaticCrsGraphType;
+  using row_map_t     = typename graph_t::row_map_type::non_const_type;
+  using entries_t     = typename graph_t::entries_type::non_const_type;
+  using sellMat_t     = typename KokkosSparse::Experimental::SellCMatrix<scalar_t, lno_t, Device, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using AT            = Kokkos::ArithTraits<scalar_t>;
+
+  // rows 1 and 3 are empty, column 0 is never used
+  const lno_t n = 5;
+  const std::vector<size_type> rows {0, 2, 2, 3, 3, 5};
+  const std::vector<lno_t> cols {1, 2, 3, 1, 4};
+  row_map_t row_map ("row map", n + 1);
+  entries_t entries ("entries", cols.size());
+  scalar_view_t values ("values", cols.size());
+  auto h_row_map = Kokkos::create_mirror_view(row_map);
+  auto h_entries = Kokkos::create_mirror_view(entries);
+  auto h_values  = Kokkos::create_mirror_view(values);
+  for(lno_t i = 0; i <= n; ++i)
+    h_row_map(i) = rows[i];
+  for(size_t k = 0; k < cols.size(); ++k) {
+    h_entries(k) = cols[k];
+    h_values(k)  = AT::one() + AT::one() * static_cast<int>(k);
+  }
+  Kokkos::deep_copy(row_map, h_row_map);
+  Kokkos::deep_copy(entries, h_entries);
+  Kokkos::deep_copy(values, h_values);
+  crsMat_t input_mat("empty rows", n, values, graph_t(entries, row_map));
+
+  scalar_view_t input_x ("x", n);
+  auto h_x = Kokkos::create_mirror_view(input_x);
+  h_x(0) = AT::nan();
+  for(lno_t i = 1; i < n; ++i)
+    h_x(i) = AT::one() * static_cast<int>(i);
+  Kokkos::deep_copy(input_x, h_x);
+
+  scalar_view_t expected_y ("expected", n);
+  KokkosSparse::spmv("N", AT::one(), input_mat, input_x, AT::zero(), expected_y);
+  auto h_expected = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), expected_y);
+
+  for(lno_t C : {1, 4}) {
+    sellMat_t A = KokkosSparse::Experimental::crs_to_sellc<sellMat_t>(input_mat, C);
+    scalar_view_t output_y ("y", n);
+    KokkosSparse::Experimental::spmv("N", AT::one(), A, input_x, AT::zero(), output_y);
+    auto h_y = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), output_y);
+    for(lno_t i = 0; i < n; ++i)
+      EXPECT_TRUE(h_y(i) == h_expected(i)) << "SellC spmv with empty rows, C = " << C << ", row " << i;
+  }
+} // test_spmv_sellc_empty_rows
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_handle(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using exec_space    = typename Device::execution_space;
+  using mem_space     = typename Device::memory_space;
+  using handle_t      = KokkosKernels::Experimental::KokkosKernelsHandle<size_type, lno_t, scalar_t, exec_space, mem_space, mem_space>;
+  using mag_type      = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+  using KokkosSparse::Experimental::SPMVAlgorithm;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  scalar_view_t input_x ("x", nc);
+  scalar_view_t output_y ("y", nr);
+  scalar_view_t expected_y ("expected", nr);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+
+  for(SPMVAlgorithm algo : {SPMVAlgorithm::SPMV_DEFAULT, SPMVAlgorithm::SPMV_PARTITIONED, SPMVAlgorithm::SPMV_MERGE_PATH}) {
+    handle_t kh;
+    kh.create_spmv_handle(algo);
+    KokkosSparse::Experimental::spmv_symbolic(&kh, input_mat);
+    auto spmv_handle = kh.get_spmv_handle();
+    EXPECT_TRUE(spmv_handle->is_symbolic_complete());
+
+    // The cached partition must cover all rows, in order
+    auto h_partition = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), spmv_handle->get_row_partition());
+    const lno_t np = spmv_handle->get_num_partitions();
+    ASSERT_GE(np, 1);
+    EXPECT_EQ(h_partition(0), 0);
+    EXPECT_EQ(h_partition(np), nr);
+    for(lno_t p = 0; p < np; ++p) {
+      EXPECT_LE(h_partition(p), h_partition(p + 1));
+    }
+
+    // Repeated calls reuse the analysis
+    for(int iter = 0; iter < 3; ++iter) {
+      for(char mode : {'N', 'C'}) {
+        for(double beta : {0.0, 1.0, 2.5}) {
+          const double alpha = 1.5;
+          Kokkos::fill_random(output_y,rand_pool,randomUpperBound<scalar_t>(10));
+          Kokkos::deep_copy(expected_y, output_y);
+          sequential_spmv(input_mat, input_x, expected_y, alpha, beta, mode);
+          KokkosSparse::Experimental::spmv(&kh, &mode, alpha, input_mat, input_x, beta, output_y);
+          Kokkos::fence();
+
+          int num_errors = 0;
+          Kokkos::parallel_reduce("KokkosSparse::Test::spmv_handle",
+                                  Kokkos::RangePolicy<exec_space>(0, nr),
+                                  fSPMV<scalar_view_t, scalar_view_t>(expected_y, output_y, eps),
+                                  num_errors);
+          EXPECT_EQ(num_errors, 0) << "handle spmv, mode " << mode << ", beta = " << beta;
+        }
+      }
+    }
+    EXPECT_NE(spmv_handle->get_selected_algorithm(), SPMVAlgorithm::SPMV_DEFAULT);
+  }
+} // test_spmv_handle
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_deltacrs(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using deltaMat_t    = typename KokkosSparse::Experimental::DeltaCrsMatrix<scalar_t, lno_t, Device, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using mv_type       = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using exec_space    = typename Device::execution_space;
+  using mag_type      = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  // Banded: every block fits in 16-bit deltas.  Scattered over 200000
+  // columns: most blocks take the escape path.
+  for(lno_t numCols : {numRows, lno_t(200000)}) {
+    const lno_t bw = (numCols == numRows) ? bandwidth : numCols;
+    crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numCols,nnz,row_size_variance, bw);
+    lno_t nr = input_mat.numRows();
+    lno_t nc = input_mat.numCols();
+
+    scalar_view_t input_x ("x", nc);
+    scalar_view_t output_y ("y", nr);
+    scalar_view_t expected_y ("expected", nr);
+    mv_type input_xmv ("x", nc, 3);
+    mv_type output_ymv ("y", nr, 3);
+    mv_type expected_ymv ("expected", nr, 3);
+
+    Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+    Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+    Kokkos::fill_random(input_xmv,rand_pool,randomUpperBound<scalar_t>(10));
+
+    for(lno_t blockRows : {1, 8, 64}) {
+      deltaMat_t A = KokkosSparse::Experimental::crs_to_delta_crs<deltaMat_t>(input_mat, blockRows);
+      EXPECT_EQ(A.nnz(), input_mat.nnz());
+      if(numCols == numRows)
+        EXPECT_EQ(A.numWideBlocks(), 0);
+      else
+        EXPECT_GT(A.numWideBlocks(), 0);
+
+      for(char mode : {'N', 'C'}) {
+        for(double beta : {0.0, 2.5}) {
+          const double alpha = 1.5;
+          Kokkos::fill_random(output_y,rand_pool,randomUpperBound<scalar_t>(10));
+          Kokkos::deep_copy(expected_y, output_y);
+          KokkosSparse::spmv(&mode, alpha, input_mat, input_x, beta, expected_y);
+          KokkosSparse::Experimental::spmv(&mode, alpha, A, input_x, beta, output_y);
+          Kokkos::fence();
+
+          int num_errors = 0;
+          Kokkos::parallel_reduce("KokkosSparse::Test::spmv_deltacrs",
+                                  Kokkos::RangePolicy<exec_space>(0, nr),
+                                  fSPMV<scalar_view_t, scalar_view_t>(expected_y, output_y, eps),
+                                  num_errors);
+          EXPECT_EQ(num_errors, 0) << "DeltaCrs spmv, " << nc << " cols, block rows = " << blockRows
+                                   << ", mode " << mode << ", beta = " << beta;
+        }
+      }
+
+      Kokkos::fill_random(output_ymv,rand_pool,randomUpperBound<scalar_t>(10));
+      Kokkos::deep_copy(expected_ymv, output_ymv);
+      KokkosSparse::spmv("N", 1.5, input_mat, input_xmv, 2.5, expected_ymv);
+      KokkosSparse::Experimental::spmv("N", 1.5, A, input_xmv, 2.5, output_ymv);
+      Kokkos::fence();
+
+      for(int j = 0; j < 3; ++j) {
+        auto expected_j = Kokkos::subview(expected_ymv, Kokkos::ALL(), j);
+        auto y_j        = Kokkos::subview(output_ymv, Kokkos::ALL(), j);
+        int num_errors = 0;
+        Kokkos::parallel_reduce("KokkosSparse::Test::spmv_deltacrs_mv",
+                                Kokkos::RangePolicy<exec_space>(0, nr),
+                                fSPMV<decltype(expected_j), decltype(y_j)>(expected_j, y_j, eps),
+                                num_errors);
+        EXPECT_EQ(num_errors, 0) << "DeltaCrs spmv, " << nc << " cols, block rows = " << blockRows << ", column " << j;
+      }
+    }
+  }
+} // test_spmv_deltacrs
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_handle_numa(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using exec_space    = typename Device::execution_space;
+  using mem_space     = typename Device::memory_space;
+  using handle_t      = KokkosKernels::Experimental::KokkosKernelsHandle<size_type, lno_t, scalar_t, exec_space, mem_space, mem_space>;
+  using mag_type      = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+
+  scalar_view_t input_x ("x", nr);
+  scalar_view_t output_y ("y", nr);
+  scalar_view_t expected_y ("expected", nr);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+
+  handle_t kh;
+  kh.create_spmv_handle();
+  kh.get_spmv_handle()->set_numa_first_touch(true);
+  KokkosSparse::Experimental::spmv_symbolic(&kh, input_mat);
+#ifdef KOKKOS_ENABLE_OPENMP
+  EXPECT_EQ(kh.get_spmv_handle()->is_numa_complete(), (std::is_same<exec_space, Kokkos::OpenMP>::value));
+#else
+  EXPECT_FALSE(kh.get_spmv_handle()->is_numa_complete());
+#endif
+
+  // Re-homed copies hold the same entries
+  auto numa_x = KokkosSparse::Experimental::spmv_first_touch(&kh, input_x);
+  auto numa_y = KokkosSparse::Experimental::spmv_first_touch(&kh, output_y);
+  EXPECT_EQ(numa_x.extent(0), input_x.extent(0));
+
+  for(int refresh = 0; refresh < 2; ++refresh) {
+    if(refresh) {
+      KokkosBlas::scal(input_mat.values, scalar_t(-2), input_mat.values);
+      KokkosSparse::Experimental::spmv_numeric(&kh, input_mat);
+    }
+    for(char mode : {'N', 'C'}) {
+      for(double beta : {0.0, 2.5}) {
+        const double alpha = 1.5;
+        Kokkos::fill_random(numa_y,rand_pool,randomUpperBound<scalar_t>(10));
+        Kokkos::deep_copy(expected_y, numa_y);
+        sequential_spmv(input_mat, input_x, expected_y, alpha, beta, mode);
+        KokkosSparse::Experimental::spmv(&kh, &mode, alpha, input_mat, numa_x, beta, numa_y);
+        Kokkos::fence();
+
+        int num_errors = 0;
+        Kokkos::parallel_reduce("KokkosSparse::Test::spmv_handle_numa",
+                                Kokkos::RangePolicy<exec_space>(0, nr),
+                                fSPMV<scalar_view_t, decltype(numa_y)>(expected_y, numa_y, eps),
+                                num_errors);
+        EXPECT_EQ(num_errors, 0) << "NUMA handle spmv, mode " << mode << ", beta = " << beta << ", refresh = " << refresh;
+      }
+    }
+  }
+} // test_spmv_handle_numa
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_handle_transpose(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using mv_t          = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using exec_space    = typename Device::execution_space;
+  using mem_space     = typename Device::memory_space;
+  using handle_t      = KokkosKernels::Experimental::KokkosKernelsHandle<size_type, lno_t, scalar_t, exec_space, mem_space, mem_space>;
+  using mag_type      = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  // Rectangular, so that a mix-up between A and A^T shows in the dimensions
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows + 17,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  scalar_view_t input_x ("x", nr);
+  scalar_view_t output_y ("y", nc);
+  scalar_view_t expected_y ("expected", nc);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+
+  handle_t kh;
+  kh.create_spmv_handle();
+  kh.get_spmv_handle()->set_explicit_transpose(true);
+  KokkosSparse::Experimental::spmv_symbolic(&kh, input_mat);
+  EXPECT_TRUE(kh.get_spmv_handle()->is_transpose_complete());
+
+  for(int refresh = 0; refresh < 2; ++refresh) {
+    if(refresh) {
+      // New values on the same graph: only the values of A^T are refreshed
+      KokkosBlas::scal(input_mat.values, scalar_t(-2), input_mat.values);
+      KokkosSparse::Experimental::spmv_numeric(&kh, input_mat);
+    }
+    for(char mode : {'T', 'H'}) {
+      for(double beta : {0.0, 2.5}) {
+        const double alpha = 1.5;
+        Kokkos::fill_random(output_y,rand_pool,randomUpperBound<scalar_t>(10));
+        Kokkos::deep_copy(expected_y, output_y);
+        sequential_spmv(input_mat, input_x, expected_y, alpha, beta, mode);
+        KokkosSparse::Experimental::spmv(&kh, &mode, alpha, input_mat, input_x, beta, output_y);
+
+        int num_errors = 0;
+        Kokkos::parallel_reduce("KokkosSparse::Test::spmv_handle_transpose",
+                                Kokkos::RangePolicy<exec_space>(0, nc),
+                                fSPMV<scalar_view_t, scalar_view_t>(expected_y, output_y, eps),
+                                num_errors);
+        EXPECT_EQ(num_errors, 0) << "explicit transpose spmv, mode " << mode << ", beta = " << beta << ", refresh = " << refresh;
+      }
+    }
+  }
+
+  // Multivectors go through the cached transpose as well
+  const int numVecs = 3;
+  mv_t input_X ("X", nr, numVecs);
+  mv_t output_Y ("Y", nc, numVecs);
+  Kokkos::fill_random(input_X,rand_pool,randomUpperBound<scalar_t>(10));
+  KokkosSparse::Experimental::spmv(&kh, "T", 1.0, input_mat, input_X, 0.0, output_Y);
+  for(int j = 0; j < numVecs; ++j) {
+    auto x_j = Kokkos::subview(input_X, Kokkos::ALL(), j);
+    auto y_j = Kokkos::subview(output_Y, Kokkos::ALL(), j);
+    Kokkos::deep_copy(expected_y, 0);
+    sequential_spmv(input_mat, x_j, expected_y, 1.0, 0.0, 'T');
+    int num_errors = 0;
+    Kokkos::parallel_reduce("KokkosSparse::Test::spmv_handle_transpose_mv",
+                            Kokkos::RangePolicy<exec_space>(0, nc),
+                            fSPMV<scalar_view_t, decltype(y_j)>(expected_y, y_j, eps),
+                            num_errors);
+    EXPECT_EQ(num_errors, 0) << "explicit transpose spmv, column " << j;
+  }
+
+  // Another pattern with the same dimensions and number of entries, in
+  // new views: the handle must not reuse the A^T of input_mat
+  {
+    using graph_t   = typename crsMat_t::StaticCrsGraphType;
+    using rowmap_t  = typename graph_t::row_map_type::non_const_type;
+    using entries_t = typename graph_t::entries_type::non_const_type;
+    rowmap_t shifted_row_map ("shifted row map", input_mat.graph.row_map.extent(0));
+    entries_t shifted_entries ("shifted entries", input_mat.graph.entries.extent(0));
+    scalar_view_t shifted_values ("shifted values", input_mat.values.extent(0));
+    Kokkos::deep_copy(shifted_row_map, input_mat.graph.row_map);
+    Kokkos::deep_copy(shifted_values, input_mat.values);
+    auto h_entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), input_mat.graph.entries);
+    for(size_t j = 0; j < h_entries.extent(0); ++j)
+      h_entries(j) = (h_entries(j) + 1) % nc;
+    Kokkos::deep_copy(shifted_entries, h_entries);
+    crsMat_t shifted_mat ("shifted", nr, nc, input_mat.nnz(), shifted_values, shifted_row_map, shifted_entries);
+
+    Kokkos::deep_copy(expected_y, 0);
+    sequential_spmv(shifted_mat, input_x, expected_y, 1.0, 0.0, 'T');
+    KokkosSparse::Experimental::spmv(&kh, "T", 1.0, shifted_mat, input_x, 0.0, output_y);
+    int num_errors = 0;
+    Kokkos::parallel_reduce("KokkosSparse::Test::spmv_handle_transpose_pattern",
+                            Kokkos::RangePolicy<exec_space>(0, nc),
+                            fSPMV<scalar_view_t, scalar_view_t>(expected_y, output_y, eps),
+                            num_errors);
+    EXPECT_EQ(num_errors, 0) << "explicit transpose spmv, new pattern with the same number of entries";
+  }
+} // test_spmv_handle_transpose
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_symmetric(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using graph_t       = typename crsMat_t::StaticCrsGraphType;
+  using row_map_t     = typename crsMat_t::row_map_type::non_const_type;
+  using entries_t     = typename crsMat_t::index_type::non_const_type;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using mv_t          = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using exec_space    = typename Device::execution_space;
+  using mem_space     = typename Device::memory_space;
+  using handle_t      = KokkosKernels::Experimental::KokkosKernelsHandle<size_type, lno_t, scalar_t, exec_space, mem_space, mem_space>;
+  using KAT           = Kokkos::ArithTraits<scalar_t>;
+  using mag_type      = typename KAT::mag_type;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+
+  // Strict lower triangle, and upper triangle with the diagonal
+  std::vector<crsMat_t> triangles;
+  triangles.push_back(KokkosKernels::Impl::kk_get_lower_crs_matrix(input_mat));
+  {
+    auto h_row_map = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), input_mat.graph.row_map);
+    auto h_entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), input_mat.graph.entries);
+    auto h_values  = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), input_mat.values);
+    std::vector<lno_t> up_entries;
+    std::vector<scalar_t> up_values;
+    row_map_t up_row_map ("upper row map", nr + 1);
+    auto h_up_row_map = Kokkos::create_mirror_view(up_row_map);
+    h_up_row_map(0) = 0;
+    for(lno_t i = 0; i < nr; ++i) {
+      for(size_type k = h_row_map(i); k < h_row_map(i + 1); ++k) {
+        if(h_entries(k) >= i) {
+          up_entries.push_back(h_entries(k));
+          up_values.push_back(h_values(k));
+        }
+      }
+      h_up_row_map(i + 1) = up_entries.size();
+    }
+    entries_t up_e ("upper entries", up_entries.size());
+    scalar_view_t up_v ("upper values", up_values.size());
+    auto h_up_e = Kokkos::create_mirror_view(up_e);
+    auto h_up_v = Kokkos::create_mirror_view(up_v);
+    for(size_t k = 0; k < up_entries.size(); ++k) {
+      h_up_e(k) = up_entries[k];
+      h_up_v(k) = up_values[k];
+    }
+    Kokkos::deep_copy(up_row_map, h_up_row_map);
+    Kokkos::deep_copy(up_e, h_up_e);
+    Kokkos::deep_copy(up_v, h_up_v);
+    triangles.push_back(crsMat_t("upper triangle", nr, up_v, graph_t(up_e, up_row_map)));
+  }
+
+  const int numVecs = 2;
+  mv_t input_X ("X", nr, numVecs);
+  mv_t output_Y ("Y", nr, numVecs);
+  mv_t expected_Y ("expected", nr, numVecs);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_X,rand_pool,randomUpperBound<scalar_t>(10));
+  auto h_X = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), input_X);
+
+  for(const crsMat_t& tri : triangles) {
+    // The handle keeps the partition across all the products with tri
+    handle_t kh;
+    kh.create_spmv_handle();
+    auto h_row_map = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), tri.graph.row_map);
+    auto h_entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), tri.graph.entries);
+    auto h_values  = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), tri.values);
+
+    for(bool hermitian : {false, true}) {
+      // 0: host kernel, 1: atomic kernel, 2: host kernel through the handle
+      for(int variant : {0, 1, 2}) {
+        const bool atomic = (variant == 1);
+        for(double beta : {0.0, 2.5}) {
+          const double alpha = 1.5;
+          Kokkos::fill_random(output_Y,rand_pool,randomUpperBound<scalar_t>(10));
+          auto h_Y = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), output_Y);
+          for(int j = 0; j < numVecs; ++j) {
+            std::vector<scalar_t> Sx(nr, KAT::zero());
+            for(lno_t i = 0; i < nr; ++i) {
+              for(size_type k = h_row_map(i); k < h_row_map(i + 1); ++k) {
+                const lno_t c = h_entries(k);
+                Sx[i] += h_values(k) * h_X(c, j);
+                if(c != i)
+                  Sx[c] += (hermitian ? KAT::conj(h_values(k)) : h_values(k)) * h_X(i, j);
+              }
+            }
+            for(lno_t i = 0; i < nr; ++i)
+              h_Y(i, j) = scalar_t(beta) * h_Y(i, j) + scalar_t(alpha) * Sx[i];
+          }
+          Kokkos::deep_copy(expected_Y, h_Y);
+
+          KokkosKernels::Experimental::Controls controls;
+          if(atomic)
+            controls.setParameter("algorithm", "atomic");
+          auto y_0 = Kokkos::subview(output_Y, Kokkos::ALL(), 0);
+          auto x_0 = Kokkos::subview(input_X, Kokkos::ALL(), 0);
+          // The remaining columns go through the multivector interface
+          auto x_1 = Kokkos::subview(input_X, Kokkos::ALL(), Kokkos::make_pair(1, numVecs));
+          auto y_1 = Kokkos::subview(output_Y, Kokkos::ALL(), Kokkos::make_pair(1, numVecs));
+          if(variant == 2) {
+            KokkosSparse::Experimental::spmv_symmetric(&kh, hermitian, alpha, tri, x_0, beta, y_0);
+            KokkosSparse::Experimental::spmv_symmetric(&kh, hermitian, alpha, tri, x_1, beta, y_1);
+          }
+          else {
+            KokkosSparse::Experimental::spmv_symmetric(controls, hermitian, alpha, tri, x_0, beta, y_0);
+            KokkosSparse::Experimental::spmv_symmetric(controls, hermitian, alpha, tri, x_1, beta, y_1);
+          }
+
+          for(int j = 0; j < numVecs; ++j) {
+            auto y_j = Kokkos::subview(output_Y, Kokkos::ALL(), j);
+            auto e_j = Kokkos::subview(expected_Y, Kokkos::ALL(), j);
+            int num_errors = 0;
+            Kokkos::parallel_reduce("KokkosSparse::Test::spmv_symmetric",
+                                    Kokkos::RangePolicy<exec_space>(0, nr),
+                                    fSPMV<decltype(e_j), decltype(y_j)>(e_j, y_j, eps),
+                                    num_errors);
+            EXPECT_EQ(num_errors, 0) << "symmetric spmv, hermitian = " << hermitian << ", variant = " << variant
+                                     << ", beta = " << beta << ", column " << j;
+          }
+        }
+      }
+    }
+    EXPECT_EQ(kh.get_spmv_handle()->is_symmetric_partition_complete(),
+              !KokkosKernels::Impl::kk_is_gpu_exec_space<exec_space>());
+  }
+} // test_spmv_symmetric
+
+template <typename mat_scalar_t, typename vec_scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_mixed(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<vec_scalar_t, lno_t, Device, void, size_type>;
+  using lowMat_t      = typename KokkosSparse::CrsMatrix<mat_scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using low_view_t    = typename lowMat_t::values_type::non_const_type;
+  using exec_space    = typename Device::execution_space;
+  using mag_type      = typename Kokkos::ArithTraits<vec_scalar_t>::mag_type;
+
+  // Tight enough that accumulating in the matrix precision would fail
+  const mag_type eps = 1e-10;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  // Round the values to the matrix precision, and keep the rounded values
+  // in the reference matrix so that only the accumulation differs.
+  low_view_t low_values ("low values", input_mat.nnz());
+  scalar_view_t high_values = input_mat.values;
+  Kokkos::parallel_for("KokkosSparse::Test::spmv_mixed::round",
+                       Kokkos::RangePolicy<exec_space>(0, input_mat.nnz()),
+                       KOKKOS_LAMBDA(const size_type i) {
+                         low_values(i)  = static_cast<mat_scalar_t>(high_values(i));
+                         high_values(i) = static_cast<vec_scalar_t>(low_values(i));
+                       });
+  lowMat_t low_mat("low precision A", nr, nc, input_mat.nnz(), low_values,
+                   input_mat.graph.row_map, input_mat.graph.entries);
+
+  scalar_view_t input_x ("x", nc);
+  scalar_view_t output_y ("y", nr);
+  scalar_view_t expected_y ("expected", nr);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<vec_scalar_t>(10));
+
+  for(char mode : {'N', 'T'}) {
+    for(double beta : {0.0, 1.0, 2.5}) {
+      const double alpha = 1.5;
+      Kokkos::fill_random(output_y,rand_pool,randomUpperBound<vec_scalar_t>(10));
+      Kokkos::deep_copy(expected_y, output_y);
+      sequential_spmv(input_mat, input_x, expected_y, alpha, beta, mode);
+      KokkosSparse::spmv(&mode, alpha, low_mat, input_x, beta, output_y);
+      Kokkos::fence();
+
+      int num_errors = 0;
+      Kokkos::parallel_reduce("KokkosSparse::Test::spmv_mixed",
+                              Kokkos::RangePolicy<exec_space>(0, output_y.extent(0)),
+                              fSPMV<scalar_view_t, scalar_view_t>(expected_y, output_y, eps),
+                              num_errors);
+      EXPECT_EQ(num_errors, 0) << "mixed precision spmv, mode " << mode << ", beta = " << beta;
+    }
+  }
+} // test_spmv_mixed
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_spmv_dot(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using mv_t          = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using exec_space    = typename Device::execution_space;
+  using AT            = Kokkos::ArithTraits<scalar_t>;
+  using mag_type      = typename AT::mag_type;
+  using KokkosSparse::SPMVDotType;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+  const int numVecs = 3;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  scalar_view_t input_x ("x", nc);
+  scalar_view_t output_y ("y", nr);
+  scalar_view_t expected_y ("expected", nr);
+  mv_t input_X ("X", nc, numVecs);
+  mv_t output_Y ("Y", nr, numVecs);
+  Kokkos::View<scalar_t*, Kokkos::HostSpace> dots ("dots", numVecs);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(input_X,rand_pool,randomUpperBound<scalar_t>(10));
+
+  auto dot_error = [] (scalar_t expected, scalar_t actual) {
+    return AT::abs(expected - actual) / (AT::abs(expected) > 0 ? AT::abs(expected) : mag_type(1));
+  };
+
+  for(SPMVDotType dotType : {SPMVDotType::XY, SPMVDotType::YY}) {
+    for(char mode : {'N', 'C', 'T'}) {
+      for(double beta : {0.0, 2.5}) {
+        const double alpha = 1.5;
+        Kokkos::fill_random(output_y,rand_pool,randomUpperBound<scalar_t>(10));
+        Kokkos::deep_copy(expected_y, output_y);
+        sequential_spmv(input_mat, input_x, expected_y, alpha, beta, mode);
+        const scalar_t expected_dot = (dotType == SPMVDotType::XY) ?
+          KokkosBlas::dot(input_x, expected_y) : KokkosBlas::dot(expected_y, expected_y);
+        const scalar_t dot = KokkosSparse::spmv_dot(&mode, alpha, input_mat, input_x, beta, output_y, dotType);
+
+        int num_errors = 0;
+        Kokkos::parallel_reduce("KokkosSparse::Test::spmv_dot",
+                                Kokkos::RangePolicy<exec_space>(0, output_y.extent(0)),
+                                fSPMV<scalar_view_t, scalar_view_t>(expected_y, output_y, eps),
+                                num_errors);
+        EXPECT_EQ(num_errors, 0) << "spmv_dot y, mode " << mode << ", beta = " << beta;
+        EXPECT_LE(dot_error(expected_dot, dot), eps) << "spmv_dot result, mode " << mode << ", beta = " << beta;
+
+        // Each column of the multivector version matches the single-vector one
+        Kokkos::fill_random(output_Y,rand_pool,randomUpperBound<scalar_t>(10));
+        for(int j = 0; j < numVecs; ++j) {
+          auto x_j = Kokkos::subview(input_X, Kokkos::ALL(), j);
+          auto y_j = Kokkos::subview(output_Y, Kokkos::ALL(), j);
+          Kokkos::deep_copy(expected_y, y_j);
+          sequential_spmv(input_mat, x_j, expected_y, alpha, beta, mode);
+          dots(j) = (dotType == SPMVDotType::XY) ?
+            KokkosBlas::dot(x_j, expected_y) : KokkosBlas::dot(expected_y, expected_y);
+        }
+        Kokkos::View<scalar_t*, Device> R ("R", numVecs);
+        KokkosSparse::spmv_dot(R, &mode, alpha, input_mat, input_X, beta, output_Y, dotType);
+        auto R_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), R);
+        for(int j = 0; j < numVecs; ++j) {
+          EXPECT_LE(dot_error(dots(j), R_h(j)), eps) << "spmv_dot column " << j << ", mode " << mode << ", beta = " << beta;
+        }
+      }
+    }
+  }
+} // test_spmv_dot
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_residual(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using mv_t          = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using exec_space    = typename Device::execution_space;
+  using AT            = Kokkos::ArithTraits<scalar_t>;
+  using mag_type      = typename AT::mag_type;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+  const int numVecs = 3;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+  lno_t nc = input_mat.numCols();
+
+  scalar_view_t input_x ("x", nc);
+  scalar_view_t input_b ("b", nr);
+  scalar_view_t output_r ("r", nr);
+  scalar_view_t expected_r ("expected", nr);
+  mv_t input_X ("X", nc, numVecs);
+  mv_t input_B ("B", nr, numVecs);
+  mv_t output_R ("R", nr, numVecs);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(input_b,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(input_X,rand_pool,randomUpperBound<scalar_t>(10));
+  Kokkos::fill_random(input_B,rand_pool,randomUpperBound<scalar_t>(10));
+
+  auto norm_error = [] (mag_type expected, mag_type actual) {
+    return Kokkos::ArithTraits<mag_type>::abs(expected - actual) / (expected > 0 ? expected : mag_type(1));
+  };
+
+  Kokkos::deep_copy(expected_r, input_b);
+  sequential_spmv(input_mat, input_x, expected_r, -1.0, 1.0);
+  const mag_type expected_norm = KokkosBlas::nrm2(expected_r);
+
+  int num_errors = 0;
+  KokkosSparse::residual(input_mat, input_x, input_b, output_r);
+  Kokkos::parallel_reduce("KokkosSparse::Test::residual",
+                          Kokkos::RangePolicy<exec_space>(0, output_r.extent(0)),
+                          fSPMV<scalar_view_t, scalar_view_t>(expected_r, output_r, eps),
+                          num_errors);
+  EXPECT_EQ(num_errors, 0) << "residual r";
+
+  Kokkos::deep_copy(output_r, scalar_t(0));
+  const mag_type norm = KokkosSparse::residual_norm(input_mat, input_x, input_b, output_r);
+  num_errors = 0;
+  Kokkos::parallel_reduce("KokkosSparse::Test::residual",
+                          Kokkos::RangePolicy<exec_space>(0, output_r.extent(0)),
+                          fSPMV<scalar_view_t, scalar_view_t>(expected_r, output_r, eps),
+                          num_errors);
+  EXPECT_EQ(num_errors, 0) << "residual_norm r";
+  EXPECT_LE(norm_error(expected_norm, norm), eps) << "residual_norm result";
+
+  // r may overwrite b
+  scalar_view_t b_copy ("b copy", nr);
+  Kokkos::deep_copy(b_copy, input_b);
+  KokkosSparse::residual(input_mat, input_x, b_copy, b_copy);
+  num_errors = 0;
+  Kokkos::parallel_reduce("KokkosSparse::Test::residual",
+                          Kokkos::RangePolicy<exec_space>(0, b_copy.extent(0)),
+                          fSPMV<scalar_view_t, scalar_view_t>(expected_r, b_copy, eps),
+                          num_errors);
+  EXPECT_EQ(num_errors, 0) << "residual in place";
+
+  // Each column of the multivector version matches the single-vector one
+  Kokkos::View<mag_type*, Kokkos::HostSpace> expected_norms ("expected norms", numVecs);
+  mv_t expected_R ("expected R", nr, numVecs);
+  for(int j = 0; j < numVecs; ++j) {
+    auto x_j = Kokkos::subview(input_X, Kokkos::ALL(), j);
+    auto r_j = Kokkos::subview(expected_R, Kokkos::ALL(), j);
+    Kokkos::deep_copy(r_j, Kokkos::subview(input_B, Kokkos::ALL(), j));
+    sequential_spmv(input_mat, x_j, r_j, -1.0, 1.0);
+    expected_norms(j) = KokkosBlas::nrm2(r_j);
+  }
+  Kokkos::View<mag_type*, Device> nrms ("nrms", numVecs);
+  KokkosSparse::residual_norm(nrms, input_mat, input_X, input_B, output_R);
+  auto nrms_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), nrms);
+  for(int j = 0; j < numVecs; ++j) {
+    auto r_j = Kokkos::subview(output_R, Kokkos::ALL(), j);
+    auto expected_r_j = Kokkos::subview(expected_R, Kokkos::ALL(), j);
+    num_errors = 0;
+    Kokkos::parallel_reduce("KokkosSparse::Test::residual",
+                            Kokkos::RangePolicy<exec_space>(0, r_j.extent(0)),
+                            fSPMV<decltype(expected_r_j), decltype(r_j)>(expected_r_j, r_j, eps),
+                            num_errors);
+    EXPECT_EQ(num_errors, 0) << "residual_norm column " << j;
+    EXPECT_LE(norm_error(expected_norms(j), nrms_h(j)), eps) << "residual_norm column " << j;
+  }
+
+  Kokkos::deep_copy(output_R, scalar_t(0));
+  KokkosSparse::residual(input_mat, input_X, input_B, output_R);
+  for(int j = 0; j < numVecs; ++j) {
+    auto r_j = Kokkos::subview(output_R, Kokkos::ALL(), j);
+    auto expected_r_j = Kokkos::subview(expected_R, Kokkos::ALL(), j);
+    num_errors = 0;
+    Kokkos::parallel_reduce("KokkosSparse::Test::residual",
+                            Kokkos::RangePolicy<exec_space>(0, r_j.extent(0)),
+                            fSPMV<decltype(expected_r_j), decltype(r_j)>(expected_r_j, r_j, eps),
+                            num_errors);
+    EXPECT_EQ(num_errors, 0) << "residual column " << j;
+  }
+} // test_residual
+
+template <typename scalar_t, typename lno_t, typename size_type, typename Device>
+void test_matrix_powers(lno_t numRows,size_type nnz, lno_t bandwidth, lno_t row_size_variance, int s, lno_t tileRows) {
+
+  using crsMat_t      = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device, void, size_type>;
+  using scalar_view_t = typename crsMat_t::values_type::non_const_type;
+  using mv_t          = Kokkos::View<scalar_t**, Kokkos::LayoutLeft, Device>;
+  using exec_space    = typename Device::execution_space;
+  using mag_type      = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+  using plan_t        = KokkosSparse::Experimental::MatrixPowersPlan<crsMat_t>;
+
+  const mag_type eps = std::is_same<mag_type, float>::value ? 2*1e-3 : 1e-7;
+
+  crsMat_t input_mat = KokkosKernels::Impl::kk_generate_sparse_matrix<crsMat_t>(numRows,numRows,nnz,row_size_variance, bandwidth);
+  lno_t nr = input_mat.numRows();
+
+  scalar_view_t input_x ("x", nr);
+  Kokkos::Random_XorShift64_Pool<exec_space> rand_pool(13718);
+  Kokkos::fill_random(input_x,rand_pool,randomUpperBound<scalar_t>(1));
+
+  Kokkos::View<scalar_t*, Device> shifts ("shifts", s);
+  auto h_shifts = Kokkos::create_mirror_view(shifts);
+  for(int k = 0; k < s; ++k)
+    h_shifts(k) = scalar_t(0.5 * (k + 1));
+  Kokkos::deep_copy(shifts, h_shifts);
+
+  plan_t plan (input_mat, s, tileRows);
+  EXPECT_EQ(plan.numPowers(), s);
+  EXPECT_GE(plan.redundancy(), 1.0);
+
+  for(bool shifted : {false, true}) {
+    mv_t V ("V", nr, s + 1);
+    if(shifted)
+      KokkosSparse::Experimental::matrix_powers(plan, input_mat, input_x, V, shifts);
+    else
+      KokkosSparse::Experimental::matrix_powers(plan, input_mat, input_x, V);
+
+    // Reference: one spmv per level
+    scalar_view_t prev ("prev", nr);
+    scalar_view_t expected ("expected", nr);
+    Kokkos::deep_copy(prev, input_x);
+    for(int k = 0; k <= s; ++k) {
+      if(k == 0) {
+        Kokkos::deep_copy(expected, input_x);
+      }
+      else {
+        KokkosSparse::spmv("N", 1.0, input_mat, prev, 0.0, expected);
+        if(shifted)
+          KokkosBlas::axpby(-h_shifts(k - 1), prev, 1.0, expected);
+      }
+      auto V_k = Kokkos::subview(V, Kokkos::ALL(), k);
+      int num_errors = 0;
+      Kokkos::parallel_reduce("KokkosSparse::Test::matrix_powers",
+                              Kokkos::RangePolicy<exec_space>(0, nr),
+                              fSPMV<scalar_view_t, decltype(V_k)>(expected, V_k, eps),
+                              num_errors);
+      EXPECT_EQ(num_errors, 0) << "matrix powers level " << k << ", shifted = " << shifted;
+      Kokkos::deep_copy(prev, expected);
+    }
+  }
+
+  // Leja-ordered Chebyshev shifts: the Chebyshev nodes of the interval,
+  // largest magnitude first, no node repeated.
+  const double lmin = -1.0, lmax = 3.0;
+  Kokkos::View<scalar_t*, Device> cheb_shifts ("cheb_shifts", s);
+  KokkosSparse::Experimental::matrix_powers_chebyshev_shifts(cheb_shifts, lmin, lmax);
+  auto h_cheb = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), cheb_shifts);
+  std::vector<bool> found(s, false);
+  for(int k = 0; k < s; ++k) {
+    const double node = Kokkos::ArithTraits<scalar_t>::real(h_cheb(k));
+    EXPECT_LE(std::abs(node), std::abs(Kokkos::ArithTraits<scalar_t>::real(h_cheb(0))) + eps);
+    for(int j = 0; j < s; ++j) {
+      const double expected = 1.0 + 2.0 * std::cos((2 * j + 1) * 3.14159265358979323846 / (2 * s));
+      if(!found[j] && std::abs(node - expected) < eps) {
+        found[j] = true;
+        break;
+      }
+    }
+  }
+  for(int j = 0; j < s; ++j)
+    EXPECT_TRUE(found[j]) << "Chebyshev node " << j << " missing from the shifts";
+} // test_matrix_powers
+
 //call it if ordinal int and, scalar float and double are instantiated.
 template<class DeviceType>
 void test_github_issue_101 ()
@@ -887,6 +2026,19 @@ TEST_F( TestCategory,sparse ## _ ## spmv ## _ ## SCALAR ## _ ## ORDINAL ## _ ##
   test_spmv<SCALAR,ORDINAL,OFFSET,DEVICE> (50000, 50000 * 30, 100, 10, false); \
   test_spmv<SCALAR,ORDINAL,OFFSET,DEVICE> (10000, 10000 * 20, 100, 5, false); \
   test_spmv_controls<SCALAR,ORDINAL,OFFSET,DEVICE> (10000, 10000 * 20, 100, 5); \
+  test_spmv_autotune<SCALAR,ORDINAL,OFFSET,DEVICE> (10000, 10000 * 20, 100, 5); \
+  test_spmv_merge<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 100); \
+  test_spmv_sellc<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 10); \
+  test_spmv_sellc_empty_rows<SCALAR,ORDINAL,OFFSET,DEVICE> (); \
+  test_spmv_deltacrs<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 10); \
+  test_spmv_handle<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 100); \
+  test_spmv_handle_numa<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 10); \
+  test_spmv_handle_transpose<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 10); \
+  test_spmv_dot<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 10); \
+  test_residual<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 10); \
+  test_spmv_symmetric<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 20, 200, 10); \
+  test_matrix_powers<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 10, 50, 5, 4, 37); \
+  test_matrix_powers<SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 10, 1000, 5, 3, 0); \
 }
 
 #define EXECUTE_TEST_MV(SCALAR, ORDINAL, OFFSET, LAYOUT, DEVICE) \
@@ -918,12 +2070,39 @@ TEST_F( TestCategory,sparse ## _ ## spmv_struct ## _ ## SCALAR ## _ ## ORDINAL #
 TEST_F( TestCategory,sparse ## _ ## spmv_mv_struct ## _ ## SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## LAYOUT ## _ ## DEVICE ) { \
   test_spmv_mv_struct_1D<SCALAR,ORDINAL,OFFSET,Kokkos::LAYOUT,DEVICE> (10, 1); \
   test_spmv_mv_struct_1D<SCALAR,ORDINAL,OFFSET,Kokkos::LAYOUT,DEVICE> (10, 2); \
+  test_spmv_mv_struct_1D<SCALAR,ORDINAL,OFFSET,Kokkos::LAYOUT,DEVICE> (23, 8); \
+  test_spmv_mv_struct_2D<SCALAR,ORDINAL,OFFSET,Kokkos::LAYOUT,DEVICE> (25, 21, 8); \
+  test_spmv_mv_struct_2D<SCALAR,ORDINAL,OFFSET,Kokkos::LAYOUT,DEVICE> (25, 21, 13); \
+  test_spmv_mv_struct_3D<SCALAR,ORDINAL,OFFSET,Kokkos::LAYOUT,DEVICE> (11, 9, 7, 16); \
+  test_spmv_mv_struct_3D<SCALAR,ORDINAL,OFFSET,Kokkos::LAYOUT,DEVICE> (11, 9, 7, 31); \
+}
+
+
+#define EXECUTE_TEST_MIXED(MAT_SCALAR, VEC_SCALAR, ORDINAL, OFFSET, DEVICE) \
+TEST_F( TestCategory,sparse ## _ ## spmv_mixed ## _ ## MAT_SCALAR ## _ ## VEC_SCALAR ## _ ## ORDINAL ## _ ## OFFSET ## _ ## DEVICE ) { \
+  test_spmv_mixed<MAT_SCALAR,VEC_SCALAR,ORDINAL,OFFSET,DEVICE> (1000, 1000 * 30, 200, 10); \
+  test_spmv_mixed<MAT_SCALAR,VEC_SCALAR,ORDINAL,OFFSET,DEVICE> (10000, 10000 * 20, 100, 5); \
 }
 
 #if (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
   EXECUTE_TEST_ISSUE_101(TestExecSpace)
 #endif
 
+#if (defined (KOKKOSKERNELS_INST_FLOAT) \
+ && defined (KOKKOSKERNELS_INST_DOUBLE) \
+ && defined (KOKKOSKERNELS_INST_ORDINAL_INT) \
+ && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+ EXECUTE_TEST_MIXED(float, double, int, int, TestExecSpace)
+#endif
+
+// Half precision matrices are not pre-instantiated. Where half_t falls back
+// to float, the float case above already covers it.
+#if defined(KOKKOS_HALF_T_IS_FLOAT) && !KOKKOS_HALF_T_IS_FLOAT \
+ && !defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS)
+using half_t = KokkosKernels::Experimental::half_t;
+ EXECUTE_TEST_MIXED(half_t, double, int, int, TestExecSpace)
+#endif
+
 
 
 #if (defined (KOKKOSKERNELS_INST_DOUBLE) \
@@ -1165,48 +2344,56 @@ TEST_F( TestCategory,sparse ## _ ## spmv_mv_struct ## _ ## SCALAR ## _ ## ORDINA
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(double, int, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(double, int, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_DOUBLE) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(double, int64_t, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(double, int64_t, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_DOUBLE) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(double, int, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(double, int, size_t, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_DOUBLE) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(double, int64_t, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(double, int64_t, size_t, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_FLOAT) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(float, int, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(float, int, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_FLOAT) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(float, int64_t, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(float, int64_t, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_FLOAT) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(float, int, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(float, int, size_t, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_FLOAT) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(float, int64_t, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(float, int64_t, size_t, LayoutRight, TestExecSpace)
 #endif
 
 
@@ -1216,48 +2403,56 @@ TEST_F( TestCategory,sparse ## _ ## spmv_mv_struct ## _ ## SCALAR ## _ ## ORDINA
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_double, int, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_double, int, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_DOUBLE_) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_double, int64_t, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_double, int64_t, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_DOUBLE_) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_double, int, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_double, int, size_t, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_DOUBLE_) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_double, int64_t, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_double, int64_t, size_t, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_float, int, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_float, int, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_INT) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_float, int64_t, int, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_float, int64_t, int, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_float, int, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_float, int, size_t, LayoutRight, TestExecSpace)
 #endif
 
 #if (defined (KOKKOSKERNELS_INST_KOKKOS_COMPLEX_FLOAT_) \
  && defined (KOKKOSKERNELS_INST_ORDINAL_INT64_T) && defined(KOKKOSKERNELS_INST_LAYOUTRIGHT) \
  && defined (KOKKOSKERNELS_INST_OFFSET_SIZE_T) ) || (!defined(KOKKOSKERNELS_ETI_ONLY) && !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
  EXECUTE_TEST_MV(kokkos_complex_float, int64_t, size_t, LayoutRight, TestExecSpace)
+ EXECUTE_TEST_MV_STRUCT(kokkos_complex_float, int64_t, size_t, LayoutRight, TestExecSpace)
 #endif
 
 